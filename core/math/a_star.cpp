@@ -33,6 +33,8 @@
 
 #include "core/math/geometry_3d.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/variant/typed_array.h"
 
 int64_t AStar3D::get_available_point_id() const {
 	if (points.has(last_free_id)) {
@@ -58,14 +60,16 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
 		pt->enabled = true;
 		points.set(p_id, pt);
+		search_graph_dirty.set();
 	} else {
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
+		if (!search_graph_dirty.is_set()) {
+			search_graph.positions[found_pt->index] = p_pos;
+			search_graph.weight_scales[found_pt->index] = p_weight_scale;
+		}
 	}
 }
 
@@ -83,6 +87,9 @@ void AStar3D::set_point_position(int64_t p_id, const Vector3 &p_pos) {
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's position. Point with id: %d doesn't exist.", p_id));
 
 	p->pos = p_pos;
+	if (!search_graph_dirty.is_set()) {
+		search_graph.positions[p->index] = p_pos;
+	}
 }
 
 real_t AStar3D::get_point_weight_scale(int64_t p_id) const {
@@ -100,6 +107,9 @@ void AStar3D::set_point_weight_scale(int64_t p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
 
 	p->weight_scale = p_weight_scale;
+	if (!search_graph_dirty.is_set()) {
+		search_graph.weight_scales[p->index] = p_weight_scale;
+	}
 }
 
 void AStar3D::remove_point(int64_t p_id) {
@@ -126,6 +136,7 @@ void AStar3D::remove_point(int64_t p_id) {
 	memdelete(p);
 	points.remove(p_id);
 	last_free_id = p_id;
+	search_graph_dirty.set();
 }
 
 void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
@@ -164,6 +175,7 @@ void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional
 	}
 
 	segments.insert(s);
+	search_graph_dirty.set();
 }
 
 void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
@@ -203,6 +215,7 @@ void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectio
 		if (s.direction != Segment::NONE) {
 			segments.insert(s);
 		}
+		search_graph_dirty.set();
 	}
 }
 
@@ -249,6 +262,7 @@ void AStar3D::clear() {
 	}
 	segments.clear();
 	points.clear();
+	search_graph_dirty.set();
 }
 
 int64_t AStar3D::get_point_count() const {
@@ -319,66 +333,152 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar3D::_solve(Point *begin_point, Point *end_point, bool p_allow_partial_path) {
-	last_closest_point = nullptr;
-	pass++;
+void AStar3D::_update_search_graph() {
+	if (!search_graph_dirty.is_set()) {
+		return;
+	}
+
+	MutexLock lock(search_graph_mutex);
+	if (!search_graph_dirty.is_set()) {
+		return; // Already rebuilt by another query.
+	}
+
+	const uint32_t point_count = points.get_num_elements();
+	search_graph.ids.resize(point_count);
+	search_graph.positions.resize(point_count);
+	search_graph.weight_scales.resize(point_count);
+	search_graph.enabled.resize(point_count);
+	search_graph.neighbor_offsets.resize(point_count + 1);
+	search_graph.neighbors.clear();
+
+	uint32_t index = 0;
+	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		Point *p = *(it.value);
+		p->index = index;
+		search_graph.ids[index] = p->id;
+		search_graph.positions[index] = p->pos;
+		search_graph.weight_scales[index] = p->weight_scale;
+		search_graph.enabled[index] = p->enabled;
+		index++;
+	}
+
+	// Both loops visit the points in the same order, so the offsets match the indices.
+	for (OAHashMap<int64_t, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		Point *p = *(it.value);
+		search_graph.neighbor_offsets[p->index] = search_graph.neighbors.size();
+		for (OAHashMap<int64_t, Point *>::Iterator nit = p->neighbors.iter(); nit.valid; nit = p->neighbors.next_iter(nit)) {
+			search_graph.neighbors.push_back((*nit.value)->index);
+		}
+	}
+	search_graph.neighbor_offsets[point_count] = search_graph.neighbors.size();
+
+	search_graph_dirty.clear();
+}
+
+AStar3D::SearchState *AStar3D::_acquire_search_state() {
+	SearchState *state = nullptr;
+	{
+		MutexLock lock(search_state_mutex);
+		if (!search_state_pool.is_empty()) {
+			state = search_state_pool[search_state_pool.size() - 1];
+			search_state_pool.remove_at(search_state_pool.size() - 1);
+		}
+	}
 
-	if (!end_point->enabled && !p_allow_partial_path) {
+	if (!state) {
+		state = memnew(SearchState);
+	}
+	if (state->nodes.size() < search_graph.ids.size()) {
+		state->nodes.resize(search_graph.ids.size());
+	}
+	return state;
+}
+
+void AStar3D::_release_search_state(SearchState *p_state) {
+	MutexLock lock(search_state_mutex);
+	search_state_pool.push_back(p_state);
+}
+
+template <typename T>
+bool AStar3D::_solve(T *p_costs, SearchState &r_state, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path) {
+	r_state.last_closest_point = UINT32_MAX;
+	r_state.pass++;
+
+	SearchNode *nodes = r_state.nodes.ptr();
+	if (unlikely(r_state.pass == 0)) {
+		// The pass counter wrapped around, forget the old passes.
+		for (uint32_t i = 0; i < r_state.nodes.size(); i++) {
+			nodes[i].open_pass = 0;
+			nodes[i].closed_pass = 0;
+		}
+		r_state.pass = 1;
+	}
+	const uint32_t pass = r_state.pass;
+
+	if (!search_graph.enabled[p_end_point] && !p_allow_partial_path) {
 		return false;
 	}
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	const int64_t end_id = search_graph.ids[p_end_point];
+	const uint32_t *neighbor_offsets = search_graph.neighbor_offsets.ptr();
+	const uint32_t *neighbors = search_graph.neighbors.ptr();
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	begin_point->abs_g_score = 0;
-	begin_point->abs_f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	LocalVector<uint32_t> &open_list = r_state.open_list;
+	open_list.clear();
+	SortArray<uint32_t, SortPoints> sorter;
+	sorter.compare.nodes = nodes;
+
+	SearchNode &begin_node = nodes[p_begin_point];
+	begin_node.g_score = 0;
+	begin_node.h_score = p_costs->_estimate_cost(search_graph.ids[p_begin_point], end_id);
+	begin_node.f_score = begin_node.h_score;
+	open_list.push_back(p_begin_point);
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		const uint32_t p = open_list[0]; // The currently processed point.
+		const SearchNode &p_node = nodes[p];
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
-			last_closest_point = p;
+		if (r_state.last_closest_point == UINT32_MAX || nodes[r_state.last_closest_point].h_score > p_node.h_score || (nodes[r_state.last_closest_point].h_score >= p_node.h_score && nodes[r_state.last_closest_point].g_score > p_node.g_score)) {
+			r_state.last_closest_point = p;
 		}
 
-		if (p == end_point) {
+		if (p == p_end_point) {
 			found_route = true;
 			break;
 		}
 
 		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
 		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		nodes[p].closed_pass = pass; // Mark the point as closed.
 
-		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-			Point *e = *(it.value); // The neighbor point.
+		const int64_t p_id = search_graph.ids[p];
+		for (uint32_t i = neighbor_offsets[p]; i < neighbor_offsets[p + 1]; i++) {
+			const uint32_t e = neighbors[i]; // The neighbor point.
+			SearchNode &e_node = nodes[e];
 
-			if (!e->enabled || e->closed_pass == pass) {
+			if (!search_graph.enabled[e] || e_node.closed_pass == pass) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			real_t tentative_g_score = nodes[p].g_score + p_costs->_compute_cost(p_id, search_graph.ids[e]) * search_graph.weight_scales[e];
 
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
+			if (e_node.open_pass != pass) { // The point wasn't inside the open list.
+				e_node.open_pass = pass;
 				open_list.push_back(e);
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_node.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			e_node.prev_point = p;
+			e_node.g_score = tentative_g_score;
+			e_node.h_score = p_costs->_estimate_cost(search_graph.ids[e], end_id);
+			e_node.f_score = e_node.g_score + e_node.h_score;
 
 			if (new_point) { // The position of the new points is already known.
 				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
@@ -391,6 +491,111 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point, bool p_allow_partial_
 	return found_route;
 }
 
+template <typename T>
+bool AStar3D::_find_path(T *p_costs, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path, LocalVector<uint32_t> &r_path) {
+	r_path.clear();
+
+	if (p_begin_point == p_end_point) {
+		r_path.push_back(p_begin_point);
+		return true;
+	}
+
+	SearchState *state = _acquire_search_state();
+
+	uint32_t end_point = p_end_point;
+	bool found_route = _solve(p_costs, *state, p_begin_point, p_end_point, p_allow_partial_path);
+	if (!found_route) {
+		if (!p_allow_partial_path || state->last_closest_point == UINT32_MAX) {
+			_release_search_state(state);
+			return false;
+		}
+
+		// Use closest point instead.
+		end_point = state->last_closest_point;
+	}
+
+	const SearchNode *nodes = state->nodes.ptr();
+	uint32_t p = end_point;
+	while (p != p_begin_point) {
+		r_path.push_back(p);
+		p = nodes[p].prev_point;
+	}
+	r_path.push_back(p_begin_point);
+	r_path.invert();
+
+	_release_search_state(state);
+	return true;
+}
+
+template <typename T>
+void AStar3D::_solve_batch_path(uint32_t p_index, PathBatch<T> *p_batch) {
+	const uint32_t begin_point = p_batch->begin_points[p_index];
+	const uint32_t end_point = p_batch->end_points[p_index];
+	if (begin_point == UINT32_MAX || end_point == UINT32_MAX) {
+		return;
+	}
+
+	LocalVector<uint32_t> route;
+	if (!_find_path(p_batch->costs, begin_point, end_point, p_batch->allow_partial_path, route)) {
+		return;
+	}
+
+	PackedInt64Array &path = p_batch->paths[p_index];
+	path.resize(route.size());
+	int64_t *w = path.ptrw();
+	for (uint32_t i = 0; i < route.size(); i++) {
+		w[i] = search_graph.ids[route[i]];
+	}
+}
+
+template <typename T>
+TypedArray<PackedInt64Array> AStar3D::_get_paths_batch(T *p_costs, const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path, bool p_use_threads) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), TypedArray<PackedInt64Array>(), vformat("Can't get paths batch. Got %d start points but %d end points.", p_from_ids.size(), p_to_ids.size()));
+
+	_update_search_graph();
+
+	const uint32_t path_count = p_from_ids.size();
+
+	PathBatch<T> batch;
+	batch.costs = p_costs;
+	batch.allow_partial_path = p_allow_partial_path;
+	batch.begin_points.resize(path_count);
+	batch.end_points.resize(path_count);
+	batch.paths.resize(path_count);
+
+	for (uint32_t i = 0; i < path_count; i++) {
+		batch.begin_points[i] = UINT32_MAX;
+		batch.end_points[i] = UINT32_MAX;
+
+		Point *a = nullptr;
+		bool from_exists = points.lookup(p_from_ids[i], a);
+		ERR_CONTINUE_MSG(!from_exists, vformat("Can't get paths batch. Point with id: %d doesn't exist.", p_from_ids[i]));
+
+		Point *b = nullptr;
+		bool to_exists = points.lookup(p_to_ids[i], b);
+		ERR_CONTINUE_MSG(!to_exists, vformat("Can't get paths batch. Point with id: %d doesn't exist.", p_to_ids[i]));
+
+		batch.begin_points[i] = a->index;
+		batch.end_points[i] = b->index;
+	}
+
+	if (p_use_threads && path_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStar3D::_solve_batch_path<T>, &batch, path_count, -1, true, SNAME("AStarPathsBatch"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < path_count; i++) {
+			_solve_batch_path(i, &batch);
+		}
+	}
+
+	TypedArray<PackedInt64Array> ret;
+	ret.resize(path_count);
+	for (uint32_t i = 0; i < path_count; i++) {
+		ret[i] = batch.paths[i];
+	}
+	return ret;
+}
+
 real_t AStar3D::_estimate_cost(int64_t p_from_id, int64_t p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -434,46 +639,21 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 	bool to_exists = points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<Vector3>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<Vector3> ret;
-		ret.push_back(a->pos);
-		return ret;
-	}
-
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<Vector3>();
-		}
+	_update_search_graph();
 
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> route;
+	if (!_find_path(this, a->index, b->index, p_allow_partial_path, route)) {
+		return Vector<Vector3>();
 	}
 
 	Vector<Vector3> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		Vector3 *w = path.ptrw();
-
-		Point *p2 = end_point;
-		int64_t idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = search_graph.positions[route[i]];
 		}
-
-		w[0] = p2->pos; // Assign first
 	}
 
 	return path;
@@ -488,57 +668,41 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 	bool to_exists = points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<int64_t> ret;
-		ret.push_back(a->id);
-		return ret;
-	}
-
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<int64_t>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
+	_update_search_graph();
 
-	Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> route;
+	if (!_find_path(this, a->index, b->index, p_allow_partial_path, route)) {
+		return Vector<int64_t>();
 	}
 
 	Vector<int64_t> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		int64_t *w = path.ptrw();
-
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = search_graph.ids[route[i]];
 		}
-
-		w[0] = p->id; // Assign first
 	}
 
 	return path;
 }
 
+TypedArray<PackedInt64Array> AStar3D::get_paths_batch(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path) {
+	// Script and extension callbacks are not safe to run on several threads at once.
+	bool use_threads = !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost);
+	return _get_paths_batch(this, p_from_ids, p_to_ids, p_allow_partial_path, use_threads);
+}
+
 void AStar3D::set_point_disabled(int64_t p_id, bool p_disabled) {
 	Point *p = nullptr;
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set if point is disabled. Point with id: %d doesn't exist.", p_id));
 
 	p->enabled = !p_disabled;
+	if (!search_graph_dirty.is_set()) {
+		search_graph.enabled[p->index] = p->enabled;
+	}
 }
 
 bool AStar3D::is_point_disabled(int64_t p_id) const {
@@ -578,6 +742,7 @@ void AStar3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStar3D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStar3D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_paths_batch", "from_ids", "to_ids", "allow_partial_path"), &AStar3D::get_paths_batch, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -585,6 +750,9 @@ void AStar3D::_bind_methods() {
 
 AStar3D::~AStar3D() {
 	clear();
+	for (SearchState *state : search_state_pool) {
+		memdelete(state);
+	}
 }
 
 /////////////////////////////////////////////////////////////
@@ -718,45 +886,22 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 	bool to_exists = astar.points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<Vector2>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<Vector2> ret = { Vector2(a->pos.x, a->pos.y) };
-		return ret;
-	}
-
-	AStar3D::Point *begin_point = a;
-	AStar3D::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
-			return Vector<Vector2>();
-		}
+	astar._update_search_graph();
 
-		// Use closest point instead.
-		end_point = astar.last_closest_point;
-	}
-
-	AStar3D::Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> route;
+	if (!astar._find_path(this, a->index, b->index, p_allow_partial_path, route)) {
+		return Vector<Vector2>();
 	}
 
 	Vector<Vector2> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		Vector2 *w = path.ptrw();
-
-		AStar3D::Point *p2 = end_point;
-		int64_t idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			const Vector3 &pos = astar.search_graph.positions[route[i]];
+			w[i] = Vector2(pos.x, pos.y);
 		}
-
-		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
 	}
 
 	return path;
@@ -771,121 +916,30 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 	bool to_exists = astar.points.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<int64_t> ret;
-		ret.push_back(a->id);
-		return ret;
-	}
-
-	AStar3D::Point *begin_point = a;
-	AStar3D::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
-			return Vector<int64_t>();
-		}
+	astar._update_search_graph();
 
-		// Use closest point instead.
-		end_point = astar.last_closest_point;
-	}
-
-	AStar3D::Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<uint32_t> route;
+	if (!astar._find_path(this, a->index, b->index, p_allow_partial_path, route)) {
+		return Vector<int64_t>();
 	}
 
 	Vector<int64_t> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		int64_t *w = path.ptrw();
-
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = astar.search_graph.ids[route[i]];
 		}
-
-		w[0] = p->id; // Assign first
 	}
 
 	return path;
 }
 
-bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point, bool p_allow_partial_path) {
-	astar.last_closest_point = nullptr;
-	astar.pass++;
-
-	if (!end_point->enabled && !p_allow_partial_path) {
-		return false;
-	}
-
-	bool found_route = false;
-
-	LocalVector<AStar3D::Point *> open_list;
-	SortArray<AStar3D::Point *, AStar3D::SortPoints> sorter;
-
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	begin_point->abs_g_score = 0;
-	begin_point->abs_f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
-
-	while (!open_list.is_empty()) {
-		AStar3D::Point *p = open_list[0]; // The currently processed point.
-
-		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (astar.last_closest_point == nullptr || astar.last_closest_point->abs_f_score > p->abs_f_score || (astar.last_closest_point->abs_f_score >= p->abs_f_score && astar.last_closest_point->abs_g_score > p->abs_g_score)) {
-			astar.last_closest_point = p;
-		}
-
-		if (p == end_point) {
-			found_route = true;
-			break;
-		}
-
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed.
-
-		for (OAHashMap<int64_t, AStar3D::Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
-			AStar3D::Point *e = *(it.value); // The neighbor point.
-
-			if (!e->enabled || e->closed_pass == astar.pass) {
-				continue;
-			}
-
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
-
-			bool new_point = false;
-
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
-				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
-				continue;
-			}
-
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
-
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
-			}
-		}
-	}
-
-	return found_route;
+TypedArray<PackedInt64Array> AStar2D::get_paths_batch(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path) {
+	// Script and extension callbacks are not safe to run on several threads at once.
+	bool use_threads = !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost);
+	return astar._get_paths_batch(this, p_from_ids, p_to_ids, p_allow_partial_path, use_threads);
 }
 
 void AStar2D::_bind_methods() {
@@ -917,6 +971,7 @@ void AStar2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStar2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStar2D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_paths_batch", "from_ids", "to_ids", "allow_partial_path"), &AStar2D::get_paths_batch, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
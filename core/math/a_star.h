@@ -33,7 +33,10 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/templates/safe_refcount.h"
 
 /**
 	A* pathfinding algorithm.
@@ -51,33 +54,64 @@ class AStar3D : public RefCounted {
 		real_t weight_scale = 0;
 		bool enabled = false;
 
+		// Index of the point in the search graph, valid while the graph is up to date.
+		uint32_t index = 0;
+
 		OAHashMap<int64_t, Point *> neighbors = 4u;
 		OAHashMap<int64_t, Point *> unlinked_neighbours = 4u;
+	};
+
+	// Compact copy of the graph used for pathfinding, with the connections
+	// stored in CSR form. Rebuilt lazily when points or connections change.
+	struct SearchGraph {
+		LocalVector<int64_t> ids;
+		LocalVector<Vector3> positions;
+		LocalVector<real_t> weight_scales;
+		LocalVector<uint8_t> enabled;
+		LocalVector<uint32_t> neighbor_offsets;
+		LocalVector<uint32_t> neighbors;
+	};
 
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
+	// Used for pathfinding, one per running query.
+	struct SearchNode {
 		real_t g_score = 0;
 		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
+		real_t h_score = 0; // Used for getting the closest point of a partial path.
+		uint32_t prev_point = 0;
+		uint32_t open_pass = 0;
+		uint32_t closed_pass = 0;
+	};
 
-		// Used for getting closest_point_of_last_pathing_call.
-		real_t abs_g_score = 0;
-		real_t abs_f_score = 0;
+	struct SearchState {
+		LocalVector<SearchNode> nodes;
+		LocalVector<uint32_t> open_list;
+		uint32_t pass = 0;
+		uint32_t last_closest_point = UINT32_MAX;
 	};
 
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+		const SearchNode *nodes = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t A, uint32_t B) const { // Returns true when the Point A is worse than Point B.
+			if (nodes[A].f_score > nodes[B].f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (nodes[A].f_score < nodes[B].f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return nodes[A].g_score < nodes[B].g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
 
+	template <typename T>
+	struct PathBatch {
+		T *costs = nullptr;
+		bool allow_partial_path = false;
+		LocalVector<uint32_t> begin_points;
+		LocalVector<uint32_t> end_points;
+		LocalVector<PackedInt64Array> paths;
+	};
+
 	struct Segment {
 		Pair<int64_t, int64_t> key;
 
@@ -109,13 +143,29 @@ class AStar3D : public RefCounted {
 	};
 
 	int64_t last_free_id = 0;
-	uint64_t pass = 1;
 
 	OAHashMap<int64_t, Point *> points;
 	HashSet<Segment, Segment> segments;
-	Point *last_closest_point = nullptr;
 
-	bool _solve(Point *begin_point, Point *end_point, bool p_allow_partial_path);
+	SearchGraph search_graph;
+	SafeFlag search_graph_dirty;
+	Mutex search_graph_mutex;
+
+	LocalVector<SearchState *> search_state_pool;
+	Mutex search_state_mutex;
+
+	void _update_search_graph();
+	SearchState *_acquire_search_state();
+	void _release_search_state(SearchState *p_state);
+
+	template <typename T>
+	bool _solve(T *p_costs, SearchState &r_state, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path);
+	template <typename T>
+	bool _find_path(T *p_costs, uint32_t p_begin_point, uint32_t p_end_point, bool p_allow_partial_path, LocalVector<uint32_t> &r_path);
+	template <typename T>
+	void _solve_batch_path(uint32_t p_index, PathBatch<T> *p_batch);
+	template <typename T>
+	TypedArray<PackedInt64Array> _get_paths_batch(T *p_costs, const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path, bool p_use_threads);
 
 protected:
 	static void _bind_methods();
@@ -162,6 +212,7 @@ public:
 
 	Vector<Vector3> get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
 	Vector<int64_t> get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
+	TypedArray<PackedInt64Array> get_paths_batch(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path = false);
 
 	AStar3D() {}
 	~AStar3D();
@@ -169,9 +220,9 @@ public:
 
 class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
-	AStar3D astar;
+	friend class AStar3D;
 
-	bool _solve(AStar3D::Point *begin_point, AStar3D::Point *end_point, bool p_allow_partial_path);
+	AStar3D astar;
 
 protected:
 	static void _bind_methods();
@@ -218,6 +269,7 @@ public:
 
 	Vector<Vector2> get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
 	Vector<int64_t> get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
+	TypedArray<PackedInt64Array> get_paths_batch(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path = false);
 
 	AStar2D() {}
 	~AStar2D() {}
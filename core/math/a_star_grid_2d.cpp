@@ -31,6 +31,7 @@
 #include "a_star_grid_2d.h"
 #include "a_star_grid_2d.compat.inc"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/variant/typed_array.h"
 
 static real_t heuristic_euclidean(const Vector2i &p_from, const Vector2i &p_to) {
@@ -136,8 +137,8 @@ void AStarGrid2D::update() {
 		solid_mask.push_back(true);
 	}
 
+	points.reserve(region.size.x * region.size.y);
 	for (int32_t y = region.position.y; y < end_y; y++) {
-		LocalVector<Point> line;
 		solid_mask.push_back(true);
 		for (int32_t x = region.position.x; x < end_x; x++) {
 			Vector2 v = offset;
@@ -154,11 +155,10 @@ void AStarGrid2D::update() {
 				default:
 					break;
 			}
-			line.push_back(Point(Vector2i(x, y), v));
+			points.push_back(Point(Vector2i(x, y), v));
 			solid_mask.push_back(false);
 		}
 		solid_mask.push_back(true);
-		points.push_back(line);
 	}
 
 	for (int32_t x = region.position.x; x < end_x + 2; x++) {
@@ -269,7 +269,7 @@ void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weig
 	}
 }
 
-AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
+AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to, Point *p_end) {
 	int32_t from_x = p_from->id.x;
 	int32_t from_y = p_from->id.y;
 
@@ -281,19 +281,19 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 
 	if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
 		if (dx == 0 || dy == 0) {
-			return _forced_successor(to_x, to_y, dx, dy);
+			return _forced_successor(to_x, to_y, dx, dy, p_end);
 		}
 
 		while (_is_walkable(to_x, to_y) && (diagonal_mode == DIAGONAL_MODE_ALWAYS || _is_walkable(to_x, to_y - dy) || _is_walkable(to_x - dx, to_y))) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (p_end->id.x == to_x && p_end->id.y == to_y) {
+				return p_end;
 			}
 
 			if ((_is_walkable(to_x - dx, to_y + dy) && !_is_walkable(to_x - dx, to_y)) || (_is_walkable(to_x + dx, to_y - dy) && !_is_walkable(to_x, to_y - dy))) {
 				return _get_point_unchecked(to_x, to_y);
 			}
 
-			if (_forced_successor(to_x + dx, to_y, dx, 0) != nullptr || _forced_successor(to_x, to_y + dy, 0, dy) != nullptr) {
+			if (_forced_successor(to_x + dx, to_y, dx, 0, p_end) != nullptr || _forced_successor(to_x, to_y + dy, 0, dy, p_end) != nullptr) {
 				return _get_point_unchecked(to_x, to_y);
 			}
 
@@ -303,19 +303,19 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 
 	} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
 		if (dx == 0 || dy == 0) {
-			return _forced_successor(from_x, from_y, dx, dy, true);
+			return _forced_successor(from_x, from_y, dx, dy, p_end, true);
 		}
 
 		while (_is_walkable(to_x, to_y) && _is_walkable(to_x, to_y - dy) && _is_walkable(to_x - dx, to_y)) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (p_end->id.x == to_x && p_end->id.y == to_y) {
+				return p_end;
 			}
 
 			if ((_is_walkable(to_x + dx, to_y + dy) && !_is_walkable(to_x, to_y + dy)) || !_is_walkable(to_x + dx, to_y)) {
 				return _get_point_unchecked(to_x, to_y);
 			}
 
-			if (_forced_successor(to_x, to_y, dx, 0) != nullptr || _forced_successor(to_x, to_y, 0, dy) != nullptr) {
+			if (_forced_successor(to_x, to_y, dx, 0, p_end) != nullptr || _forced_successor(to_x, to_y, 0, dy, p_end) != nullptr) {
 				return _get_point_unchecked(to_x, to_y);
 			}
 
@@ -325,19 +325,19 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 
 	} else { // DIAGONAL_MODE_NEVER
 		if (dy == 0) {
-			return _forced_successor(from_x, from_y, dx, 0, true);
+			return _forced_successor(from_x, from_y, dx, 0, p_end, true);
 		}
 
 		while (_is_walkable(to_x, to_y)) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (p_end->id.x == to_x && p_end->id.y == to_y) {
+				return p_end;
 			}
 
 			if ((_is_walkable(to_x - 1, to_y) && !_is_walkable(to_x - 1, to_y - dy)) || (_is_walkable(to_x + 1, to_y) && !_is_walkable(to_x + 1, to_y - dy))) {
 				return _get_point_unchecked(to_x, to_y);
 			}
 
-			if (_forced_successor(to_x, to_y, 1, 0, true) != nullptr || _forced_successor(to_x, to_y, -1, 0, true) != nullptr) {
+			if (_forced_successor(to_x, to_y, 1, 0, p_end, true) != nullptr || _forced_successor(to_x, to_y, -1, 0, p_end, true) != nullptr) {
 				return _get_point_unchecked(to_x, to_y);
 			}
 
@@ -348,7 +348,7 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 	return nullptr;
 }
 
-AStarGrid2D::Point *AStarGrid2D::_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive) {
+AStarGrid2D::Point *AStarGrid2D::_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, Point *p_end, bool p_inclusive) {
 	// Remembering previous results can improve performance.
 	bool l_prev = false, r_prev = false, l = false, r = false;
 
@@ -362,8 +362,8 @@ AStarGrid2D::Point *AStarGrid2D::_forced_successor(int32_t p_x, int32_t p_y, int
 	int32_t r_x = p_x + p_dy, r_y = p_y + p_dx;
 
 	while (_is_walkable(o_x, o_y)) {
-		if (end->id.x == o_x && end->id.y == o_y) {
-			return end;
+		if (p_end->id.x == o_x && p_end->id.y == o_y) {
+			return p_end;
 		}
 
 		l_prev = l || _is_walkable(l_x, l_y);
@@ -491,9 +491,44 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 	}
 }
 
-bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path) {
-	last_closest_point = nullptr;
-	pass++;
+AStarGrid2D::SearchState *AStarGrid2D::_acquire_search_state() {
+	SearchState *state = nullptr;
+	{
+		MutexLock lock(search_state_mutex);
+		if (!search_state_pool.is_empty()) {
+			state = search_state_pool[search_state_pool.size() - 1];
+			search_state_pool.remove_at(search_state_pool.size() - 1);
+		}
+	}
+
+	if (!state) {
+		state = memnew(SearchState);
+	}
+	if (state->nodes.size() < points.size()) {
+		state->nodes.resize(points.size());
+	}
+	return state;
+}
+
+void AStarGrid2D::_release_search_state(SearchState *p_state) {
+	MutexLock lock(search_state_mutex);
+	search_state_pool.push_back(p_state);
+}
+
+bool AStarGrid2D::_solve(SearchState &r_state, Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path) {
+	r_state.last_closest_point = UINT32_MAX;
+	r_state.pass++;
+
+	SearchNode *nodes = r_state.nodes.ptr();
+	if (unlikely(r_state.pass == 0)) {
+		// The pass counter wrapped around, forget the old passes.
+		for (uint32_t i = 0; i < r_state.nodes.size(); i++) {
+			nodes[i].open_pass = 0;
+			nodes[i].closed_pass = 0;
+		}
+		r_state.pass = 1;
+	}
+	const uint32_t pass = r_state.pass;
 
 	if (_get_solid_unchecked(p_end_point->id) && !p_allow_partial_path) {
 		return false;
@@ -501,34 +536,42 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	Point *point_data = points.ptr();
+	const uint32_t end_index = p_end_point - point_data;
+
+	LocalVector<uint32_t> &open_list = r_state.open_list;
+	open_list.clear();
+	SortArray<uint32_t, SortPoints> sorter;
+	sorter.compare.nodes = nodes;
 
-	p_begin_point->g_score = 0;
-	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	p_begin_point->abs_g_score = 0;
-	p_begin_point->abs_f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	open_list.push_back(p_begin_point);
-	end = p_end_point;
+	const uint32_t begin_index = p_begin_point - point_data;
+	SearchNode &begin_node = nodes[begin_index];
+	begin_node.g_score = 0;
+	begin_node.h_score = _estimate_cost(p_begin_point->id, p_end_point->id);
+	begin_node.f_score = begin_node.h_score;
+	open_list.push_back(begin_index);
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		const uint32_t p_index = open_list[0]; // The currently processed point.
+		const SearchNode &p_node = nodes[p_index];
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
-			last_closest_point = p;
+		if (r_state.last_closest_point == UINT32_MAX || nodes[r_state.last_closest_point].h_score > p_node.h_score || (nodes[r_state.last_closest_point].h_score >= p_node.h_score && nodes[r_state.last_closest_point].g_score > p_node.g_score)) {
+			r_state.last_closest_point = p_index;
 		}
 
-		if (p == p_end_point) {
+		if (p_index == end_index) {
 			found_route = true;
 			break;
 		}
 
 		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
 		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		nodes[p_index].closed_pass = pass; // Mark the point as closed.
 
-		LocalVector<Point *> nbors;
+		Point *p = &point_data[p_index];
+		LocalVector<Point *> &nbors = r_state.nbors;
+		nbors.clear();
 		_get_nbors(p, nbors);
 
 		for (Point *e : nbors) {
@@ -536,39 +579,40 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 
 			if (jumping_enabled) {
 				// TODO: Make it works with weight_scale.
-				e = _jump(p, e);
-				if (!e || e->closed_pass == pass) {
+				e = _jump(p, e, p_end_point);
+				if (!e || nodes[e - point_data].closed_pass == pass) {
 					continue;
 				}
 			} else {
-				if (_get_solid_unchecked(e->id) || e->closed_pass == pass) {
+				if (_get_solid_unchecked(e->id) || nodes[e - point_data].closed_pass == pass) {
 					continue;
 				}
 				weight_scale = e->weight_scale;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * weight_scale;
+			const uint32_t e_index = e - point_data;
+			SearchNode &e_node = nodes[e_index];
+
+			real_t tentative_g_score = nodes[p_index].g_score + _compute_cost(p->id, e->id) * weight_scale;
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (e_node.open_pass != pass) { // The point wasn't inside the open list.
+				e_node.open_pass = pass;
+				open_list.push_back(e_index);
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_node.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
-
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			e_node.prev_point = p_index;
+			e_node.g_score = tentative_g_score;
+			e_node.h_score = _estimate_cost(e->id, p_end_point->id);
+			e_node.f_score = e_node.g_score + e_node.h_score;
 
 			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+				sorter.push_heap(0, open_list.size() - 1, 0, e_index, open_list.ptr());
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+				sorter.push_heap(0, open_list.find(e_index), 0, e_index, open_list.ptr());
 			}
 		}
 	}
@@ -576,6 +620,63 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 	return found_route;
 }
 
+bool AStarGrid2D::_find_path(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path, LocalVector<Point *> &r_path) {
+	r_path.clear();
+
+	if (p_begin_point == p_end_point) {
+		r_path.push_back(p_begin_point);
+		return true;
+	}
+
+	SearchState *state = _acquire_search_state();
+
+	Point *point_data = points.ptr();
+	uint32_t end_index = p_end_point - point_data;
+
+	bool found_route = _solve(*state, p_begin_point, p_end_point, p_allow_partial_path);
+	if (!found_route) {
+		if (!p_allow_partial_path || state->last_closest_point == UINT32_MAX) {
+			_release_search_state(state);
+			return false;
+		}
+
+		// Use closest point instead.
+		end_index = state->last_closest_point;
+	}
+
+	const SearchNode *nodes = state->nodes.ptr();
+	const uint32_t begin_index = p_begin_point - point_data;
+	uint32_t p = end_index;
+	while (p != begin_index) {
+		r_path.push_back(&point_data[p]);
+		p = nodes[p].prev_point;
+	}
+	r_path.push_back(p_begin_point);
+	r_path.invert();
+
+	_release_search_state(state);
+	return true;
+}
+
+void AStarGrid2D::_solve_batch_path(uint32_t p_index, PathBatch *p_batch) {
+	const Vector2i &from_id = p_batch->from_ids[p_index];
+	const Vector2i &to_id = p_batch->to_ids[p_index];
+	if (!is_in_boundsv(from_id) || !is_in_boundsv(to_id)) {
+		return;
+	}
+
+	LocalVector<Point *> route;
+	if (!_find_path(_get_point_unchecked(from_id), _get_point_unchecked(to_id), p_batch->allow_partial_path, route)) {
+		return;
+	}
+
+	LocalVector<Vector2i> &path = p_batch->paths[p_index];
+	path.resize(route.size());
+	for (uint32_t i = 0; i < route.size(); i++) {
+		path[i] = route[i]->id;
+	}
+}
+
 real_t AStarGrid2D::_estimate_cost(const Vector2i &p_from_id, const Vector2i &p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -616,7 +717,7 @@ TypedArray<Dictionary> AStarGrid2D::get_point_data_in_region(const Rect2i &p_reg
 
 	for (int32_t y = start_y; y < end_y; y++) {
 		for (int32_t x = start_x; x < end_x; x++) {
-			const Point &p = points[y][x];
+			const Point &p = points[y * region.size.x + x];
 
 			Dictionary dict;
 			dict["id"] = p.id;
@@ -635,49 +736,19 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
-
-	if (a == b) {
-		Vector<Vector2> ret;
-		ret.push_back(a->pos);
-		return ret;
-	}
-
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<Vector2>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	LocalVector<Point *> route;
+	if (!_find_path(_get_point(p_from_id.x, p_from_id.y), _get_point(p_to_id.x, p_to_id.y), p_allow_partial_path, route)) {
+		return Vector<Vector2>();
 	}
 
 	Vector<Vector2> path;
-	path.resize(pc);
+	path.resize(route.size());
 
 	{
 		Vector2 *w = path.ptrw();
-
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->pos;
-			p = p->prev_point;
+		for (uint32_t i = 0; i < route.size(); i++) {
+			w[i] = route[i]->pos;
 		}
-
-		w[0] = p->pos;
 	}
 
 	return path;
@@ -688,50 +759,63 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
-
-	if (a == b) {
-		TypedArray<Vector2i> ret;
-		ret.push_back(a->id);
-		return ret;
+	LocalVector<Point *> route;
+	if (!_find_path(_get_point(p_from_id.x, p_from_id.y), _get_point(p_to_id.x, p_to_id.y), p_allow_partial_path, route)) {
+		return TypedArray<Vector2i>();
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	TypedArray<Vector2i> path;
+	path.resize(route.size());
+	for (uint32_t i = 0; i < route.size(); i++) {
+		path[i] = route[i]->id;
+	}
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return TypedArray<Vector2i>();
-		}
+	return path;
+}
 
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
+Array AStarGrid2D::get_paths_batch(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path) {
+	ERR_FAIL_COND_V_MSG(dirty, Array(), "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), Array(), vformat("Can't get paths batch. Got %d start points but %d end points.", p_from_ids.size(), p_to_ids.size()));
 
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
+	const uint32_t path_count = p_from_ids.size();
 
-	TypedArray<Vector2i> path;
-	path.resize(pc);
+	PathBatch batch;
+	batch.allow_partial_path = p_allow_partial_path;
+	batch.from_ids.resize(path_count);
+	batch.to_ids.resize(path_count);
+	batch.paths.resize(path_count);
 
-	{
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			path[idx--] = p->id;
-			p = p->prev_point;
+	for (uint32_t i = 0; i < path_count; i++) {
+		batch.from_ids[i] = p_from_ids[i];
+		batch.to_ids[i] = p_to_ids[i];
+		if (!is_in_boundsv(batch.from_ids[i]) || !is_in_boundsv(batch.to_ids[i])) {
+			ERR_PRINT(vformat("Can't get paths batch. Path from %s to %s is out of bounds %s.", batch.from_ids[i], batch.to_ids[i], region));
 		}
+	}
 
-		path[0] = p->id;
+	// Script and extension callbacks are not safe to run on several threads at once.
+	bool use_threads = !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost);
+	if (use_threads && path_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStarGrid2D::_solve_batch_path, &batch, path_count, -1, true, SNAME("AStarGrid2DPathsBatch"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < path_count; i++) {
+			_solve_batch_path(i, &batch);
+		}
 	}
 
-	return path;
+	Array ret;
+	ret.resize(path_count);
+	for (uint32_t i = 0; i < path_count; i++) {
+		const LocalVector<Vector2i> &route = batch.paths[i];
+		TypedArray<Vector2i> path;
+		path.resize(route.size());
+		for (uint32_t j = 0; j < route.size(); j++) {
+			path[j] = route[j];
+		}
+		ret[i] = path;
+	}
+	return ret;
 }
 
 void AStarGrid2D::_bind_methods() {
@@ -769,6 +853,7 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_data_in_region", "region"), &AStarGrid2D::get_point_data_in_region);
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_paths_batch", "from_ids", "to_ids", "allow_partial_path"), &AStarGrid2D::get_paths_batch, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -801,3 +886,9 @@ void AStarGrid2D::_bind_methods() {
 	BIND_ENUM_CONSTANT(CELL_SHAPE_ISOMETRIC_DOWN);
 	BIND_ENUM_CONSTANT(CELL_SHAPE_MAX);
 }
+
+AStarGrid2D::~AStarGrid2D() {
+	for (SearchState *state : search_state_pool) {
+		memdelete(state);
+	}
+}
@@ -33,6 +33,7 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
 #include "core/templates/list.h"
 #include "core/templates/local_vector.h"
 
@@ -81,41 +82,56 @@ private:
 		Vector2 pos;
 		real_t weight_scale = 1.0;
 
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
-
-		// Used for getting last_closest_point.
-		real_t abs_g_score = 0;
-		real_t abs_f_score = 0;
-
 		Point() {}
 
 		Point(const Vector2i &p_id, const Vector2 &p_pos) :
 				id(p_id), pos(p_pos) {}
 	};
 
+	// Used for pathfinding, one per running query.
+	struct SearchNode {
+		real_t g_score = 0;
+		real_t f_score = 0;
+		real_t h_score = 0; // Used for getting the closest point of a partial path.
+		uint32_t prev_point = 0;
+		uint32_t open_pass = 0;
+		uint32_t closed_pass = 0;
+	};
+
+	struct SearchState {
+		LocalVector<SearchNode> nodes;
+		LocalVector<uint32_t> open_list;
+		LocalVector<Point *> nbors;
+		uint32_t pass = 0;
+		uint32_t last_closest_point = UINT32_MAX;
+	};
+
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+		const SearchNode *nodes = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t A, uint32_t B) const { // Returns true when the Point A is worse than Point B.
+			if (nodes[A].f_score > nodes[B].f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (nodes[A].f_score < nodes[B].f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return nodes[A].g_score < nodes[B].g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
 
+	struct PathBatch {
+		bool allow_partial_path = false;
+		LocalVector<Vector2i> from_ids;
+		LocalVector<Vector2i> to_ids;
+		LocalVector<LocalVector<Vector2i>> paths;
+	};
+
 	LocalVector<bool> solid_mask;
-	LocalVector<LocalVector<Point>> points;
-	Point *end = nullptr;
-	Point *last_closest_point = nullptr;
+	LocalVector<Point> points; // Row-major, one row per region line.
 
-	uint64_t pass = 1;
+	LocalVector<SearchState *> search_state_pool;
+	Mutex search_state_mutex;
 
 private: // Internal routines.
 	_FORCE_INLINE_ size_t _to_mask_index(int32_t p_x, int32_t p_y) const {
@@ -128,7 +144,7 @@ private: // Internal routines.
 
 	_FORCE_INLINE_ Point *_get_point(int32_t p_x, int32_t p_y) {
 		if (region.has_point(Vector2i(p_x, p_y))) {
-			return &points[p_y - region.position.y][p_x - region.position.x];
+			return _get_point_unchecked(p_x, p_y);
 		}
 		return nullptr;
 	}
@@ -145,22 +161,31 @@ private: // Internal routines.
 		return solid_mask[_to_mask_index(p_id.x, p_id.y)];
 	}
 
+	_FORCE_INLINE_ uint32_t _to_point_index(int32_t p_x, int32_t p_y) const {
+		return (p_y - region.position.y) * region.size.x + p_x - region.position.x;
+	}
+
 	_FORCE_INLINE_ Point *_get_point_unchecked(int32_t p_x, int32_t p_y) {
-		return &points[p_y - region.position.y][p_x - region.position.x];
+		return &points[_to_point_index(p_x, p_y)];
 	}
 
 	_FORCE_INLINE_ Point *_get_point_unchecked(const Vector2i &p_id) {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
+		return &points[_to_point_index(p_id.x, p_id.y)];
 	}
 
 	_FORCE_INLINE_ const Point *_get_point_unchecked(const Vector2i &p_id) const {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
+		return &points[_to_point_index(p_id.x, p_id.y)];
 	}
 
+	SearchState *_acquire_search_state();
+	void _release_search_state(SearchState *p_state);
+
 	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
-	Point *_jump(Point *p_from, Point *p_to);
-	bool _solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
-	Point *_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive = false);
+	Point *_jump(Point *p_from, Point *p_to, Point *p_end);
+	bool _solve(SearchState &r_state, Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
+	bool _find_path(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path, LocalVector<Point *> &r_path);
+	void _solve_batch_path(uint32_t p_index, PathBatch *p_batch);
+	Point *_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, Point *p_end, bool p_inclusive = false);
 
 protected:
 	static void _bind_methods();
@@ -226,6 +251,9 @@ public:
 	TypedArray<Dictionary> get_point_data_in_region(const Rect2i &p_region) const;
 	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
 	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
+	Array get_paths_batch(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path = false);
+
+	~AStarGrid2D();
 };
 
 VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
@@ -289,6 +289,8 @@ void DynamicBVH::clear() {
 	}
 	lkhd = -1;
 	opath = 0;
+	wide_nodes.clear();
+	wide_nodes_valid = false;
 }
 
 void DynamicBVH::optimize_bottom_up() {
@@ -337,6 +339,7 @@ DynamicBVH::ID DynamicBVH::insert(const AABB &p_box, void *p_userdata) {
 	Node *leaf = _create_node_with_volume(nullptr, volume, p_userdata);
 	_insert_leaf(bvh_root, leaf);
 	++total_leaves;
+	wide_nodes_valid = false;
 
 	ID id;
 	id.node = leaf;
@@ -383,12 +386,20 @@ bool DynamicBVH::update(const ID &p_id, const AABB &p_box) {
 	}
 	leaf->volume = volume;
 	_insert_leaf(base, leaf);
+	if (wide_nodes_valid) {
+		_refit_wide_leaf(leaf);
+	}
 	return true;
 }
 
 void DynamicBVH::remove(const ID &p_id) {
 	ERR_FAIL_COND(!p_id.is_valid());
 	Node *leaf = p_id.node;
+	if (wide_nodes_valid) {
+		WideNode &wide = wide_nodes[leaf->wide_index / WIDE_NODE_LANES];
+		wide.clear_lane(leaf->wide_index % WIDE_NODE_LANES);
+		_refit_wide_leaf(leaf);
+	}
 	_remove_leaf(leaf);
 	_delete_node(leaf);
 	--total_leaves;
@@ -420,6 +431,146 @@ void DynamicBVH::get_elements(List<ID> *r_elements) {
 	}
 }
 
+bool DynamicBVH::WideNode::get_bounds(Volume &r_volume) const {
+	bool empty = true;
+	for (uint32_t i = 0; i < WIDE_NODE_LANES; i++) {
+		if (children[i] == WIDE_LANE_EMPTY) {
+			continue;
+		}
+		const Vector3 lane_min(min_x[i], min_y[i], min_z[i]);
+		const Vector3 lane_max(max_x[i], max_y[i], max_z[i]);
+		if (empty) {
+			r_volume.min = lane_min;
+			r_volume.max = lane_max;
+			empty = false;
+		} else {
+			r_volume.min = r_volume.min.min(lane_min);
+			r_volume.max = r_volume.max.max(lane_max);
+		}
+	}
+	return !empty;
+}
+
+void DynamicBVH::_refit_wide_leaf(Node *p_leaf) {
+	ERR_FAIL_COND(p_leaf->wide_index < 0);
+	int32_t node_index = p_leaf->wide_index / WIDE_NODE_LANES;
+	WideNode *node = &wide_nodes[node_index];
+	const uint32_t lane = p_leaf->wide_index % WIDE_NODE_LANES;
+	if (node->children[lane] == WIDE_LANE_LEAF) {
+		node->set_lane(lane, p_leaf->volume);
+	}
+
+	// Propagate the new bounds upwards, stopping as soon as they no longer change.
+	while (node->parent >= 0) {
+		WideNode &parent = wide_nodes[node->parent];
+		Volume bounds;
+		if (node->get_bounds(bounds)) {
+			const uint32_t parent_lane = node->parent_lane;
+			const Volume previous = { Vector3(parent.min_x[parent_lane], parent.min_y[parent_lane], parent.min_z[parent_lane]),
+				Vector3(parent.max_x[parent_lane], parent.max_y[parent_lane], parent.max_z[parent_lane]) };
+			if (!bounds.is_not_equal_to(previous)) {
+				break;
+			}
+			parent.set_lane(parent_lane, bounds);
+		} else {
+			parent.clear_lane(node->parent_lane);
+		}
+		node_index = node->parent;
+		node = &wide_nodes[node_index];
+	}
+
+	wide_refit_count++;
+}
+
+void DynamicBVH::update_wide_nodes() {
+	// Refitting degrades the tree as instances move around, so rebuild once a
+	// significant part of it was touched since the last build.
+	if (wide_nodes_valid && wide_refit_count <= uint32_t(total_leaves / 4)) {
+		return;
+	}
+
+	wide_nodes.clear();
+	wide_nodes_valid = false;
+	wide_refit_count = 0;
+
+	if (!bvh_root) {
+		return;
+	}
+
+	struct PendingNode {
+		Node *node = nullptr;
+		int32_t parent = -1;
+		uint32_t parent_lane = 0;
+	};
+
+	LocalVector<PendingNode> pending;
+	pending.push_back({ bvh_root, -1, 0 });
+
+	while (pending.size()) {
+		const PendingNode current = pending[pending.size() - 1];
+		pending.resize(pending.size() - 1);
+
+		const int32_t node_index = wide_nodes.size();
+		wide_nodes.push_back(WideNode());
+		if (current.parent >= 0) {
+			wide_nodes[current.parent].children[current.parent_lane] = node_index;
+		}
+
+		// Collapse the binary subtree by repeatedly opening the largest internal
+		// candidate until all lanes are used.
+		Node *candidates[WIDE_NODE_LANES];
+		uint32_t candidate_count = 0;
+		if (current.node->is_leaf()) {
+			// Only happens when the root is a leaf.
+			candidates[candidate_count++] = current.node;
+		} else {
+			candidates[candidate_count++] = current.node->children[0];
+			candidates[candidate_count++] = current.node->children[1];
+		}
+
+		while (candidate_count < WIDE_NODE_LANES) {
+			int32_t best = -1;
+			real_t best_size = 0;
+			for (uint32_t i = 0; i < candidate_count; i++) {
+				if (candidates[i]->is_internal() && (best == -1 || candidates[i]->volume.get_size() > best_size)) {
+					best = i;
+					best_size = candidates[i]->volume.get_size();
+				}
+			}
+			if (best == -1) {
+				break;
+			}
+			Node *opened = candidates[best];
+			candidates[best] = opened->children[0];
+			candidates[candidate_count++] = opened->children[1];
+		}
+
+		WideNode &wide = wide_nodes[node_index];
+		wide.parent = current.parent;
+		wide.parent_lane = current.parent_lane;
+		for (uint32_t i = 0; i < WIDE_NODE_LANES; i++) {
+			if (i >= candidate_count) {
+				wide.clear_lane(i);
+				continue;
+			}
+			Node *candidate = candidates[i];
+			wide.set_lane(i, candidate->volume);
+			if (candidate->is_leaf()) {
+				wide.children[i] = WIDE_LANE_LEAF;
+				wide.leaves[i] = candidate;
+				candidate->wide_index = node_index * WIDE_NODE_LANES + i;
+			} else {
+				// Assigned once the child is popped.
+				wide.children[i] = WIDE_LANE_EMPTY;
+				wide.leaves[i] = nullptr;
+				pending.push_back({ candidate, node_index, i });
+			}
+		}
+	}
+
+	wide_nodes_valid = true;
+}
+
 int DynamicBVH::get_leaf_count() const {
 	return total_leaves;
 }
@@ -181,6 +181,7 @@ private:
 	struct Node {
 		Volume volume;
 		Node *parent = nullptr;
+		int32_t wide_index = -1; // Leaf lane in the wide node array (node * WIDE_NODE_LANES + lane).
 		union {
 			Node *children[2];
 			void *data;
@@ -221,6 +222,48 @@ private:
 		}
 	};
 
+	enum {
+		WIDE_NODE_LANES = 4,
+		WIDE_LANE_LEAF = -1,
+		WIDE_LANE_EMPTY = -2,
+	};
+
+	// Collapsed 4-wide version of the tree, used to speed up culling queries.
+	// Bounds are stored as structure of arrays so the per-lane tests can be
+	// vectorized. Only leaves are referenced, so rebalancing the binary tree
+	// does not invalidate it; moved and removed leaves are refit in place.
+	struct WideNode {
+		real_t min_x[WIDE_NODE_LANES];
+		real_t min_y[WIDE_NODE_LANES];
+		real_t min_z[WIDE_NODE_LANES];
+		real_t max_x[WIDE_NODE_LANES];
+		real_t max_y[WIDE_NODE_LANES];
+		real_t max_z[WIDE_NODE_LANES];
+		int32_t children[WIDE_NODE_LANES]; // Wide node index, WIDE_LANE_LEAF or WIDE_LANE_EMPTY.
+		Node *leaves[WIDE_NODE_LANES];
+		int32_t parent = -1;
+		uint32_t parent_lane = 0;
+
+		_FORCE_INLINE_ void set_lane(uint32_t p_lane, const Volume &p_volume) {
+			min_x[p_lane] = p_volume.min.x;
+			min_y[p_lane] = p_volume.min.y;
+			min_z[p_lane] = p_volume.min.z;
+			max_x[p_lane] = p_volume.max.x;
+			max_y[p_lane] = p_volume.max.y;
+			max_z[p_lane] = p_volume.max.z;
+		}
+
+		_FORCE_INLINE_ void clear_lane(uint32_t p_lane) {
+			// Inverted bounds never pass the overlap test.
+			min_x[p_lane] = min_y[p_lane] = min_z[p_lane] = 1e30;
+			max_x[p_lane] = max_y[p_lane] = max_z[p_lane] = -1e30;
+			children[p_lane] = WIDE_LANE_EMPTY;
+			leaves[p_lane] = nullptr;
+		}
+
+		bool get_bounds(Volume &r_volume) const;
+	};
+
 	PagedAllocator<Node> node_allocator;
 	// Fields
 	Node *bvh_root = nullptr;
@@ -229,6 +272,10 @@ private:
 	uint32_t opath = 0;
 	uint32_t index = 0;
 
+	LocalVector<WideNode> wide_nodes;
+	bool wide_nodes_valid = false;
+	uint32_t wide_refit_count = 0;
+
 	enum {
 		ALLOCA_STACK_SIZE = 128
 	};
@@ -250,6 +297,10 @@ private:
 
 	void _extract_leaves(Node *p_node, List<ID> *r_elements);
 
+	void _refit_wide_leaf(Node *p_leaf);
+	template <typename QueryResult>
+	void _wide_query(const Volume &p_volume, const Plane *p_planes, int p_plane_count, QueryResult &r_result);
+
 	_FORCE_INLINE_ bool _ray_aabb(const Vector3 &rayFrom, const Vector3 &rayInvDirection, const unsigned int raySign[3], const Vector3 bounds[2], real_t &tmin, real_t lambda_min, real_t lambda_max) {
 		real_t tmax, tymin, tymax, tzmin, tzmax;
 		tmin = (bounds[raySign[0]].x - rayFrom.x) * rayInvDirection.x;
@@ -299,6 +350,12 @@ public:
 	int get_leaf_count() const;
 	int get_max_depth() const;
 
+	// Builds (or rebuilds, once too many leaves were refit) the wide node array
+	// used by aabb_query() and convex_query(). Inserting or clearing invalidates
+	// it, and queries fall back to the binary tree until this is called again.
+	void update_wide_nodes();
+	bool has_wide_nodes() const { return wide_nodes_valid; }
+
 	/* Discouraged, but works as a reference on how it must be used */
 	struct DefaultQueryResult {
 		virtual bool operator()(void *p_data) = 0; //return true whether you want to continue the query
@@ -328,6 +385,11 @@ void DynamicBVH::aabb_query(const AABB &p_box, QueryResult &r_result) {
 	volume.min = p_box.position;
 	volume.max = p_box.position + p_box.size;
 
+	if (wide_nodes_valid) {
+		_wide_query(volume, nullptr, 0, r_result);
+		return;
+	}
+
 	const Node **alloca_stack = (const Node **)alloca(ALLOCA_STACK_SIZE * sizeof(const Node *));
 	const Node **stack = alloca_stack;
 	stack[0] = bvh_root;
@@ -365,7 +427,8 @@ void DynamicBVH::aabb_query(const AABB &p_box, QueryResult &r_result) {
 
 template <typename QueryResult>
 void DynamicBVH::convex_query(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, QueryResult &r_result) {
-	if (!bvh_root) {
+	if (!bvh_root || p_point_count == 0) {
+		// No volume can be inside a convex without points.
 		return;
 	}
 
@@ -381,6 +444,12 @@ void DynamicBVH::convex_query(const Plane *p_planes, int p_plane_count, const Ve
 		}
 	}
 
+	if (wide_nodes_valid) {
+		// The point separation test of intersects_convex() is the same as the volume pre-test.
+		_wide_query(volume, p_planes, p_plane_count, r_result);
+		return;
+	}
+
 	const Node **alloca_stack = (const Node **)alloca(ALLOCA_STACK_SIZE * sizeof(const Node *));
 	const Node **stack = alloca_stack;
 	stack[0] = bvh_root;
@@ -415,6 +484,67 @@ void DynamicBVH::convex_query(const Plane *p_planes, int p_plane_count, const Ve
 		}
 	} while (depth > 0);
 }
+
+template <typename QueryResult>
+void DynamicBVH::_wide_query(const Volume &p_volume, const Plane *p_planes, int p_plane_count, QueryResult &r_result) {
+	int32_t *alloca_stack = (int32_t *)alloca(ALLOCA_STACK_SIZE * sizeof(int32_t));
+	int32_t *stack = alloca_stack;
+	stack[0] = 0;
+	int32_t depth = 1;
+	int32_t threshold = ALLOCA_STACK_SIZE - WIDE_NODE_LANES;
+
+	LocalVector<int32_t> aux_stack; //only used in rare occasions when you run out of alloca memory because tree is too unbalanced. Should correct itself over time.
+
+	do {
+		depth--;
+		const WideNode &n = wide_nodes[stack[depth]];
+
+		// Test all lanes at once, these loops are branchless so they can be vectorized.
+		uint32_t hit[WIDE_NODE_LANES];
+		for (uint32_t i = 0; i < WIDE_NODE_LANES; i++) {
+			hit[i] = uint32_t(n.min_x[i] <= p_volume.max.x) & uint32_t(n.max_x[i] >= p_volume.min.x) &
+					uint32_t(n.min_y[i] <= p_volume.max.y) & uint32_t(n.max_y[i] >= p_volume.min.y) &
+					uint32_t(n.min_z[i] <= p_volume.max.z) & uint32_t(n.max_z[i] >= p_volume.min.z);
+		}
+
+		for (int p = 0; p < p_plane_count; p++) {
+			// Test the corner furthest along the negative normal, the volume is outside if it is over the plane.
+			const Plane &plane = p_planes[p];
+			const real_t *nx = plane.normal.x > 0 ? n.min_x : n.max_x;
+			const real_t *ny = plane.normal.y > 0 ? n.min_y : n.max_y;
+			const real_t *nz = plane.normal.z > 0 ? n.min_z : n.max_z;
+			for (uint32_t i = 0; i < WIDE_NODE_LANES; i++) {
+				hit[i] &= uint32_t(plane.normal.x * nx[i] + plane.normal.y * ny[i] + plane.normal.z * nz[i] <= plane.d);
+			}
+		}
+
+		for (uint32_t i = 0; i < WIDE_NODE_LANES; i++) {
+			if (!hit[i]) {
+				continue;
+			}
+			const int32_t child = n.children[i];
+			if (child == WIDE_LANE_LEAF) {
+				if (r_result(n.leaves[i]->data)) {
+					return;
+				}
+			} else if (child >= 0) {
+				if (depth > threshold) {
+					if (aux_stack.is_empty()) {
+						aux_stack.resize(ALLOCA_STACK_SIZE * 2);
+						memcpy(aux_stack.ptr(), alloca_stack, ALLOCA_STACK_SIZE * sizeof(int32_t));
+						alloca_stack = nullptr;
+					} else {
+						aux_stack.resize(aux_stack.size() * 2);
+					}
+					stack = aux_stack.ptr();
+					threshold = aux_stack.size() - WIDE_NODE_LANES;
+				}
+				stack[depth++] = child;
+			}
+		}
+	} while (depth > 0);
+}
+
 template <typename QueryResult>
 void DynamicBVH::ray_query(const Vector3 &p_from, const Vector3 &p_to, QueryResult &r_result) {
 	if (!bvh_root) {
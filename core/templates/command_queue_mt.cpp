@@ -33,9 +33,144 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
+SafeNumeric<uint64_t> CommandQueueMT::last_queue_id;
+thread_local CommandQueueMT::ThreadProducers CommandQueueMT::thread_producers;
+BinaryMutex CommandQueueMT::queues_mutex;
+LocalVector<CommandQueueMT *> CommandQueueMT::queues;
+
+CommandQueueMT::ThreadProducers::~ThreadProducers() {
+	if (thread_id != Thread::UNASSIGNED_ID) {
+		CommandQueueMT::_release_thread_producers(thread_id);
+	}
+}
+
+void CommandQueueMT::_release_thread_producers(Thread::ID p_thread_id) {
+	MutexLock lock(queues_mutex);
+	for (CommandQueueMT *queue : queues) {
+		MutexLock block_lock(queue->block_mutex);
+		for (Producer &producer : queue->producers) {
+			if (producer.thread_id != p_thread_id) {
+				continue;
+			}
+			CommandBlock *block = producer.block;
+			producer.thread_id = Thread::UNASSIGNED_ID;
+			producer.block = nullptr;
+			if (block && block->refcount.decrement() == 0) {
+				// Not through _release_block(), block_mutex is already held.
+				block->next_free = queue->free_blocks;
+				queue->free_blocks = block;
+			}
+		}
+	}
+}
+
+CommandQueueMT::Producer *CommandQueueMT::_register_producer() {
+	Thread::ID thread_id = Thread::get_caller_id();
+
+	Producer *producer = nullptr;
+	{
+		MutexLock lock(block_mutex);
+
+		Producer *free_producer = nullptr;
+		for (uint32_t i = 0; i < MAX_PRODUCERS; i++) {
+			if (producers[i].thread_id == thread_id) {
+				producer = &producers[i];
+				break;
+			}
+			if (!free_producer && producers[i].thread_id == Thread::UNASSIGNED_ID) {
+				free_producer = &producers[i];
+			}
+		}
+
+		if (!producer && free_producer) {
+			free_producer->thread_id = thread_id;
+			producer = free_producer;
+		}
+	}
+
+	if (producer) {
+		// Evicted entries keep their slot, they're found again above and released on thread exit.
+		ProducerCache &entry = thread_producers.cache[thread_producers.next_cache_entry++ % PRODUCER_CACHE_SIZE];
+		entry.queue = this;
+		entry.queue_id = queue_id;
+		entry.producer = producer;
+		thread_producers.thread_id = thread_id;
+	}
+	return producer;
+}
+
+CommandQueueMT::CommandBlock *CommandQueueMT::_producer_acquire_block(Producer *p_producer) {
+	if (p_producer->block) {
+		// Retire the current block, it will be recycled once all its commands are done.
+		_unref_block(p_producer->block);
+		p_producer->block = nullptr;
+	}
+
+	CommandBlock *block;
+	{
+		MutexLock lock(block_mutex);
+		if (free_blocks) {
+			block = free_blocks;
+			free_blocks = block->next_free;
+		} else {
+			block = memnew_placement(memalloc(BLOCK_HEADER_SIZE + BLOCK_DATA_SIZE), CommandBlock);
+			blocks.push_back(block);
+		}
+	}
+
+	block->next_free = nullptr;
+	block->used = 0;
+	block->refcount.set(1);
+	p_producer->block = block;
+	return block;
+}
+
+CommandQueueMT::CommandBlock *CommandQueueMT::_allocate_dedicated_block(uint32_t p_size) {
+	CommandBlock *block = memnew_placement(memalloc(BLOCK_HEADER_SIZE + p_size), CommandBlock);
+	block->dedicated = true;
+	block->used = p_size;
+	block->refcount.set(1);
+	return block;
+}
+
+void CommandQueueMT::_release_block(CommandBlock *p_block) {
+	if (p_block->dedicated) {
+		p_block->~CommandBlock();
+		memfree(p_block);
+		return;
+	}
+
+	MutexLock lock(block_mutex);
+	p_block->next_free = free_blocks;
+	free_blocks = p_block;
+}
+
 CommandQueueMT::CommandQueueMT() {
-	command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
+	queue_id = last_queue_id.increment();
+	tail.store(&stub, std::memory_order_relaxed);
+	head = &stub;
+
+	MutexLock lock(queues_mutex);
+	queues.push_back(this);
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	{
+		MutexLock lock(queues_mutex);
+		queues.erase(this);
+	}
+
+	// Commands that were never flushed aren't destructed, but dedicated blocks still need freeing.
+	CommandBase *cmd = _pop();
+	while (cmd) {
+		if (cmd->block->dedicated) {
+			_unref_block(cmd->block);
+		}
+		cmd = _pop();
+	}
+
+	for (CommandBlock *block : blocks) {
+		block->~CommandBlock();
+		memfree(block);
+	}
 }
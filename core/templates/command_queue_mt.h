@@ -32,14 +32,19 @@
 #define COMMAND_QUEUE_MT_H
 
 #include "core/object/worker_thread_pool.h"
-#include "core/os/condition_variable.h"
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
+#include "core/os/os.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/string/print_string.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -248,17 +253,14 @@
 #define CMD_TYPE(N) Command##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
 #define CMD_ASSIGN_PARAM(N) cmd->p##N = p##N
 
-#define DECL_PUSH(N)                                                            \
-	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>    \
-	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) {    \
-		MutexLock mlock(mutex);                                                 \
-		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                             \
-		cmd->instance = p_instance;                                             \
-		cmd->method = p_method;                                                 \
-		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                    \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id); \
-		}                                                                       \
+#define DECL_PUSH(N)                                                         \
+	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)> \
+	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
+		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                          \
+		cmd->instance = p_instance;                                          \
+		cmd->method = p_method;                                              \
+		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
+		_publish(cmd);                                                       \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -266,17 +268,12 @@
 #define DECL_PUSH_AND_RET(N)                                                                   \
 	template <typename T, typename M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) typename R>       \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
-		MutexLock mlock(mutex);                                                                \
 		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                    \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                               \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);                \
-		}                                                                                      \
-		sync_tail++;                                                                           \
-		_wait_for_sync(mlock);                                                                 \
+		_publish_and_wait(cmd);                                                                \
 	}
 
 #define CMD_SYNC_TYPE(N) CommandSync##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
@@ -284,32 +281,38 @@
 #define DECL_PUSH_AND_SYNC(N)                                                         \
 	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>          \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
-		MutexLock mlock(mutex);                                                       \
 		CMD_SYNC_TYPE(N) *cmd = allocate<CMD_SYNC_TYPE(N)>();                         \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                      \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);       \
-		}                                                                             \
-		sync_tail++;                                                                  \
-		_wait_for_sync(mlock);                                                        \
+		_publish_and_wait(cmd);                                                       \
 	}
 
 #define MAX_CMD_PARAMS 15
 
+// Multi-producer, single-consumer command queue.
+//
+// Pushing doesn't take any lock: each producer thread allocates commands from
+// its own memory block, and publishes them into an intrusive linked list with
+// a single atomic exchange (Vyukov MPSC queue). Commands from a single thread
+// are executed in order, and commands from different threads are executed in
+// the order they were published.
 class CommandQueueMT {
-	struct CommandBase {
-		bool sync = false;
+	struct CommandBlock;
+
+	struct CommandNode {
+		std::atomic<CommandNode *> next = { nullptr };
+	};
+
+	struct CommandBase : public CommandNode {
+		CommandBlock *block = nullptr;
+		Semaphore *sync_sem = nullptr; // Posted once the command is done, if the pusher waits for it.
 		virtual void call() = 0;
 		virtual ~CommandBase() = default;
 	};
 
 	struct SyncCommand : public CommandBase {
 		virtual void call() override {}
-		SyncCommand() {
-			sync = true;
-		}
 	};
 
 	DECL_CMD(0)
@@ -325,84 +328,209 @@ class CommandQueueMT {
 
 	/***** BASE *******/
 
-	static const uint32_t DEFAULT_COMMAND_MEM_SIZE_KB = 64;
+	static const uint32_t BLOCK_SIZE_KB = 16;
+	static const uint32_t MAX_PRODUCERS = 32;
+	static const uint32_t PRODUCER_CACHE_SIZE = 4;
+	static const uint32_t FLUSH_SPINS_BEFORE_YIELD = 64;
+
+	// Memory commands are allocated from. A block is written by a single producer,
+	// and recycled once it has been retired by it and all its commands are done.
+	struct CommandBlock {
+		CommandBlock *next_free = nullptr;
+		SafeNumeric<uint32_t> refcount; // Commands not yet done, plus one while owned by a producer.
+		uint32_t used = 0;
+		bool dedicated = false; // Allocated for a single command, freed once it's done.
+
+		_FORCE_INLINE_ uint8_t *get_data() { return reinterpret_cast<uint8_t *>(this) + BLOCK_HEADER_SIZE; }
+	};
+
+	static const uint32_t BLOCK_HEADER_SIZE = (sizeof(CommandBlock) + 8 - 1) & ~(8 - 1);
+	static const uint32_t BLOCK_DATA_SIZE = BLOCK_SIZE_KB * 1024 - BLOCK_HEADER_SIZE;
+
+	struct Producer {
+		Thread::ID thread_id = Thread::UNASSIGNED_ID;
+		CommandBlock *block = nullptr;
+	};
+
+	struct ProducerCache {
+		CommandQueueMT *queue = nullptr;
+		uint64_t queue_id = 0; // A destroyed queue's address can be reused, its id can't.
+		Producer *producer = nullptr;
+	};
 
-	BinaryMutex mutex;
-	LocalVector<uint8_t> command_mem;
-	ConditionVariable sync_cond_var;
-	uint32_t sync_head = 0;
-	uint32_t sync_tail = 0;
-	uint32_t sync_awaiters = 0;
-	WorkerThreadPool::TaskID pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
-	uint64_t flush_read_ptr = 0;
+	// Producer slots used by the current thread, released when it exits.
+	struct ThreadProducers {
+		ProducerCache cache[PRODUCER_CACHE_SIZE];
+		uint32_t next_cache_entry = 0;
+		Thread::ID thread_id = Thread::UNASSIGNED_ID;
+
+		~ThreadProducers();
+	};
+
+	static SafeNumeric<uint64_t> last_queue_id;
+	static thread_local ThreadProducers thread_producers;
+
+	// Live queues, so exiting threads can give their producer slots back.
+	static BinaryMutex queues_mutex;
+	static LocalVector<CommandQueueMT *> queues;
+
+	uint64_t queue_id = 0;
+	Producer producers[MAX_PRODUCERS];
+
+	BinaryMutex block_mutex; // Only taken to register producers and recycle blocks.
+	CommandBlock *free_blocks = nullptr;
+	LocalVector<CommandBlock *> blocks;
+
+	// Producers write the tail, the consumer owns the head.
+	std::atomic<CommandNode *> tail;
+	CommandNode *head = nullptr;
+	CommandNode stub;
+
+	SafeNumeric<int32_t> pending_commands; // Counted once linked, so it briefly goes negative if the consumer runs a command first.
+	SafeNumeric<WorkerThreadPool::TaskID> pump_task_id{ WorkerThreadPool::INVALID_TASK_ID };
+
+	BinaryMutex flush_mutex;
+	SafeFlag flushing;
+
+	Producer *_register_producer();
+	static void _release_thread_producers(Thread::ID p_thread_id);
+	CommandBlock *_producer_acquire_block(Producer *p_producer);
+	CommandBlock *_allocate_dedicated_block(uint32_t p_size);
+	void _release_block(CommandBlock *p_block);
+
+	_FORCE_INLINE_ Producer *_get_producer() {
+		for (ProducerCache &entry : thread_producers.cache) {
+			if (entry.queue == this && entry.queue_id == queue_id) {
+				return entry.producer;
+			}
+		}
+		return _register_producer();
+	}
 
 	template <typename T>
 	T *allocate() {
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1));
-		uint64_t size = command_mem.size();
-		command_mem.resize(size + alloc_size + 8);
-		*(uint64_t *)&command_mem[size] = alloc_size;
-		T *cmd = memnew_placement(&command_mem[size + 8], T);
+		static_assert(sizeof(T) <= BLOCK_DATA_SIZE, "Command doesn't fit in a command queue block.");
+		const uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1));
+
+		Producer *producer = _get_producer();
+		CommandBlock *block;
+		uint8_t *mem;
+		if (likely(producer)) {
+			block = producer->block;
+			if (unlikely(!block || block->used + alloc_size > BLOCK_DATA_SIZE)) {
+				block = _producer_acquire_block(producer);
+			}
+			mem = block->get_data() + block->used;
+			block->used += alloc_size;
+			block->refcount.increment();
+		} else {
+			// Too many producer threads, fall back to an allocation per command.
+			block = _allocate_dedicated_block(alloc_size);
+			mem = block->get_data();
+		}
+
+		T *cmd = memnew_placement(mem, T);
+		cmd->block = block;
 		return cmd;
 	}
 
-	_FORCE_INLINE_ void _prevent_sync_wraparound() {
-		bool safe_to_reset = !sync_awaiters;
-		bool already_sync_to_latest = sync_head == sync_tail;
-		if (safe_to_reset && already_sync_to_latest) {
-			sync_head = 0;
-			sync_tail = 0;
+	_FORCE_INLINE_ void _link(CommandNode *p_node) {
+		p_node->next.store(nullptr, std::memory_order_relaxed);
+		CommandNode *prev = tail.exchange(p_node, std::memory_order_acq_rel);
+		prev->next.store(p_node, std::memory_order_release);
+	}
+
+	_FORCE_INLINE_ void _publish(CommandBase *p_cmd) {
+		_link(p_cmd);
+		if (pending_commands.postincrement() == 0) {
+			// Only the first pending command needs to wake up the pump, it will flush everything.
+			// Commands the consumer ran before they were counted are already balanced out here.
+			WorkerThreadPool::TaskID pump = pump_task_id.get();
+			if (pump != WorkerThreadPool::INVALID_TASK_ID) {
+				WorkerThreadPool::get_singleton()->notify_yield_over(pump);
+			}
+		}
+	}
+
+	_FORCE_INLINE_ void _publish_and_wait(SyncCommand *p_cmd) {
+		Semaphore sync_sem;
+		p_cmd->sync_sem = &sync_sem;
+		_publish(p_cmd);
+		sync_sem.wait();
+	}
+
+	// Returns nullptr if the queue is empty, or if a producer is halfway through linking a command.
+	CommandBase *_pop() {
+		CommandNode *node = head;
+		CommandNode *next = node->next.load(std::memory_order_acquire);
+		if (node == &stub) {
+			if (!next) {
+				return nullptr;
+			}
+			head = next;
+			node = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+		if (next) {
+			head = next;
+			return static_cast<CommandBase *>(node);
+		}
+		if (node != tail.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		_link(&stub);
+		next = node->next.load(std::memory_order_acquire);
+		if (next) {
+			head = next;
+			return static_cast<CommandBase *>(node);
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ void _unref_block(CommandBlock *p_block) {
+		if (p_block->refcount.decrement() == 0) {
+			_release_block(p_block);
 		}
 	}
 
 	void _flush() {
-		if (unlikely(flush_read_ptr)) {
+		if (unlikely(flushing.is_set())) {
 			// Re-entrant call.
 			return;
 		}
 
-		MutexLock lock(mutex);
+		MutexLock lock(flush_mutex);
+		flushing.set();
+
+		uint32_t spins = 0;
+		while (pending_commands.get() > 0) {
+			CommandBase *cmd = _pop();
+			if (unlikely(!cmd)) {
+				// Another producer is between swapping the tail and linking it, which is only a couple of instructions.
+				// It may have been preempted in between though, so give up the core if it takes longer than that.
+				if (++spins > FLUSH_SPINS_BEFORE_YIELD) {
+					OS::get_singleton()->yield();
+				}
+				continue;
+			}
+			spins = 0;
 
-		while (flush_read_ptr < command_mem.size()) {
-			uint64_t size = *(uint64_t *)&command_mem[flush_read_ptr];
-			flush_read_ptr += 8;
-			CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
 			uint32_t allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(lock);
 			cmd->call();
 			WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
 
-			// Handle potential realloc due to the command and unlock allowance.
-			cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
-
-			if (unlikely(cmd->sync)) {
-				sync_head++;
-				lock.~MutexLock(); // Give an opportunity to awaiters right away.
-				sync_cond_var.notify_all();
-				new (&lock) MutexLock(mutex);
-				// Handle potential realloc happened during unlock.
-				cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
-			}
-
+			Semaphore *sync_sem = cmd->sync_sem;
+			CommandBlock *block = cmd->block;
 			cmd->~CommandBase();
+			_unref_block(block);
+			pending_commands.decrement();
 
-			flush_read_ptr += size;
+			if (unlikely(sync_sem)) {
+				sync_sem->post();
+			}
 		}
 
-		command_mem.clear();
-		flush_read_ptr = 0;
-
-		_prevent_sync_wraparound();
-	}
-
-	_FORCE_INLINE_ void _wait_for_sync(MutexLock<BinaryMutex> &p_lock) {
-		sync_awaiters++;
-		uint32_t sync_head_goal = sync_tail;
-		do {
-			sync_cond_var.wait(p_lock);
-		} while (sync_head < sync_head_goal);
-		sync_awaiters--;
-		_prevent_sync_wraparound();
+		flushing.clear();
 	}
 
 	void _no_op() {}
@@ -421,7 +549,7 @@ public:
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(command_mem.size() > 0)) {
+		if (unlikely(pending_commands.get() > 0)) {
 			_flush();
 		}
 	}
@@ -435,14 +563,13 @@ public:
 	}
 
 	void wait_and_flush() {
-		ERR_FAIL_COND(pump_task_id == WorkerThreadPool::INVALID_TASK_ID);
-		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump_task_id);
+		ERR_FAIL_COND(pump_task_id.get() == WorkerThreadPool::INVALID_TASK_ID);
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump_task_id.get());
 		_flush();
 	}
 
 	void set_pump_task_id(WorkerThreadPool::TaskID p_task_id) {
-		MutexLock lock(mutex);
-		pump_task_id = p_task_id;
+		pump_task_id.set(p_task_id);
 	}
 
 	CommandQueueMT();
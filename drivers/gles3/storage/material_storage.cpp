@@ -1804,6 +1804,8 @@ void MaterialStorage::global_shader_parameter_add(const StringName &p_name, RS::
 	}
 
 	global_shader_uniforms.variables[p_name] = gv;
+
+	ShaderCompiler::global_shader_uniforms_changed();
 }
 
 void MaterialStorage::global_shader_parameter_remove(const StringName &p_name) {
@@ -1820,6 +1822,8 @@ void MaterialStorage::global_shader_parameter_remove(const StringName &p_name) {
 	}
 
 	global_shader_uniforms.variables.erase(p_name);
+
+	ShaderCompiler::global_shader_uniforms_changed();
 }
 
 Vector<StringName> MaterialStorage::global_shader_parameter_get_list() const {
@@ -1997,6 +2001,8 @@ void MaterialStorage::global_shader_parameters_load_settings(bool p_load_texture
 
 void MaterialStorage::global_shader_parameters_clear() {
 	global_shader_uniforms.variables.clear();
+
+	ShaderCompiler::global_shader_uniforms_changed();
 }
 
 GLuint MaterialStorage::global_shader_parameters_get_uniform_buffer() const {
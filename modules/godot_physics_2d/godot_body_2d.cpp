@@ -148,6 +148,28 @@ void GodotBody2D::set_active(bool p_active) {
 	}
 }
 
+void GodotBody2D::restore_state(const Transform2D &p_transform, const Vector2 &p_linear_velocity, real_t p_angular_velocity, real_t p_still_time, bool p_active) {
+	new_transform = p_transform;
+	_set_transform(p_transform);
+	_set_inv_transform(p_transform.affine_inverse());
+	if (mode >= PhysicsServer2D::BODY_MODE_RIGID) {
+		_update_transform_dependent();
+	}
+
+	linear_velocity = p_linear_velocity;
+	angular_velocity = p_angular_velocity;
+	biased_linear_velocity = Vector2();
+	biased_angular_velocity = 0.0;
+	still_time = p_still_time;
+
+	set_active(p_active);
+
+	// Sync the restored state to the node even if the body stays asleep.
+	if (get_space() && !direct_state_query_list.in_list() && (fi_callback_data || body_state_callback.is_valid())) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+}
+
 void GodotBody2D::set_param(PhysicsServer2D::BodyParameter p_param, const Variant &p_value) {
 	switch (p_param) {
 		case PhysicsServer2D::BODY_PARAM_BOUNCE: {
@@ -618,7 +640,7 @@ void GodotBody2D::integrate_velocities(real_t p_step) {
 
 	ERR_FAIL_NULL(get_space());
 
-	if (fi_callback_data || body_state_callback.is_valid()) {
+	if (!direct_state_query_list.in_list() && (fi_callback_data || body_state_callback.is_valid())) {
 		get_space()->body_add_to_state_query_list(&direct_state_query_list);
 	}
 
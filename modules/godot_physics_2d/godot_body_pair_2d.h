@@ -84,6 +84,8 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	bool oneway_disabled = false;
 	bool report_contacts_only = false;
 
+	SelfList<GodotBodyPair2D> pair_list;
+
 	bool _test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2D &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2D &p_xform_B);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
@@ -94,6 +96,18 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	// Contact count followed by the cached contacts, including their accumulated impulses.
+	static constexpr uint32_t CONTACT_STATE_SIZE = sizeof(int32_t) + sizeof(Contact) * MAX_CONTACTS;
+
+	_FORCE_INLINE_ GodotBody2D *get_body_a() const { return A; }
+	_FORCE_INLINE_ GodotBody2D *get_body_b() const { return B; }
+	_FORCE_INLINE_ int get_shape_a() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_b() const { return shape_B; }
+
+	void get_contact_state(uint8_t *r_state) const;
+	void set_contact_state(const uint8_t *p_state);
+	void clear_contacts() { contact_count = 0; }
+
 	GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B);
 	~GodotBodyPair2D();
 };
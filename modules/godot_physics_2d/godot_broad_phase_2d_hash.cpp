@@ -0,0 +1,519 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_hash.cpp                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_broad_phase_2d_hash.h"
+#include "godot_collision_object_2d.h"
+
+#include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
+
+static _FORCE_INLINE_ void _erase_unordered(LocalVector<GodotBroadPhase2D::ID> &r_ids, GodotBroadPhase2D::ID p_id) {
+	int64_t index = r_ids.find(p_id);
+	if (index >= 0) {
+		r_ids.remove_at_unordered(index);
+	}
+}
+
+bool GodotBroadPhase2DHash::_can_pair(const Element &p_a, const Element &p_b) {
+	if (p_a.is_static && p_b.is_static) {
+		return false;
+	}
+	// Shapes of the same object never collide with each other.
+	if (p_a.owner == p_b.owner) {
+		return false;
+	}
+	return p_a.aabb.intersects(p_b.aabb, true) && p_a.owner->interacts_with(p_b.owner);
+}
+
+void GodotBroadPhase2DHash::_register(ID p_id) {
+	Element &e = _get_element(p_id);
+	Rect2i range = _get_cell_range(e.aabb);
+	e.large = _get_cell_count(range) > LARGE_ELEMENT_CELLS;
+	if (e.large) {
+		large_elements.push_back(p_id);
+		return;
+	}
+
+	e.cells = range;
+	for (int32_t y = range.position.y; y <= range.position.y + range.size.y; y++) {
+		for (int32_t x = range.position.x; x <= range.position.x + range.size.x; x++) {
+			Vector2i key(x, y);
+			HashMap<Vector2i, uint32_t>::Iterator E = cell_map.find(key);
+			uint32_t cell_index;
+			if (E) {
+				cell_index = E->value;
+			} else if (!free_cells.is_empty()) {
+				cell_index = free_cells[free_cells.size() - 1];
+				free_cells.resize(free_cells.size() - 1);
+				cell_map.insert(key, cell_index);
+			} else {
+				cell_index = cells.size();
+				cells.push_back(Cell());
+				cell_map.insert(key, cell_index);
+			}
+			cells[cell_index].elements.push_back(p_id);
+		}
+	}
+}
+
+void GodotBroadPhase2DHash::_unregister(ID p_id) {
+	Element &e = _get_element(p_id);
+	if (e.large) {
+		_erase_unordered(large_elements, p_id);
+		e.large = false;
+		return;
+	}
+
+	const Rect2i &range = e.cells;
+	for (int32_t y = range.position.y; y <= range.position.y + range.size.y; y++) {
+		for (int32_t x = range.position.x; x <= range.position.x + range.size.x; x++) {
+			HashMap<Vector2i, uint32_t>::Iterator E = cell_map.find(Vector2i(x, y));
+			ERR_CONTINUE(!E);
+			Cell &cell = cells[E->value];
+			_erase_unordered(cell.elements, p_id);
+			if (cell.elements.is_empty()) {
+				// Keep the cell around, so its storage is reused by the next one.
+				free_cells.push_back(E->value);
+				cell_map.remove(E);
+			}
+		}
+	}
+}
+
+void GodotBroadPhase2DHash::_pair(ID p_a, ID p_b) {
+	ID a = MIN(p_a, p_b);
+	ID b = MAX(p_a, p_b);
+	Element &ea = _get_element(a);
+	Element &eb = _get_element(b);
+
+	void *data = nullptr;
+	if (pair_callback) {
+		data = pair_callback(ea.owner, ea.subindex, eb.owner, eb.subindex, pair_userdata);
+	}
+
+	pair_data.insert(_pair_key(a, b), data);
+	ea.pairs.push_back(b);
+	eb.pairs.push_back(a);
+}
+
+void GodotBroadPhase2DHash::_unpair(ID p_a, ID p_b) {
+	ID a = MIN(p_a, p_b);
+	ID b = MAX(p_a, p_b);
+	Element &ea = _get_element(a);
+	Element &eb = _get_element(b);
+
+	HashMap<uint64_t, void *>::Iterator E = pair_data.find(_pair_key(a, b));
+	ERR_FAIL_COND(!E);
+	void *data = E->value;
+	pair_data.remove(E);
+	_erase_unordered(ea.pairs, b);
+	_erase_unordered(eb.pairs, a);
+
+	if (unpair_callback) {
+		unpair_callback(ea.owner, ea.subindex, eb.owner, eb.subindex, data, unpair_userdata);
+	}
+}
+
+void GodotBroadPhase2DHash::_find_pairs(uint32_t p_index, void *p_userdata) {
+	ID id = moved[p_index];
+	LocalVector<ID> &result = moved_results[p_index];
+	result.clear();
+
+	const Element &e = _get_element(id);
+
+	if (e.large) {
+		for (uint32_t i = 0; i < elements.size(); i++) {
+			const Element &other = elements[i];
+			if (other.owner && i + 1 != id && _can_pair(e, other)) {
+				result.push_back(i + 1);
+			}
+		}
+	} else {
+		const Rect2i &range = e.cells;
+		for (int32_t y = range.position.y; y <= range.position.y + range.size.y; y++) {
+			for (int32_t x = range.position.x; x <= range.position.x + range.size.x; x++) {
+				const Cell *cell = _get_cell(x, y);
+				if (!cell) {
+					continue;
+				}
+				for (ID other_id : cell->elements) {
+					if (other_id == id) {
+						continue;
+					}
+					const Element &other = _get_element(other_id);
+					// Only report the pair in the first cell both elements share.
+					if (x != MAX(range.position.x, other.cells.position.x) || y != MAX(range.position.y, other.cells.position.y)) {
+						continue;
+					}
+					if (_can_pair(e, other)) {
+						result.push_back(other_id);
+					}
+				}
+			}
+		}
+
+		for (ID other_id : large_elements) {
+			if (_can_pair(e, _get_element(other_id))) {
+				result.push_back(other_id);
+			}
+		}
+	}
+
+	result.sort();
+}
+
+GodotBroadPhase2D::ID GodotBroadPhase2DHash::create(GodotCollisionObject2D *p_object, int p_subindex, const Rect2 &p_aabb, bool p_static) {
+	ID id;
+	if (!free_ids.is_empty()) {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	} else {
+		elements.push_back(Element());
+		id = elements.size();
+	}
+
+	Element &e = _get_element(id);
+	e.owner = p_object;
+	e.subindex = p_subindex;
+	e.aabb = p_aabb;
+	e.is_static = p_static;
+	e.moved = true;
+	_register(id);
+	moved.push_back(id);
+	element_count++;
+
+	return id;
+}
+
+void GodotBroadPhase2DHash::move(ID p_id, const Rect2 &p_aabb) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = _get_element(p_id);
+	ERR_FAIL_NULL(e.owner);
+
+	Rect2i range = _get_cell_range(p_aabb);
+	bool large = _get_cell_count(range) > LARGE_ELEMENT_CELLS;
+	if (large != e.large || (!large && range != e.cells)) {
+		_unregister(p_id);
+		e.aabb = p_aabb;
+		_register(p_id);
+	} else {
+		e.aabb = p_aabb;
+	}
+
+	if (!e.moved) {
+		e.moved = true;
+		moved.push_back(p_id);
+	}
+}
+
+void GodotBroadPhase2DHash::set_static(ID p_id, bool p_static) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = _get_element(p_id);
+	ERR_FAIL_NULL(e.owner);
+
+	e.is_static = p_static;
+	if (!e.moved) {
+		e.moved = true;
+		moved.push_back(p_id);
+	}
+}
+
+void GodotBroadPhase2DHash::remove(ID p_id) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = _get_element(p_id);
+	ERR_FAIL_NULL(e.owner);
+
+	while (!e.pairs.is_empty()) {
+		_unpair(p_id, e.pairs[e.pairs.size() - 1]);
+	}
+	_unregister(p_id);
+
+	// Stale entries in the moved list are skipped on update.
+	e.owner = nullptr;
+	e.subindex = 0;
+	e.moved = false;
+	free_ids.push_back(p_id);
+	element_count--;
+}
+
+GodotCollisionObject2D *GodotBroadPhase2DHash::get_object(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), nullptr);
+	GodotCollisionObject2D *it = _get_element(p_id).owner;
+	ERR_FAIL_NULL_V(it, nullptr);
+	return it;
+}
+
+bool GodotBroadPhase2DHash::is_static(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), false);
+	return _get_element(p_id).is_static;
+}
+
+int GodotBroadPhase2DHash::get_subindex(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), 0);
+	return _get_element(p_id).subindex;
+}
+
+int GodotBroadPhase2DHash::cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	int count = 0;
+
+	// Sweep the columns crossed by the segment from left to right, and the
+	// covered cells of each column in the direction of the segment.
+	Vector2 a = p_from;
+	Vector2 b = p_to;
+	if (a.x > b.x) {
+		SWAP(a, b);
+	}
+	int32_t column_from = _to_cell(a.x);
+	int32_t column_to = _to_cell(b.x);
+	bool upwards = b.y >= a.y;
+
+	Rect2i range = _get_cell_range(Rect2(p_from, Vector2()).expand(p_to));
+	if (_get_cell_count(range) > MAX((int64_t)element_count, LARGE_ELEMENT_CELLS)) {
+		// Long enough to cross more cells than there are elements.
+		for (uint32_t i = 0; i < elements.size() && count < p_max_results; i++) {
+			const Element &e = elements[i];
+			if (e.owner && e.aabb.intersects_segment(p_from, p_to)) {
+				p_results[count] = e.owner;
+				if (p_result_indices) {
+					p_result_indices[count] = e.subindex;
+				}
+				count++;
+			}
+		}
+		return count;
+	}
+
+	int32_t prev_min_y = 0;
+	int32_t prev_max_y = -1;
+	for (int32_t column = column_from; column <= column_to; column++) {
+		// Part of the segment inside this column.
+		real_t x0 = MAX(a.x, _get_cell_start(column));
+		real_t x1 = MIN(b.x, _get_cell_start(column + 1));
+		real_t y0 = a.y;
+		real_t y1 = b.y;
+		if (b.x > a.x) {
+			real_t slope = (b.y - a.y) / (b.x - a.x);
+			y0 = a.y + slope * (x0 - a.x);
+			y1 = a.y + slope * (x1 - a.x);
+		}
+		int32_t min_y = MAX(_to_cell(MIN(y0, y1)), range.position.y);
+		int32_t max_y = MIN(_to_cell(MAX(y0, y1)), range.position.y + range.size.y);
+
+		for (int32_t i = 0; i <= max_y - min_y; i++) {
+			int32_t y = upwards ? min_y + i : max_y - i;
+			const Cell *cell = _get_cell(column, y);
+			if (!cell) {
+				continue;
+			}
+			for (ID id : cell->elements) {
+				const Element &e = _get_element(id);
+				// Only report each element in the first of its cells the sweep reaches:
+				// the first column of the element it overlaps, at the first cell in the sweep direction.
+				int32_t e_min_y = e.cells.position.y;
+				int32_t e_max_y = e.cells.position.y + e.cells.size.y;
+				if (column > e.cells.position.x && column > column_from && prev_min_y <= e_max_y && prev_max_y >= e_min_y) {
+					continue;
+				}
+				if (y != (upwards ? MAX(min_y, e_min_y) : MIN(max_y, e_max_y))) {
+					continue;
+				}
+				if (!e.aabb.intersects_segment(p_from, p_to)) {
+					continue;
+				}
+				p_results[count] = e.owner;
+				if (p_result_indices) {
+					p_result_indices[count] = e.subindex;
+				}
+				count++;
+				if (count >= p_max_results) {
+					return count;
+				}
+			}
+		}
+
+		prev_min_y = min_y;
+		prev_max_y = max_y;
+	}
+
+	for (ID id : large_elements) {
+		const Element &e = _get_element(id);
+		if (!e.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+		p_results[count] = e.owner;
+		if (p_result_indices) {
+			p_result_indices[count] = e.subindex;
+		}
+		count++;
+		if (count >= p_max_results) {
+			return count;
+		}
+	}
+
+	return count;
+}
+
+int GodotBroadPhase2DHash::cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	int count = 0;
+
+	Rect2i range = _get_cell_range(p_aabb);
+	if (_get_cell_count(range) > MAX((int64_t)element_count, LARGE_ELEMENT_CELLS)) {
+		// Covering more cells than there are elements, check them all instead.
+		for (uint32_t i = 0; i < elements.size() && count < p_max_results; i++) {
+			const Element &e = elements[i];
+			if (e.owner && e.aabb.intersects(p_aabb, true)) {
+				p_results[count] = e.owner;
+				if (p_result_indices) {
+					p_result_indices[count] = e.subindex;
+				}
+				count++;
+			}
+		}
+		return count;
+	}
+
+	for (int32_t y = range.position.y; y <= range.position.y + range.size.y; y++) {
+		for (int32_t x = range.position.x; x <= range.position.x + range.size.x; x++) {
+			const Cell *cell = _get_cell(x, y);
+			if (!cell) {
+				continue;
+			}
+			for (ID id : cell->elements) {
+				const Element &e = _get_element(id);
+				// Only report each element in the first cell it shares with the query.
+				if (x != MAX(range.position.x, e.cells.position.x) || y != MAX(range.position.y, e.cells.position.y)) {
+					continue;
+				}
+				if (!e.aabb.intersects(p_aabb, true)) {
+					continue;
+				}
+				p_results[count] = e.owner;
+				if (p_result_indices) {
+					p_result_indices[count] = e.subindex;
+				}
+				count++;
+				if (count >= p_max_results) {
+					return count;
+				}
+			}
+		}
+	}
+
+	for (ID id : large_elements) {
+		const Element &e = _get_element(id);
+		if (!e.aabb.intersects(p_aabb, true)) {
+			continue;
+		}
+		p_results[count] = e.owner;
+		if (p_result_indices) {
+			p_result_indices[count] = e.subindex;
+		}
+		count++;
+		if (count >= p_max_results) {
+			return count;
+		}
+	}
+
+	return count;
+}
+
+void GodotBroadPhase2DHash::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DHash::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DHash::update() {
+	if (moved.is_empty()) {
+		return;
+	}
+
+	// Process in ID order, dropping removed elements and duplicates left by reused IDs.
+	moved.sort();
+	uint32_t moved_count = 0;
+	for (uint32_t i = 0; i < moved.size(); i++) {
+		ID id = moved[i];
+		if ((moved_count > 0 && moved[moved_count - 1] == id) || !_get_element(id).moved) {
+			continue;
+		}
+		moved[moved_count++] = id;
+	}
+	moved.resize(moved_count);
+
+	if (moved_results.size() < moved_count) {
+		moved_results.resize(moved_count);
+	}
+
+	if (moved_count >= PARALLEL_THRESHOLD) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotBroadPhase2DHash::_find_pairs, nullptr, moved_count, -1, true, SNAME("GodotBroadPhase2DHashFindPairs"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < moved_count; i++) {
+			_find_pairs(i, nullptr);
+		}
+	}
+
+	for (uint32_t i = 0; i < moved_count; i++) {
+		ID id = moved[i];
+		Element &e = _get_element(id);
+
+		for (uint32_t j = 0; j < e.pairs.size(); j++) {
+			ID other = e.pairs[j];
+			if (!_can_pair(e, _get_element(other))) {
+				_unpair(id, other);
+				// The last pair was swapped into this slot.
+				j--;
+			}
+		}
+
+		for (ID other : moved_results[i]) {
+			if (!pair_data.has(_pair_key(id, other))) {
+				_pair(id, other);
+			}
+		}
+
+		e.moved = false;
+	}
+
+	moved.clear();
+}
+
+GodotBroadPhase2D *GodotBroadPhase2DHash::_create() {
+	return memnew(GodotBroadPhase2DHash);
+}
+
+GodotBroadPhase2DHash::GodotBroadPhase2DHash() {
+	cell_size = MAX(real_t(GLOBAL_GET("physics/2d/spatial_hash_cell_size")), real_t(1.0));
+	inv_cell_size = 1.0 / cell_size;
+}
@@ -0,0 +1,172 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_hash.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_BROAD_PHASE_2D_HASH_H
+#define GODOT_BROAD_PHASE_2D_HASH_H
+
+#include "godot_broad_phase_2d.h"
+
+#include "core/math/rect2.h"
+#include "core/math/rect2i.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Uniform grid broadphase, meant for dense scenes of many small objects of
+// similar size, where BVH reinsertion and refitting dominate the step time.
+// Objects covering too many cells are kept in a separate list and tested
+// against everything instead.
+//
+// Moves update the grid right away, so queries always see current bounds.
+// Pairs are searched in parallel for the objects that moved, then pair and
+// unpair callbacks are sent serially in ID order, so the output does not
+// depend on threading.
+class GodotBroadPhase2DHash : public GodotBroadPhase2D {
+	static constexpr int64_t LARGE_ELEMENT_CELLS = 256;
+	static constexpr int32_t CELL_COORD_MAX = 1 << 30;
+	static constexpr uint32_t PARALLEL_THRESHOLD = 256;
+
+	struct Element {
+		GodotCollisionObject2D *owner = nullptr;
+		int subindex = 0;
+		Rect2 aabb;
+		// Range of registered cells, unused for large elements.
+		Rect2i cells;
+		bool is_static = false;
+		bool large = false;
+		bool moved = false;
+		LocalVector<ID> pairs;
+	};
+
+	struct Cell {
+		LocalVector<ID> elements;
+	};
+
+	real_t cell_size = 128.0;
+	real_t inv_cell_size = 1.0 / 128.0;
+
+	LocalVector<Element> elements;
+	LocalVector<ID> free_ids;
+	uint32_t element_count = 0;
+
+	HashMap<Vector2i, uint32_t> cell_map;
+	LocalVector<Cell> cells;
+	LocalVector<uint32_t> free_cells;
+
+	LocalVector<ID> large_elements;
+
+	HashMap<uint64_t, void *> pair_data;
+
+	LocalVector<ID> moved;
+	LocalVector<LocalVector<ID>> moved_results;
+
+	PairCallback pair_callback = nullptr;
+	void *pair_userdata = nullptr;
+	UnpairCallback unpair_callback = nullptr;
+	void *unpair_userdata = nullptr;
+
+	_FORCE_INLINE_ static uint64_t _pair_key(ID p_a, ID p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | p_b) : ((uint64_t(p_b) << 32) | p_a);
+	}
+
+	_FORCE_INLINE_ Element &_get_element(ID p_id) { return elements[p_id - 1]; }
+	_FORCE_INLINE_ const Element &_get_element(ID p_id) const { return elements[p_id - 1]; }
+
+	_FORCE_INLINE_ real_t _get_cell_start(int32_t p_cell) const {
+		return p_cell * cell_size;
+	}
+
+	// Exact with respect to _get_cell_start(), so that sweeps stepping along
+	// cell edges visit the same cells elements are registered in.
+	_FORCE_INLINE_ int32_t _to_cell(real_t p_coord) const {
+		double cell = Math::floor(double(p_coord) * inv_cell_size);
+		int32_t result = int32_t(CLAMP(cell, double(-CELL_COORD_MAX), double(CELL_COORD_MAX)));
+		// The inverse is rounded, so coordinates on an edge may land in the previous cell.
+		if (result > -CELL_COORD_MAX && p_coord < _get_cell_start(result)) {
+			result--;
+		} else if (result < CELL_COORD_MAX && p_coord >= _get_cell_start(result + 1)) {
+			result++;
+		}
+		return result;
+	}
+
+	_FORCE_INLINE_ Rect2i _get_cell_range(const Rect2 &p_aabb) const {
+		Point2i from(_to_cell(p_aabb.position.x), _to_cell(p_aabb.position.y));
+		Point2i to(_to_cell(p_aabb.position.x + p_aabb.size.x), _to_cell(p_aabb.position.y + p_aabb.size.y));
+		// Size counts cells minus one, so a range fits in the grid limits.
+		return Rect2i(from, to - from);
+	}
+
+	_FORCE_INLINE_ static int64_t _get_cell_count(const Rect2i &p_range) {
+		return (int64_t(p_range.size.x) + 1) * (int64_t(p_range.size.y) + 1);
+	}
+
+	_FORCE_INLINE_ static bool _range_has_cell(const Rect2i &p_range, int32_t p_x, int32_t p_y) {
+		return p_x >= p_range.position.x && p_x <= p_range.position.x + p_range.size.x && p_y >= p_range.position.y && p_y <= p_range.position.y + p_range.size.y;
+	}
+
+	_FORCE_INLINE_ const Cell *_get_cell(int32_t p_x, int32_t p_y) const {
+		HashMap<Vector2i, uint32_t>::ConstIterator E = cell_map.find(Vector2i(p_x, p_y));
+		return E ? &cells[E->value] : nullptr;
+	}
+
+	static bool _can_pair(const Element &p_a, const Element &p_b);
+
+	void _register(ID p_id);
+	void _unregister(ID p_id);
+
+	void _pair(ID p_a, ID p_b);
+	void _unpair(ID p_a, ID p_b);
+
+	void _find_pairs(uint32_t p_index, void *p_userdata);
+
+public:
+	// 0 is an invalid ID
+	virtual ID create(GodotCollisionObject2D *p_object, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false) override;
+	virtual void move(ID p_id, const Rect2 &p_aabb) override;
+	virtual void set_static(ID p_id, bool p_static) override;
+	virtual void remove(ID p_id) override;
+
+	virtual GodotCollisionObject2D *get_object(ID p_id) const override;
+	virtual bool is_static(ID p_id) const override;
+	virtual int get_subindex(ID p_id) const override;
+
+	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+	virtual int cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) override;
+
+	virtual void update() override;
+
+	static GodotBroadPhase2D *_create();
+	GodotBroadPhase2DHash();
+};
+
+#endif // GODOT_BROAD_PHASE_2D_HASH_H
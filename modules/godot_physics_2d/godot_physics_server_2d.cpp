@@ -32,10 +32,12 @@
 
 #include "godot_body_direct_state_2d.h"
 #include "godot_broad_phase_2d_bvh.h"
+#include "godot_broad_phase_2d_hash.h"
 #include "godot_collision_solver_2d.h"
 
 #include "core/config/project_settings.h"
 #include "core/debugger/engine_debugger.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #define FLUSH_QUERY_CHECK(m_object) \
@@ -276,6 +278,24 @@ int GodotPhysicsServer2D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+PackedByteArray GodotPhysicsServer2D::space_save_state(RID p_space) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, PackedByteArray());
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), PackedByteArray(), "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	_update_shapes();
+	return space->save_state();
+}
+
+bool GodotPhysicsServer2D::space_restore_state(RID p_space, const PackedByteArray &p_state) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, false);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), false, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	_update_shapes();
+	return space->restore_state(p_state);
+}
+
 PhysicsDirectSpaceState2D *GodotPhysicsServer2D::space_get_direct_state(RID p_space) {
 	GodotSpace2D *space = space_owner.get_or_null(p_space);
 	ERR_FAIL_NULL_V(space, nullptr);
@@ -1002,6 +1022,53 @@ bool GodotPhysicsServer2D::body_test_motion(RID p_body, const MotionParameters &
 	return body->get_space()->test_body_motion(body, p_parameters, r_result);
 }
 
+void GodotPhysicsServer2D::_test_motion_batch_item(uint32_t p_index, MotionBatch *p_batch) {
+	GodotBody2D *body = p_batch->bodies[p_index];
+	MotionResult *result = p_batch->results ? &p_batch->results[p_index] : nullptr;
+	if (!body) {
+		if (result) {
+			*result = MotionResult();
+		}
+		p_batch->collided[p_index] = false;
+		return;
+	}
+	p_batch->collided[p_index] = body->get_space()->test_body_motion(body, p_batch->parameters[p_index], result);
+}
+
+void GodotPhysicsServer2D::body_test_motion_batch(const RID *p_bodies, const MotionParameters *p_parameters, MotionResult *r_results, bool *r_collided, int p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	if (p_count == 0) {
+		return;
+	}
+	ERR_FAIL_NULL(p_bodies);
+	ERR_FAIL_NULL(p_parameters);
+	ERR_FAIL_NULL(r_collided);
+
+	// Shapes must be up to date before the spaces are read from several threads.
+	_update_shapes();
+
+	MotionBatch batch;
+	batch.bodies.resize(p_count);
+	batch.parameters = p_parameters;
+	batch.results = r_results;
+	batch.collided = r_collided;
+
+	for (int i = 0; i < p_count; i++) {
+		GodotBody2D *body = body_owner.get_or_null(p_bodies[i]);
+		if (body && (!body->get_space() || body->get_space()->is_locked())) {
+			body = nullptr;
+		}
+		if (!body) {
+			ERR_PRINT("Invalid body or body space in motion batch.");
+		}
+		batch.bodies[i] = body;
+	}
+
+	// Motion tests only read from the spaces, so each one can run on its own worker.
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsServer2D::_test_motion_batch_item, &batch, p_count, -1, true, SNAME("Physics2DTestMotionBatch"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
 PhysicsDirectBodyState2D *GodotPhysicsServer2D::body_get_direct_state(RID p_body) {
 	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync), nullptr, "Body state is inaccessible right now, wait for iteration or physics process notification.");
 
@@ -1394,7 +1461,11 @@ GodotPhysicsServer2D *GodotPhysicsServer2D::godot_singleton = nullptr;
 
 GodotPhysicsServer2D::GodotPhysicsServer2D(bool p_using_threads) {
 	godot_singleton = this;
-	GodotBroadPhase2D::create_func = GodotBroadPhase2DBVH::_create;
+	if (int(GLOBAL_GET("physics/2d/broad_phase")) == 1) {
+		GodotBroadPhase2D::create_func = GodotBroadPhase2DHash::_create;
+	} else {
+		GodotBroadPhase2D::create_func = GodotBroadPhase2DBVH::_create;
+	}
 
 	using_threads = p_using_threads;
 }
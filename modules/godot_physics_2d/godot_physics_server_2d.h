@@ -70,6 +70,15 @@ class GodotPhysicsServer2D : public PhysicsServer2D {
 	SelfList<GodotCollisionObject2D>::List pending_shape_update_list;
 	void _update_shapes();
 
+	struct MotionBatch {
+		LocalVector<GodotBody2D *> bodies;
+		const MotionParameters *parameters = nullptr;
+		MotionResult *results = nullptr;
+		bool *collided = nullptr;
+	};
+
+	void _test_motion_batch_item(uint32_t p_index, MotionBatch *p_batch);
+
 	RID _shape_create(ShapeType p_shape);
 
 public:
@@ -116,6 +125,9 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual PackedByteArray space_save_state(RID p_space) override;
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state) override;
+
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space) override;
 
@@ -255,6 +267,7 @@ public:
 	virtual void body_set_pickable(RID p_body, bool p_pickable) override;
 
 	virtual bool body_test_motion(RID p_body, const MotionParameters &p_parameters, MotionResult *r_result = nullptr) override;
+	virtual void body_test_motion_batch(const RID *p_bodies, const MotionParameters *p_parameters, MotionResult *r_results, bool *r_collided, int p_count) override;
 
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectBodyState2D *body_get_direct_state(RID p_body) override;
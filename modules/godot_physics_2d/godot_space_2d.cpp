@@ -502,26 +502,26 @@ bool GodotPhysicsDirectSpaceState2D::rest_info(const ShapeParameters &p_paramete
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int GodotSpace2D::_cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb) {
-	int amount = broadphase->cull_aabb(p_aabb, intersection_query_results, INTERSECTION_QUERY_MAX, intersection_query_subindex_results);
+int GodotSpace2D::_cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb, GodotCollisionObject2D **r_results, int *r_subindex_results) {
+	int amount = broadphase->cull_aabb(p_aabb, r_results, INTERSECTION_QUERY_MAX, r_subindex_results);
 
 	for (int i = 0; i < amount; i++) {
 		bool keep = true;
 
-		if (intersection_query_results[i] == p_body) {
+		if (r_results[i] == p_body) {
 			keep = false;
-		} else if (intersection_query_results[i]->get_type() == GodotCollisionObject2D::TYPE_AREA) {
+		} else if (r_results[i]->get_type() == GodotCollisionObject2D::TYPE_AREA) {
 			keep = false;
-		} else if (!p_body->collides_with(static_cast<GodotBody2D *>(intersection_query_results[i]))) {
+		} else if (!p_body->collides_with(static_cast<GodotBody2D *>(r_results[i]))) {
 			keep = false;
-		} else if (static_cast<GodotBody2D *>(intersection_query_results[i])->has_exception(p_body->get_self()) || p_body->has_exception(intersection_query_results[i]->get_self())) {
+		} else if (static_cast<GodotBody2D *>(r_results[i])->has_exception(p_body->get_self()) || p_body->has_exception(r_results[i]->get_self())) {
 			keep = false;
 		}
 
 		if (!keep) {
 			if (i < amount - 1) {
-				SWAP(intersection_query_results[i], intersection_query_results[amount - 1]);
-				SWAP(intersection_query_subindex_results[i], intersection_query_subindex_results[amount - 1]);
+				SWAP(r_results[i], r_results[amount - 1]);
+				SWAP(r_subindex_results[i], r_subindex_results[amount - 1]);
 			}
 
 			amount--;
@@ -545,6 +545,11 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 		r_result->collider_shape = 0;
 	}
 
+	// Broadphase results are kept on the stack rather than in the shared space buffers,
+	// so several motions can be tested at the same time (see body_test_motion_batch).
+	GodotCollisionObject2D *cull_results[INTERSECTION_QUERY_MAX];
+	int cull_subindex_results[INTERSECTION_QUERY_MAX];
+
 	Rect2 body_aabb;
 
 	bool shapes_found = false;
@@ -612,7 +617,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 
 			bool collided = false;
 
-			int amount = _cull_aabb_for_body(p_body, body_aabb);
+			int amount = _cull_aabb_for_body(p_body, body_aabb, cull_results, cull_subindex_results);
 
 			for (int j = 0; j < p_body->get_shape_count(); j++) {
 				if (p_body->is_shape_disabled(j)) {
@@ -623,7 +628,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 				Transform2D body_shape_xform = body_transform * p_body->get_shape_transform(j);
 
 				for (int i = 0; i < amount; i++) {
-					const GodotCollisionObject2D *col_obj = intersection_query_results[i];
+					const GodotCollisionObject2D *col_obj = cull_results[i];
 					if (p_parameters.exclude_bodies.has(col_obj->get_self())) {
 						continue;
 					}
@@ -631,7 +636,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 						continue;
 					}
 
-					int shape_idx = intersection_query_subindex_results[i];
+					int shape_idx = cull_subindex_results[i];
 
 					Transform2D col_obj_shape_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 
@@ -742,7 +747,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 		motion_aabb.position += p_parameters.motion;
 		motion_aabb = motion_aabb.merge(body_aabb);
 
-		int amount = _cull_aabb_for_body(p_body, motion_aabb);
+		int amount = _cull_aabb_for_body(p_body, motion_aabb, cull_results, cull_subindex_results);
 
 		for (int body_shape_idx = 0; body_shape_idx < p_body->get_shape_count(); body_shape_idx++) {
 			if (p_body->is_shape_disabled(body_shape_idx)) {
@@ -768,7 +773,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 			real_t best_unsafe = 1;
 
 			for (int i = 0; i < amount; i++) {
-				const GodotCollisionObject2D *col_obj = intersection_query_results[i];
+				const GodotCollisionObject2D *col_obj = cull_results[i];
 				if (p_parameters.exclude_bodies.has(col_obj->get_self())) {
 					continue;
 				}
@@ -776,7 +781,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 					continue;
 				}
 
-				int col_shape_idx = intersection_query_subindex_results[i];
+				int col_shape_idx = cull_subindex_results[i];
 				GodotShape2D *against_shape = col_obj->get_shape(col_shape_idx);
 
 				bool excluded = false;
@@ -902,7 +907,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 		rcd.min_allowed_depth = MIN(motion_length, min_contact_depth);
 
 		body_aabb.position += p_parameters.motion * unsafe;
-		int amount = _cull_aabb_for_body(p_body, body_aabb);
+		int amount = _cull_aabb_for_body(p_body, body_aabb, cull_results, cull_subindex_results);
 
 		int from_shape = best_shape != -1 ? best_shape : 0;
 		int to_shape = best_shape != -1 ? best_shape + 1 : p_body->get_shape_count();
@@ -916,7 +921,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 			GodotShape2D *body_shape = p_body->get_shape(j);
 
 			for (int i = 0; i < amount; i++) {
-				const GodotCollisionObject2D *col_obj = intersection_query_results[i];
+				const GodotCollisionObject2D *col_obj = cull_results[i];
 				if (p_parameters.exclude_bodies.has(col_obj->get_self())) {
 					continue;
 				}
@@ -924,7 +929,7 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 					continue;
 				}
 
-				int shape_idx = intersection_query_subindex_results[i];
+				int shape_idx = cull_subindex_results[i];
 
 				GodotShape2D *against_shape = col_obj->get_shape(shape_idx);
 
@@ -1116,6 +1121,14 @@ const SelfList<GodotArea2D>::List &GodotSpace2D::get_moved_area_list() const {
 	return area_moved_list;
 }
 
+void GodotSpace2D::body_pair_add_to_list(SelfList<GodotBodyPair2D> *p_pair) {
+	body_pair_list.add(p_pair);
+}
+
+void GodotSpace2D::body_pair_remove_from_list(SelfList<GodotBodyPair2D> *p_pair) {
+	body_pair_list.remove(p_pair);
+}
+
 void GodotSpace2D::call_queries() {
 	while (state_query_list.first()) {
 		GodotBody2D *b = state_query_list.first()->self();
@@ -1215,6 +1228,202 @@ GodotPhysicsDirectSpaceState2D *GodotSpace2D::get_direct_state() {
 	return direct_access;
 }
 
+// Snapshots are laid out as a header followed by one tightly packed array per
+// field (body ids, transforms, velocities, ...), so saving and restoring boil
+// down to linear copies. The layout depends on the build (real_t precision),
+// so snapshots are only meant to be restored by the same binary.
+struct SpaceStateHeader2D {
+	static constexpr uint32_t MAGIC = 0x32535047; // "GPS2"
+
+	uint32_t magic = MAGIC;
+	uint32_t real_size = sizeof(real_t);
+	uint32_t contact_state_size = GodotBodyPair2D::CONTACT_STATE_SIZE;
+	uint32_t body_count = 0;
+	uint32_t pair_count = 0;
+};
+
+struct SpaceStateLayout2D {
+	uint32_t body_ids = 0;
+	uint32_t body_transforms = 0;
+	uint32_t body_linear_velocities = 0;
+	uint32_t body_angular_velocities = 0;
+	uint32_t body_still_times = 0;
+	uint32_t body_active = 0;
+	uint32_t pair_body_a = 0;
+	uint32_t pair_body_b = 0;
+	uint32_t pair_shape_a = 0;
+	uint32_t pair_shape_b = 0;
+	uint32_t pair_contacts = 0;
+	uint32_t size = 0;
+
+	SpaceStateLayout2D(uint32_t p_body_count, uint32_t p_pair_count) {
+		size = sizeof(SpaceStateHeader2D);
+		body_ids = _add(sizeof(uint64_t) * p_body_count);
+		body_transforms = _add(sizeof(Transform2D) * p_body_count);
+		body_linear_velocities = _add(sizeof(Vector2) * p_body_count);
+		body_angular_velocities = _add(sizeof(real_t) * p_body_count);
+		body_still_times = _add(sizeof(real_t) * p_body_count);
+		body_active = _add(sizeof(uint8_t) * p_body_count);
+		pair_body_a = _add(sizeof(uint64_t) * p_pair_count);
+		pair_body_b = _add(sizeof(uint64_t) * p_pair_count);
+		pair_shape_a = _add(sizeof(int32_t) * p_pair_count);
+		pair_shape_b = _add(sizeof(int32_t) * p_pair_count);
+		pair_contacts = _add(GodotBodyPair2D::CONTACT_STATE_SIZE * p_pair_count);
+	}
+
+private:
+	uint32_t _add(uint32_t p_bytes) {
+		uint32_t offset = size;
+		size += p_bytes;
+		return offset;
+	}
+};
+
+template <typename T>
+static _FORCE_INLINE_ void _state_write(uint8_t *p_buffer, uint32_t p_offset, uint32_t p_index, const T &p_value) {
+	memcpy(p_buffer + p_offset + p_index * sizeof(T), &p_value, sizeof(T));
+}
+
+template <typename T>
+static _FORCE_INLINE_ T _state_read(const uint8_t *p_buffer, uint32_t p_offset, uint32_t p_index) {
+	T value;
+	memcpy(&value, p_buffer + p_offset + p_index * sizeof(T), sizeof(T));
+	return value;
+}
+
+struct SpaceStatePairKey2D {
+	uint64_t body_a = 0;
+	uint64_t body_b = 0;
+	int32_t shape_a = 0;
+	int32_t shape_b = 0;
+
+	static uint32_t hash(const SpaceStatePairKey2D &p_key) {
+		uint32_t h = hash_murmur3_one_64(p_key.body_a);
+		h = hash_murmur3_one_64(p_key.body_b, h);
+		h = hash_murmur3_one_32(p_key.shape_a, h);
+		h = hash_murmur3_one_32(p_key.shape_b, h);
+		return hash_fmix32(h);
+	}
+
+	bool operator==(const SpaceStatePairKey2D &p_other) const {
+		return body_a == p_other.body_a && body_b == p_other.body_b && shape_a == p_other.shape_a && shape_b == p_other.shape_b;
+	}
+};
+
+PackedByteArray GodotSpace2D::save_state() const {
+	LocalVector<GodotBody2D *> bodies;
+	bodies.reserve(objects.size());
+	for (GodotCollisionObject2D *E : objects) {
+		if (E->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			bodies.push_back(static_cast<GodotBody2D *>(E));
+		}
+	}
+
+	SpaceStateHeader2D header;
+	header.body_count = bodies.size();
+	for (const SelfList<GodotBodyPair2D> *E = body_pair_list.first(); E; E = E->next()) {
+		header.pair_count++;
+	}
+
+	const SpaceStateLayout2D layout(header.body_count, header.pair_count);
+
+	PackedByteArray state;
+	state.resize(layout.size);
+	uint8_t *w = state.ptrw();
+	memcpy(w, &header, sizeof(SpaceStateHeader2D));
+
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		const GodotBody2D *body = bodies[i];
+		_state_write<uint64_t>(w, layout.body_ids, i, body->get_self().get_id());
+		_state_write<Transform2D>(w, layout.body_transforms, i, body->get_transform());
+		_state_write<Vector2>(w, layout.body_linear_velocities, i, body->get_linear_velocity());
+		_state_write<real_t>(w, layout.body_angular_velocities, i, body->get_angular_velocity());
+		_state_write<real_t>(w, layout.body_still_times, i, body->get_still_time());
+		_state_write<uint8_t>(w, layout.body_active, i, body->is_active() ? 1 : 0);
+	}
+
+	uint32_t pair_index = 0;
+	for (const SelfList<GodotBodyPair2D> *E = body_pair_list.first(); E; E = E->next()) {
+		const GodotBodyPair2D *pair = E->self();
+		_state_write<uint64_t>(w, layout.pair_body_a, pair_index, pair->get_body_a()->get_self().get_id());
+		_state_write<uint64_t>(w, layout.pair_body_b, pair_index, pair->get_body_b()->get_self().get_id());
+		_state_write<int32_t>(w, layout.pair_shape_a, pair_index, pair->get_shape_a());
+		_state_write<int32_t>(w, layout.pair_shape_b, pair_index, pair->get_shape_b());
+		pair->get_contact_state(w + layout.pair_contacts + pair_index * GodotBodyPair2D::CONTACT_STATE_SIZE);
+		pair_index++;
+	}
+
+	return state;
+}
+
+bool GodotSpace2D::restore_state(const PackedByteArray &p_state) {
+	ERR_FAIL_COND_V_MSG(p_state.size() < (int64_t)sizeof(SpaceStateHeader2D), false, "Invalid physics space state.");
+
+	const uint8_t *r = p_state.ptr();
+	SpaceStateHeader2D header;
+	memcpy(&header, r, sizeof(SpaceStateHeader2D));
+	ERR_FAIL_COND_V_MSG(header.magic != SpaceStateHeader2D::MAGIC, false, "Invalid physics space state.");
+	ERR_FAIL_COND_V_MSG(header.real_size != sizeof(real_t) || header.contact_state_size != GodotBodyPair2D::CONTACT_STATE_SIZE, false, "Physics space state was saved by an incompatible build.");
+
+	const SpaceStateLayout2D layout(header.body_count, header.pair_count);
+	ERR_FAIL_COND_V_MSG(p_state.size() != (int64_t)layout.size, false, "Invalid physics space state.");
+
+	HashMap<uint64_t, GodotBody2D *> bodies;
+	bodies.reserve(objects.size());
+	for (GodotCollisionObject2D *E : objects) {
+		if (E->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			bodies.insert(E->get_self().get_id(), static_cast<GodotBody2D *>(E));
+		}
+	}
+
+	// Bodies which were freed or moved to another space since the state was saved are skipped.
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		HashMap<uint64_t, GodotBody2D *>::Iterator E = bodies.find(_state_read<uint64_t>(r, layout.body_ids, i));
+		if (!E) {
+			continue;
+		}
+		E->value->restore_state(
+				_state_read<Transform2D>(r, layout.body_transforms, i),
+				_state_read<Vector2>(r, layout.body_linear_velocities, i),
+				_state_read<real_t>(r, layout.body_angular_velocities, i),
+				_state_read<real_t>(r, layout.body_still_times, i),
+				_state_read<uint8_t>(r, layout.body_active, i) != 0);
+	}
+
+	// Let the broadphase create and remove pairs for the restored transforms,
+	// then hand the saved contacts back to the pairs that existed at save time.
+	update();
+
+	HashMap<SpaceStatePairKey2D, uint32_t, SpaceStatePairKey2D> saved_pairs;
+	saved_pairs.reserve(header.pair_count);
+	for (uint32_t i = 0; i < header.pair_count; i++) {
+		SpaceStatePairKey2D key;
+		key.body_a = _state_read<uint64_t>(r, layout.pair_body_a, i);
+		key.body_b = _state_read<uint64_t>(r, layout.pair_body_b, i);
+		key.shape_a = _state_read<int32_t>(r, layout.pair_shape_a, i);
+		key.shape_b = _state_read<int32_t>(r, layout.pair_shape_b, i);
+		saved_pairs.insert(key, i);
+	}
+
+	for (SelfList<GodotBodyPair2D> *E = body_pair_list.first(); E; E = E->next()) {
+		GodotBodyPair2D *pair = E->self();
+		SpaceStatePairKey2D key;
+		key.body_a = pair->get_body_a()->get_self().get_id();
+		key.body_b = pair->get_body_b()->get_self().get_id();
+		key.shape_a = pair->get_shape_a();
+		key.shape_b = pair->get_shape_b();
+
+		HashMap<SpaceStatePairKey2D, uint32_t, SpaceStatePairKey2D>::Iterator P = saved_pairs.find(key);
+		if (P) {
+			pair->set_contact_state(r + layout.pair_contacts + P->value * GodotBodyPair2D::CONTACT_STATE_SIZE);
+		} else {
+			pair->clear_contacts();
+		}
+	}
+
+	return true;
+}
+
 GodotSpace2D::GodotSpace2D() {
 	body_linear_velocity_sleep_threshold = GLOBAL_GET("physics/2d/sleep_threshold_linear");
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/2d/sleep_threshold_angular");
@@ -1235,6 +1444,11 @@ GodotSpace2D::GodotSpace2D() {
 }
 
 GodotSpace2D::~GodotSpace2D() {
+	// Pairs still alive at this point are owned by the broadphase, detach them
+	// so the list can be destroyed safely.
+	while (body_pair_list.first()) {
+		body_pair_list.remove(body_pair_list.first());
+	}
 	memdelete(broadphase);
 	memdelete(direct_access);
 }
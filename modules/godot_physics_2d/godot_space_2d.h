@@ -88,6 +88,7 @@ private:
 	SelfList<GodotBody2D>::List state_query_list;
 	SelfList<GodotArea2D>::List monitor_query_list;
 	SelfList<GodotArea2D>::List area_moved_list;
+	SelfList<GodotBodyPair2D>::List body_pair_list;
 
 	static void *_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_data, void *p_self);
@@ -123,7 +124,7 @@ private:
 	int active_objects = 0;
 	int collision_pairs = 0;
 
-	int _cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb);
+	int _cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb, GodotCollisionObject2D **r_results, int *r_subindex_results);
 
 	Vector<Vector2> contact_debug;
 	int contact_debug_count = 0;
@@ -146,6 +147,9 @@ public:
 	void area_remove_from_moved_list(SelfList<GodotArea2D> *p_area);
 	const SelfList<GodotArea2D>::List &get_moved_area_list() const;
 
+	void body_pair_add_to_list(SelfList<GodotBodyPair2D> *p_pair);
+	void body_pair_remove_from_list(SelfList<GodotBodyPair2D> *p_pair);
+
 	void body_add_to_state_query_list(SelfList<GodotBody2D> *p_body);
 	void body_remove_from_state_query_list(SelfList<GodotBody2D> *p_body);
 
@@ -192,6 +196,9 @@ public:
 
 	bool test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::MotionParameters &p_parameters, PhysicsServer2D::MotionResult *r_result);
 
+	PackedByteArray save_state() const;
+	bool restore_state(const PackedByteArray &p_state);
+
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
 	_FORCE_INLINE_ bool is_debugging_contacts() const { return !contact_debug.is_empty(); }
 	_FORCE_INLINE_ void add_debug_contact(const Vector2 &p_contact) {
@@ -0,0 +1,415 @@
+/**************************************************************************/
+/*  test_godot_broad_phase_2d_hash.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#ifndef TEST_GODOT_BROAD_PHASE_2D_HASH_H
+#define TEST_GODOT_BROAD_PHASE_2D_HASH_H
+
+#include "../godot_body_2d.h"
+#include "../godot_broad_phase_2d_bvh.h"
+#include "../godot_broad_phase_2d_hash.h"
+
+#include "core/config/project_settings.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/hash_set.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotBroadPhase2DHash {
+
+// The cell size is read from the project settings when the broadphase is created.
+struct CellSizeOverride {
+	static constexpr const char *SETTING = "physics/2d/spatial_hash_cell_size";
+	bool had_setting = false;
+	Variant previous;
+
+	explicit CellSizeOverride(real_t p_cell_size) {
+		had_setting = ProjectSettings::get_singleton()->has_setting(SETTING);
+		if (had_setting) {
+			previous = ProjectSettings::get_singleton()->get_setting(SETTING);
+		}
+		ProjectSettings::get_singleton()->set_setting(SETTING, p_cell_size);
+	}
+
+	~CellSizeOverride() {
+		// Setting a null value erases the setting again.
+		ProjectSettings::get_singleton()->set_setting(SETTING, had_setting ? previous : Variant());
+	}
+};
+
+// Each element uses its index as subindex, so pairs can be keyed by index.
+struct PairTracker {
+	HashSet<uint64_t> pairs;
+	int duplicate_pairs = 0;
+	int unknown_unpairs = 0;
+
+	static uint64_t key(int p_a, int p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | uint32_t(p_b)) : ((uint64_t(p_b) << 32) | uint32_t(p_a));
+	}
+
+	static void *pair(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_userdata) {
+		PairTracker *tracker = static_cast<PairTracker *>(p_userdata);
+		uint64_t k = key(p_subindex_a, p_subindex_b);
+		if (tracker->pairs.has(k)) {
+			tracker->duplicate_pairs++;
+		}
+		tracker->pairs.insert(k);
+		return nullptr;
+	}
+
+	static void unpair(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_data, void *p_userdata) {
+		PairTracker *tracker = static_cast<PairTracker *>(p_userdata);
+		if (!tracker->pairs.erase(key(p_subindex_a, p_subindex_b))) {
+			tracker->unknown_unpairs++;
+		}
+	}
+};
+
+struct TestScene {
+	GodotBroadPhase2DHash broad_phase;
+	LocalVector<GodotBody2D *> bodies;
+	LocalVector<GodotBroadPhase2D::ID> ids;
+	LocalVector<Rect2> rects;
+	PairTracker tracker;
+	RandomPCG rng;
+
+	Rect2 random_rect() {
+		Vector2 position(rng.random(-200.0f, 200.0f), rng.random(-200.0f, 200.0f));
+		return Rect2(position, Vector2(rng.random(0.0f, 8.0f), rng.random(0.0f, 8.0f)));
+	}
+
+	// Pairs the broadphase should report, by brute force.
+	HashSet<uint64_t> expected_pairs() const {
+		HashSet<uint64_t> expected;
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			if (!ids[i]) {
+				continue;
+			}
+			for (uint32_t j = i + 1; j < ids.size(); j++) {
+				if (ids[j] && rects[i].intersects(rects[j], true)) {
+					expected.insert(PairTracker::key(i, j));
+				}
+			}
+		}
+		return expected;
+	}
+
+	bool pairs_match() const {
+		HashSet<uint64_t> expected = expected_pairs();
+		if (expected.size() != tracker.pairs.size()) {
+			return false;
+		}
+		for (const uint64_t &k : expected) {
+			if (!tracker.pairs.has(k)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void add(const Rect2 &p_rect) {
+		GodotBody2D *body = memnew(GodotBody2D);
+		bodies.push_back(body);
+		rects.push_back(p_rect);
+		ids.push_back(broad_phase.create(body, ids.size(), p_rect, false));
+	}
+
+	TestScene(uint32_t p_count, uint64_t p_seed) :
+			rng(p_seed) {
+		broad_phase.set_pair_callback(&PairTracker::pair, &tracker);
+		broad_phase.set_unpair_callback(&PairTracker::unpair, &tracker);
+		for (uint32_t i = 0; i < p_count; i++) {
+			add(random_rect());
+		}
+		// A few elements spanning the whole scene go through the large list.
+		for (uint32_t i = 0; i < MIN(p_count, 3u); i++) {
+			rects[i] = Rect2(-5000, -5000, 10000, 10000);
+			broad_phase.move(ids[i], rects[i]);
+		}
+	}
+
+	~TestScene() {
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			if (ids[i]) {
+				broad_phase.remove(ids[i]);
+			}
+		}
+		for (GodotBody2D *body : bodies) {
+			memdelete(body);
+		}
+	}
+};
+
+TEST_CASE("[Physics][GodotBroadPhase2DHash] Pairs match brute force") {
+	TestScene scene(600, 1);
+	scene.broad_phase.update();
+	CHECK(scene.tracker.duplicate_pairs == 0);
+	CHECK(scene.pairs_match());
+
+	SUBCASE("After moving elements") {
+		for (int frame = 0; frame < 5; frame++) {
+			for (uint32_t i = 0; i < scene.ids.size(); i += 3) {
+				scene.rects[i] = scene.random_rect();
+				scene.broad_phase.move(scene.ids[i], scene.rects[i]);
+			}
+			scene.broad_phase.update();
+			CHECK(scene.pairs_match());
+		}
+		CHECK(scene.tracker.duplicate_pairs == 0);
+		CHECK(scene.tracker.unknown_unpairs == 0);
+	}
+
+	SUBCASE("After removing elements") {
+		for (uint32_t i = 0; i < scene.ids.size(); i += 4) {
+			scene.broad_phase.remove(scene.ids[i]);
+			scene.ids[i] = 0;
+		}
+		scene.broad_phase.update();
+		CHECK(scene.pairs_match());
+		CHECK(scene.tracker.unknown_unpairs == 0);
+	}
+}
+
+TEST_CASE("[Physics][GodotBroadPhase2DHash] Static elements don't pair with each other") {
+	TestScene scene(2, 2);
+	scene.rects[0] = Rect2(0, 0, 10, 10);
+	scene.rects[1] = Rect2(5, 5, 10, 10);
+	scene.broad_phase.move(scene.ids[0], scene.rects[0]);
+	scene.broad_phase.move(scene.ids[1], scene.rects[1]);
+	scene.broad_phase.update();
+	CHECK(scene.tracker.pairs.size() == 1);
+
+	scene.broad_phase.set_static(scene.ids[0], true);
+	scene.broad_phase.set_static(scene.ids[1], true);
+	scene.broad_phase.update();
+	CHECK(scene.tracker.pairs.is_empty());
+}
+
+TEST_CASE("[Physics][GodotBroadPhase2DHash] AABB and segment culls match brute force") {
+	TestScene scene(600, 3);
+	scene.broad_phase.update();
+
+	LocalVector<GodotCollisionObject2D *> results;
+	LocalVector<int> indices;
+	results.resize(scene.ids.size());
+	indices.resize(scene.ids.size());
+
+	for (int query = 0; query < 50; query++) {
+		Rect2 rect = scene.random_rect().grow(query % 10);
+		int count = scene.broad_phase.cull_aabb(rect, results.ptr(), results.size(), indices.ptr());
+
+		HashSet<int> found;
+		for (int i = 0; i < count; i++) {
+			CHECK_FALSE_MESSAGE(found.has(indices[i]), "Elements should be reported only once.");
+			found.insert(indices[i]);
+		}
+		int expected = 0;
+		for (uint32_t i = 0; i < scene.rects.size(); i++) {
+			if (scene.rects[i].intersects(rect, true)) {
+				expected++;
+				CHECK(found.has(i));
+			}
+		}
+		CHECK(count == expected);
+	}
+
+	for (int query = 0; query < 50; query++) {
+		Vector2 from(scene.rng.random(-200.0f, 200.0f), scene.rng.random(-200.0f, 200.0f));
+		Vector2 to(scene.rng.random(-200.0f, 200.0f), scene.rng.random(-200.0f, 200.0f));
+		int count = scene.broad_phase.cull_segment(from, to, results.ptr(), results.size(), indices.ptr());
+
+		HashSet<int> found;
+		for (int i = 0; i < count; i++) {
+			found.insert(indices[i]);
+		}
+		CHECK(found.size() == (uint32_t)count);
+		for (uint32_t i = 0; i < scene.rects.size(); i++) {
+			if (scene.rects[i].intersects_segment(from, to)) {
+				CHECK(found.has(i));
+			}
+		}
+	}
+}
+
+TEST_CASE("[Physics][GodotBroadPhase2DHash] Segment culls on cell edges match brute force") {
+	// 49 has no exact inverse, so multiplying by it puts many edges in the previous cell.
+	const real_t cell_size = 49.0;
+	CellSizeOverride cell_size_override(cell_size);
+	TestScene scene(0, 4);
+	for (int i = -3; i <= 3; i++) {
+		for (int j = -3; j <= 3; j++) {
+			Vector2 corner(i * cell_size, j * cell_size);
+			// Points on cell corners, and rects ending or starting exactly on an edge.
+			scene.add(Rect2(corner, Vector2()));
+			scene.add(Rect2(corner + Vector2(-2, 10), Vector2(2, 5)));
+			scene.add(Rect2(corner + Vector2(10, 0), Vector2(5, 2)));
+		}
+	}
+	scene.broad_phase.update();
+
+	LocalVector<Vector2> points;
+	for (int i = -3; i <= 3; i++) {
+		for (int j = -3; j <= 3; j++) {
+			points.push_back(Vector2(i * cell_size, j * cell_size));
+			points.push_back(Vector2(i * cell_size, j * cell_size + 12));
+		}
+	}
+
+	LocalVector<GodotCollisionObject2D *> results;
+	LocalVector<int> indices;
+	results.resize(scene.ids.size());
+	indices.resize(scene.ids.size());
+
+	int misses = 0;
+	int duplicates = 0;
+	for (uint32_t from = 0; from < points.size(); from += 3) {
+		for (uint32_t to = 0; to < points.size(); to++) {
+			int count = scene.broad_phase.cull_segment(points[from], points[to], results.ptr(), results.size(), indices.ptr());
+
+			HashSet<int> found;
+			for (int i = 0; i < count; i++) {
+				if (found.has(indices[i])) {
+					duplicates++;
+				}
+				found.insert(indices[i]);
+			}
+			for (uint32_t i = 0; i < scene.rects.size(); i++) {
+				if (scene.rects[i].intersects_segment(points[from], points[to]) && !found.has(i)) {
+					misses++;
+				}
+			}
+		}
+	}
+	CHECK_MESSAGE(misses == 0, "Segments ending on cell edges should still visit the cells they touch.");
+	CHECK_MESSAGE(duplicates == 0, "Elements should be reported only once.");
+}
+
+struct PairCounter {
+	int pairs = 0;
+
+	static void *pair(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_userdata) {
+		static_cast<PairCounter *>(p_userdata)->pairs++;
+		return nullptr;
+	}
+
+	static void unpair(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_data, void *p_userdata) {
+		static_cast<PairCounter *>(p_userdata)->pairs--;
+	}
+};
+
+// Moves every object each frame, like a crowd of bullets, and returns the
+// time spent in moves and updates.
+static uint64_t step_moving_objects(GodotBroadPhase2D &p_broad_phase, const LocalVector<GodotBody2D *> &p_bodies, LocalVector<Rect2> p_rects, const LocalVector<Vector2> &p_velocities, int p_frames, int &r_pairs) {
+	PairCounter counter;
+	p_broad_phase.set_pair_callback(&PairCounter::pair, &counter);
+	p_broad_phase.set_unpair_callback(&PairCounter::unpair, &counter);
+
+	LocalVector<GodotBroadPhase2D::ID> ids;
+	ids.resize(p_bodies.size());
+	for (uint32_t i = 0; i < p_bodies.size(); i++) {
+		ids[i] = p_broad_phase.create(p_bodies[i], i, p_rects[i], false);
+	}
+	p_broad_phase.update();
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < p_frames; frame++) {
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			p_rects[i].position += p_velocities[i];
+			p_broad_phase.move(ids[i], p_rects[i]);
+		}
+		p_broad_phase.update();
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	r_pairs = counter.pairs;
+	for (const GodotBroadPhase2D::ID &id : ids) {
+		p_broad_phase.remove(id);
+	}
+	return usec;
+}
+
+TEST_CASE("[Stress][Physics][GodotBroadPhase2DHash] Moving 20000 objects against the BVH broadphase") {
+	const uint32_t count = 20000;
+	const int frames = 10;
+	CellSizeOverride cell_size_override(16.0);
+
+	LocalVector<GodotBody2D *> bodies;
+	for (uint32_t i = 0; i < count; i++) {
+		bodies.push_back(memnew(GodotBody2D));
+	}
+
+	struct Distribution {
+		const char *name;
+		real_t extent;
+		// Share of objects that are large.
+		real_t large_ratio;
+	};
+	const Distribution distributions[] = {
+		{ "sparse, similar sizes", 4000.0, 0.0 },
+		{ "dense, similar sizes", 1000.0, 0.0 },
+		{ "dense, mixed sizes", 1000.0, 0.05 },
+	};
+
+	for (const Distribution &distribution : distributions) {
+		RandomPCG rng(5);
+		LocalVector<Rect2> rects;
+		LocalVector<Vector2> velocities;
+		for (uint32_t i = 0; i < count; i++) {
+			real_t size = rng.randf() < distribution.large_ratio ? rng.random(32.0f, 128.0f) : rng.random(4.0f, 8.0f);
+			Vector2 position(rng.random(0.0f, distribution.extent), rng.random(0.0f, distribution.extent));
+			rects.push_back(Rect2(position, Vector2(size, size)));
+			velocities.push_back(Vector2(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f)));
+		}
+
+		int bvh_pairs = 0;
+		int hash_pairs = 0;
+		uint64_t bvh_usec = 0;
+		uint64_t hash_usec = 0;
+		{
+			GodotBroadPhase2DBVH bvh;
+			bvh_usec = step_moving_objects(bvh, bodies, rects, velocities, frames, bvh_pairs);
+		}
+		{
+			GodotBroadPhase2DHash hash;
+			hash_usec = step_moving_objects(hash, bodies, rects, velocities, frames, hash_pairs);
+		}
+
+		MESSAGE(count, " objects, ", distribution.name, ": ", bvh_usec / frames, " usec per frame with the BVH (", bvh_pairs, " pairs), ", hash_usec / frames, " usec per frame with the spatial hash (", hash_pairs, " pairs).");
+	}
+
+	for (GodotBody2D *body : bodies) {
+		memdelete(body);
+	}
+}
+
+} // namespace TestGodotBroadPhase2DHash
+
+#endif // TEST_GODOT_BROAD_PHASE_2D_HASH_H
@@ -597,8 +597,22 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+void GodotBodyPair3D::get_contact_state(uint8_t *r_state) const {
+	int32_t count = contact_count;
+	memcpy(r_state, &count, sizeof(int32_t));
+	memcpy(r_state + sizeof(int32_t), contacts, sizeof(Contact) * MAX_CONTACTS);
+}
+
+void GodotBodyPair3D::set_contact_state(const uint8_t *p_state) {
+	int32_t count = 0;
+	memcpy(&count, p_state, sizeof(int32_t));
+	memcpy(contacts, p_state + sizeof(int32_t), sizeof(Contact) * MAX_CONTACTS);
+	contact_count = CLAMP(count, 0, (int32_t)MAX_CONTACTS);
+}
+
 GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B) :
-		GodotBodyContact3D(_arr, 2) {
+		GodotBodyContact3D(_arr, 2),
+		pair_list(this) {
 	A = p_A;
 	B = p_B;
 	shape_A = p_shape_A;
@@ -606,9 +620,13 @@ GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p
 	space = A->get_space();
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
+	space->body_pair_add_to_list(&pair_list);
 }
 
 GodotBodyPair3D::~GodotBodyPair3D() {
+	if (pair_list.in_list()) {
+		space->body_pair_remove_from_list(&pair_list);
+	}
 	A->remove_constraint(this);
 	B->remove_constraint(this);
 }
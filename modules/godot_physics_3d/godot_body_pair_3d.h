@@ -97,6 +97,8 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	SelfList<GodotBodyPair3D> pair_list;
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
@@ -109,6 +111,18 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	// Contact count followed by the cached contacts, including their accumulated impulses.
+	static constexpr uint32_t CONTACT_STATE_SIZE = sizeof(int32_t) + sizeof(Contact) * MAX_CONTACTS;
+
+	_FORCE_INLINE_ GodotBody3D *get_body_a() const { return A; }
+	_FORCE_INLINE_ GodotBody3D *get_body_b() const { return B; }
+	_FORCE_INLINE_ int get_shape_a() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_b() const { return shape_B; }
+
+	void get_contact_state(uint8_t *r_state) const;
+	void set_contact_state(const uint8_t *p_state);
+	void clear_contacts() { contact_count = 0; }
+
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
 };
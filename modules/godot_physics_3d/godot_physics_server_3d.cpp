@@ -39,6 +39,7 @@
 #include "joints/godot_slider_joint_3d.h"
 
 #include "core/debugger/engine_debugger.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #define FLUSH_QUERY_CHECK(m_object) \
@@ -214,6 +215,24 @@ int GodotPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+PackedByteArray GodotPhysicsServer3D::space_save_state(RID p_space) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, PackedByteArray());
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), PackedByteArray(), "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	_update_shapes();
+	return space->save_state();
+}
+
+bool GodotPhysicsServer3D::space_restore_state(RID p_space, const PackedByteArray &p_state) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, false);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), false, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	_update_shapes();
+	return space->restore_state(p_state);
+}
+
 RID GodotPhysicsServer3D::area_create() {
 	GodotArea3D *area = memnew(GodotArea3D);
 	RID rid = area_owner.make_rid(area);
@@ -920,6 +939,53 @@ bool GodotPhysicsServer3D::body_test_motion(RID p_body, const MotionParameters &
 	return body->get_space()->test_body_motion(body, p_parameters, r_result);
 }
 
+void GodotPhysicsServer3D::_test_motion_batch_item(uint32_t p_index, MotionBatch *p_batch) {
+	GodotBody3D *body = p_batch->bodies[p_index];
+	MotionResult *result = p_batch->results ? &p_batch->results[p_index] : nullptr;
+	if (!body) {
+		if (result) {
+			*result = MotionResult();
+		}
+		p_batch->collided[p_index] = false;
+		return;
+	}
+	p_batch->collided[p_index] = body->get_space()->test_body_motion(body, p_batch->parameters[p_index], result);
+}
+
+void GodotPhysicsServer3D::body_test_motion_batch(const RID *p_bodies, const MotionParameters *p_parameters, MotionResult *r_results, bool *r_collided, int p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	if (p_count == 0) {
+		return;
+	}
+	ERR_FAIL_NULL(p_bodies);
+	ERR_FAIL_NULL(p_parameters);
+	ERR_FAIL_NULL(r_collided);
+
+	// Shapes must be up to date before the spaces are read from several threads.
+	_update_shapes();
+
+	MotionBatch batch;
+	batch.bodies.resize(p_count);
+	batch.parameters = p_parameters;
+	batch.results = r_results;
+	batch.collided = r_collided;
+
+	for (int i = 0; i < p_count; i++) {
+		GodotBody3D *body = body_owner.get_or_null(p_bodies[i]);
+		if (body && (!body->get_space() || body->get_space()->is_locked())) {
+			body = nullptr;
+		}
+		if (!body) {
+			ERR_PRINT("Invalid body or body space in motion batch.");
+		}
+		batch.bodies[i] = body;
+	}
+
+	// Motion tests only read from the spaces, so each one can run on its own worker.
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsServer3D::_test_motion_batch_item, &batch, p_count, -1, true, SNAME("Physics3DTestMotionBatch"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
 PhysicsDirectBodyState3D *GodotPhysicsServer3D::body_get_direct_state(RID p_body) {
 	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync), nullptr, "Body state is inaccessible right now, wait for iteration or physics process notification.");
 
@@ -0,0 +1,244 @@
+/**************************************************************************/
+/*  godot_quantized_bvh_3d.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_quantized_bvh_3d.h"
+
+#include "core/templates/sort_array.h"
+
+#include <cmath>
+
+struct _QuantizedBVHCompareX {
+	template <typename T>
+	_FORCE_INLINE_ bool operator()(const T &a, const T &b) const {
+		return a.center.x < b.center.x;
+	}
+};
+
+struct _QuantizedBVHCompareY {
+	template <typename T>
+	_FORCE_INLINE_ bool operator()(const T &a, const T &b) const {
+		return a.center.y < b.center.y;
+	}
+};
+
+struct _QuantizedBVHCompareZ {
+	template <typename T>
+	_FORCE_INLINE_ bool operator()(const T &a, const T &b) const {
+		return a.center.z < b.center.z;
+	}
+};
+
+void GodotQuantizedBVH3D::_quantize_child(Node &r_node, int p_child, const AABB &p_aabb, const Vector3 &p_node_min, const Vector3 &p_node_size) {
+	Vector3 scale = _get_scale(p_node_size);
+	Vector3 end = p_aabb.get_end();
+	uint16_t *mins[3] = { r_node.min_x, r_node.min_y, r_node.min_z };
+	uint16_t *maxs[3] = { r_node.max_x, r_node.max_y, r_node.max_z };
+
+	for (int i = 0; i < 3; i++) {
+		int64_t q_min = 0;
+		int64_t q_max = 0;
+		if (scale[i] > 0.0) {
+			// Keep one ulp of margin on both sides, so that a decode rounded
+			// differently (e.g. contracted into a fused multiply-add) still
+			// contains the bounds. This matters far from the origin, where an
+			// ulp is larger than the rounding error of the division.
+			const real_t lower = std::nextafter(p_aabb.position[i], -(real_t)INFINITY);
+			const real_t upper = std::nextafter(end[i], (real_t)INFINITY);
+			q_min = CLAMP((int64_t)Math::floor((lower - p_node_min[i]) / scale[i]), 0, (int64_t)QUANTIZE_MAX);
+			q_max = CLAMP((int64_t)Math::ceil((upper - p_node_min[i]) / scale[i]), 0, (int64_t)QUANTIZE_MAX);
+			// Rounding in the division may land one step inside the bounds, make
+			// sure the decoded values contain them.
+			while (q_min > 0 && p_node_min[i] + q_min * scale[i] > lower) {
+				q_min--;
+			}
+			while (q_max < QUANTIZE_MAX && p_node_min[i] + q_max * scale[i] < upper) {
+				q_max++;
+			}
+		}
+		mins[i][p_child] = q_min;
+		maxs[i][p_child] = q_max;
+	}
+}
+
+uint32_t GodotQuantizedBVH3D::_median_split(BuildItem *p_items, uint32_t p_count, bool p_full_sort) {
+	AABB centers(p_items[0].center, Vector3());
+	for (uint32_t i = 1; i < p_count; i++) {
+		centers.expand_to(p_items[i].center);
+	}
+
+	// Keep the split on a multiple of the leaf size, so leaves end up full.
+	uint32_t mid = CLAMP((p_count / 2 + LEAF_SIZE / 2) / LEAF_SIZE * LEAF_SIZE, 1u, p_count - 1);
+	switch (centers.get_longest_axis_index()) {
+		case 0: {
+			SortArray<BuildItem, _QuantizedBVHCompareX> sort_x;
+			if (p_full_sort) {
+				sort_x.sort(p_items, p_count);
+			} else {
+				sort_x.nth_element(0, p_count, mid, p_items);
+			}
+		} break;
+		case 1: {
+			SortArray<BuildItem, _QuantizedBVHCompareY> sort_y;
+			if (p_full_sort) {
+				sort_y.sort(p_items, p_count);
+			} else {
+				sort_y.nth_element(0, p_count, mid, p_items);
+			}
+		} break;
+		case 2: {
+			SortArray<BuildItem, _QuantizedBVHCompareZ> sort_z;
+			if (p_full_sort) {
+				sort_z.sort(p_items, p_count);
+			} else {
+				sort_z.nth_element(0, p_count, mid, p_items);
+			}
+		} break;
+	}
+	return mid;
+}
+
+void GodotQuantizedBVH3D::_split(BuildItem *p_items, uint32_t p_count, uint32_t *r_offsets, uint32_t *r_counts, uint32_t &r_groups) {
+	r_groups = 0;
+	if (p_count <= LEAF_SIZE) {
+		r_offsets[0] = 0;
+		r_counts[0] = p_count;
+		r_groups = 1;
+		return;
+	}
+
+	if (p_count <= LEAF_SIZE * 4) {
+		// Few enough items to make every child a leaf.
+		_median_split(p_items, p_count, true);
+		for (uint32_t i = 0; i < p_count; i += LEAF_SIZE) {
+			r_offsets[r_groups] = i;
+			r_counts[r_groups] = MIN(LEAF_SIZE, p_count - i);
+			r_groups++;
+		}
+		return;
+	}
+
+	// Split at the median twice, for four groups.
+	uint32_t mid = _median_split(p_items, p_count, false);
+	uint32_t halves_offset[2] = { 0, mid };
+	uint32_t halves_count[2] = { mid, p_count - mid };
+
+	for (int i = 0; i < 2; i++) {
+		if (halves_count[i] <= LEAF_SIZE) {
+			r_offsets[r_groups] = halves_offset[i];
+			r_counts[r_groups] = halves_count[i];
+			r_groups++;
+			continue;
+		}
+
+		uint32_t quarter = _median_split(&p_items[halves_offset[i]], halves_count[i], false);
+		r_offsets[r_groups] = halves_offset[i];
+		r_counts[r_groups] = quarter;
+		r_groups++;
+		r_offsets[r_groups] = halves_offset[i] + quarter;
+		r_counts[r_groups] = halves_count[i] - quarter;
+		r_groups++;
+	}
+}
+
+uint32_t GodotQuantizedBVH3D::_build_node(BuildItem *p_items, uint32_t p_count, uint32_t p_first, const Vector3 &p_node_min, const Vector3 &p_node_size) {
+	uint32_t node_index = nodes.size();
+	nodes.push_back(Node());
+
+	uint32_t offsets[4];
+	uint32_t counts[4];
+	uint32_t groups = 0;
+	_split(p_items, p_count, offsets, counts, groups);
+
+	Node node;
+	for (int i = 0; i < 4; i++) {
+		node.min_x[i] = node.min_y[i] = node.min_z[i] = QUANTIZE_MAX;
+		node.max_x[i] = node.max_y[i] = node.max_z[i] = 0;
+		node.children[i] = CHILD_EMPTY;
+	}
+
+	for (uint32_t i = 0; i < groups; i++) {
+		const BuildItem *items = &p_items[offsets[i]];
+		AABB aabb = items[0].aabb;
+		for (uint32_t j = 1; j < counts[i]; j++) {
+			aabb.merge_with(items[j].aabb);
+		}
+		_quantize_child(node, i, aabb, p_node_min, p_node_size);
+	}
+
+	// Children are built against the decoded bounds, exactly as they will be seen when querying.
+	ChildBounds bounds;
+	_decode_children(node, p_node_min, _get_scale(p_node_size), bounds);
+
+	for (uint32_t i = 0; i < groups; i++) {
+		if (counts[i] <= LEAF_SIZE) {
+			node.children[i] = ~int32_t(((p_first + offsets[i]) << LEAF_SIZE_BITS) | (counts[i] - 1));
+		} else {
+			Vector3 child_min(bounds.min_x[i], bounds.min_y[i], bounds.min_z[i]);
+			Vector3 child_size = Vector3(bounds.max_x[i], bounds.max_y[i], bounds.max_z[i]) - child_min;
+			node.children[i] = _build_node(&p_items[offsets[i]], counts[i], p_first + offsets[i], child_min, child_size);
+		}
+	}
+
+	nodes[node_index] = node;
+	return node_index;
+}
+
+void GodotQuantizedBVH3D::build(const AABB *p_aabbs, uint32_t p_count) {
+	clear();
+	if (p_count == 0) {
+		return;
+	}
+	ERR_FAIL_COND_MSG(p_count > MAX_ITEMS, "Too many items for a quantized BVH.");
+
+	LocalVector<BuildItem> items;
+	items.resize(p_count);
+	root_aabb = p_aabbs[0];
+	for (uint32_t i = 0; i < p_count; i++) {
+		items[i].aabb = p_aabbs[i];
+		items[i].center = p_aabbs[i].get_center();
+		items[i].index = i;
+		root_aabb.merge_with(p_aabbs[i]);
+	}
+
+	// A node holds four children, and most of them end up as leaves.
+	nodes.reserve(p_count / LEAF_SIZE / 3 + 1);
+	_build_node(items.ptr(), p_count, 0, root_aabb.position, root_aabb.size);
+
+	leaf_items.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		leaf_items[i] = items[i].index;
+	}
+}
+
+void GodotQuantizedBVH3D::clear() {
+	nodes.clear();
+	leaf_items.clear();
+	root_aabb = AABB();
+}
@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*  godot_quantized_bvh_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_QUANTIZED_BVH_3D_H
+#define GODOT_QUANTIZED_BVH_3D_H
+
+#include "core/math/aabb.h"
+#include "core/templates/local_vector.h"
+
+// Compact, read-only BVH over static items such as the faces of a concave mesh.
+//
+// Every node has four children. Child bounds are stored as 16-bit offsets
+// relative to the bounds of the node itself, which are decoded from its parent
+// while traversing, so a node fits in a single 64-byte cache line. Children are
+// tested four at a time over SoA arrays. Leaves reference up to LEAF_SIZE items
+// through an index array, so items keep their original order.
+class GodotQuantizedBVH3D {
+public:
+	static constexpr uint32_t LEAF_SIZE = 4;
+
+private:
+	static constexpr uint32_t LEAF_SIZE_BITS = 2;
+	static constexpr uint32_t MAX_ITEMS = 1 << (31 - LEAF_SIZE_BITS);
+	static constexpr int32_t CHILD_EMPTY = INT32_MIN;
+	static constexpr uint32_t QUANTIZE_MAX = 65535;
+	// One step short of QUANTIZE_MAX, so the top value always decodes past the
+	// end of the node even when rounding shrinks its size slightly.
+	static constexpr real_t QUANTIZE_STEPS = 65534.0;
+
+	struct Node {
+		uint16_t min_x[4];
+		uint16_t min_y[4];
+		uint16_t min_z[4];
+		uint16_t max_x[4];
+		uint16_t max_y[4];
+		uint16_t max_z[4];
+		// >= 0 for internal nodes, ~((first_item << LEAF_SIZE_BITS) | (item_count - 1)) for leaves.
+		int32_t children[4];
+	};
+
+	static_assert(sizeof(Node) == 64, "Quantized BVH nodes must fit in a cache line.");
+
+	struct ChildBounds {
+		real_t min_x[4];
+		real_t min_y[4];
+		real_t min_z[4];
+		real_t max_x[4];
+		real_t max_y[4];
+		real_t max_z[4];
+	};
+
+	struct BuildItem {
+		AABB aabb;
+		Vector3 center;
+		uint32_t index = 0;
+	};
+
+	LocalVector<Node> nodes;
+	LocalVector<uint32_t> leaf_items;
+	AABB root_aabb;
+
+	_FORCE_INLINE_ static Vector3 _get_scale(const Vector3 &p_size) {
+		return p_size * (1.0 / QUANTIZE_STEPS);
+	}
+
+	// Builder and queries must decode bounds in exactly the same way, which is
+	// what keeps the quantized bounds conservative.
+	_FORCE_INLINE_ static void _decode_children(const Node &p_node, const Vector3 &p_min, const Vector3 &p_scale, ChildBounds &r_bounds) {
+		for (int i = 0; i < 4; i++) {
+			r_bounds.min_x[i] = p_min.x + p_node.min_x[i] * p_scale.x;
+			r_bounds.min_y[i] = p_min.y + p_node.min_y[i] * p_scale.y;
+			r_bounds.min_z[i] = p_min.z + p_node.min_z[i] * p_scale.z;
+			r_bounds.max_x[i] = p_min.x + p_node.max_x[i] * p_scale.x;
+			r_bounds.max_y[i] = p_min.y + p_node.max_y[i] * p_scale.y;
+			r_bounds.max_z[i] = p_min.z + p_node.max_z[i] * p_scale.z;
+		}
+	}
+
+	_FORCE_INLINE_ static uint32_t _aabb_mask(const ChildBounds &p_bounds, const Vector3 &p_min, const Vector3 &p_max) {
+		uint32_t mask = 0;
+		for (int i = 0; i < 4; i++) {
+			bool overlap = (p_bounds.min_x[i] <= p_max.x) & (p_bounds.max_x[i] >= p_min.x) &
+					(p_bounds.min_y[i] <= p_max.y) & (p_bounds.max_y[i] >= p_min.y) &
+					(p_bounds.min_z[i] <= p_max.z) & (p_bounds.max_z[i] >= p_min.z);
+			mask |= uint32_t(overlap) << i;
+		}
+		return mask;
+	}
+
+	struct SegmentQuery {
+		Vector3 from;
+		Vector3 inv_dir;
+		Vector3 min;
+		Vector3 max;
+		bool parallel[3] = {};
+	};
+
+	_FORCE_INLINE_ static void _slab(const real_t *p_min, const real_t *p_max, const SegmentQuery &p_query, int p_axis, real_t *r_tmin, real_t *r_tmax) {
+		if (p_query.parallel[p_axis]) {
+			// Barely moving along this axis, only check that the ranges overlap.
+			for (int i = 0; i < 4; i++) {
+				bool overlap = (p_query.min[p_axis] <= p_max[i]) & (p_query.max[p_axis] >= p_min[i]);
+				r_tmax[i] = overlap ? r_tmax[i] : -1.0;
+			}
+			return;
+		}
+
+		real_t from = p_query.from[p_axis];
+		real_t inv_dir = p_query.inv_dir[p_axis];
+		for (int i = 0; i < 4; i++) {
+			real_t t0 = (p_min[i] - from) * inv_dir;
+			real_t t1 = (p_max[i] - from) * inv_dir;
+			r_tmin[i] = MAX(r_tmin[i], MIN(t0, t1));
+			r_tmax[i] = MIN(r_tmax[i], MAX(t0, t1));
+		}
+	}
+
+	_FORCE_INLINE_ static uint32_t _segment_mask(const ChildBounds &p_bounds, const SegmentQuery &p_query) {
+		real_t tmin[4] = { 0.0, 0.0, 0.0, 0.0 };
+		real_t tmax[4] = { 1.0, 1.0, 1.0, 1.0 };
+		_slab(p_bounds.min_x, p_bounds.max_x, p_query, 0, tmin, tmax);
+		_slab(p_bounds.min_y, p_bounds.max_y, p_query, 1, tmin, tmax);
+		_slab(p_bounds.min_z, p_bounds.max_z, p_query, 2, tmin, tmax);
+
+		uint32_t mask = 0;
+		for (int i = 0; i < 4; i++) {
+			mask |= uint32_t(tmin[i] <= tmax[i]) << i;
+		}
+		return mask;
+	}
+
+	template <typename F>
+	bool _visit_leaf(int32_t p_child, F &p_callback) const {
+		uint32_t leaf = ~uint32_t(p_child);
+		uint32_t first = leaf >> LEAF_SIZE_BITS;
+		uint32_t count = (leaf & (LEAF_SIZE - 1)) + 1;
+		for (uint32_t i = 0; i < count; i++) {
+			if (p_callback(leaf_items[first + i])) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template <typename F>
+	bool _cull_aabb(uint32_t p_node, const Vector3 &p_node_min, const Vector3 &p_node_size, const Vector3 &p_min, const Vector3 &p_max, F &p_callback) const {
+		const Node &node = nodes[p_node];
+		Vector3 scale = _get_scale(p_node_size);
+
+		ChildBounds bounds;
+		_decode_children(node, p_node_min, scale, bounds);
+		uint32_t mask = _aabb_mask(bounds, p_min, p_max);
+
+		for (int i = 0; i < 4; i++) {
+			if (!(mask & (1 << i)) || node.children[i] == CHILD_EMPTY) {
+				continue;
+			}
+			if (node.children[i] < 0) {
+				if (_visit_leaf(node.children[i], p_callback)) {
+					return true;
+				}
+			} else {
+				Vector3 child_min(bounds.min_x[i], bounds.min_y[i], bounds.min_z[i]);
+				Vector3 child_size = Vector3(bounds.max_x[i], bounds.max_y[i], bounds.max_z[i]) - child_min;
+				if (_cull_aabb(node.children[i], child_min, child_size, p_min, p_max, p_callback)) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	template <typename F>
+	bool _cull_segment(uint32_t p_node, const Vector3 &p_node_min, const Vector3 &p_node_size, const SegmentQuery &p_query, F &p_callback) const {
+		const Node &node = nodes[p_node];
+		Vector3 scale = _get_scale(p_node_size);
+
+		ChildBounds bounds;
+		_decode_children(node, p_node_min, scale, bounds);
+		uint32_t mask = _segment_mask(bounds, p_query);
+
+		for (int i = 0; i < 4; i++) {
+			if (!(mask & (1 << i)) || node.children[i] == CHILD_EMPTY) {
+				continue;
+			}
+			if (node.children[i] < 0) {
+				if (_visit_leaf(node.children[i], p_callback)) {
+					return true;
+				}
+			} else {
+				Vector3 child_min(bounds.min_x[i], bounds.min_y[i], bounds.min_z[i]);
+				Vector3 child_size = Vector3(bounds.max_x[i], bounds.max_y[i], bounds.max_z[i]) - child_min;
+				if (_cull_segment(node.children[i], child_min, child_size, p_query, p_callback)) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	static void _quantize_child(Node &r_node, int p_child, const AABB &p_aabb, const Vector3 &p_node_min, const Vector3 &p_node_size);
+	static uint32_t _median_split(BuildItem *p_items, uint32_t p_count, bool p_full_sort);
+	static void _split(BuildItem *p_items, uint32_t p_count, uint32_t *r_offsets, uint32_t *r_counts, uint32_t &r_groups);
+	uint32_t _build_node(BuildItem *p_items, uint32_t p_count, uint32_t p_first, const Vector3 &p_node_min, const Vector3 &p_node_size);
+
+public:
+	// Builds the tree over p_count items, identified by their index in p_aabbs.
+	void build(const AABB *p_aabbs, uint32_t p_count);
+	void clear();
+
+	_FORCE_INLINE_ bool is_empty() const { return nodes.is_empty(); }
+	_FORCE_INLINE_ uint64_t get_memory_usage() const { return nodes.size() * sizeof(Node) + leaf_items.size() * sizeof(uint32_t); }
+
+	// Calls p_callback(uint32_t item) for each item whose bounds may overlap p_aabb, stops when it returns true.
+	template <typename F>
+	bool cull_aabb(const AABB &p_aabb, F &p_callback) const {
+		if (nodes.is_empty()) {
+			return false;
+		}
+		return _cull_aabb(0, root_aabb.position, root_aabb.size, p_aabb.position, p_aabb.get_end(), p_callback);
+	}
+
+	// Calls p_callback(uint32_t item) for each item whose bounds may be crossed by the segment, stops when it returns true.
+	template <typename F>
+	bool cull_segment(const Vector3 &p_from, const Vector3 &p_to, F &p_callback) const {
+		if (nodes.is_empty()) {
+			return false;
+		}
+		SegmentQuery query;
+		query.from = p_from;
+		query.min = p_from.min(p_to);
+		query.max = p_from.max(p_to);
+		Vector3 dir = p_to - p_from;
+		for (int i = 0; i < 3; i++) {
+			query.parallel[i] = Math::abs(dir[i]) < (real_t)CMP_EPSILON;
+			query.inv_dir[i] = query.parallel[i] ? 0.0 : 1.0 / dir[i];
+		}
+		return _cull_segment(0, root_aabb.position, root_aabb.size, query, p_callback);
+	}
+};
+
+#endif // GODOT_QUANTIZED_BVH_3D_H
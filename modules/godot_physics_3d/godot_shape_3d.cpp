@@ -33,7 +33,6 @@
 #include "core/io/image.h"
 #include "core/math/convex_hull.h"
 #include "core/math/geometry_3d.h"
-#include "core/templates/sort_array.h"
 
 // GodotHeightMapShape3D is based on Bullet btHeightfieldTerrainShape.
 
@@ -1345,42 +1344,28 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+bool GodotConcavePolygonShape3D::_SegmentCullParams::operator()(uint32_t p_face_index) {
+	const Face *f = &faces[p_face_index];
+	face->normal = f->normal;
+	face->vertex[0] = vertices[f->indices[0]];
+	face->vertex[1] = vertices[f->indices[1]];
+	face->vertex[2] = vertices[f->indices[2]];
 
-	if (!params_bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
-	}
-
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		int face_index = params_bvh->face_index;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal, face_index, true)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->face_index = face_index;
-				p_params->collisions++;
-			}
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			_cull_segment(params_bvh->left, p_params);
-		}
-		if (params_bvh->right >= 0) {
-			_cull_segment(params_bvh->right, p_params);
+	Vector3 res;
+	Vector3 res_normal;
+	int res_face_index = p_face_index;
+	if (face->intersect_segment(from, to, res, res_normal, res_face_index, true)) {
+		real_t d = dir.dot(res) - dir.dot(from);
+		if ((d > 0) && (d < min_d)) {
+			min_d = d;
+			result = res;
+			normal = res_normal;
+			face_index = res_face_index;
+			collisions++;
 		}
 	}
+
+	return false;
 }
 
 bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const {
@@ -1388,11 +1373,6 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 		return false;
 	}
 
-	// unlock data
-	const Face *fr = faces.ptr();
-	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
-
 	GodotFaceShape3D face;
 	face.backface_collision = backface_collision && p_hit_back_faces;
 
@@ -1401,14 +1381,13 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 	params.to = p_end;
 	params.dir = (p_end - p_begin).normalized();
 
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	params.faces = faces.ptr();
+	params.vertices = vertices.ptr();
 
 	params.face = &face;
 
 	// cull
-	_cull_segment(0, &params);
+	bvh.cull_segment(p_begin, p_end, params);
 
 	if (params.collisions > 0) {
 		r_result = params.result;
@@ -1428,38 +1407,13 @@ Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point)
 	return Vector3();
 }
 
-bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
-
-	if (!p_params->aabb.intersects(params_bvh->aabb)) {
-		return false;
-	}
-
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		if (p_params->callback(p_params->userdata, face)) {
-			return true;
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			if (_cull(params_bvh->left, p_params)) {
-				return true;
-			}
-		}
-
-		if (params_bvh->right >= 0) {
-			if (_cull(params_bvh->right, p_params)) {
-				return true;
-			}
-		}
-	}
-
-	return false;
+bool GodotConcavePolygonShape3D::_CullParams::operator()(uint32_t p_face_index) {
+	const Face *f = &faces[p_face_index];
+	face->normal = f->normal;
+	face->vertex[0] = vertices[f->indices[0]];
+	face->vertex[1] = vertices[f->indices[1]];
+	face->vertex[2] = vertices[f->indices[2]];
+	return callback(userdata, face);
 }
 
 void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
@@ -1468,28 +1422,19 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 		return;
 	}
 
-	AABB local_aabb = p_local_aabb;
-
-	// unlock data
-	const Face *fr = faces.ptr();
-	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
-
 	GodotFaceShape3D face; // use this to send in the callback
 	face.backface_collision = backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
 	_CullParams params;
-	params.aabb = local_aabb;
 	params.face = &face;
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	params.faces = faces.ptr();
+	params.vertices = vertices.ptr();
 	params.callback = p_callback;
 	params.userdata = p_userdata;
 
 	// cull
-	_cull(0, &params);
+	bvh.cull_aabb(p_local_aabb, params);
 }
 
 Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -1502,116 +1447,12 @@ Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
-struct _Volume_BVH_Element {
-	AABB aabb;
-	Vector3 center;
-	int face_index = 0;
-};
-
-struct _Volume_BVH_CompareX {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.x < b.center.x;
-	}
-};
-
-struct _Volume_BVH_CompareY {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.y < b.center.y;
-	}
-};
-
-struct _Volume_BVH_CompareZ {
-	_FORCE_INLINE_ bool operator()(const _Volume_BVH_Element &a, const _Volume_BVH_Element &b) const {
-		return a.center.z < b.center.z;
-	}
-};
-
-struct _Volume_BVH {
-	AABB aabb;
-	_Volume_BVH *left = nullptr;
-	_Volume_BVH *right = nullptr;
-
-	int face_index = 0;
-};
-
-_Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int &count) {
-	_Volume_BVH *bvh = memnew(_Volume_BVH);
-
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
-	}
-
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
-		}
-	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
-		case 0: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
-
-		} break;
-		case 1: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
-			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
-	}
-
-	int split = p_size / 2;
-	bvh->left = _volume_build_bvh(p_elements, split, count);
-	bvh->right = _volume_build_bvh(&p_elements[split], p_size - split, count);
-
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
-}
-
-void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
-
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
-
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].left = -1;
-	}
-
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].right = -1;
-	}
-
-	memdelete(p_bvh_tree);
-}
-
 void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
+		faces.clear();
+		vertices.clear();
+		bvh.clear();
 		configure(AABB());
 		return;
 	}
@@ -1620,10 +1461,8 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 
 	const Vector3 *facesr = p_faces.ptr();
 
-	Vector<_Volume_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
-
-	_Volume_BVH_Element *bvh_arrayw = bvh_array.ptrw();
+	LocalVector<AABB> face_aabbs;
+	face_aabbs.resize(src_face_count);
 
 	faces.resize(src_face_count);
 	Face *facesw = faces.ptrw();
@@ -1637,9 +1476,7 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 	for (int i = 0; i < src_face_count; i++) {
 		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.get_center();
-		bvh_arrayw[i].face_index = i;
+		face_aabbs[i] = face.get_aabb();
 		facesw[i].indices[0] = i * 3 + 0;
 		facesw[i].indices[1] = i * 3 + 1;
 		facesw[i].indices[2] = i * 3 + 2;
@@ -1648,21 +1485,13 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 		verticesw[i * 3 + 1] = face.vertex[1];
 		verticesw[i * 3 + 2] = face.vertex[2];
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = face_aabbs[i];
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(face_aabbs[i]);
 		}
 	}
 
-	int count = 0;
-	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
-
-	bvh.resize(count + 1);
-
-	BVH *bvh_arrayw2 = bvh.ptrw();
-
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	bvh.build(face_aabbs.ptr(), src_face_count);
 
 	backface_collision = p_backface_collision;
 
@@ -31,6 +31,8 @@
 #ifndef GODOT_SHAPE_3D_H
 #define GODOT_SHAPE_3D_H
 
+#include "godot_quantized_bvh_3d.h"
+
 #include "core/math/geometry_3d.h"
 #include "core/templates/local_vector.h"
 #include "servers/physics_server_3d.h"
@@ -302,7 +304,6 @@ public:
 	GodotConvexPolygonShape3D();
 };
 
-struct _Volume_BVH;
 struct GodotFaceShape3D;
 
 struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
@@ -316,24 +317,16 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
-
-		int face_index = 0;
-	};
-
-	Vector<BVH> bvh;
+	GodotQuantizedBVH3D bvh;
 
 	struct _CullParams {
-		AABB aabb;
 		QueryCallback callback = nullptr;
 		void *userdata = nullptr;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
 		GodotFaceShape3D *face = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t p_face_index);
 	};
 
 	struct _SegmentCullParams {
@@ -342,7 +335,6 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 		Vector3 dir;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
 		GodotFaceShape3D *face = nullptr;
 
 		Vector3 result;
@@ -350,15 +342,12 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 		int face_index = -1;
 		real_t min_d = 1e20;
 		int collisions = 0;
+
+		_FORCE_INLINE_ bool operator()(uint32_t p_face_index);
 	};
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	bool _cull(int p_idx, _CullParams *p_params) const;
-
-	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
-
 	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
 
 public:
@@ -33,7 +33,9 @@
 #include "godot_space_3d.h"
 
 #include "core/math/geometry_3d.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/rb_map.h"
+#include "core/templates/sort_array.h"
 #include "servers/rendering_server.h"
 
 // Based on Bullet soft body.
@@ -168,29 +170,58 @@ void GodotSoftBody3D::update_rendering_server(PhysicsServer3DRenderingServerHand
 	p_rendering_server_handler->set_aabb(bounds);
 }
 
-void GodotSoftBody3D::update_normals_and_centroids() {
-	for (Node &node : nodes) {
-		node.n = Vector3();
+template <typename M, typename U>
+void GodotSoftBody3D::_process_chunks(M p_method, U p_userdata, uint32_t p_element_count) {
+	const uint32_t chunk_count = (p_element_count + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+	if (chunk_count < 2) {
+		// Not worth dispatching to other threads.
+		for (uint32_t chunk = 0; chunk < chunk_count; chunk++) {
+			(this->*p_method)(chunk, p_userdata);
+		}
+		return;
 	}
 
-	for (Face &face : faces) {
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_method, p_userdata, chunk_count, -1, true, SNAME("GodotSoftBody3D"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+void GodotSoftBody3D::_update_face_normals_chunk(uint32_t p_chunk, void *p_userdata) {
+	const uint32_t begin = p_chunk * PARALLEL_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + PARALLEL_CHUNK_SIZE, faces.size());
+	for (uint32_t i = begin; i < end; i++) {
+		Face &face = faces[i];
 		const Vector3 n = vec3_cross(face.n[0]->x - face.n[2]->x, face.n[0]->x - face.n[1]->x);
-		face.n[0]->n += n;
-		face.n[1]->n += n;
-		face.n[2]->n += n;
+		face.weighted_normal = n;
 		face.normal = n;
 		face.normal.normalize();
 		face.centroid = 0.33333333333 * (face.n[0]->x + face.n[1]->x + face.n[2]->x);
 	}
+}
 
-	for (Node &node : nodes) {
-		real_t len = node.n.length();
+void GodotSoftBody3D::_update_node_normals_chunk(uint32_t p_chunk, void *p_userdata) {
+	const uint32_t begin = p_chunk * PARALLEL_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + PARALLEL_CHUNK_SIZE, nodes.size());
+	for (uint32_t i = begin; i < end; i++) {
+		Vector3 n;
+		for (uint32_t j = node_face_offsets[i]; j < node_face_offsets[i + 1]; j++) {
+			n += faces[node_faces[j]].weighted_normal;
+		}
+
+		real_t len = n.length();
 		if (len > CMP_EPSILON) {
-			node.n /= len;
+			n /= len;
 		}
+		nodes[i].n = n;
 	}
 }
 
+void GodotSoftBody3D::update_normals_and_centroids() {
+	// Faces are updated first, then each node gathers the normals of its faces,
+	// so neither pass writes to data shared between threads.
+	_process_chunks(&GodotSoftBody3D::_update_face_normals_chunk, (void *)nullptr, faces.size());
+	_process_chunks(&GodotSoftBody3D::_update_node_normals_chunk, (void *)nullptr, nodes.size());
+}
+
 void GodotSoftBody3D::update_bounds() {
 	AABB prev_bounds = bounds;
 	prev_bounds.grow_by(collision_margin);
@@ -581,7 +612,8 @@ bool GodotSoftBody3D::create_from_trimesh(const Vector<int> &p_indices, const Ve
 	}
 
 	generate_bending_constraints(2);
-	reoptimize_link_order();
+	build_link_batches();
+	build_node_faces();
 
 	update_constants();
 	update_normals_and_centroids();
@@ -691,139 +723,138 @@ void GodotSoftBody3D::generate_bending_constraints(int p_distance) {
 //===================================================================
 //
 //
-// This function takes in a list of interdependent Links and tries
-// to maximize the distance between calculation
-// of dependent links. This increases the amount of parallelism that can
-// be exploited by out-of-order instruction processors with large but
-// (inevitably) finite instruction windows.
+// This function splits the Links into batches where no two Links
+// share a node, so that every Link of a batch can be solved at the same
+// time on the WorkerThreadPool. Batches are solved one after the other,
+// so dependent Links still see each other's corrections within an
+// iteration. Links inside a batch are independent, so they are ordered
+// by node index instead, which keeps the nodes touched by each chunk
+// close together in memory.
 //
-//===================================================================
-
-// A small structure to track lists of dependent link calculations.
-class LinkDeps {
-public:
-	// A link calculation that is dependent on this one.
-	// Positive values = "input A" while negative values = "input B".
-	int value;
-	// Next dependence in the list.
-	LinkDeps *next;
-};
-typedef LinkDeps *LinkDepsPtr;
-
-void GodotSoftBody3D::reoptimize_link_order() {
-	const int reop_not_dependent = -1;
-	const int reop_node_complete = -2;
+void GodotSoftBody3D::build_link_batches() {
+	link_batches.clear();
 
-	uint32_t link_count = links.size();
-	uint32_t node_count = nodes.size();
+	const uint32_t link_count = links.size();
+	if (link_count == 0) {
+		return;
+	}
 
-	if (link_count < 1 || node_count < 2) {
+	if (!link_coloring) {
+		// Solve every link serially, in creation order.
+		LinkBatch batch;
+		batch.end = link_count;
+		batch.parallel = false;
+		link_batches.push_back(batch);
 		return;
 	}
 
-	uint32_t i;
-	Link *lr;
-	int ar, br;
-	Node *node0 = &(nodes[0]);
-	Node *node1 = &(nodes[1]);
-	LinkDepsPtr link_dep;
-	int ready_list_head, ready_list_tail, link_num, link_dep_frees, dep_link;
-
-	// Allocate temporary buffers.
-	int *node_written_at = memnew_arr(int, node_count + 1); // What link calculation produced this node's current values?
-	int *link_dep_A = memnew_arr(int, link_count); // Link calculation input is dependent upon prior calculation #N
-	int *link_dep_B = memnew_arr(int, link_count);
-	int *ready_list = memnew_arr(int, link_count); // List of ready-to-process link calculations (# of links, maximum)
-	LinkDeps *link_dep_free_list = memnew_arr(LinkDeps, 2 * link_count); // Dependent-on-me list elements (2x# of links, maximum)
-	LinkDepsPtr *link_dep_list_starts = memnew_arr(LinkDepsPtr, link_count); // Start nodes of dependent-on-me lists, one for each link
-
-	// Copy the original, unsorted links to a side buffer.
-	Link *link_buffer = memnew_arr(Link, link_count);
-	memcpy(link_buffer, &(links[0]), sizeof(Link) * link_count);
-
-	// Clear out the node setup and ready list.
-	for (i = 0; i < node_count + 1; i++) {
-		node_written_at[i] = reop_not_dependent;
-	}
-	for (i = 0; i < link_count; i++) {
-		link_dep_list_starts[i] = nullptr;
-	}
-	ready_list_head = ready_list_tail = link_dep_frees = 0;
-
-	// Initial link analysis to set up data structures.
-	for (i = 0; i < link_count; i++) {
-		// Note which prior link calculations we are dependent upon & build up dependence lists.
-		lr = &(links[i]);
-		ar = (lr->n[0] - node0) / (node1 - node0);
-		br = (lr->n[1] - node0) / (node1 - node0);
-		if (node_written_at[ar] > reop_not_dependent) {
-			link_dep_A[i] = node_written_at[ar];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = i;
-			link_dep->next = link_dep_list_starts[node_written_at[ar]];
-			link_dep_list_starts[node_written_at[ar]] = link_dep;
-		} else {
-			link_dep_A[i] = reop_not_dependent;
+	// Greedy graph coloring: links of the same color never share a node,
+	// so all links of a color can be solved at the same time.
+	LocalVector<uint64_t> node_colors;
+	node_colors.resize(nodes.size());
+	memset(node_colors.ptr(), 0, node_colors.size() * sizeof(uint64_t));
+
+	LocalVector<uint32_t> link_colors;
+	link_colors.resize(link_count);
+
+	uint32_t color_link_counts[LINK_COLOR_MAX + 1] = {};
+
+	for (uint32_t i = 0; i < link_count; i++) {
+		const uint32_t node_a = links[i].n[0]->index;
+		const uint32_t node_b = links[i].n[1]->index;
+		const uint64_t used_colors = node_colors[node_a] | node_colors[node_b];
+
+		// Links that can't be given a color go to a last batch that is solved serially.
+		uint32_t color = 0;
+		while (color < LINK_COLOR_MAX && (used_colors & (uint64_t(1) << color))) {
+			color++;
 		}
-		if (node_written_at[br] > reop_not_dependent) {
-			link_dep_B[i] = node_written_at[br];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = -(int)(i + 1);
-			link_dep->next = link_dep_list_starts[node_written_at[br]];
-			link_dep_list_starts[node_written_at[br]] = link_dep;
-		} else {
-			link_dep_B[i] = reop_not_dependent;
+		if (color < LINK_COLOR_MAX) {
+			node_colors[node_a] |= uint64_t(1) << color;
+			node_colors[node_b] |= uint64_t(1) << color;
+		}
+
+		link_colors[i] = color;
+		color_link_counts[color]++;
+	}
+
+	// Sort links by color, keeping their relative order within each color.
+	uint32_t color_offsets[LINK_COLOR_MAX + 1];
+	uint32_t offset = 0;
+	for (uint32_t color = 0; color <= LINK_COLOR_MAX; color++) {
+		color_offsets[color] = offset;
+		if (color_link_counts[color] > 0) {
+			LinkBatch batch;
+			batch.begin = offset;
+			batch.end = offset + color_link_counts[color];
+			batch.parallel = color < LINK_COLOR_MAX;
+			link_batches.push_back(batch);
 		}
+		offset += color_link_counts[color];
+	}
 
-		// Add this link to the initial ready list, if it is not dependent on any other links.
-		if ((link_dep_A[i] == reop_not_dependent) && (link_dep_B[i] == reop_not_dependent)) {
-			ready_list[ready_list_tail++] = i;
-			link_dep_A[i] = link_dep_B[i] = reop_node_complete; // Probably not needed now.
+	struct LinkSortKey {
+		uint64_t nodes = 0;
+		uint32_t link = 0;
+
+		bool operator<(const LinkSortKey &p_other) const {
+			return nodes < p_other.nodes || (nodes == p_other.nodes && link < p_other.link);
 		}
+	};
 
-		// Update the nodes to mark which ones are calculated by this link.
-		node_written_at[ar] = node_written_at[br] = i;
-	}
-
-	// Process the ready list and create the sorted list of links:
-	// -- By treating the ready list as a queue, we maximize the distance between any
-	//    inter-dependent node calculations.
-	// -- All other (non-related) nodes in the ready list will automatically be inserted
-	//    in between each set of inter-dependent link calculations by this loop.
-	i = 0;
-	while (ready_list_head != ready_list_tail) {
-		// Use ready list to select the next link to process.
-		link_num = ready_list[ready_list_head++];
-		// Copy the next-to-calculate link back into the original link array.
-		links[i++] = link_buffer[link_num];
-
-		// Free up any link inputs that are dependent on this one.
-		link_dep = link_dep_list_starts[link_num];
-		while (link_dep) {
-			dep_link = link_dep->value;
-			if (dep_link >= 0) {
-				link_dep_A[dep_link] = reop_not_dependent;
-			} else {
-				dep_link = -dep_link - 1;
-				link_dep_B[dep_link] = reop_not_dependent;
-			}
-			// Add this dependent link calculation to the ready list if *both* inputs are clear.
-			if ((link_dep_A[dep_link] == reop_not_dependent) && (link_dep_B[dep_link] == reop_not_dependent)) {
-				ready_list[ready_list_tail++] = dep_link;
-				link_dep_A[dep_link] = link_dep_B[dep_link] = reop_node_complete; // Probably not needed now.
-			}
-			link_dep = link_dep->next;
+	LocalVector<LinkSortKey> sorted_keys;
+	sorted_keys.resize(link_count);
+	for (uint32_t i = 0; i < link_count; i++) {
+		const uint64_t node_a = links[i].n[0]->index;
+		const uint64_t node_b = links[i].n[1]->index;
+		LinkSortKey &key = sorted_keys[color_offsets[link_colors[i]]++];
+		key.nodes = node_a < node_b ? ((node_a << 32) | node_b) : ((node_b << 32) | node_a);
+		key.link = i;
+	}
+
+	// Within a color, order links by node so that the links of a chunk touch nearby nodes.
+	// The serial batch keeps its creation order.
+	SortArray<LinkSortKey> sorter;
+	for (const LinkBatch &batch : link_batches) {
+		if (batch.parallel) {
+			sorter.sort(sorted_keys.ptr() + batch.begin, batch.end - batch.begin);
+		}
+	}
+
+	LocalVector<Link> sorted_links;
+	sorted_links.resize(link_count);
+	for (uint32_t i = 0; i < link_count; i++) {
+		sorted_links[i] = links[sorted_keys[i].link];
+	}
+	links = sorted_links;
+}
+
+void GodotSoftBody3D::build_node_faces() {
+	const uint32_t node_count = nodes.size();
+	const uint32_t face_count = faces.size();
+
+	node_face_offsets.resize(node_count + 1);
+	memset(node_face_offsets.ptr(), 0, node_face_offsets.size() * sizeof(uint32_t));
+
+	for (const Face &face : faces) {
+		for (int i = 0; i < 3; i++) {
+			node_face_offsets[face.n[i]->index + 1]++;
 		}
 	}
+	for (uint32_t i = 0; i < node_count; i++) {
+		node_face_offsets[i + 1] += node_face_offsets[i];
+	}
 
-	// Delete the temporary buffers.
-	memdelete_arr(node_written_at);
-	memdelete_arr(link_dep_A);
-	memdelete_arr(link_dep_B);
-	memdelete_arr(ready_list);
-	memdelete_arr(link_dep_free_list);
-	memdelete_arr(link_dep_list_starts);
-	memdelete_arr(link_buffer);
+	LocalVector<uint32_t> write_offsets;
+	write_offsets.resize(node_count);
+	memcpy(write_offsets.ptr(), node_face_offsets.ptr(), node_count * sizeof(uint32_t));
+
+	node_faces.resize(face_count * 3);
+	for (uint32_t face_index = 0; face_index < face_count; face_index++) {
+		for (int i = 0; i < 3; i++) {
+			node_faces[write_offsets[faces[face_index].n[i]->index]++] = face_index;
+		}
+	}
 }
 
 void GodotSoftBody3D::append_link(uint32_t p_node1, uint32_t p_node2) {
@@ -867,6 +898,18 @@ void GodotSoftBody3D::append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p
 	faces.push_back(face);
 }
 
+void GodotSoftBody3D::set_link_coloring_enabled(bool p_enabled) {
+	if (link_coloring == p_enabled) {
+		return;
+	}
+	link_coloring = p_enabled;
+
+	// Links are reordered by coloring, so their creation order can only be restored from the mesh.
+	if (soft_mesh.is_valid()) {
+		set_mesh(soft_mesh);
+	}
+}
+
 void GodotSoftBody3D::set_iteration_count(int p_val) {
 	iteration_count = p_val;
 }
@@ -969,6 +1012,25 @@ Vector3 GodotSoftBody3D::_compute_area_windforce(const GodotArea3D *p_area, cons
 	return nodal_force_magnitude * p_face->normal;
 }
 
+void GodotSoftBody3D::_integrate_nodes_chunk(uint32_t p_chunk, const IntegrateData *p_data) {
+	const real_t delta = p_data->delta;
+	const real_t clamp_delta_v = p_data->clamp_delta_v;
+
+	const uint32_t begin = p_chunk * PARALLEL_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + PARALLEL_CHUNK_SIZE, nodes.size());
+	for (uint32_t i = begin; i < end; i++) {
+		Node &node = nodes[i];
+		node.q = node.x;
+		Vector3 delta_v = node.f * node.im * delta;
+		for (int c = 0; c < 3; c++) {
+			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
+		}
+		node.v += delta_v;
+		node.x += node.v * delta;
+		node.f = Vector3();
+	}
+}
+
 void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	const real_t inv_delta = 1.0 / p_delta;
 
@@ -1034,16 +1096,10 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	real_t clamp_delta_v = max_displacement * inv_delta;
 
 	// Integrate.
-	for (Node &node : nodes) {
-		node.q = node.x;
-		Vector3 delta_v = node.f * node.im * p_delta;
-		for (int c = 0; c < 3; c++) {
-			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
-		}
-		node.v += delta_v;
-		node.x += node.v * p_delta;
-		node.f = Vector3();
-	}
+	IntegrateData integrate_data;
+	integrate_data.delta = p_delta;
+	integrate_data.clamp_delta_v = clamp_delta_v;
+	_process_chunks(&GodotSoftBody3D::_integrate_nodes_chunk, &integrate_data, nodes.size());
 
 	// Bounds and tree update.
 	update_bounds();
@@ -1067,50 +1123,102 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	face_tree.optimize_incremental(1);
 }
 
-void GodotSoftBody3D::solve_constraints(real_t p_delta) {
-	const real_t inv_delta = 1.0 / p_delta;
-
-	for (Link &link : links) {
+void GodotSoftBody3D::_prepare_links_chunk(uint32_t p_chunk, void *p_userdata) {
+	const uint32_t begin = p_chunk * PARALLEL_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + PARALLEL_CHUNK_SIZE, links.size());
+	for (uint32_t i = begin; i < end; i++) {
+		Link &link = links[i];
 		link.c3 = link.n[1]->q - link.n[0]->q;
 		link.c2 = 1 / (link.c3.length_squared() * link.c0);
 	}
+}
 
-	// Solve velocities.
-	for (Node &node : nodes) {
-		node.x = node.q + node.v * p_delta;
+void GodotSoftBody3D::_predict_positions_chunk(uint32_t p_chunk, const IntegrateData *p_data) {
+	const real_t delta = p_data->delta;
+
+	const uint32_t begin = p_chunk * PARALLEL_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + PARALLEL_CHUNK_SIZE, nodes.size());
+	for (uint32_t i = begin; i < end; i++) {
+		Node &node = nodes[i];
+		node.x = node.q + node.v * delta;
 	}
+}
+
+void GodotSoftBody3D::_update_velocities_chunk(uint32_t p_chunk, const IntegrateData *p_data) {
+	const real_t delta = p_data->delta;
+	const real_t vc = (1.0 - damping_coefficient) / delta;
+
+	const uint32_t begin = p_chunk * PARALLEL_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + PARALLEL_CHUNK_SIZE, nodes.size());
+	for (uint32_t i = begin; i < end; i++) {
+		Node &node = nodes[i];
+		node.x += node.bv * delta;
+		node.bv = Vector3();
+
+		node.v = (node.x - node.q) * vc;
+
+		node.q = node.x;
+	}
+}
+
+void GodotSoftBody3D::solve_constraints(real_t p_delta) {
+	IntegrateData integrate_data;
+	integrate_data.delta = p_delta;
+
+	_process_chunks(&GodotSoftBody3D::_prepare_links_chunk, (void *)nullptr, links.size());
+
+	// Solve velocities.
+	_process_chunks(&GodotSoftBody3D::_predict_positions_chunk, &integrate_data, nodes.size());
 
 	// Solve positions.
 	for (int isolve = 0; isolve < iteration_count; ++isolve) {
 		const real_t ti = isolve / (real_t)iteration_count;
 		solve_links(1.0, ti);
 	}
-	const real_t vc = (1.0 - damping_coefficient) * inv_delta;
-	for (Node &node : nodes) {
-		node.x += node.bv * p_delta;
-		node.bv = Vector3();
 
-		node.v = (node.x - node.q) * vc;
+	_process_chunks(&GodotSoftBody3D::_update_velocities_chunk, &integrate_data, nodes.size());
 
-		node.q = node.x;
+	update_normals_and_centroids();
+}
+
+_FORCE_INLINE_ void GodotSoftBody3D::_solve_link(Link &p_link, real_t p_kst) {
+	if (p_link.c0 > 0) {
+		Node &node_a = *p_link.n[0];
+		Node &node_b = *p_link.n[1];
+		const Vector3 del = node_b.x - node_a.x;
+		const real_t len = del.length_squared();
+		if (p_link.c1 + len > CMP_EPSILON) {
+			const real_t k = ((p_link.c1 - len) / (p_link.c0 * (p_link.c1 + len))) * p_kst;
+			node_a.x -= del * (k * node_a.im);
+			node_b.x += del * (k * node_b.im);
+		}
 	}
+}
 
-	update_normals_and_centroids();
+void GodotSoftBody3D::_solve_links_chunk(uint32_t p_chunk, const LinkSolveData *p_data) {
+	const uint32_t begin = p_data->begin + p_chunk * PARALLEL_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + PARALLEL_CHUNK_SIZE, p_data->end);
+	for (uint32_t i = begin; i < end; i++) {
+		_solve_link(links[i], p_data->kst);
+	}
 }
 
 void GodotSoftBody3D::solve_links(real_t kst, real_t ti) {
-	for (Link &link : links) {
-		if (link.c0 > 0) {
-			Node &node_a = *link.n[0];
-			Node &node_b = *link.n[1];
-			const Vector3 del = node_b.x - node_a.x;
-			const real_t len = del.length_squared();
-			if (link.c1 + len > CMP_EPSILON) {
-				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * kst;
-				node_a.x -= del * (k * node_a.im);
-				node_b.x += del * (k * node_b.im);
+	// Batches are solved in order, Gauss-Seidel style. Links within a batch don't share nodes,
+	// so a batch can be split across threads with the same result as solving it serially.
+	for (const LinkBatch &batch : link_batches) {
+		if (!batch.parallel) {
+			for (uint32_t i = batch.begin; i < batch.end; i++) {
+				_solve_link(links[i], kst);
 			}
+			continue;
 		}
+
+		LinkSolveData solve_data;
+		solve_data.begin = batch.begin;
+		solve_data.end = batch.end;
+		solve_data.kst = kst;
+		_process_chunks(&GodotSoftBody3D::_solve_links_chunk, &solve_data, batch.end - batch.begin);
 	}
 }
 
@@ -1223,6 +1331,10 @@ void GodotSoftBody3D::destroy() {
 	links.clear();
 	faces.clear();
 
+	link_batches.clear();
+	node_face_offsets.clear();
+	node_faces.clear();
+
 	bounds = AABB();
 	deinitialize_shape();
 }
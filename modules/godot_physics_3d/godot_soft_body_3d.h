@@ -73,15 +73,45 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 		Vector3 centroid;
 		Node *n[3] = { nullptr, nullptr, nullptr }; // Node pointers
 		Vector3 normal; // Normal
+		Vector3 weighted_normal; // Unnormalized normal, proportional to area
 		real_t ra = 0.0; // Rest area
 		DynamicBVH::ID leaf; // Leaf data
 		uint32_t index = 0;
 	};
 
+	// Links of a batch never share a node, so they can be solved in parallel.
+	struct LinkBatch {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		bool parallel = true;
+	};
+
+	struct LinkSolveData {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		real_t kst = 1.0;
+	};
+
+	struct IntegrateData {
+		real_t delta = 0.0;
+		real_t clamp_delta_v = 0.0;
+	};
+
+	enum {
+		LINK_COLOR_MAX = 64,
+		PARALLEL_CHUNK_SIZE = 256,
+	};
+
 	LocalVector<Node> nodes;
-	LocalVector<Link> links;
+	LocalVector<Link> links; // Sorted by batch.
 	LocalVector<Face> faces;
 
+	LocalVector<LinkBatch> link_batches;
+
+	// Faces using each node, indexed by node_face_offsets.
+	LocalVector<uint32_t> node_face_offsets;
+	LocalVector<uint32_t> node_faces;
+
 	DynamicBVH node_tree;
 	DynamicBVH face_tree;
 
@@ -95,6 +125,7 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 	real_t inv_total_mass = 1.0;
 
 	int iteration_count = 5;
+	bool link_coloring = true;
 	real_t linear_stiffness = 0.5; // [0,1]
 	real_t pressure_coefficient = 0.0; // [-inf,+inf]
 	real_t damping_coefficient = 0.01; // [0,1]
@@ -179,6 +210,10 @@ public:
 	void get_face_points(uint32_t p_face_index, Vector3 &r_point_1, Vector3 &r_point_2, Vector3 &r_point_3) const;
 	Vector3 get_face_normal(uint32_t p_face_index) const;
 
+	// When disabled, links are solved serially in creation order. Rebuilds the body from its mesh.
+	void set_link_coloring_enabled(bool p_enabled);
+	_FORCE_INLINE_ bool is_link_coloring_enabled() const { return link_coloring; }
+
 	void set_iteration_count(int p_val);
 	_FORCE_INLINE_ real_t get_iteration_count() const { return iteration_count; }
 
@@ -233,12 +268,25 @@ private:
 
 	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
-	void reoptimize_link_order();
+	void build_link_batches();
+	void build_node_faces();
 	void append_link(uint32_t p_node1, uint32_t p_node2);
 	void append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_node3);
 
 	void solve_links(real_t kst, real_t ti);
 
+	template <typename M, typename U>
+	void _process_chunks(M p_method, U p_userdata, uint32_t p_element_count);
+
+	_FORCE_INLINE_ void _solve_link(Link &p_link, real_t p_kst);
+	void _solve_links_chunk(uint32_t p_chunk, const LinkSolveData *p_data);
+	void _prepare_links_chunk(uint32_t p_chunk, void *p_userdata);
+	void _integrate_nodes_chunk(uint32_t p_chunk, const IntegrateData *p_data);
+	void _predict_positions_chunk(uint32_t p_chunk, const IntegrateData *p_data);
+	void _update_velocities_chunk(uint32_t p_chunk, const IntegrateData *p_data);
+	void _update_face_normals_chunk(uint32_t p_chunk, void *p_userdata);
+	void _update_node_normals_chunk(uint32_t p_chunk, void *p_userdata);
+
 	void initialize_face_tree();
 	void update_face_tree(real_t p_delta);
 
@@ -0,0 +1,246 @@
+/**************************************************************************/
+/*  test_godot_physics_server_3d_motion_batch.h                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_PHYSICS_SERVER_3D_MOTION_BATCH_H
+#define TEST_GODOT_PHYSICS_SERVER_3D_MOTION_BATCH_H
+
+#include "../godot_physics_server_3d.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotPhysicsServer3DMotionBatch {
+
+struct CrowdScene {
+	PhysicsServer3D *ps = nullptr;
+	RID space;
+	RID floor_shape;
+	RID pillar_shape;
+	RID body_shape;
+	RID floor;
+	Vector<RID> pillars;
+	Vector<RID> bodies;
+
+	// A floor with a grid of pillars, and capsule-sized boxes standing between them.
+	// Every third body starts inside a pillar, so recovery is part of the motion test.
+	CrowdScene(int p_body_count) {
+		ps = PhysicsServer3D::get_singleton();
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+
+		floor_shape = ps->box_shape_create();
+		ps->shape_set_data(floor_shape, Vector3(1000, 1, 1000));
+		floor = ps->body_create();
+		ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+		ps->body_add_shape(floor, floor_shape);
+		ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+		ps->body_set_space(floor, space);
+
+		int row = MAX(1, int(Math::ceil(Math::sqrt(real_t(p_body_count)))));
+
+		pillar_shape = ps->box_shape_create();
+		ps->shape_set_data(pillar_shape, Vector3(0.5, 2, 0.5));
+		for (int i = 0; i < row * row; i += 3) {
+			RID pillar = ps->body_create();
+			ps->body_set_mode(pillar, PhysicsServer3D::BODY_MODE_STATIC);
+			ps->body_add_shape(pillar, pillar_shape);
+			ps->body_set_state(pillar, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3((i % row) * 4.0, 2, (i / row) * 4.0)));
+			ps->body_set_space(pillar, space);
+			pillars.push_back(pillar);
+		}
+
+		body_shape = ps->box_shape_create();
+		ps->shape_set_data(body_shape, Vector3(0.4, 0.9, 0.4));
+		for (int i = 0; i < p_body_count; i++) {
+			RID body = ps->body_create();
+			ps->body_set_mode(body, PhysicsServer3D::BODY_MODE_KINEMATIC);
+			ps->body_add_shape(body, body_shape);
+			// Bodies with (i % 3 == 0) overlap the pillar at their cell, the others stand next to it.
+			Vector3 offset = (i % 3 == 0) ? Vector3(0.6, 0, 0.1) : Vector3(1.5 + 0.1 * (i % 5), 0, 1.2);
+			ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3((i % row) * 4.0, 0.9, (i / row) * 4.0) + offset));
+			ps->body_set_space(body, space);
+			bodies.push_back(body);
+		}
+
+		ps->step(1.0 / 60.0);
+		ps->flush_queries();
+	}
+
+	~CrowdScene() {
+		for (const RID &body : bodies) {
+			ps->free(body);
+		}
+		for (const RID &pillar : pillars) {
+			ps->free(pillar);
+		}
+		ps->free(floor);
+		ps->free(body_shape);
+		ps->free(pillar_shape);
+		ps->free(floor_shape);
+		ps->free(space);
+	}
+
+	LocalVector<PhysicsServer3D::MotionParameters> make_parameters() const {
+		LocalVector<PhysicsServer3D::MotionParameters> parameters;
+		for (int i = 0; i < bodies.size(); i++) {
+			Transform3D from = ps->body_get_state(bodies[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+			// Alternate between walking into the pillars, walking away from them and falling onto the floor.
+			Vector3 motion;
+			switch (i % 4) {
+				case 0:
+					motion = Vector3(-2, 0, 0);
+					break;
+				case 1:
+					motion = Vector3(0.5, 0, 0.5);
+					break;
+				case 2:
+					motion = Vector3(-1.5, -0.5, -1.2);
+					break;
+				default:
+					motion = Vector3(0, -1, 0);
+					break;
+			}
+			PhysicsServer3D::MotionParameters p(from, motion);
+			p.max_collisions = 6;
+			p.recovery_as_collision = true;
+			parameters.push_back(p);
+		}
+		return parameters;
+	}
+};
+
+bool results_match(const PhysicsServer3D::MotionResult &p_a, const PhysicsServer3D::MotionResult &p_b) {
+	if (p_a.travel != p_b.travel || p_a.remainder != p_b.remainder || p_a.collision_depth != p_b.collision_depth ||
+			p_a.collision_safe_fraction != p_b.collision_safe_fraction || p_a.collision_unsafe_fraction != p_b.collision_unsafe_fraction ||
+			p_a.collision_count != p_b.collision_count) {
+		return false;
+	}
+	for (int i = 0; i < p_a.collision_count; i++) {
+		const PhysicsServer3D::MotionCollision &a = p_a.collisions[i];
+		const PhysicsServer3D::MotionCollision &b = p_b.collisions[i];
+		if (a.position != b.position || a.normal != b.normal || a.depth != b.depth || a.local_shape != b.local_shape ||
+				a.collider != b.collider || a.collider_id != b.collider_id || a.collider_shape != b.collider_shape) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[SceneTree][Physics][GodotPhysicsServer3D] Batched motion tests match single motion tests") {
+	REQUIRE_MESSAGE(Object::cast_to<GodotPhysicsServer3D>(PhysicsServer3D::get_singleton()), "The test needs GodotPhysics3D as the physics server.");
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+
+	CrowdScene scene(48);
+	LocalVector<PhysicsServer3D::MotionParameters> parameters = scene.make_parameters();
+	const int count = scene.bodies.size();
+
+	LocalVector<PhysicsServer3D::MotionResult> single_results;
+	LocalVector<bool> single_collided;
+	single_results.resize(count);
+	single_collided.resize(count);
+	for (int i = 0; i < count; i++) {
+		single_collided[i] = ps->body_test_motion(scene.bodies[i], parameters[i], &single_results[i]);
+	}
+
+	LocalVector<PhysicsServer3D::MotionResult> batch_results;
+	LocalVector<bool> batch_collided;
+	batch_results.resize(count);
+	batch_collided.resize(count);
+	ps->body_test_motion_batch(scene.bodies.ptr(), parameters.ptr(), batch_results.ptr(), batch_collided.ptr(), count);
+
+	int overlapping_collisions = 0;
+	int free_motions = 0;
+	int mismatches = 0;
+	for (int i = 0; i < count; i++) {
+		if (i % 3 == 0 && single_collided[i]) {
+			overlapping_collisions++;
+		}
+		if (!single_collided[i]) {
+			free_motions++;
+		}
+		if (batch_collided[i] != single_collided[i] || !results_match(batch_results[i], single_results[i])) {
+			mismatches++;
+		}
+	}
+
+	// Make sure the scene covers both bodies starting inside a pillar and bodies moving freely.
+	CHECK(overlapping_collisions > 0);
+	CHECK(free_motions > 0);
+	CHECK_MESSAGE(mismatches == 0, "Every batched result should be identical to the result of body_test_motion().");
+
+	SUBCASE("Invalid bodies only fail their own entry") {
+		RID invalid_bodies[3] = { scene.bodies[0], RID(), scene.bodies[1] };
+		PhysicsServer3D::MotionResult results[3];
+		bool collided[3] = { false, true, false };
+		ERR_PRINT_OFF;
+		ps->body_test_motion_batch(invalid_bodies, parameters.ptr(), results, collided, 3);
+		ERR_PRINT_ON;
+		CHECK(collided[0] == single_collided[0]);
+		CHECK(results_match(results[0], single_results[0]));
+		CHECK_FALSE(collided[1]);
+		CHECK(results[1].collision_count == 0);
+	}
+}
+
+TEST_CASE("[Stress][SceneTree][Physics][GodotPhysicsServer3D] Motion tests for a crowd of 2000 bodies") {
+	REQUIRE_MESSAGE(Object::cast_to<GodotPhysicsServer3D>(PhysicsServer3D::get_singleton()), "The test needs GodotPhysics3D as the physics server.");
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+
+	CrowdScene scene(2000);
+	LocalVector<PhysicsServer3D::MotionParameters> parameters = scene.make_parameters();
+	const int count = scene.bodies.size();
+	const int frames = 20;
+
+	LocalVector<PhysicsServer3D::MotionResult> results;
+	LocalVector<bool> collided;
+	results.resize(count);
+	collided.resize(count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < frames; frame++) {
+		for (int i = 0; i < count; i++) {
+			collided[i] = ps->body_test_motion(scene.bodies[i], parameters[i], &results[i]);
+		}
+	}
+	uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < frames; frame++) {
+		ps->body_test_motion_batch(scene.bodies.ptr(), parameters.ptr(), results.ptr(), collided.ptr(), count);
+	}
+	uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("Motion tests for ", count, " bodies: ", single_usec / frames, " usec per frame one by one, ", batch_usec / frames, " usec per frame batched.");
+}
+
+} // namespace TestGodotPhysicsServer3DMotionBatch
+
+#endif // TEST_GODOT_PHYSICS_SERVER_3D_MOTION_BATCH_H
@@ -0,0 +1,187 @@
+/**************************************************************************/
+/*  test_godot_quantized_bvh_3d.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#ifndef TEST_GODOT_QUANTIZED_BVH_3D_H
+#define TEST_GODOT_QUANTIZED_BVH_3D_H
+
+#include "../godot_quantized_bvh_3d.h"
+
+#include "core/math/random_pcg.h"
+#include "core/templates/hash_set.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotQuantizedBVH3D {
+
+struct ItemCollector {
+	HashSet<uint32_t> items;
+
+	bool operator()(uint32_t p_item) {
+		items.insert(p_item);
+		return false;
+	}
+};
+
+static LocalVector<AABB> make_random_aabbs(uint32_t p_count, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	LocalVector<AABB> aabbs;
+	aabbs.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		Vector3 position(rng.random(-100.0f, 100.0f), rng.random(-100.0f, 100.0f), rng.random(-100.0f, 100.0f));
+		Vector3 size(rng.random(0.0f, 5.0f), rng.random(0.0f, 5.0f), rng.random(0.0f, 5.0f));
+		aabbs[i] = AABB(position, size);
+	}
+	// A flat item, like an axis-aligned floor triangle.
+	aabbs[0].size.y = 0.0;
+	return aabbs;
+}
+
+TEST_CASE("[Physics][GodotQuantizedBVH3D] Empty tree") {
+	GodotQuantizedBVH3D bvh;
+	CHECK(bvh.is_empty());
+
+	ItemCollector collector;
+	CHECK_FALSE(bvh.cull_aabb(AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2)), collector));
+	CHECK_FALSE(bvh.cull_segment(Vector3(-1, 0, 0), Vector3(1, 0, 0), collector));
+	CHECK(collector.items.is_empty());
+
+	LocalVector<AABB> aabbs = make_random_aabbs(16, 1);
+	bvh.build(aabbs.ptr(), aabbs.size());
+	CHECK_FALSE(bvh.is_empty());
+	CHECK(bvh.get_memory_usage() > 0);
+
+	bvh.clear();
+	CHECK(bvh.is_empty());
+}
+
+TEST_CASE("[Physics][GodotQuantizedBVH3D] AABB queries report every overlapping item") {
+	LocalVector<AABB> aabbs = make_random_aabbs(2000, 2);
+	GodotQuantizedBVH3D bvh;
+	bvh.build(aabbs.ptr(), aabbs.size());
+
+	RandomPCG rng(3);
+	uint32_t misses = 0;
+	uint32_t false_items = 0;
+	for (int query = 0; query < 200; query++) {
+		Vector3 position(rng.random(-110.0f, 110.0f), rng.random(-110.0f, 110.0f), rng.random(-110.0f, 110.0f));
+		Vector3 size(rng.random(0.0f, 20.0f), rng.random(0.0f, 20.0f), rng.random(0.0f, 20.0f));
+		AABB query_aabb(position, size);
+
+		ItemCollector collector;
+		bvh.cull_aabb(query_aabb, collector);
+
+		for (uint32_t i = 0; i < aabbs.size(); i++) {
+			if (aabbs[i].intersects_inclusive(query_aabb) && !collector.items.has(i)) {
+				misses++;
+			}
+		}
+		for (const uint32_t &item : collector.items) {
+			if (item >= aabbs.size()) {
+				false_items++;
+			}
+		}
+	}
+	CHECK_MESSAGE(misses == 0, "The quantized bounds should always be conservative.");
+	CHECK(false_items == 0);
+}
+
+TEST_CASE("[Physics][GodotQuantizedBVH3D] AABB queries far from the origin miss no pair") {
+	// Around 1e5 units an ulp is large compared to the quantization steps of
+	// small nodes, so any rounding inward would drop touching pairs.
+	RandomPCG rng(7);
+	LocalVector<AABB> aabbs;
+	aabbs.resize(2000);
+	for (uint32_t i = 0; i < aabbs.size(); i++) {
+		Vector3 position(rng.random(99950.0f, 100050.0f), rng.random(-100050.0f, -99950.0f), rng.random(99950.0f, 100050.0f));
+		Vector3 size(rng.random(0.0f, 2.0f), rng.random(0.0f, 2.0f), rng.random(0.0f, 2.0f));
+		aabbs[i] = AABB(position, size);
+	}
+	GodotQuantizedBVH3D bvh;
+	bvh.build(aabbs.ptr(), aabbs.size());
+
+	// Every item queried with its own bounds must report every item it overlaps.
+	uint32_t misses = 0;
+	for (uint32_t i = 0; i < aabbs.size(); i++) {
+		ItemCollector collector;
+		bvh.cull_aabb(aabbs[i], collector);
+		for (uint32_t j = 0; j < aabbs.size(); j++) {
+			if (aabbs[i].intersects_inclusive(aabbs[j]) && !collector.items.has(j)) {
+				misses++;
+			}
+		}
+	}
+	CHECK_MESSAGE(misses == 0, "The quantized bounds should stay conservative far from the origin.");
+}
+
+TEST_CASE("[Physics][GodotQuantizedBVH3D] Segment queries report every crossed item") {
+	LocalVector<AABB> aabbs = make_random_aabbs(2000, 4);
+	GodotQuantizedBVH3D bvh;
+	bvh.build(aabbs.ptr(), aabbs.size());
+
+	RandomPCG rng(5);
+	uint32_t misses = 0;
+	for (int query = 0; query < 200; query++) {
+		Vector3 from(rng.random(-110.0f, 110.0f), rng.random(-110.0f, 110.0f), rng.random(-110.0f, 110.0f));
+		Vector3 to(rng.random(-110.0f, 110.0f), rng.random(-110.0f, 110.0f), rng.random(-110.0f, 110.0f));
+		if (query % 4 == 0) {
+			// Axis-aligned rays take the parallel slab path.
+			to = Vector3(from.x, to.y, from.z);
+		}
+
+		ItemCollector collector;
+		bvh.cull_segment(from, to, collector);
+
+		for (uint32_t i = 0; i < aabbs.size(); i++) {
+			if (aabbs[i].intersects_segment(from, to) && !collector.items.has(i)) {
+				misses++;
+			}
+		}
+	}
+	CHECK_MESSAGE(misses == 0, "The quantized bounds should always be conservative.");
+}
+
+TEST_CASE("[Physics][GodotQuantizedBVH3D] Queries stop when the callback returns true") {
+	LocalVector<AABB> aabbs = make_random_aabbs(500, 6);
+	GodotQuantizedBVH3D bvh;
+	bvh.build(aabbs.ptr(), aabbs.size());
+
+	uint32_t visited = 0;
+	auto stop_at_first = [&visited](uint32_t p_item) {
+		visited++;
+		return true;
+	};
+	CHECK(bvh.cull_aabb(AABB(Vector3(-200, -200, -200), Vector3(400, 400, 400)), stop_at_first));
+	CHECK(visited == 1);
+}
+
+} // namespace TestGodotQuantizedBVH3D
+
+#endif // TEST_GODOT_QUANTIZED_BVH_3D_H
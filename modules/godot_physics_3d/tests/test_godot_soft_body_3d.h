@@ -0,0 +1,172 @@
+/**************************************************************************/
+/*  test_godot_soft_body_3d.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SOFT_BODY_3D_H
+#define TEST_GODOT_SOFT_BODY_3D_H
+
+#include "../godot_area_3d.h"
+#include "../godot_physics_server_3d.h"
+#include "../godot_soft_body_3d.h"
+#include "../godot_space_3d.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotSoftBody3D {
+
+// A square cloth of p_resolution x p_resolution vertices, hanging from its first row.
+struct HangingCloth {
+	RID mesh;
+	GodotSpace3D *space = nullptr;
+	GodotArea3D *area = nullptr;
+	GodotSoftBody3D *body = nullptr;
+
+	HangingCloth(int p_resolution, real_t p_size, bool p_link_coloring) {
+		Vector<Vector3> vertices;
+		Vector<int> indices;
+		for (int y = 0; y < p_resolution; y++) {
+			for (int x = 0; x < p_resolution; x++) {
+				vertices.push_back(Vector3(x, 0, y) * (p_size / (p_resolution - 1)));
+			}
+		}
+		for (int y = 0; y < p_resolution - 1; y++) {
+			for (int x = 0; x < p_resolution - 1; x++) {
+				const int i = y * p_resolution + x;
+				indices.push_back(i);
+				indices.push_back(i + 1);
+				indices.push_back(i + p_resolution);
+				indices.push_back(i + 1);
+				indices.push_back(i + p_resolution + 1);
+				indices.push_back(i + p_resolution);
+			}
+		}
+
+		Array arrays;
+		arrays.resize(RS::ARRAY_MAX);
+		arrays[RS::ARRAY_VERTEX] = vertices;
+		arrays[RS::ARRAY_INDEX] = indices;
+		mesh = RenderingServer::get_singleton()->mesh_create();
+		RenderingServer::get_singleton()->mesh_add_surface_from_arrays(mesh, RS::PRIMITIVE_TRIANGLES, arrays);
+
+		space = memnew(GodotSpace3D);
+		area = memnew(GodotArea3D);
+		space->set_default_area(area);
+		area->set_space(space);
+
+		body = memnew(GodotSoftBody3D);
+		body->set_link_coloring_enabled(p_link_coloring);
+		body->set_iteration_count(10);
+		body->set_damping_coefficient(0.2);
+		body->set_mesh(mesh);
+		for (int x = 0; x < p_resolution; x++) {
+			body->pin_vertex(x);
+		}
+		body->set_space(space);
+	}
+
+	~HangingCloth() {
+		body->set_space(nullptr);
+		memdelete(body);
+		area->set_space(nullptr);
+		memdelete(area);
+		memdelete(space);
+		RenderingServer::get_singleton()->free(mesh);
+	}
+
+	void step(int p_steps) {
+		const real_t delta = 1.0 / 60.0;
+		for (int i = 0; i < p_steps; i++) {
+			body->predict_motion(delta);
+			body->solve_constraints(delta);
+		}
+	}
+};
+
+TEST_CASE("[SceneTree][Physics][GodotSoftBody3D] Colored and serial link solves settle in the same place") {
+	REQUIRE_MESSAGE(Object::cast_to<GodotPhysicsServer3D>(PhysicsServer3D::get_singleton()), "The test needs GodotPhysics3D as the physics server.");
+
+	// Large enough for the color batches to be split across threads.
+	const int resolution = 48;
+	const real_t size = 4.0;
+	HangingCloth serial(resolution, size, false);
+	HangingCloth colored(resolution, size, true);
+
+	CHECK_FALSE(serial.body->is_link_coloring_enabled());
+	CHECK(colored.body->is_link_coloring_enabled());
+	REQUIRE(serial.body->get_node_count() == colored.body->get_node_count());
+
+	serial.step(600);
+	colored.step(600);
+
+	// Both solvers use the same links, only the order they are relaxed in differs,
+	// so the settled cloths may differ slightly but must not drift apart.
+	real_t max_distance = 0.0;
+	real_t total_distance = 0.0;
+	real_t lowest = 0.0;
+	for (uint32_t i = 0; i < colored.body->get_node_count(); i++) {
+		const Vector3 serial_position = serial.body->get_node_position(i);
+		const real_t distance = serial_position.distance_to(colored.body->get_node_position(i));
+		max_distance = MAX(max_distance, distance);
+		total_distance += distance;
+		lowest = MIN(lowest, serial_position.y);
+	}
+
+	CHECK_MESSAGE(lowest < -size * 0.5, "The cloth should hang down from the pinned row.");
+	CHECK_MESSAGE(max_distance < size * 0.025, "No node of the colored solve should settle far from the serial solve.");
+	CHECK_MESSAGE(total_distance / colored.body->get_node_count() < size * 0.005, "The colored solve should settle close to the serial solve on average.");
+
+	for (int x = 0; x < resolution; x++) {
+		CHECK(colored.body->get_node_position(x).is_equal_approx(serial.body->get_node_position(x)));
+	}
+}
+
+TEST_CASE("[Stress][SceneTree][Physics][GodotSoftBody3D] Solving a 128x128 cloth") {
+	REQUIRE_MESSAGE(Object::cast_to<GodotPhysicsServer3D>(PhysicsServer3D::get_singleton()), "The test needs GodotPhysics3D as the physics server.");
+
+	const int resolution = 128;
+	const int steps = 60;
+	HangingCloth serial(resolution, 10.0, false);
+	HangingCloth colored(resolution, 10.0, true);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	serial.step(steps);
+	uint64_t serial_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	colored.step(steps);
+	uint64_t colored_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE("Cloth with ", colored.body->get_node_count(), " nodes: ", serial_usec / steps, " usec per step serial, ", colored_usec / steps, " usec per step colored.");
+}
+
+} // namespace TestGodotSoftBody3D
+
+#endif // TEST_GODOT_SOFT_BODY_3D_H
@@ -0,0 +1,201 @@
+/**************************************************************************/
+/*  test_godot_space_3d_state.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SPACE_3D_STATE_H
+#define TEST_GODOT_SPACE_3D_STATE_H
+
+#include "../godot_physics_server_3d.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotSpace3DState {
+
+struct BodySnapshot {
+	Transform3D transform;
+	Vector3 linear_velocity;
+	Vector3 angular_velocity;
+};
+
+struct BoxScene {
+	PhysicsServer3D *ps = nullptr;
+	RID space;
+	RID floor_shape;
+	RID box_shape;
+	RID floor;
+	Vector<RID> boxes;
+
+	// Boxes dropped on a static floor, spaced so each one only ever touches the floor.
+	BoxScene(int p_box_count, real_t p_spacing = 3.0) {
+		ps = PhysicsServer3D::get_singleton();
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+		ps->area_set_param(space, PhysicsServer3D::AREA_PARAM_GRAVITY, 9.8);
+		ps->area_set_param(space, PhysicsServer3D::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+
+		floor_shape = ps->box_shape_create();
+		ps->shape_set_data(floor_shape, Vector3(1000, 1, 1000));
+		floor = ps->body_create();
+		ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+		ps->body_add_shape(floor, floor_shape);
+		ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+		ps->body_set_space(floor, space);
+
+		box_shape = ps->box_shape_create();
+		ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+		int row = MAX(1, int(Math::sqrt(real_t(p_box_count))));
+		for (int i = 0; i < p_box_count; i++) {
+			RID box = ps->body_create();
+			ps->body_set_mode(box, PhysicsServer3D::BODY_MODE_RIGID);
+			ps->body_add_shape(box, box_shape);
+			Basis basis = Basis::from_euler(Vector3(0.3 * (i % 5), 0.7 * (i % 3), 0.2 * (i % 4)));
+			Vector3 origin((i % row) * p_spacing, 0.6 + 0.25 * (i % 7), (i / row) * p_spacing);
+			ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(basis, origin));
+			ps->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(0.1 * (i % 3), 0, -0.1 * (i % 2)));
+			ps->body_set_space(box, space);
+			boxes.push_back(box);
+		}
+	}
+
+	~BoxScene() {
+		for (const RID &box : boxes) {
+			ps->free(box);
+		}
+		ps->free(floor);
+		ps->free(box_shape);
+		ps->free(floor_shape);
+		ps->free(space);
+	}
+
+	void step(int p_steps) {
+		for (int i = 0; i < p_steps; i++) {
+			ps->step(1.0 / 60.0);
+			ps->flush_queries();
+		}
+	}
+
+	LocalVector<BodySnapshot> snapshot() const {
+		LocalVector<BodySnapshot> result;
+		for (const RID &box : boxes) {
+			BodySnapshot body;
+			body.transform = ps->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+			body.linear_velocity = ps->body_get_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+			body.angular_velocity = ps->body_get_state(box, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+			result.push_back(body);
+		}
+		return result;
+	}
+};
+
+TEST_CASE("[SceneTree][Physics][GodotSpace3D] Restoring a saved state replays the same steps") {
+	REQUIRE_MESSAGE(Object::cast_to<GodotPhysicsServer3D>(PhysicsServer3D::get_singleton()), "The test needs GodotPhysics3D as the physics server.");
+
+	BoxScene scene(16);
+	// Let the boxes land, so the state includes contacts to warm start from.
+	scene.step(30);
+
+	PackedByteArray state = PhysicsServer3D::get_singleton()->space_save_state(scene.space);
+	REQUIRE_FALSE(state.is_empty());
+
+	const int steps = 60;
+	scene.step(steps);
+	LocalVector<BodySnapshot> expected = scene.snapshot();
+
+	SUBCASE("Bodies match bit for bit") {
+		REQUIRE(PhysicsServer3D::get_singleton()->space_restore_state(scene.space, state));
+		scene.step(steps);
+		LocalVector<BodySnapshot> replayed = scene.snapshot();
+
+		int mismatches = 0;
+		for (uint32_t i = 0; i < expected.size(); i++) {
+			// Exact comparison on purpose, a rollback is only useful if the replay is deterministic.
+			if (replayed[i].transform != expected[i].transform || replayed[i].linear_velocity != expected[i].linear_velocity || replayed[i].angular_velocity != expected[i].angular_velocity) {
+				mismatches++;
+			}
+		}
+		CHECK_MESSAGE(mismatches == 0, "Every body should end in exactly the same state after restoring and stepping again.");
+	}
+
+	SUBCASE("Restoring twice gives the same result") {
+		REQUIRE(PhysicsServer3D::get_singleton()->space_restore_state(scene.space, state));
+		scene.step(steps);
+		LocalVector<BodySnapshot> first = scene.snapshot();
+		REQUIRE(PhysicsServer3D::get_singleton()->space_restore_state(scene.space, state));
+		scene.step(steps);
+		LocalVector<BodySnapshot> second = scene.snapshot();
+
+		for (uint32_t i = 0; i < first.size(); i++) {
+			CHECK(first[i].transform == second[i].transform);
+		}
+	}
+
+	SUBCASE("Invalid states are rejected") {
+		ERR_PRINT_OFF;
+		CHECK_FALSE(PhysicsServer3D::get_singleton()->space_restore_state(scene.space, PackedByteArray()));
+		PackedByteArray truncated = state.slice(0, state.size() - 1);
+		CHECK_FALSE(PhysicsServer3D::get_singleton()->space_restore_state(scene.space, truncated));
+		ERR_PRINT_ON;
+		// A rejected state leaves the bodies alone.
+		LocalVector<BodySnapshot> after = scene.snapshot();
+		for (uint32_t i = 0; i < expected.size(); i++) {
+			CHECK(after[i].transform == expected[i].transform);
+		}
+	}
+}
+
+TEST_CASE("[Stress][SceneTree][Physics][GodotSpace3D] Saving and restoring 1000 bodies") {
+	REQUIRE_MESSAGE(Object::cast_to<GodotPhysicsServer3D>(PhysicsServer3D::get_singleton()), "The test needs GodotPhysics3D as the physics server.");
+
+	BoxScene scene(1000);
+	scene.step(30);
+
+	const int cycles = 100;
+	PackedByteArray state;
+	uint64_t save_usec = 0;
+	uint64_t restore_usec = 0;
+	bool restored = true;
+	for (int i = 0; i < cycles; i++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		state = PhysicsServer3D::get_singleton()->space_save_state(scene.space);
+		uint64_t middle = OS::get_singleton()->get_ticks_usec();
+		restored = PhysicsServer3D::get_singleton()->space_restore_state(scene.space, state) && restored;
+		uint64_t end = OS::get_singleton()->get_ticks_usec();
+		save_usec += middle - begin;
+		restore_usec += end - middle;
+	}
+
+	CHECK(restored);
+	MESSAGE("Saved ", state.size(), " bytes for 1000 bodies in ", save_usec / cycles, " usec and restored them in ", restore_usec / cycles, " usec on average.");
+}
+
+} // namespace TestGodotSpace3DState
+
+#endif // TEST_GODOT_SPACE_3D_STATE_H
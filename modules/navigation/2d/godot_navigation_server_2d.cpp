@@ -177,9 +177,15 @@ void GodotNavigationServer2D::sync() {
 		navmesh_generator_2d->sync();
 	}
 #endif // CLIPPER2_ENABLED
+
+	_sync_path_query_batch_requests();
 }
 
 void GodotNavigationServer2D::finish() {
+	{
+		MutexLock lock(path_query_batch_mutex);
+		path_query_batch_requests.clear();
+	}
 #ifdef CLIPPER2_ENABLED
 	if (navmesh_generator_2d) {
 		navmesh_generator_2d->finish();
@@ -456,6 +462,36 @@ Vector<Vector2> GodotNavigationServer2D::obstacle_get_vertices(RID p_obstacle) c
 	return vector_v3_to_v2(NavigationServer3D::get_singleton()->obstacle_get_vertices(p_obstacle));
 }
 
+RID GodotNavigationServer2D::flow_field_create() {
+	RID flow_field = NavigationServer3D::get_singleton()->flow_field_create();
+	return flow_field;
+}
+
+void FORWARD_2(flow_field_set_map, RID, p_flow_field, RID, p_map, rid_to_rid, rid_to_rid);
+RID FORWARD_1_C(flow_field_get_map, RID, p_flow_field, rid_to_rid);
+void FORWARD_2(flow_field_set_navigation_layers, RID, p_flow_field, uint32_t, p_navigation_layers, rid_to_rid, uint32_to_uint32);
+uint32_t FORWARD_1_C(flow_field_get_navigation_layers, RID, p_flow_field, rid_to_rid);
+
+void GodotNavigationServer2D::flow_field_set_targets(RID p_flow_field, const Vector<Vector2> &p_targets) {
+	NavigationServer3D::get_singleton()->flow_field_set_targets(p_flow_field, vector_v2_to_v3(p_targets));
+}
+
+Vector<Vector2> GodotNavigationServer2D::flow_field_get_targets(RID p_flow_field) const {
+	return vector_v3_to_v2(NavigationServer3D::get_singleton()->flow_field_get_targets(p_flow_field));
+}
+
+Vector2 GodotNavigationServer2D::flow_field_get_direction(RID p_flow_field, const Vector2 &p_position) const {
+	return v3_to_v2(NavigationServer3D::get_singleton()->flow_field_get_direction(p_flow_field, v2_to_v3(p_position)));
+}
+
+real_t GodotNavigationServer2D::flow_field_get_distance(RID p_flow_field, const Vector2 &p_position) const {
+	return NavigationServer3D::get_singleton()->flow_field_get_distance(p_flow_field, v2_to_v3(p_position));
+}
+
+Vector<Vector2> GodotNavigationServer2D::flow_field_get_directions(RID p_flow_field, const Vector<Vector2> &p_positions) const {
+	return vector_v3_to_v2(NavigationServer3D::get_singleton()->flow_field_get_directions(p_flow_field, vector_v2_to_v3(p_positions)));
+}
+
 void GodotNavigationServer2D::query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const {
 	ERR_FAIL_COND(!p_query_parameters.is_valid());
 	ERR_FAIL_COND(!p_query_result.is_valid());
@@ -468,6 +504,85 @@ void GodotNavigationServer2D::query_path(const Ref<NavigationPathQueryParameters
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
 }
 
+uint32_t GodotNavigationServer2D::query_path_batch_async(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback) {
+	ERR_FAIL_COND_V_MSG(p_query_parameters.size() != p_query_results.size(), 0, "The path query batch needs one result object per parameters object.");
+
+	LocalVector<NavigationUtilities::PathQueryParameters> parameters;
+	parameters.resize(p_query_parameters.size());
+
+	PathQueryBatchRequest2D request;
+	request.query_results.resize(p_query_results.size());
+	request.callback = p_callback;
+
+	for (uint32_t i = 0; i < parameters.size(); i++) {
+		Ref<NavigationPathQueryParameters2D> query_parameters = p_query_parameters[i];
+		Ref<NavigationPathQueryResult2D> query_result = p_query_results[i];
+		ERR_FAIL_COND_V(!query_parameters.is_valid(), 0);
+		ERR_FAIL_COND_V(!query_result.is_valid(), 0);
+
+		parameters[i] = query_parameters->get_parameters();
+		request.query_results[i] = query_result;
+	}
+
+	request.batch_id = NavigationServer3D::get_singleton()->_query_path_batch_async(parameters);
+	if (request.batch_id == 0) {
+		return 0;
+	}
+
+	MutexLock lock(path_query_batch_mutex);
+	path_query_batch_requests.push_back(request);
+
+	return request.batch_id;
+}
+
+bool GodotNavigationServer2D::is_query_path_batch_completed(uint32_t p_batch_id) const {
+	MutexLock lock(path_query_batch_mutex);
+	for (const PathQueryBatchRequest2D &request : path_query_batch_requests) {
+		if (request.batch_id == p_batch_id) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void GodotNavigationServer2D::_sync_path_query_batch_requests() {
+	LocalVector<PathQueryBatchRequest2D> requests;
+	{
+		MutexLock lock(path_query_batch_mutex);
+		requests = path_query_batch_requests;
+	}
+
+	// Deliver outside of the lock, the callbacks may start new batches.
+	for (const PathQueryBatchRequest2D &request : requests) {
+		LocalVector<NavigationUtilities::PathQueryResult> results;
+		if (!NavigationServer3D::get_singleton()->_query_path_batch_get_results(request.batch_id, results)) {
+			continue;
+		}
+
+		for (uint32_t i = 0; i < results.size(); i++) {
+			const Ref<NavigationPathQueryResult2D> &query_result = request.query_results[i];
+			query_result->set_path(vector_v3_to_v2(results[i].path));
+			query_result->set_path_types(results[i].path_types);
+			query_result->set_path_rids(results[i].path_rids);
+			query_result->set_path_owner_ids(results[i].path_owner_ids);
+		}
+
+		{
+			MutexLock lock(path_query_batch_mutex);
+			for (uint32_t i = 0; i < path_query_batch_requests.size(); i++) {
+				if (path_query_batch_requests[i].batch_id == request.batch_id) {
+					path_query_batch_requests.remove_at(i);
+					break;
+				}
+			}
+		}
+
+		if (request.callback.is_valid()) {
+			request.callback.call();
+		}
+	}
+}
+
 RID GodotNavigationServer2D::source_geometry_parser_create() {
 #ifdef CLIPPER2_ENABLED
 	if (navmesh_generator_2d) {
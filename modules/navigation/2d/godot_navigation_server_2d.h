@@ -51,6 +51,18 @@ class GodotNavigationServer2D : public NavigationServer2D {
 	NavMeshGenerator2D *navmesh_generator_2d = nullptr;
 #endif // CLIPPER2_ENABLED
 
+	struct PathQueryBatchRequest2D {
+		uint32_t batch_id = 0;
+		LocalVector<Ref<NavigationPathQueryResult2D>> query_results;
+		Callable callback;
+	};
+
+	/// Batches started with `query_path_batch_async()` that wait for their results to be delivered.
+	mutable Mutex path_query_batch_mutex;
+	LocalVector<PathQueryBatchRequest2D> path_query_batch_requests;
+
+	void _sync_path_query_batch_requests();
+
 public:
 	GodotNavigationServer2D();
 	virtual ~GodotNavigationServer2D();
@@ -242,7 +254,20 @@ public:
 	virtual void obstacle_set_avoidance_layers(RID p_obstacle, uint32_t p_layers) override;
 	virtual uint32_t obstacle_get_avoidance_layers(RID p_obstacle) const override;
 
+	virtual RID flow_field_create() override;
+	virtual void flow_field_set_map(RID p_flow_field, RID p_map) override;
+	virtual RID flow_field_get_map(RID p_flow_field) const override;
+	virtual void flow_field_set_targets(RID p_flow_field, const Vector<Vector2> &p_targets) override;
+	virtual Vector<Vector2> flow_field_get_targets(RID p_flow_field) const override;
+	virtual void flow_field_set_navigation_layers(RID p_flow_field, uint32_t p_navigation_layers) override;
+	virtual uint32_t flow_field_get_navigation_layers(RID p_flow_field) const override;
+	virtual Vector2 flow_field_get_direction(RID p_flow_field, const Vector2 &p_position) const override;
+	virtual real_t flow_field_get_distance(RID p_flow_field, const Vector2 &p_position) const override;
+	virtual Vector<Vector2> flow_field_get_directions(RID p_flow_field, const Vector<Vector2> &p_positions) const override;
+
 	virtual void query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const override;
+	virtual uint32_t query_path_batch_async(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback = Callable()) override;
+	virtual bool is_query_path_batch_completed(uint32_t p_batch_id) const override;
 
 	virtual void init() override;
 	virtual void sync() override;
@@ -1129,6 +1129,107 @@ uint32_t GodotNavigationServer3D::obstacle_get_avoidance_layers(RID p_obstacle)
 	return obstacle->get_avoidance_layers();
 }
 
+RID GodotNavigationServer3D::flow_field_create() {
+	MutexLock lock(operations_mutex);
+
+	RID rid = flow_field_owner.make_rid();
+	NavFlowField *flow_field = flow_field_owner.get_or_null(rid);
+	flow_field->set_self(rid);
+	return rid;
+}
+
+COMMAND_2(flow_field_set_map, RID, p_flow_field, RID, p_map) {
+	NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL(flow_field);
+
+	NavMap *map = map_owner.get_or_null(p_map);
+
+	flow_field->set_map(map);
+}
+
+RID GodotNavigationServer3D::flow_field_get_map(RID p_flow_field) const {
+	const NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL_V(flow_field, RID());
+
+	if (flow_field->get_map()) {
+		return flow_field->get_map()->get_self();
+	}
+	return RID();
+}
+
+void GodotNavigationServer3D::flow_field_set_targets(RID p_flow_field, const Vector<Vector3> &p_targets) {
+	NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL(flow_field);
+
+	flow_field->set_targets(p_targets);
+}
+
+Vector<Vector3> GodotNavigationServer3D::flow_field_get_targets(RID p_flow_field) const {
+	const NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL_V(flow_field, Vector<Vector3>());
+
+	return flow_field->get_targets();
+}
+
+COMMAND_2(flow_field_set_navigation_layers, RID, p_flow_field, uint32_t, p_navigation_layers) {
+	NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL(flow_field);
+
+	flow_field->set_navigation_layers(p_navigation_layers);
+}
+
+uint32_t GodotNavigationServer3D::flow_field_get_navigation_layers(RID p_flow_field) const {
+	const NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL_V(flow_field, 0);
+
+	return flow_field->get_navigation_layers();
+}
+
+Vector3 GodotNavigationServer3D::flow_field_get_direction(RID p_flow_field, const Vector3 &p_position) const {
+	const NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL_V(flow_field, Vector3());
+	if (!flow_field->get_map()) {
+		return Vector3();
+	}
+
+	NavFlowField::Sample sample;
+	flow_field->get_map()->sample_flow_field(flow_field, &p_position, 1, &sample);
+	return sample.direction;
+}
+
+real_t GodotNavigationServer3D::flow_field_get_distance(RID p_flow_field, const Vector3 &p_position) const {
+	const NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL_V(flow_field, FLT_MAX);
+	if (!flow_field->get_map()) {
+		return FLT_MAX;
+	}
+
+	NavFlowField::Sample sample;
+	flow_field->get_map()->sample_flow_field(flow_field, &p_position, 1, &sample);
+	return sample.distance;
+}
+
+Vector<Vector3> GodotNavigationServer3D::flow_field_get_directions(RID p_flow_field, const Vector<Vector3> &p_positions) const {
+	const NavFlowField *flow_field = flow_field_owner.get_or_null(p_flow_field);
+	ERR_FAIL_NULL_V(flow_field, Vector<Vector3>());
+
+	Vector<Vector3> directions;
+	directions.resize(p_positions.size());
+	if (!flow_field->get_map()) {
+		return directions;
+	}
+
+	LocalVector<NavFlowField::Sample> samples;
+	samples.resize(p_positions.size());
+	flow_field->get_map()->sample_flow_field(flow_field, p_positions.ptr(), p_positions.size(), samples.ptr());
+
+	Vector3 *directions_ptrw = directions.ptrw();
+	for (uint32_t i = 0; i < samples.size(); i++) {
+		directions_ptrw[i] = samples[i].direction;
+	}
+	return directions;
+}
+
 void GodotNavigationServer3D::parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback) {
 #ifndef _3D_DISABLED
 	ERR_FAIL_COND_MSG(!Thread::is_main_thread(), "The SceneTree can only be parsed on the main thread. Call this function from the main thread or use call_deferred().");
@@ -1173,6 +1274,9 @@ COMMAND_1(free, RID, p_object) {
 	if (map_owner.owns(p_object)) {
 		NavMap *map = map_owner.get_or_null(p_object);
 
+		// Running path query batches can still read from the map.
+		_wait_for_path_query_batches();
+
 		// Removes any assigned region
 		for (NavRegion *region : map->get_regions()) {
 			map->remove_region(region);
@@ -1197,6 +1301,12 @@ COMMAND_1(free, RID, p_object) {
 			obstacle->set_map(nullptr);
 		}
 
+		// Remove any assigned flow fields
+		const LocalVector<NavFlowField *> flow_fields = map->get_flow_fields();
+		for (NavFlowField *flow_field : flow_fields) {
+			flow_field->set_map(nullptr);
+		}
+
 		int map_index = active_maps.find(map);
 		if (map_index >= 0) {
 			active_maps.remove_at(map_index);
@@ -1207,6 +1317,9 @@ COMMAND_1(free, RID, p_object) {
 	} else if (region_owner.owns(p_object)) {
 		NavRegion *region = region_owner.get_or_null(p_object);
 
+		// Running path query batches can still read the region through the map polygons.
+		_wait_for_path_query_batches();
+
 		// Removes this region from the map if assigned
 		if (region->get_map() != nullptr) {
 			region->get_map()->remove_region(region);
@@ -1218,6 +1331,9 @@ COMMAND_1(free, RID, p_object) {
 	} else if (link_owner.owns(p_object)) {
 		NavLink *link = link_owner.get_or_null(p_object);
 
+		// Running path query batches can still read the link through the map polygons.
+		_wait_for_path_query_batches();
+
 		// Removes this link from the map if assigned
 		if (link->get_map() != nullptr) {
 			link->get_map()->remove_link(link);
@@ -1232,6 +1348,16 @@ COMMAND_1(free, RID, p_object) {
 	} else if (obstacle_owner.owns(p_object)) {
 		internal_free_obstacle(p_object);
 
+	} else if (flow_field_owner.owns(p_object)) {
+		NavFlowField *flow_field = flow_field_owner.get_or_null(p_object);
+
+		// Removes this flow field from the map if assigned
+		if (flow_field->get_map() != nullptr) {
+			flow_field->set_map(nullptr);
+		}
+
+		flow_field_owner.free(p_object);
+
 #ifndef _3D_DISABLED
 	} else if (navmesh_generator_3d && navmesh_generator_3d->owns(p_object)) {
 		navmesh_generator_3d->free(p_object);
@@ -1311,6 +1437,8 @@ void GodotNavigationServer3D::sync() {
 		navmesh_generator_3d->sync();
 	}
 #endif // _3D_DISABLED
+
+	_sync_path_query_batch_requests();
 }
 
 void GodotNavigationServer3D::process(real_t p_delta_time) {
@@ -1375,6 +1503,7 @@ void GodotNavigationServer3D::init() {
 
 void GodotNavigationServer3D::finish() {
 	flush_queries();
+	_free_path_query_batches();
 #ifndef _3D_DISABLED
 	if (navmesh_generator_3d) {
 		navmesh_generator_3d->finish();
@@ -1385,33 +1514,41 @@ void GodotNavigationServer3D::finish() {
 }
 
 PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &p_parameters) const {
-	PathQueryResult r_query_result;
-
 	const NavMap *map = map_owner.get_or_null(p_parameters.map);
-	ERR_FAIL_NULL_V(map, r_query_result);
+	ERR_FAIL_NULL_V(map, PathQueryResult());
+
+	return _map_query_path(map, p_parameters);
+}
+
+PathQueryResult GodotNavigationServer3D::_map_query_path(const NavMap *p_map, const PathQueryParameters &p_parameters) {
+	PathQueryResult r_query_result;
 
 	// run the pathfinding
 
 	if (p_parameters.pathfinding_algorithm == PathfindingAlgorithm::PATHFINDING_ALGORITHM_ASTAR) {
 		// while postprocessing is still part of map.get_path() need to check and route it here for the correct "optimize" post-processing
 		if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_CORRIDORFUNNEL) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					true,
 					p_parameters.navigation_layers,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_TYPES) ? &r_query_result.path_types : nullptr,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
-					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
+					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr,
+					p_parameters.use_hierarchical_pathfinding,
+					p_parameters.hierarchical_suboptimality_bound);
 		} else if (p_parameters.path_postprocessing == PathPostProcessing::PATH_POSTPROCESSING_EDGECENTERED) {
-			r_query_result.path = map->get_path(
+			r_query_result.path = p_map->get_path(
 					p_parameters.start_position,
 					p_parameters.target_position,
 					false,
 					p_parameters.navigation_layers,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_TYPES) ? &r_query_result.path_types : nullptr,
 					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_RIDS) ? &r_query_result.path_rids : nullptr,
-					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr);
+					p_parameters.metadata_flags.has_flag(PathMetadataFlags::PATH_INCLUDE_OWNERS) ? &r_query_result.path_owner_ids : nullptr,
+					p_parameters.use_hierarchical_pathfinding,
+					p_parameters.hierarchical_suboptimality_bound);
 		}
 	} else {
 		return r_query_result;
@@ -1466,6 +1603,161 @@ PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &
 	return r_query_result;
 }
 
+uint32_t GodotNavigationServer3D::query_path_batch_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback) {
+	ERR_FAIL_COND_V_MSG(p_query_parameters.size() != p_query_results.size(), 0, "The path query batch needs one result object per parameters object.");
+
+	LocalVector<PathQueryParameters> parameters;
+	parameters.resize(p_query_parameters.size());
+
+	PathQueryBatchRequest3D request;
+	request.query_results.resize(p_query_results.size());
+	request.callback = p_callback;
+
+	for (uint32_t i = 0; i < parameters.size(); i++) {
+		Ref<NavigationPathQueryParameters3D> query_parameters = p_query_parameters[i];
+		Ref<NavigationPathQueryResult3D> query_result = p_query_results[i];
+		ERR_FAIL_COND_V(!query_parameters.is_valid(), 0);
+		ERR_FAIL_COND_V(!query_result.is_valid(), 0);
+
+		parameters[i] = query_parameters->get_parameters();
+		request.query_results[i] = query_result;
+	}
+
+	request.batch_id = _query_path_batch_async(parameters);
+	if (request.batch_id == 0) {
+		return 0;
+	}
+
+	MutexLock lock(path_query_batch_mutex);
+	path_query_batch_requests.push_back(request);
+
+	return request.batch_id;
+}
+
+bool GodotNavigationServer3D::is_query_path_batch_completed(uint32_t p_batch_id) const {
+	MutexLock lock(path_query_batch_mutex);
+	for (const PathQueryBatchRequest3D &request : path_query_batch_requests) {
+		if (request.batch_id == p_batch_id) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t GodotNavigationServer3D::_query_path_batch_async(const LocalVector<PathQueryParameters> &p_parameters) {
+	PathQueryBatch *batch = memnew(PathQueryBatch);
+	batch->parameters = p_parameters;
+	batch->results.resize(p_parameters.size());
+	batch->maps.resize(p_parameters.size());
+
+	// Resolve the maps here, the worker threads don't access the RID owners.
+	for (uint32_t i = 0; i < p_parameters.size(); i++) {
+		batch->maps[i] = map_owner.get_or_null(p_parameters[i].map);
+		if (unlikely(batch->maps[i] == nullptr)) {
+			memdelete(batch);
+			ERR_FAIL_V_MSG(0, "Invalid navigation map in path query batch.");
+		}
+	}
+
+	MutexLock lock(path_query_batch_mutex);
+	batch->id = ++path_query_batch_id_counter;
+	if (batch->id == 0) {
+		batch->id = ++path_query_batch_id_counter;
+	}
+	if (!batch->parameters.is_empty()) {
+		batch->group_task_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer3D::_query_path_batch_thread, batch, batch->parameters.size(), -1, false, SNAME("NavigationPathQueryBatch"));
+	}
+	path_query_batches.insert(batch->id, batch);
+
+	return batch->id;
+}
+
+bool GodotNavigationServer3D::_query_path_batch_get_results(uint32_t p_batch_id, LocalVector<PathQueryResult> &r_results) {
+	MutexLock lock(path_query_batch_mutex);
+
+	PathQueryBatch **batch_ptr = path_query_batches.getptr(p_batch_id);
+	ERR_FAIL_NULL_V(batch_ptr, true);
+	PathQueryBatch *batch = *batch_ptr;
+
+	if (batch->group_task_id != -1) {
+		if (!WorkerThreadPool::get_singleton()->is_group_task_completed(batch->group_task_id)) {
+			return false;
+		}
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(batch->group_task_id);
+		batch->group_task_id = -1;
+	}
+
+	r_results = batch->results;
+
+	path_query_batches.erase(p_batch_id);
+	memdelete(batch);
+
+	return true;
+}
+
+void GodotNavigationServer3D::_query_path_batch_thread(uint32_t p_index, PathQueryBatch *p_batch) {
+	p_batch->results[p_index] = _map_query_path(p_batch->maps[p_index], p_batch->parameters[p_index]);
+}
+
+void GodotNavigationServer3D::_sync_path_query_batch_requests() {
+	LocalVector<PathQueryBatchRequest3D> requests;
+	{
+		MutexLock lock(path_query_batch_mutex);
+		requests = path_query_batch_requests;
+	}
+
+	// Deliver outside of the lock, the callbacks may start new batches.
+	for (const PathQueryBatchRequest3D &request : requests) {
+		LocalVector<PathQueryResult> results;
+		if (!_query_path_batch_get_results(request.batch_id, results)) {
+			continue;
+		}
+
+		for (uint32_t i = 0; i < results.size(); i++) {
+			const Ref<NavigationPathQueryResult3D> &query_result = request.query_results[i];
+			query_result->set_path(results[i].path);
+			query_result->set_path_types(results[i].path_types);
+			query_result->set_path_rids(results[i].path_rids);
+			query_result->set_path_owner_ids(results[i].path_owner_ids);
+		}
+
+		{
+			MutexLock lock(path_query_batch_mutex);
+			for (uint32_t i = 0; i < path_query_batch_requests.size(); i++) {
+				if (path_query_batch_requests[i].batch_id == request.batch_id) {
+					path_query_batch_requests.remove_at(i);
+					break;
+				}
+			}
+		}
+
+		if (request.callback.is_valid()) {
+			request.callback.call();
+		}
+	}
+}
+
+void GodotNavigationServer3D::_wait_for_path_query_batches() {
+	MutexLock lock(path_query_batch_mutex);
+	for (KeyValue<uint32_t, PathQueryBatch *> &E : path_query_batches) {
+		if (E.value->group_task_id != -1) {
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(E.value->group_task_id);
+			E.value->group_task_id = -1;
+		}
+	}
+}
+
+void GodotNavigationServer3D::_free_path_query_batches() {
+	_wait_for_path_query_batches();
+
+	MutexLock lock(path_query_batch_mutex);
+	for (KeyValue<uint32_t, PathQueryBatch *> &E : path_query_batches) {
+		memdelete(E.value);
+	}
+	path_query_batches.clear();
+	path_query_batch_requests.clear();
+}
+
 RID GodotNavigationServer3D::source_geometry_parser_create() {
 #ifndef _3D_DISABLED
 	if (navmesh_generator_3d) {
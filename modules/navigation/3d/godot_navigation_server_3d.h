@@ -32,6 +32,7 @@
 #define GODOT_NAVIGATION_SERVER_3D_H
 
 #include "../nav_agent.h"
+#include "../nav_flow_field.h"
 #include "../nav_link.h"
 #include "../nav_map.h"
 #include "../nav_obstacle.h"
@@ -77,6 +78,7 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	mutable RID_Owner<NavRegion> region_owner;
 	mutable RID_Owner<NavAgent> agent_owner;
 	mutable RID_Owner<NavObstacle> obstacle_owner;
+	mutable RID_Owner<NavFlowField> flow_field_owner;
 
 	bool active = true;
 	LocalVector<NavMap *> active_maps;
@@ -86,6 +88,27 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	NavMeshGenerator3D *navmesh_generator_3d = nullptr;
 #endif // _3D_DISABLED
 
+	struct PathQueryBatch {
+		uint32_t id = 0;
+		LocalVector<const NavMap *> maps;
+		LocalVector<NavigationUtilities::PathQueryParameters> parameters;
+		LocalVector<NavigationUtilities::PathQueryResult> results;
+		WorkerThreadPool::GroupID group_task_id = -1;
+	};
+
+	struct PathQueryBatchRequest3D {
+		uint32_t batch_id = 0;
+		LocalVector<Ref<NavigationPathQueryResult3D>> query_results;
+		Callable callback;
+	};
+
+	/// Batches whose queries run on the WorkerThreadPool, kept until their results are taken.
+	mutable Mutex path_query_batch_mutex;
+	HashMap<uint32_t, PathQueryBatch *> path_query_batches;
+	uint32_t path_query_batch_id_counter = 0;
+	/// Batches started with `query_path_batch_async()` that wait for their results to be delivered.
+	LocalVector<PathQueryBatchRequest3D> path_query_batch_requests;
+
 	// Performance Monitor
 	int pm_region_count = 0;
 	int pm_agent_count = 0;
@@ -263,6 +286,17 @@ public:
 	COMMAND_2(obstacle_set_avoidance_layers, RID, p_obstacle, uint32_t, p_layers);
 	virtual uint32_t obstacle_get_avoidance_layers(RID p_obstacle) const override;
 
+	virtual RID flow_field_create() override;
+	COMMAND_2(flow_field_set_map, RID, p_flow_field, RID, p_map);
+	virtual RID flow_field_get_map(RID p_flow_field) const override;
+	virtual void flow_field_set_targets(RID p_flow_field, const Vector<Vector3> &p_targets) override;
+	virtual Vector<Vector3> flow_field_get_targets(RID p_flow_field) const override;
+	COMMAND_2(flow_field_set_navigation_layers, RID, p_flow_field, uint32_t, p_navigation_layers);
+	virtual uint32_t flow_field_get_navigation_layers(RID p_flow_field) const override;
+	virtual Vector3 flow_field_get_direction(RID p_flow_field, const Vector3 &p_position) const override;
+	virtual real_t flow_field_get_distance(RID p_flow_field, const Vector3 &p_position) const override;
+	virtual Vector<Vector3> flow_field_get_directions(RID p_flow_field, const Vector<Vector3> &p_positions) const override;
+
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
@@ -290,11 +324,22 @@ public:
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
 
+	virtual uint32_t query_path_batch_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback = Callable()) override;
+	virtual bool is_query_path_batch_completed(uint32_t p_batch_id) const override;
+	virtual uint32_t _query_path_batch_async(const LocalVector<NavigationUtilities::PathQueryParameters> &p_parameters) override;
+	virtual bool _query_path_batch_get_results(uint32_t p_batch_id, LocalVector<NavigationUtilities::PathQueryResult> &r_results) override;
+
 	int get_process_info(ProcessInfo p_info) const override;
 
 private:
 	void internal_free_agent(RID p_object);
 	void internal_free_obstacle(RID p_object);
+
+	static NavigationUtilities::PathQueryResult _map_query_path(const NavMap *p_map, const NavigationUtilities::PathQueryParameters &p_parameters);
+	void _query_path_batch_thread(uint32_t p_index, PathQueryBatch *p_batch);
+	void _sync_path_query_batch_requests();
+	void _wait_for_path_query_batches();
+	void _free_path_query_batches();
 };
 
 #undef COMMAND_1
@@ -74,6 +74,24 @@ HashSet<Ref<NavigationMesh>> NavMeshGenerator3D::baking_navmeshes;
 HashMap<WorkerThreadPool::TaskID, NavMeshGenerator3D::NavMeshGeneratorTask3D *> NavMeshGenerator3D::generator_tasks;
 RID_Owner<NavMeshGenerator3D::NavMeshGeometryParser3D> NavMeshGenerator3D::generator_parser_owner;
 LocalVector<NavMeshGenerator3D::NavMeshGeometryParser3D *> NavMeshGenerator3D::generator_parsers;
+Mutex NavMeshGenerator3D::generator_tile_cache_mutex;
+HashMap<ObjectID, NavMeshGenerator3D::NavMeshBakeTileCache3D> NavMeshGenerator3D::generator_tile_caches;
+
+struct NavMeshGenerator3D::NavMeshBakeTileJob3D {
+	Vector2i coords;
+	rcConfig cfg;
+	LocalVector<int> triangle_indices;
+	LocalVector<AABB> excluded_areas;
+	NavMeshBakeTile3D tile;
+};
+
+struct NavMeshGenerator3D::NavMeshBakeTilesData3D {
+	Ref<NavigationMesh> navigation_mesh;
+	const float *verts = nullptr;
+	int nverts = 0;
+	const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> *projected_obstructions = nullptr;
+	LocalVector<NavMeshBakeTileJob3D> jobs;
+};
 
 NavMeshGenerator3D *NavMeshGenerator3D::get_singleton() {
 	return singleton;
@@ -142,6 +160,11 @@ void NavMeshGenerator3D::cleanup() {
 		}
 		generator_tasks.clear();
 
+		{
+			MutexLock tile_cache_lock(generator_tile_cache_mutex);
+			generator_tile_caches.clear();
+		}
+
 		generator_rid_rwlock.write_lock();
 		for (NavMeshGeometryParser3D *parser : generator_parsers) {
 			generator_parser_owner.free(parser->self);
@@ -662,6 +685,123 @@ void NavMeshGenerator3D::generator_parse_source_geometry_data(const Ref<Navigati
 	}
 };
 
+// Runs the Recast steps from the rasterization of the source geometry to the detail mesh.
+// Spans inside of `p_excluded_areas` are not walkable and erode the walkable area around them.
+static bool generator_build_detail_mesh(rcContext &p_ctx, const rcConfig &p_cfg, const Ref<NavigationMesh> &p_navigation_mesh, const float *p_verts, int p_nverts, const int *p_tris, int p_ntris, const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &p_projected_obstructions, const LocalVector<AABB> &p_excluded_areas, rcPolyMeshDetail &r_detail_mesh) {
+	// Creating heightfield.
+	rcHeightfield *hf = rcAllocHeightfield();
+
+	ERR_FAIL_NULL_V(hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&p_ctx, *hf, p_cfg.width, p_cfg.height, p_cfg.bmin, p_cfg.bmax, p_cfg.cs, p_cfg.ch), false);
+
+	// Marking walkable triangles.
+	{
+		Vector<unsigned char> tri_areas;
+		tri_areas.resize(p_ntris);
+
+		ERR_FAIL_COND_V(tri_areas.is_empty(), false);
+
+		memset(tri_areas.ptrw(), 0, p_ntris * sizeof(unsigned char));
+		rcMarkWalkableTriangles(&p_ctx, p_cfg.walkableSlopeAngle, p_verts, p_nverts, p_tris, p_ntris, tri_areas.ptrw());
+
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&p_ctx, p_verts, p_nverts, p_tris, tri_areas.ptr(), p_ntris, *hf, p_cfg.walkableClimb), false);
+	}
+
+	if (p_navigation_mesh->get_filter_low_hanging_obstacles()) {
+		rcFilterLowHangingWalkableObstacles(&p_ctx, p_cfg.walkableClimb, *hf);
+	}
+	if (p_navigation_mesh->get_filter_ledge_spans()) {
+		rcFilterLedgeSpans(&p_ctx, p_cfg.walkableHeight, p_cfg.walkableClimb, *hf);
+	}
+	if (p_navigation_mesh->get_filter_walkable_low_height_spans()) {
+		rcFilterWalkableLowHeightSpans(&p_ctx, p_cfg.walkableHeight, *hf);
+	}
+
+	// Constructing compact heightfield.
+	rcCompactHeightfield *chf = rcAllocCompactHeightfield();
+
+	ERR_FAIL_NULL_V(chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&p_ctx, p_cfg.walkableHeight, p_cfg.walkableClimb, *hf, *chf), false);
+
+	rcFreeHeightField(hf);
+	hf = nullptr;
+
+	// Mark the areas that the bake must treat as outside of the bake bounds.
+	for (const AABB &excluded_area : p_excluded_areas) {
+		const Vector3 excluded_area_end = excluded_area.get_end();
+		const float excluded_area_bmin[3] = { (float)excluded_area.position.x, (float)excluded_area.position.y, (float)excluded_area.position.z };
+		const float excluded_area_bmax[3] = { (float)excluded_area_end.x, (float)excluded_area_end.y, (float)excluded_area_end.z };
+		rcMarkBoxArea(&p_ctx, excluded_area_bmin, excluded_area_bmax, RC_NULL_AREA, *chf);
+	}
+
+	// Add obstacles to the source geometry. Those will be affected by e.g. agent_radius.
+	if (!p_projected_obstructions.is_empty()) {
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : p_projected_obstructions) {
+			if (projected_obstruction.carve) {
+				continue;
+			}
+			if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
+				continue;
+			}
+
+			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
+			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
+
+			rcMarkConvexPolyArea(&p_ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
+		}
+	}
+
+	// Eroding walkable area.
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&p_ctx, p_cfg.walkableRadius, *chf), false);
+
+	// Carve obstacles to the eroded geometry. Those will NOT be affected by e.g. agent_radius because that step is already done.
+	if (!p_projected_obstructions.is_empty()) {
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : p_projected_obstructions) {
+			if (!projected_obstruction.carve) {
+				continue;
+			}
+			if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
+				continue;
+			}
+
+			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
+			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
+
+			rcMarkConvexPolyArea(&p_ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
+		}
+	}
+
+	// Partitioning.
+	if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&p_ctx, *chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&p_ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea, p_cfg.mergeRegionArea), false);
+	} else if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&p_ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea, p_cfg.mergeRegionArea), false);
+	} else {
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&p_ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea), false);
+	}
+
+	// Creating contours.
+	rcContourSet *cset = rcAllocContourSet();
+
+	ERR_FAIL_NULL_V(cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&p_ctx, *chf, p_cfg.maxSimplificationError, p_cfg.maxEdgeLen, *cset), false);
+
+	// Creating polymesh.
+
+	rcPolyMesh *poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_NULL_V(poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&p_ctx, *cset, p_cfg.maxVertsPerPoly, *poly_mesh), false);
+
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&p_ctx, *poly_mesh, *chf, p_cfg.detailSampleDist, p_cfg.detailSampleMaxError, r_detail_mesh), false);
+
+	rcFreeCompactHeightfield(chf);
+	rcFreeContourSet(cset);
+	rcFreePolyMesh(poly_mesh);
+
+	return true;
+}
+
 void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data) {
 	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
 		return;
@@ -680,10 +820,6 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 		return;
 	}
 
-	rcHeightfield *hf = nullptr;
-	rcCompactHeightfield *chf = nullptr;
-	rcContourSet *cset = nullptr;
-	rcPolyMesh *poly_mesh = nullptr;
 	rcPolyMeshDetail *detail_mesh = nullptr;
 	rcContext ctx;
 
@@ -766,6 +902,12 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
 	}
 
+	if (p_navigation_mesh->get_tile_size() > 0.0) {
+		bake_state = "Baking tiles..."; // step #2 to #10
+		generator_bake_tiles_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data, cfg);
+		return;
+	}
+
 	bake_state = "Calculating grid size..."; // step #2
 	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 
@@ -780,115 +922,14 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 		return;
 	}
 
-	bake_state = "Creating heightfield..."; // step #3
-	hf = rcAllocHeightfield();
-
-	ERR_FAIL_NULL(hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
-
-	bake_state = "Marking walkable triangles..."; // step #4
-	{
-		Vector<unsigned char> tri_areas;
-		tri_areas.resize(ntris);
-
-		ERR_FAIL_COND(tri_areas.is_empty());
-
-		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
-		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
-
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
-	}
-
-	if (p_navigation_mesh->get_filter_low_hanging_obstacles()) {
-		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *hf);
-	}
-	if (p_navigation_mesh->get_filter_ledge_spans()) {
-		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf);
-	}
-	if (p_navigation_mesh->get_filter_walkable_low_height_spans()) {
-		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *hf);
-	}
-
-	bake_state = "Constructing compact heightfield..."; // step #5
-
-	chf = rcAllocCompactHeightfield();
-
-	ERR_FAIL_NULL(chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
-
-	rcFreeHeightField(hf);
-	hf = nullptr;
-
-	// Add obstacles to the source geometry. Those will be affected by e.g. agent_radius.
-	if (!projected_obstructions.is_empty()) {
-		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : projected_obstructions) {
-			if (projected_obstruction.carve) {
-				continue;
-			}
-			if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
-				continue;
-			}
-
-			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
-			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
-
-			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
-		}
-	}
-
-	bake_state = "Eroding walkable area..."; // step #6
-
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
-
-	// Carve obstacles to the eroded geometry. Those will NOT be affected by e.g. agent_radius because that step is already done.
-	if (!projected_obstructions.is_empty()) {
-		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : projected_obstructions) {
-			if (!projected_obstruction.carve) {
-				continue;
-			}
-			if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
-				continue;
-			}
-
-			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
-			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
-
-			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
-		}
-	}
-
-	bake_state = "Partitioning..."; // step #7
-
-	if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea));
-	}
-
-	bake_state = "Creating contours..."; // step #8
-
-	cset = rcAllocContourSet();
-
-	ERR_FAIL_NULL(cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
-
-	bake_state = "Creating polymesh..."; // step #9
-
-	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_NULL(poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
+	bake_state = "Creating detail mesh..."; // step #3 to #9
 
 	detail_mesh = rcAllocPolyMeshDetail();
 	ERR_FAIL_NULL(detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
-
-	rcFreeCompactHeightfield(chf);
-	chf = nullptr;
-	rcFreeContourSet(cset);
-	cset = nullptr;
+	if (!generator_build_detail_mesh(ctx, cfg, p_navigation_mesh, verts, nverts, tris, ntris, projected_obstructions, LocalVector<AABB>(), *detail_mesh)) {
+		rcFreePolyMeshDetail(detail_mesh);
+		return;
+	}
 
 	bake_state = "Converting to native navigation mesh..."; // step #10
 
@@ -939,14 +980,476 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 
 	bake_state = "Cleanup..."; // step #11
 
-	rcFreePolyMesh(poly_mesh);
-	poly_mesh = nullptr;
 	rcFreePolyMeshDetail(detail_mesh);
 	detail_mesh = nullptr;
 
 	bake_state = "Baking finished."; // step #12
 }
 
+static _FORCE_INLINE_ int generator_floor_div(int p_value, int p_divisor) {
+	return (p_value >= 0) ? (p_value / p_divisor) : -((-p_value + p_divisor - 1) / p_divisor);
+}
+
+void NavMeshGenerator3D::generator_bake_tile(void *p_arg, uint32_t p_index) {
+	NavMeshBakeTilesData3D *bake_data = static_cast<NavMeshBakeTilesData3D *>(p_arg);
+	NavMeshBakeTileJob3D &job = bake_data->jobs[p_index];
+
+	rcContext ctx;
+	rcPolyMeshDetail *detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_NULL(detail_mesh);
+
+	if (!generator_build_detail_mesh(ctx, job.cfg, bake_data->navigation_mesh, bake_data->verts, bake_data->nverts, job.triangle_indices.ptr(), job.triangle_indices.size() / 3, *bake_data->projected_obstructions, job.excluded_areas, *detail_mesh)) {
+		// Bake this tile again next time.
+		job.tile.geometry_hash = 0;
+		rcFreePolyMeshDetail(detail_mesh);
+		return;
+	}
+
+	job.tile.vertices.resize(detail_mesh->nverts);
+	for (int i = 0; i < detail_mesh->nverts; i++) {
+		const float *v = &detail_mesh->verts[i * 3];
+		job.tile.vertices[i] = Vector3(v[0], v[1], v[2]);
+	}
+
+	for (int i = 0; i < detail_mesh->nmeshes; i++) {
+		const unsigned int *detail_mesh_m = &detail_mesh->meshes[i * 4];
+		const unsigned int detail_mesh_bverts = detail_mesh_m[0];
+		const unsigned int detail_mesh_m_btris = detail_mesh_m[2];
+		const unsigned int detail_mesh_ntris = detail_mesh_m[3];
+		const unsigned char *detail_mesh_tris = &detail_mesh->tris[detail_mesh_m_btris * 4];
+		for (unsigned int j = 0; j < detail_mesh_ntris; j++) {
+			// Polygon order in recast is opposite than godot's
+			job.tile.triangles.push_back((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 0]));
+			job.tile.triangles.push_back((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 2]));
+			job.tile.triangles.push_back((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 1]));
+		}
+	}
+
+	rcFreePolyMeshDetail(detail_mesh);
+}
+
+void NavMeshGenerator3D::generator_bake_tiles_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const rcConfig &p_cfg) {
+	Vector<float> source_geometry_vertices;
+	Vector<int> source_geometry_indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+
+	p_source_geometry_data->get_data(
+			source_geometry_vertices,
+			source_geometry_indices,
+			projected_obstructions);
+
+	const float *verts = source_geometry_vertices.ptr();
+	const int nverts = source_geometry_vertices.size() / 3;
+	const int *tris = source_geometry_indices.ptr();
+	const int ntris = source_geometry_indices.size() / 3;
+
+	const float cs = p_cfg.cs;
+	const float ch = p_cfg.ch;
+
+	const int tile_cells = MAX(1, (int)Math::ceil(p_navigation_mesh->get_tile_size() / cs));
+	if (!Math::is_equal_approx((float)tile_cells * cs, p_navigation_mesh->get_tile_size())) {
+		WARN_PRINT("Property tile_size is ceiled to cell_size voxel units and loses precision.");
+	}
+
+	// Recast removes this border from each tile after eroding and partitioning it, so the tile
+	// edges are not eroded by the agent radius and the regions continue in the neighbor tiles.
+	const int tile_border = p_cfg.walkableRadius + 3;
+
+	// ~30000000 seems to be around sweetspot where Editor baking breaks
+	if ((tile_cells + 2 * tile_border) * (tile_cells + 2 * tile_border) > 30000000 && GLOBAL_GET("navigation/baking/use_crash_prevention_checks")) {
+		ERR_FAIL_MSG("Baking interrupted."
+					 "\nNavigationMesh baking process would likely crash the engine."
+					 "\nThe tile_size is suspiciously big for the current Cell Size in the NavMesh Resource bake settings."
+					 "\nIf you would like to try baking anyway, disable the 'navigation/baking/use_crash_prevention_checks' project setting.");
+		return;
+	}
+
+	// The bake area in cells of a grid that starts at the world origin, so the tiles
+	// keep their place when the bounds of the source geometry change.
+	const int area_min_x = (int)Math::floor(p_cfg.bmin[0] / cs) + p_cfg.borderSize;
+	const int area_min_z = (int)Math::floor(p_cfg.bmin[2] / cs) + p_cfg.borderSize;
+	const int area_max_x = (int)Math::ceil(p_cfg.bmax[0] / cs) - p_cfg.borderSize;
+	const int area_max_z = (int)Math::ceil(p_cfg.bmax[2] / cs) - p_cfg.borderSize;
+	if (area_max_x <= area_min_x || area_max_z <= area_min_z) {
+		return;
+	}
+
+	const int tile_min_x = generator_floor_div(area_min_x, tile_cells);
+	const int tile_min_z = generator_floor_div(area_min_z, tile_cells);
+	const int tile_count_x = generator_floor_div(area_max_x - 1, tile_cells) - tile_min_x + 1;
+	const int tile_count_z = generator_floor_div(area_max_z - 1, tile_cells) - tile_min_z + 1;
+
+	// Heights stay on the same cell_height steps in all tiles.
+	const float tile_bmin_y = Math::floor(p_cfg.bmin[1] / ch) * ch;
+	const float tile_bmax_y = p_cfg.bmax[1];
+
+	// Sort the triangles into the tiles that they overlap, including the tile borders.
+	LocalVector<LocalVector<int>> tile_triangles;
+	tile_triangles.resize(tile_count_x * tile_count_z);
+
+	for (int i = 0; i < ntris; i++) {
+		const float *v0 = &verts[tris[i * 3 + 0] * 3];
+		const float *v1 = &verts[tris[i * 3 + 1] * 3];
+		const float *v2 = &verts[tris[i * 3 + 2] * 3];
+
+		const int cell_min_x = (int)Math::floor(MIN(v0[0], MIN(v1[0], v2[0])) / cs) - tile_border;
+		const int cell_min_z = (int)Math::floor(MIN(v0[2], MIN(v1[2], v2[2])) / cs) - tile_border;
+		const int cell_max_x = (int)Math::floor(MAX(v0[0], MAX(v1[0], v2[0])) / cs) + tile_border;
+		const int cell_max_z = (int)Math::floor(MAX(v0[2], MAX(v1[2], v2[2])) / cs) + tile_border;
+
+		const int from_x = MAX(generator_floor_div(cell_min_x, tile_cells) - tile_min_x, 0);
+		const int from_z = MAX(generator_floor_div(cell_min_z, tile_cells) - tile_min_z, 0);
+		const int to_x = MIN(generator_floor_div(cell_max_x, tile_cells) - tile_min_x, tile_count_x - 1);
+		const int to_z = MIN(generator_floor_div(cell_max_z, tile_cells) - tile_min_z, tile_count_z - 1);
+
+		for (int z = from_z; z <= to_z; z++) {
+			for (int x = from_x; x <= to_x; x++) {
+				tile_triangles[z * tile_count_x + x].push_back(i);
+			}
+		}
+	}
+
+	LocalVector<AABB> obstruction_bounds;
+	obstruction_bounds.resize(projected_obstructions.size());
+	for (int i = 0; i < projected_obstructions.size(); i++) {
+		const Vector<float> &obstruction_vertices = projected_obstructions[i].vertices;
+		for (int j = 0; j + 2 < obstruction_vertices.size(); j += 3) {
+			const Vector3 vertex(obstruction_vertices[j], 0.0, obstruction_vertices[j + 2]);
+			if (j == 0) {
+				obstruction_bounds[i] = AABB(vertex, Vector3());
+			} else {
+				obstruction_bounds[i].expand_to(vertex);
+			}
+		}
+	}
+
+	// Tiles are only reused with the same bake settings.
+	uint32_t settings_hash = hash_murmur3_one_32(tile_cells);
+	settings_hash = hash_murmur3_one_float(cs, settings_hash);
+	settings_hash = hash_murmur3_one_float(ch, settings_hash);
+	settings_hash = hash_murmur3_one_float(p_cfg.walkableSlopeAngle, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_cfg.walkableHeight, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_cfg.walkableClimb, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_cfg.walkableRadius, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_cfg.maxEdgeLen, settings_hash);
+	settings_hash = hash_murmur3_one_float(p_cfg.maxSimplificationError, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_cfg.minRegionArea, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_cfg.mergeRegionArea, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_cfg.maxVertsPerPoly, settings_hash);
+	settings_hash = hash_murmur3_one_float(p_cfg.detailSampleDist, settings_hash);
+	settings_hash = hash_murmur3_one_float(p_cfg.detailSampleMaxError, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_sample_partition_type(), settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_filter_low_hanging_obstacles(), settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_filter_ledge_spans(), settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_filter_walkable_low_height_spans(), settings_hash);
+	if (p_navigation_mesh->get_filter_baking_aabb().has_volume()) {
+		settings_hash = hash_murmur3_one_float(tile_bmin_y, settings_hash);
+		settings_hash = hash_murmur3_one_float(tile_bmax_y, settings_hash);
+	}
+	settings_hash = hash_fmix32(settings_hash);
+
+	NavMeshBakeTileCache3D *tile_cache = nullptr;
+	{
+		MutexLock tile_cache_lock(generator_tile_cache_mutex);
+
+		// Drop the caches of navigation meshes that were freed.
+		LocalVector<ObjectID> freed_navmesh_ids;
+		for (const KeyValue<ObjectID, NavMeshBakeTileCache3D> &E : generator_tile_caches) {
+			if (ObjectDB::get_instance(E.key) == nullptr) {
+				freed_navmesh_ids.push_back(E.key);
+			}
+		}
+		for (const ObjectID &freed_navmesh_id : freed_navmesh_ids) {
+			generator_tile_caches.erase(freed_navmesh_id);
+		}
+
+		// Only one bake of the same navigation mesh can run at a time, the cache can be used without the lock.
+		tile_cache = &generator_tile_caches[p_navigation_mesh->get_instance_id()];
+	}
+
+	if (tile_cache->settings_hash != settings_hash) {
+		tile_cache->tiles.clear();
+		tile_cache->settings_hash = settings_hash;
+	}
+
+	NavMeshBakeTilesData3D bake_data;
+	bake_data.navigation_mesh = p_navigation_mesh;
+	bake_data.verts = verts;
+	bake_data.nverts = nverts;
+	bake_data.projected_obstructions = &projected_obstructions;
+
+	HashSet<Vector2i> baked_tiles;
+
+	for (int z = 0; z < tile_count_z; z++) {
+		for (int x = 0; x < tile_count_x; x++) {
+			const LocalVector<int> &triangles = tile_triangles[z * tile_count_x + x];
+			if (triangles.is_empty()) {
+				continue;
+			}
+
+			const Vector2i coords(tile_min_x + x, tile_min_z + z);
+			const int cell_min_x = MAX(coords.x * tile_cells, area_min_x);
+			const int cell_min_z = MAX(coords.y * tile_cells, area_min_z);
+			const int cell_max_x = MIN((coords.x + 1) * tile_cells, area_max_x);
+			const int cell_max_z = MIN((coords.y + 1) * tile_cells, area_max_z);
+
+			rcConfig cfg = p_cfg;
+			cfg.borderSize = tile_border;
+			cfg.width = cell_max_x - cell_min_x + 2 * tile_border;
+			cfg.height = cell_max_z - cell_min_z + 2 * tile_border;
+			cfg.bmin[0] = (cell_min_x - tile_border) * cs;
+			cfg.bmin[1] = tile_bmin_y;
+			cfg.bmin[2] = (cell_min_z - tile_border) * cs;
+			cfg.bmax[0] = (cell_max_x + tile_border) * cs;
+			cfg.bmax[1] = tile_bmax_y;
+			cfg.bmax[2] = (cell_max_z + tile_border) * cs;
+
+			// A bake without tiles ends at the bake bounds, so the tile borders outside of them
+			// are not walkable and erode the walkable area the same way.
+			LocalVector<AABB> excluded_areas;
+			const Vector3 excluded_area_min(cfg.bmin[0] - cs, tile_bmin_y - ch, cfg.bmin[2] - cs);
+			const Vector3 excluded_area_max(cfg.bmax[0] + cs, tile_bmax_y + (p_cfg.walkableHeight + 1) * ch, cfg.bmax[2] + cs);
+			if (p_cfg.bmin[0] - 0.5f * cs >= cfg.bmin[0]) {
+				excluded_areas.push_back(AABB(excluded_area_min, Vector3(p_cfg.bmin[0] - 0.5f * cs, excluded_area_max.y, excluded_area_max.z) - excluded_area_min));
+			}
+			if (p_cfg.bmax[0] + 0.5f * cs <= cfg.bmax[0]) {
+				const Vector3 position(p_cfg.bmax[0] + 0.5f * cs, excluded_area_min.y, excluded_area_min.z);
+				excluded_areas.push_back(AABB(position, excluded_area_max - position));
+			}
+			if (p_cfg.bmin[2] - 0.5f * cs >= cfg.bmin[2]) {
+				excluded_areas.push_back(AABB(excluded_area_min, Vector3(excluded_area_max.x, excluded_area_max.y, p_cfg.bmin[2] - 0.5f * cs) - excluded_area_min));
+			}
+			if (p_cfg.bmax[2] + 0.5f * cs <= cfg.bmax[2]) {
+				const Vector3 position(excluded_area_min.x, excluded_area_min.y, p_cfg.bmax[2] + 0.5f * cs);
+				excluded_areas.push_back(AABB(position, excluded_area_max - position));
+			}
+
+			uint32_t geometry_hash = hash_murmur3_one_32(cell_min_x);
+			geometry_hash = hash_murmur3_one_32(cell_min_z, geometry_hash);
+			geometry_hash = hash_murmur3_one_32(cell_max_x, geometry_hash);
+			geometry_hash = hash_murmur3_one_32(cell_max_z, geometry_hash);
+			for (const AABB &excluded_area : excluded_areas) {
+				geometry_hash = hash_murmur3_one_real(excluded_area.position.x, geometry_hash);
+				geometry_hash = hash_murmur3_one_real(excluded_area.position.z, geometry_hash);
+				geometry_hash = hash_murmur3_one_real(excluded_area.size.x, geometry_hash);
+				geometry_hash = hash_murmur3_one_real(excluded_area.size.z, geometry_hash);
+			}
+			for (int triangle : triangles) {
+				for (int i = 0; i < 3; i++) {
+					const float *v = &verts[tris[triangle * 3 + i] * 3];
+					geometry_hash = hash_murmur3_one_float(v[0], geometry_hash);
+					geometry_hash = hash_murmur3_one_float(v[1], geometry_hash);
+					geometry_hash = hash_murmur3_one_float(v[2], geometry_hash);
+				}
+			}
+			const AABB tile_bounds(Vector3(cfg.bmin[0], 0.0, cfg.bmin[2]), Vector3(cfg.bmax[0] - cfg.bmin[0], 0.0, cfg.bmax[2] - cfg.bmin[2]));
+			for (int i = 0; i < projected_obstructions.size(); i++) {
+				const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction = projected_obstructions[i];
+				if (projected_obstruction.vertices.is_empty() || !tile_bounds.intersects_inclusive(obstruction_bounds[i])) {
+					continue;
+				}
+				geometry_hash = hash_murmur3_one_32(projected_obstruction.carve, geometry_hash);
+				geometry_hash = hash_murmur3_one_float(projected_obstruction.elevation, geometry_hash);
+				geometry_hash = hash_murmur3_one_float(projected_obstruction.height, geometry_hash);
+				for (float value : projected_obstruction.vertices) {
+					geometry_hash = hash_murmur3_one_float(value, geometry_hash);
+				}
+			}
+			geometry_hash = hash_fmix32(geometry_hash);
+
+			baked_tiles.insert(coords);
+
+			const NavMeshBakeTile3D *cached_tile = tile_cache->tiles.getptr(coords);
+			if (cached_tile && cached_tile->geometry_hash == geometry_hash) {
+				continue;
+			}
+
+			bake_data.jobs.push_back(NavMeshBakeTileJob3D());
+			NavMeshBakeTileJob3D &job = bake_data.jobs[bake_data.jobs.size() - 1];
+			job.coords = coords;
+			job.cfg = cfg;
+			job.excluded_areas = excluded_areas;
+			job.tile.geometry_hash = geometry_hash;
+			job.triangle_indices.resize(triangles.size() * 3);
+			for (uint32_t i = 0; i < triangles.size(); i++) {
+				job.triangle_indices[i * 3 + 0] = tris[triangles[i] * 3 + 0];
+				job.triangle_indices[i * 3 + 1] = tris[triangles[i] * 3 + 1];
+				job.triangle_indices[i * 3 + 2] = tris[triangles[i] * 3 + 2];
+			}
+		}
+	}
+
+	if (use_threads && baking_use_multiple_threads && bake_data.jobs.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&NavMeshGenerator3D::generator_bake_tile, &bake_data, bake_data.jobs.size(), -1, baking_use_high_priority_threads, SNAME("NavMeshGeneratorBakeTiles3D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < bake_data.jobs.size(); i++) {
+			generator_bake_tile(&bake_data, i);
+		}
+	}
+
+	for (NavMeshBakeTileJob3D &job : bake_data.jobs) {
+		tile_cache->tiles[job.coords] = job.tile;
+	}
+
+	LocalVector<Vector2i> tile_coords;
+	for (const KeyValue<Vector2i, NavMeshBakeTile3D> &E : tile_cache->tiles) {
+		tile_coords.push_back(E.key);
+	}
+	for (const Vector2i &coords : tile_coords) {
+		if (!baked_tiles.has(coords)) {
+			tile_cache->tiles.erase(coords);
+		}
+	}
+	tile_coords.clear();
+	for (const KeyValue<Vector2i, NavMeshBakeTile3D> &E : tile_cache->tiles) {
+		tile_coords.push_back(E.key);
+	}
+	tile_coords.sort();
+
+	// Join the tiles, vertices that the tiles share are merged.
+	const real_t vertex_snap_xz = cs / 16.0;
+	const real_t vertex_snap_y = ch / 16.0;
+
+	Vector<Vector3> nav_vertices;
+	LocalVector<int> nav_triangles;
+	HashMap<Vector3i, int> snapped_vertex_to_index;
+
+	for (const Vector2i &coords : tile_coords) {
+		const NavMeshBakeTile3D &tile = tile_cache->tiles[coords];
+
+		LocalVector<int> tile_index_to_index;
+		tile_index_to_index.resize(tile.vertices.size());
+		for (uint32_t i = 0; i < tile.vertices.size(); i++) {
+			const Vector3 &vertex = tile.vertices[i];
+			const Vector3i snapped_vertex((int)Math::round(vertex.x / vertex_snap_xz), (int)Math::round(vertex.y / vertex_snap_y), (int)Math::round(vertex.z / vertex_snap_xz));
+			HashMap<Vector3i, int>::Iterator E = snapped_vertex_to_index.find(snapped_vertex);
+			if (E) {
+				tile_index_to_index[i] = E->value;
+			} else {
+				tile_index_to_index[i] = nav_vertices.size();
+				snapped_vertex_to_index.insert(snapped_vertex, nav_vertices.size());
+				nav_vertices.push_back(vertex);
+			}
+		}
+
+		for (int index : tile.triangles) {
+			nav_triangles.push_back(tile_index_to_index[index]);
+		}
+	}
+
+	// Neighbor tiles can split their shared border differently. Add the border vertices of the
+	// other tile to the edges on the border so both sides have the same edges and get connected.
+	struct BorderVertex {
+		real_t position = 0.0;
+		real_t height = 0.0;
+		int index = -1;
+
+		bool operator<(const BorderVertex &p_other) const { return position < p_other.position; }
+	};
+
+	// Key is the axis (0 for borders along z at a fixed x, 1 for borders along x at a fixed z) and the border index.
+	HashMap<Vector2i, LocalVector<BorderVertex>> border_vertices;
+	LocalVector<Vector2i> vertex_borders;
+	vertex_borders.resize(nav_vertices.size());
+
+	for (int i = 0; i < nav_vertices.size(); i++) {
+		const Vector3 &vertex = nav_vertices[i];
+		vertex_borders[i] = Vector2i(INT32_MAX, INT32_MAX);
+
+		const real_t cell_x = vertex.x / cs;
+		const int border_x = (int)Math::round(cell_x / tile_cells);
+		if (Math::abs(cell_x - border_x * tile_cells) < 0.01) {
+			vertex_borders[i].x = border_x;
+			border_vertices[Vector2i(0, border_x)].push_back({ vertex.z, vertex.y, i });
+		}
+
+		const real_t cell_z = vertex.z / cs;
+		const int border_z = (int)Math::round(cell_z / tile_cells);
+		if (Math::abs(cell_z - border_z * tile_cells) < 0.01) {
+			vertex_borders[i].y = border_z;
+			border_vertices[Vector2i(1, border_z)].push_back({ vertex.x, vertex.y, i });
+		}
+	}
+	for (KeyValue<Vector2i, LocalVector<BorderVertex>> &E : border_vertices) {
+		E.value.sort();
+	}
+
+	const real_t border_epsilon = cs * 0.01;
+	const real_t max_border_height_error = MAX(p_cfg.walkableClimb, 1) * ch;
+
+	Vector<Vector<int>> nav_polygons;
+	nav_polygons.resize(nav_triangles.size() / 3);
+
+	for (uint32_t i = 0; i < nav_triangles.size() / 3; i++) {
+		Vector<int> &nav_indices = nav_polygons.write[i];
+
+		for (int j = 0; j < 3; j++) {
+			const int from = nav_triangles[i * 3 + j];
+			const int to = nav_triangles[i * 3 + (j + 1) % 3];
+			nav_indices.push_back(from);
+
+			int axis = -1;
+			int border = 0;
+			if (vertex_borders[from].x != INT32_MAX && vertex_borders[from].x == vertex_borders[to].x) {
+				axis = 0;
+				border = vertex_borders[from].x;
+			} else if (vertex_borders[from].y != INT32_MAX && vertex_borders[from].y == vertex_borders[to].y) {
+				axis = 1;
+				border = vertex_borders[from].y;
+			}
+			if (axis == -1) {
+				continue;
+			}
+
+			const Vector3 &from_vertex = nav_vertices[from];
+			const Vector3 &to_vertex = nav_vertices[to];
+			const real_t from_position = axis == 0 ? from_vertex.z : from_vertex.x;
+			const real_t to_position = axis == 0 ? to_vertex.z : to_vertex.x;
+			const real_t min_position = MIN(from_position, to_position) + border_epsilon;
+			const real_t max_position = MAX(from_position, to_position) - border_epsilon;
+			if (min_position >= max_position) {
+				continue;
+			}
+
+			const LocalVector<BorderVertex> &vertices = border_vertices[Vector2i(axis, border)];
+
+			// First vertex after the start of the edge.
+			uint32_t first = 0;
+			uint32_t last = vertices.size();
+			while (first < last) {
+				const uint32_t middle = (first + last) / 2;
+				if (vertices[middle].position <= min_position) {
+					first = middle + 1;
+				} else {
+					last = middle;
+				}
+			}
+
+			LocalVector<int> edge_vertices;
+			for (uint32_t k = first; k < vertices.size() && vertices[k].position < max_position; k++) {
+				const BorderVertex &border_vertex = vertices[k];
+				const real_t weight = (border_vertex.position - from_position) / (to_position - from_position);
+				if (Math::abs(border_vertex.height - Math::lerp(from_vertex.y, to_vertex.y, weight)) <= max_border_height_error) {
+					edge_vertices.push_back(border_vertex.index);
+				}
+			}
+
+			if (from_position < to_position) {
+				for (uint32_t k = 0; k < edge_vertices.size(); k++) {
+					nav_indices.push_back(edge_vertices[k]);
+				}
+			} else {
+				for (int64_t k = (int64_t)edge_vertices.size() - 1; k >= 0; k--) {
+					nav_indices.push_back(edge_vertices[k]);
+				}
+			}
+		}
+	}
+
+	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
+}
+
 bool NavMeshGenerator3D::generator_emit_callback(const Callable &p_callback) {
 	ERR_FAIL_COND_V(!p_callback.is_valid(), false);
 
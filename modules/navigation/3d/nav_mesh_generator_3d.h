@@ -41,6 +41,7 @@
 class Node;
 class NavigationMesh;
 class NavigationMeshSourceGeometryData3D;
+struct rcConfig;
 
 class NavMeshGenerator3D : public Object {
 	static NavMeshGenerator3D *singleton;
@@ -82,6 +83,27 @@ class NavMeshGenerator3D : public Object {
 
 	static HashSet<Ref<NavigationMesh>> baking_navmeshes;
 
+	struct NavMeshBakeTile3D {
+		uint32_t geometry_hash = 0;
+		LocalVector<Vector3> vertices;
+		LocalVector<int> triangles;
+	};
+
+	struct NavMeshBakeTileCache3D {
+		uint32_t settings_hash = 0;
+		HashMap<Vector2i, NavMeshBakeTile3D> tiles;
+	};
+
+	// The tiles of the last tiled bake of each navigation mesh, reused when their source geometry did not change.
+	static Mutex generator_tile_cache_mutex;
+	static HashMap<ObjectID, NavMeshBakeTileCache3D> generator_tile_caches;
+
+	struct NavMeshBakeTileJob3D;
+	struct NavMeshBakeTilesData3D;
+
+	static void generator_bake_tiles_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const rcConfig &p_cfg);
+	static void generator_bake_tile(void *p_arg, uint32_t p_index);
+
 	static void generator_parse_geometry_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node, bool p_recurse_children);
 	static void generator_parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_root_node);
 	static void generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data);
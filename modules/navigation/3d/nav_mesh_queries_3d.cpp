@@ -49,6 +49,51 @@
 		r_path_owners->push_back(poly->owner->get_owner_id()); \
 	}
 
+Vector3 NavMeshQueries3D::polygon_get_random_point(const gd::Polygon &p_polygon, bool p_uniformly) {
+	if (p_polygon.points.size() < 3) {
+		return Vector3();
+	}
+
+	if (p_uniformly) {
+		real_t accumulated_polygon_area = 0;
+		RBMap<real_t, uint32_t> polygon_area_map;
+
+		for (uint32_t rpp_index = 2; rpp_index < p_polygon.points.size(); rpp_index++) {
+			real_t face_area = Face3(p_polygon.points[0].pos, p_polygon.points[rpp_index - 1].pos, p_polygon.points[rpp_index].pos).get_area();
+
+			if (face_area == 0.0) {
+				continue;
+			}
+			polygon_area_map[accumulated_polygon_area] = rpp_index;
+			accumulated_polygon_area += face_area;
+		}
+		if (polygon_area_map.is_empty() || accumulated_polygon_area == 0) {
+			// All faces have no real surface / no area.
+			return Vector3();
+		}
+
+		real_t polygon_area_map_pos = Math::random(real_t(0), accumulated_polygon_area);
+
+		RBMap<real_t, uint32_t>::Iterator polygon_E = polygon_area_map.find_closest(polygon_area_map_pos);
+		ERR_FAIL_COND_V(!polygon_E, Vector3());
+		uint32_t rrp_face_index = polygon_E->value;
+		ERR_FAIL_UNSIGNED_INDEX_V(rrp_face_index, p_polygon.points.size(), Vector3());
+
+		const Face3 face(p_polygon.points[0].pos, p_polygon.points[rrp_face_index - 1].pos, p_polygon.points[rrp_face_index].pos);
+
+		Vector3 face_random_position = face.get_random_point_inside();
+		return face_random_position;
+
+	} else {
+		uint32_t rrp_face_index = Math::random(int(2), p_polygon.points.size() - 1);
+
+		const Face3 face(p_polygon.points[0].pos, p_polygon.points[rrp_face_index - 1].pos, p_polygon.points[rrp_face_index].pos);
+
+		Vector3 face_random_position = face.get_random_point_inside();
+		return face_random_position;
+	}
+}
+
 Vector3 NavMeshQueries3D::polygons_get_random_point(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_navigation_layers, bool p_uniformly) {
 	const LocalVector<gd::Polygon> &region_polygons = p_polygons;
 
@@ -82,52 +127,26 @@ Vector3 NavMeshQueries3D::polygons_get_random_point(const LocalVector<gd::Polygo
 		uint32_t rrp_polygon_index = region_E->value;
 		ERR_FAIL_UNSIGNED_INDEX_V(rrp_polygon_index, region_polygons.size(), Vector3());
 
-		const gd::Polygon &rr_polygon = region_polygons[rrp_polygon_index];
-
-		real_t accumulated_polygon_area = 0;
-		RBMap<real_t, uint32_t> polygon_area_map;
-
-		for (uint32_t rpp_index = 2; rpp_index < rr_polygon.points.size(); rpp_index++) {
-			real_t face_area = Face3(rr_polygon.points[0].pos, rr_polygon.points[rpp_index - 1].pos, rr_polygon.points[rpp_index].pos).get_area();
-
-			if (face_area == 0.0) {
-				continue;
-			}
-			polygon_area_map[accumulated_polygon_area] = rpp_index;
-			accumulated_polygon_area += face_area;
-		}
-		if (polygon_area_map.is_empty() || accumulated_polygon_area == 0) {
-			// All faces have no real surface / no area.
-			return Vector3();
-		}
-
-		real_t polygon_area_map_pos = Math::random(real_t(0), accumulated_polygon_area);
-
-		RBMap<real_t, uint32_t>::Iterator polygon_E = polygon_area_map.find_closest(polygon_area_map_pos);
-		ERR_FAIL_COND_V(!polygon_E, Vector3());
-		uint32_t rrp_face_index = polygon_E->value;
-		ERR_FAIL_UNSIGNED_INDEX_V(rrp_face_index, rr_polygon.points.size(), Vector3());
-
-		const Face3 face(rr_polygon.points[0].pos, rr_polygon.points[rrp_face_index - 1].pos, rr_polygon.points[rrp_face_index].pos);
-
-		Vector3 face_random_position = face.get_random_point_inside();
-		return face_random_position;
+		return polygon_get_random_point(region_polygons[rrp_polygon_index], p_uniformly);
 
 	} else {
 		uint32_t rrp_polygon_index = Math::random(int(0), region_polygons.size() - 1);
 
-		const gd::Polygon &rr_polygon = region_polygons[rrp_polygon_index];
-
-		uint32_t rrp_face_index = Math::random(int(2), rr_polygon.points.size() - 1);
-
-		const Face3 face(rr_polygon.points[0].pos, rr_polygon.points[rrp_face_index - 1].pos, rr_polygon.points[rrp_face_index].pos);
+		return polygon_get_random_point(region_polygons[rrp_polygon_index], p_uniformly);
+	}
+}
 
-		Vector3 face_random_position = face.get_random_point_inside();
-		return face_random_position;
+Vector3 NavMeshQueries3D::polygons_get_random_point(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, uint32_t p_navigation_layers, bool p_uniformly) {
+	const uint32_t polygon_index = p_polygon_bvh.get_random_polygon(p_polygons, p_navigation_layers, p_uniformly);
+	if (polygon_index == UINT32_MAX) {
+		return Vector3();
 	}
+	ERR_FAIL_UNSIGNED_INDEX_V(polygon_index, p_polygons.size(), Vector3());
+
+	return polygon_get_random_point(p_polygons[polygon_index], p_uniformly);
 }
 
-Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size) {
+Vector<Vector3> NavMeshQueries3D::polygons_get_path(gd::PathQuerySlot &p_query_slot, const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size, const NavPathHierarchy *p_path_hierarchy, real_t p_suboptimality_bound) {
 	// Clear metadata outputs.
 	if (r_path_types) {
 		r_path_types->clear();
@@ -139,42 +158,24 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		r_path_owners->clear();
 	}
 
-	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
-	Vector3 begin_point;
-	Vector3 end_point;
-	real_t begin_d = FLT_MAX;
-	real_t end_d = FLT_MAX;
-	// Find the initial poly and the end poly on this map.
-	for (const gd::Polygon &p : p_polygons) {
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_navigation_layers & p.owner->get_navigation_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			real_t distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
+	if (p_navigation_layers == 0) {
+		// No region can match, and the spatial index treats 0 as "any layer".
+		return Vector<Vector3>();
 	}
 
+	// Find the start poly and the end poly on this map.
+	// Only polygons in regions with compatible layers are considered.
+	NavPolygonBVH::ClosestPoint begin_closest;
+	NavPolygonBVH::ClosestPoint end_closest;
+	p_polygon_bvh.get_closest_point(p_polygons, p_origin, p_navigation_layers, FLT_MAX, begin_closest);
+	p_polygon_bvh.get_closest_point(p_polygons, p_destination, p_navigation_layers, FLT_MAX, end_closest);
+
+	const gd::Polygon *begin_poly = begin_closest.polygon_index != UINT32_MAX ? &p_polygons[begin_closest.polygon_index] : nullptr;
+	const gd::Polygon *end_poly = end_closest.polygon_index != UINT32_MAX ? &p_polygons[end_closest.polygon_index] : nullptr;
+	const Vector3 begin_point = begin_closest.point;
+	Vector3 end_point = end_closest.point;
+	real_t end_d = Math::sqrt(end_closest.distance_squared);
+
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
 		return Vector<Vector3>();
@@ -205,9 +206,23 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		return path;
 	}
 
+	// Guide queries that leave the start cluster with the distances on the cluster portal graph.
+	// Clusters that cannot reach the goal are skipped, and the heuristic can be weighted by the
+	// suboptimality bound, so the path cost is at most that factor above the best path found without it.
+	NavPathHierarchy::GoalDistances goal_distances;
+	bool use_hierarchy = false;
+	if (p_path_hierarchy && !p_path_hierarchy->is_empty()) {
+		const uint32_t begin_cluster = p_path_hierarchy->get_polygon_cluster(begin_poly->id);
+		const uint32_t end_cluster = p_path_hierarchy->get_polygon_cluster(end_poly->id);
+		if (begin_cluster != end_cluster) {
+			use_hierarchy = p_path_hierarchy->compute_goal_distances(begin_cluster, end_cluster, end_point, p_navigation_layers, goal_distances);
+		}
+	}
+	const real_t heuristic_weight = use_hierarchy ? MAX(p_suboptimality_bound, real_t(1.0)) : real_t(1.0);
+
 	// List of all reachable navigation polys.
-	LocalVector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.resize(p_polygons.size() + p_link_polygons_size);
+	p_query_slot.reset(p_polygons.size() + p_link_polygons_size);
+	LocalVector<gd::NavigationPoly> &navigation_polys = p_query_slot.navigation_polys;
 
 	// Initialize the matching navigation polygon.
 	gd::NavigationPoly &begin_navigation_poly = navigation_polys[begin_poly->id];
@@ -217,8 +232,7 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
 
 	// Heap of polygons to travel next.
-	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer>
-			traversable_polys;
+	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer> &traversable_polys = p_query_slot.traversable_polys;
 	traversable_polys.reserve(p_polygons.size() * 0.25);
 
 	// This is an implementation of the A* algorithm.
@@ -255,6 +269,16 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
 				const real_t new_traveled_distance = least_cost_poly.entry.distance_to(new_entry) * poly_travel_cost + poly_enter_cost + least_cost_poly.traveled_distance;
 
+				real_t distance_to_destination = new_entry.distance_to(end_point);
+				if (use_hierarchy) {
+					distance_to_destination = p_path_hierarchy->get_distance_to_goal(p_path_hierarchy->get_polygon_cluster(connection.polygon->id), new_entry, goal_distances);
+					if (distance_to_destination == FLT_MAX) {
+						// The goal cannot be reached from the cluster of this polygon.
+						continue;
+					}
+					distance_to_destination *= heuristic_weight;
+				}
+
 				// Check if the neighbor polygon has already been processed.
 				gd::NavigationPoly &neighbor_poly = navigation_polys[connection.polygon->id];
 				if (neighbor_poly.poly != nullptr) {
@@ -268,7 +292,7 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 						neighbor_poly.back_navigation_edge_pathway_end = connection.pathway_end;
 						neighbor_poly.traveled_distance = new_traveled_distance;
 						neighbor_poly.distance_to_destination =
-								new_entry.distance_to(end_point) *
+								distance_to_destination *
 								neighbor_poly.poly->owner->get_travel_cost();
 						neighbor_poly.entry = new_entry;
 
@@ -284,7 +308,7 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 					neighbor_poly.back_navigation_edge_pathway_end = connection.pathway_end;
 					neighbor_poly.traveled_distance = new_traveled_distance;
 					neighbor_poly.distance_to_destination =
-							new_entry.distance_to(end_point) *
+							distance_to_destination *
 							neighbor_poly.poly->owner->get_travel_cost();
 					neighbor_poly.entry = new_entry;
 
@@ -297,6 +321,12 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		// When the heap of traversable polygons is empty at this point it means the end polygon is
 		// unreachable.
 		if (traversable_polys.is_empty()) {
+			if (use_hierarchy) {
+				// The portal graph can connect clusters whose polygons are not connected,
+				// search again without it to find the closest reachable point.
+				return polygons_get_path(p_query_slot, p_polygons, p_polygon_bvh, p_origin, p_destination, p_optimize, p_navigation_layers, r_path_types, r_path_rids, r_path_owners, p_map_up, p_link_polygons_size, nullptr, 1.0);
+			}
+
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -642,13 +672,28 @@ Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVecto
 	return closest_point;
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) {
+	Vector3 closest_point;
+
+	// An intersection always wins over the closest point when the segment does not touch the polygons.
+	if (p_polygon_bvh.get_closest_segment_intersection(p_polygons, p_from, p_to, 0, closest_point)) {
+		return closest_point;
+	}
+	if (p_use_collision) {
+		return Vector3();
+	}
+
+	p_polygon_bvh.get_closest_point_to_segment(p_polygons, p_from, p_to, 0, closest_point);
+	return closest_point;
+}
+
+Vector3 NavMeshQueries3D::polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_polygon_bvh, p_point);
 	return cp.point;
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+Vector3 NavMeshQueries3D::polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_polygon_bvh, p_point);
 	return cp.normal;
 }
 
@@ -673,8 +718,21 @@ gd::ClosestPointQueryResult NavMeshQueries3D::polygons_get_closest_point_info(co
 	return result;
 }
 
-RID NavMeshQueries3D::polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+gd::ClosestPointQueryResult NavMeshQueries3D::polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult result;
+
+	NavPolygonBVH::ClosestPoint closest;
+	if (p_polygon_bvh.get_closest_point(p_polygons, p_point, 0, FLT_MAX, closest)) {
+		result.point = closest.point;
+		result.normal = closest.normal;
+		result.owner = p_polygons[closest.polygon_index].owner->get_self();
+	}
+
+	return result;
+}
+
+RID NavMeshQueries3D::polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_polygon_bvh, p_point);
 	return cp.owner;
 }
 
@@ -37,14 +37,18 @@
 
 class NavMeshQueries3D {
 public:
+	static Vector3 polygon_get_random_point(const gd::Polygon &p_polygon, bool p_uniformly);
 	static Vector3 polygons_get_random_point(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_navigation_layers, bool p_uniformly);
+	static Vector3 polygons_get_random_point(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, uint32_t p_navigation_layers, bool p_uniformly);
 
-	static Vector<Vector3> polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size);
+	static Vector<Vector3> polygons_get_path(gd::PathQuerySlot &p_query_slot, const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size, const NavPathHierarchy *p_path_hierarchy = nullptr, real_t p_suboptimality_bound = 1.0);
 	static Vector3 polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision);
-	static Vector3 polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static Vector3 polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
+	static Vector3 polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision);
+	static Vector3 polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point);
+	static Vector3 polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point);
 	static gd::ClosestPointQueryResult polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static RID polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
+	static gd::ClosestPointQueryResult polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point);
+	static RID polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const NavPolygonBVH &p_polygon_bvh, const Vector3 &p_point);
 
 	static void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up);
 };
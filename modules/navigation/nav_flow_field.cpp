@@ -0,0 +1,431 @@
+/**************************************************************************/
+/*  nav_flow_field.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_flow_field.h"
+
+#include "nav_base.h"
+#include "nav_map.h"
+
+#include "core/math/geometry_3d.h"
+
+enum PolygonState : uint8_t {
+	POLYGON_STATE_UNKNOWN,
+	POLYGON_STATE_KEPT,
+	POLYGON_STATE_AFFECTED,
+};
+
+NavFlowField::NavFlowField() {}
+
+NavFlowField::~NavFlowField() {}
+
+void NavFlowField::set_map(NavMap *p_map) {
+	if (map == p_map) {
+		return;
+	}
+
+	if (map) {
+		map->remove_flow_field(this);
+	}
+
+	map = p_map;
+	field_dirty = true;
+
+	if (map) {
+		map->add_flow_field(this);
+	}
+}
+
+void NavFlowField::set_targets(const Vector<Vector3> &p_targets) {
+	RWLockWrite write_lock(field_rwlock);
+
+	targets.resize(p_targets.size());
+	for (int i = 0; i < p_targets.size(); i++) {
+		targets[i] = p_targets[i];
+	}
+	field_dirty = true;
+}
+
+Vector<Vector3> NavFlowField::get_targets() const {
+	RWLockRead read_lock(field_rwlock);
+
+	Vector<Vector3> r_targets;
+	r_targets.resize(targets.size());
+	for (uint32_t i = 0; i < targets.size(); i++) {
+		r_targets.write[i] = targets[i];
+	}
+	return r_targets;
+}
+
+void NavFlowField::set_navigation_layers(uint32_t p_navigation_layers) {
+	RWLockWrite write_lock(field_rwlock);
+
+	if (navigation_layers == p_navigation_layers) {
+		return;
+	}
+
+	navigation_layers = p_navigation_layers;
+	field_dirty = true;
+}
+
+const gd::Polygon &NavFlowField::_get_polygon(const NavMapIteration &p_iteration, uint32_t p_polygon_id) {
+	if (p_polygon_id < p_iteration.polygons.size()) {
+		return p_iteration.polygons[p_polygon_id];
+	}
+	return p_iteration.link_polygons[p_polygon_id - p_iteration.polygons.size()];
+}
+
+bool NavFlowField::_owner_accepts(const NavBase *p_owner) const {
+	return (p_owner->get_navigation_layers() & navigation_layers) != 0;
+}
+
+void NavFlowField::_build_connections(const NavMapIteration &p_iteration) {
+	polygon_count = p_iteration.polygons.size() + p_iteration.link_polygons.size();
+
+	// Count the connections that lead into every polygon, then fill them in polygon order.
+	incoming_offsets.resize(polygon_count + 1);
+	for (uint32_t &offset : incoming_offsets) {
+		offset = 0;
+	}
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		for (const gd::Edge &edge : _get_polygon(p_iteration, polygon_id).edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				incoming_offsets[connection.polygon->id + 1]++;
+			}
+		}
+	}
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		incoming_offsets[polygon_id + 1] += incoming_offsets[polygon_id];
+	}
+
+	incoming_connections.resize(incoming_offsets[polygon_count]);
+	LocalVector<uint32_t> cursors;
+	cursors.resize(polygon_count);
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		cursors[polygon_id] = incoming_offsets[polygon_id];
+	}
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		for (const gd::Edge &edge : _get_polygon(p_iteration, polygon_id).edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				IncomingConnection &incoming_connection = incoming_connections[cursors[connection.polygon->id]++];
+				incoming_connection.polygon = polygon_id;
+				incoming_connection.pathway_start = connection.pathway_start;
+				incoming_connection.pathway_end = connection.pathway_end;
+			}
+		}
+	}
+}
+
+void NavFlowField::_capture_owner_states(const NavMapIteration &p_iteration) {
+	HashMap<const NavBase *, uint32_t> owner_indices;
+	owner_states.clear();
+	polygon_owner_states.resize(polygon_count);
+
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		const NavBase *owner = _get_polygon(p_iteration, polygon_id).owner;
+		HashMap<const NavBase *, uint32_t>::Iterator owner_index = owner_indices.find(owner);
+		if (owner_index) {
+			polygon_owner_states[polygon_id] = owner_index->value;
+			continue;
+		}
+
+		OwnerState owner_state;
+		owner_state.owner = owner;
+		owner_state.enter_cost = owner->get_enter_cost();
+		owner_state.travel_cost = owner->get_travel_cost();
+		owner_state.navigation_layers = owner->get_navigation_layers();
+		owner_indices.insert(owner, owner_states.size());
+		polygon_owner_states[polygon_id] = owner_states.size();
+		owner_states.push_back(owner_state);
+	}
+}
+
+void NavFlowField::_find_target_polygons(const NavMapIteration &p_iteration) {
+	target_polygons.clear();
+	if (p_iteration.polygon_bvh.is_empty() || navigation_layers == 0) {
+		return;
+	}
+
+	for (const Vector3 &target : targets) {
+		NavPolygonBVH::ClosestPoint closest;
+		if (p_iteration.polygon_bvh.get_closest_point(p_iteration.polygons, target, navigation_layers, FLT_MAX, closest)) {
+			Target target_polygon;
+			target_polygon.polygon = closest.polygon_index;
+			target_polygon.point = closest.point;
+			target_polygons.push_back(target_polygon);
+		}
+	}
+}
+
+bool NavFlowField::_relax(const NavMapIteration &p_iteration, uint32_t p_from_polygon, uint32_t p_to_polygon, const Vector3 &p_pathway_start, const Vector3 &p_pathway_end) {
+	const gd::Polygon &from_polygon = _get_polygon(p_iteration, p_from_polygon);
+	if (!_owner_accepts(from_polygon.owner)) {
+		return false;
+	}
+
+	// Leaving `p_from_polygon` over the pathway, then crossing `p_to_polygon` to its anchor.
+	const gd::Polygon &to_polygon = _get_polygon(p_iteration, p_to_polygon);
+	const Vector3 pathway[2] = { p_pathway_start, p_pathway_end };
+	const Vector3 anchor = Geometry3D::get_closest_point_to_segment(anchors[p_to_polygon], pathway);
+	real_t distance = distances[p_to_polygon] + anchor.distance_to(anchors[p_to_polygon]) * to_polygon.owner->get_travel_cost();
+	if (from_polygon.owner != to_polygon.owner) {
+		distance += to_polygon.owner->get_enter_cost();
+	}
+
+	if (distance >= distances[p_from_polygon]) {
+		return false;
+	}
+
+	distances[p_from_polygon] = distance;
+	anchors[p_from_polygon] = anchor;
+	exit_starts[p_from_polygon] = p_pathway_start;
+	exit_ends[p_from_polygon] = p_pathway_end;
+	next_polygons[p_from_polygon] = p_to_polygon;
+	return true;
+}
+
+void NavFlowField::_search(const NavMapIteration &p_iteration, gd::Heap<uint32_t, DistanceGreaterThan, HeapIndexer> &p_heap) {
+	while (!p_heap.is_empty()) {
+		const uint32_t polygon_id = p_heap.pop();
+		last_update_polygon_count++;
+
+		for (uint32_t i = incoming_offsets[polygon_id]; i < incoming_offsets[polygon_id + 1]; i++) {
+			const IncomingConnection &incoming_connection = incoming_connections[i];
+			if (!_relax(p_iteration, incoming_connection.polygon, polygon_id, incoming_connection.pathway_start, incoming_connection.pathway_end)) {
+				continue;
+			}
+
+			if (heap_indices[incoming_connection.polygon] == UINT32_MAX) {
+				p_heap.push(incoming_connection.polygon);
+			} else {
+				p_heap.shift(heap_indices[incoming_connection.polygon]);
+			}
+		}
+	}
+}
+
+void NavFlowField::_compute(const NavMapIteration &p_iteration) {
+	_capture_owner_states(p_iteration);
+	_find_target_polygons(p_iteration);
+
+	distances.resize(polygon_count);
+	anchors.resize(polygon_count);
+	exit_starts.resize(polygon_count);
+	exit_ends.resize(polygon_count);
+	next_polygons.resize(polygon_count);
+	heap_indices.resize(polygon_count);
+	polygon_states.resize(polygon_count);
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		distances[polygon_id] = FLT_MAX;
+		next_polygons[polygon_id] = UINT32_MAX;
+		heap_indices[polygon_id] = UINT32_MAX;
+	}
+
+	gd::Heap<uint32_t, DistanceGreaterThan, HeapIndexer> heap(DistanceGreaterThan{ distances.ptr() }, HeapIndexer{ heap_indices.ptr() });
+
+	for (const Target &target_polygon : target_polygons) {
+		if (distances[target_polygon.polygon] == 0.0) {
+			// Another target already uses this polygon.
+			continue;
+		}
+		distances[target_polygon.polygon] = 0.0;
+		anchors[target_polygon.polygon] = target_polygon.point;
+		exit_starts[target_polygon.polygon] = target_polygon.point;
+		exit_ends[target_polygon.polygon] = target_polygon.point;
+		heap.push(target_polygon.polygon);
+	}
+
+	_search(p_iteration, heap);
+}
+
+bool NavFlowField::_repair(const NavMapIteration &p_iteration) {
+	LocalVector<bool> owner_changed;
+	owner_changed.resize(owner_states.size());
+	bool any_owner_changed = false;
+	bool any_layers_changed = false;
+	for (uint32_t i = 0; i < owner_states.size(); i++) {
+		OwnerState &owner_state = owner_states[i];
+		const NavBase *owner = owner_state.owner;
+		owner_changed[i] = owner_state.enter_cost != owner->get_enter_cost() ||
+				owner_state.travel_cost != owner->get_travel_cost() ||
+				owner_state.navigation_layers != owner->get_navigation_layers();
+		if (!owner_changed[i]) {
+			continue;
+		}
+
+		any_owner_changed = true;
+		any_layers_changed = any_layers_changed || owner_state.navigation_layers != owner->get_navigation_layers();
+		owner_state.enter_cost = owner->get_enter_cost();
+		owner_state.travel_cost = owner->get_travel_cost();
+		owner_state.navigation_layers = owner->get_navigation_layers();
+	}
+
+	if (!any_owner_changed) {
+		return false;
+	}
+
+	if (any_layers_changed) {
+		// Targets snap to the closest polygon with matching layers, so they can move to another polygon.
+		const LocalVector<Target> previous_target_polygons = target_polygons;
+		_find_target_polygons(p_iteration);
+		bool targets_changed = previous_target_polygons.size() != target_polygons.size();
+		for (uint32_t i = 0; !targets_changed && i < target_polygons.size(); i++) {
+			targets_changed = previous_target_polygons[i].polygon != target_polygons[i].polygon || previous_target_polygons[i].point != target_polygons[i].point;
+		}
+		if (targets_changed) {
+			_compute(p_iteration);
+			return true;
+		}
+	}
+
+	// Every polygon of a changed owner is affected, and so is every polygon whose route passes through one.
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		polygon_states[polygon_id] = owner_changed[polygon_owner_states[polygon_id]] ? POLYGON_STATE_AFFECTED : POLYGON_STATE_UNKNOWN;
+	}
+	LocalVector<uint32_t> route;
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		uint32_t route_polygon = polygon_id;
+		route.clear();
+		while (polygon_states[route_polygon] == POLYGON_STATE_UNKNOWN && next_polygons[route_polygon] != UINT32_MAX && route.size() < polygon_count) {
+			route.push_back(route_polygon);
+			route_polygon = next_polygons[route_polygon];
+		}
+		if (polygon_states[route_polygon] == POLYGON_STATE_UNKNOWN) {
+			// The route ends at a target or an unreachable polygon that kept its owner.
+			polygon_states[route_polygon] = POLYGON_STATE_KEPT;
+		}
+		for (uint32_t route_polygon_id : route) {
+			polygon_states[route_polygon_id] = polygon_states[route_polygon];
+		}
+	}
+
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		if (polygon_states[polygon_id] == POLYGON_STATE_AFFECTED) {
+			distances[polygon_id] = FLT_MAX;
+			next_polygons[polygon_id] = UINT32_MAX;
+		}
+	}
+
+	gd::Heap<uint32_t, DistanceGreaterThan, HeapIndexer> heap(DistanceGreaterThan{ distances.ptr() }, HeapIndexer{ heap_indices.ptr() });
+
+	for (const Target &target_polygon : target_polygons) {
+		if (polygon_states[target_polygon.polygon] != POLYGON_STATE_AFFECTED || distances[target_polygon.polygon] == 0.0) {
+			continue;
+		}
+		distances[target_polygon.polygon] = 0.0;
+		anchors[target_polygon.polygon] = target_polygon.point;
+		exit_starts[target_polygon.polygon] = target_polygon.point;
+		exit_ends[target_polygon.polygon] = target_polygon.point;
+		heap.push(target_polygon.polygon);
+	}
+
+	// Reconnect the affected polygons to the kept part of the field.
+	for (uint32_t polygon_id = 0; polygon_id < polygon_count; polygon_id++) {
+		if (polygon_states[polygon_id] != POLYGON_STATE_AFFECTED || distances[polygon_id] == 0.0) {
+			continue;
+		}
+		for (const gd::Edge &edge : _get_polygon(p_iteration, polygon_id).edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t to_polygon = connection.polygon->id;
+				if (polygon_states[to_polygon] == POLYGON_STATE_AFFECTED || distances[to_polygon] == FLT_MAX) {
+					continue;
+				}
+				if (!_relax(p_iteration, polygon_id, to_polygon, connection.pathway_start, connection.pathway_end)) {
+					continue;
+				}
+				if (heap_indices[polygon_id] == UINT32_MAX) {
+					heap.push(polygon_id);
+				} else {
+					heap.shift(heap_indices[polygon_id]);
+				}
+			}
+		}
+	}
+
+	// Cost decreases can also shorten the routes of kept polygons, the search updates those as it reaches them.
+	_search(p_iteration, heap);
+	return true;
+}
+
+void NavFlowField::update(const NavMapIteration &p_iteration) {
+	RWLockWrite write_lock(field_rwlock);
+
+	last_update_polygon_count = 0;
+
+	if (p_iteration.id != map_iteration_id || field_dirty) {
+		if (p_iteration.id != map_iteration_id || incoming_offsets.is_empty()) {
+			_build_connections(p_iteration);
+		}
+		_compute(p_iteration);
+		map_iteration_id = p_iteration.id;
+		field_dirty = false;
+		return;
+	}
+
+	_repair(p_iteration);
+}
+
+void NavFlowField::sample(const NavMapIteration &p_iteration, const Vector3 *p_positions, uint32_t p_count, Sample *r_samples) const {
+	RWLockRead read_lock(field_rwlock);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		r_samples[i] = Sample();
+	}
+
+	if (p_iteration.id != map_iteration_id || field_dirty || p_iteration.polygon_bvh.is_empty() || navigation_layers == 0) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		const Vector3 &position = p_positions[i];
+
+		NavPolygonBVH::ClosestPoint closest;
+		if (!p_iteration.polygon_bvh.get_closest_point(p_iteration.polygons, position, navigation_layers, FLT_MAX, closest)) {
+			continue;
+		}
+		const uint32_t polygon_id = closest.polygon_index;
+		if (distances[polygon_id] == FLT_MAX) {
+			continue;
+		}
+
+		Vector3 goal_point = anchors[polygon_id];
+		if (next_polygons[polygon_id] != UINT32_MAX) {
+			// Head for the closest point of the exit pathway, or past it when already standing on it.
+			const Vector3 pathway[2] = { exit_starts[polygon_id], exit_ends[polygon_id] };
+			goal_point = Geometry3D::get_closest_point_to_segment(position, pathway);
+			if (goal_point.distance_squared_to(position) < CMP_EPSILON2) {
+				goal_point = anchors[next_polygons[polygon_id]];
+			}
+		}
+
+		Sample &sample = r_samples[i];
+		sample.direction = (goal_point - position).normalized();
+		sample.distance = distances[polygon_id] + closest.point.distance_to(anchors[polygon_id]) * p_iteration.polygons[polygon_id].owner->get_travel_cost();
+	}
+}
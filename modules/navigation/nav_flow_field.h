@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  nav_flow_field.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_FLOW_FIELD_H
+#define NAV_FLOW_FIELD_H
+
+#include "nav_rid.h"
+#include "nav_utils.h"
+
+#include "core/os/rw_lock.h"
+
+class NavBase;
+class NavMap;
+struct NavMapIteration;
+
+/// Cost field over the polygons of a navigation map toward one or more targets.
+///
+/// The field is computed once with a Dijkstra search that starts at the target
+/// polygons and follows the polygon connections backwards, so every polygon
+/// stores its travel cost to the closest target and the pathway that leads
+/// there. Agents that share the targets sample the field instead of running
+/// their own path query, which costs one polygon lookup per sample.
+///
+/// The field is recomputed when the map polygons, the targets or the navigation
+/// layers change. When only the costs or navigation layers of regions and links
+/// change, the polygons whose route used them are reset and repaired from their
+/// neighbors, while the rest of the field is kept.
+class NavFlowField : public NavRid {
+public:
+	struct Sample {
+		/// Normalized direction toward the next pathway or target, zero when no target can be reached.
+		Vector3 direction;
+		/// Travel cost to the closest target, FLT_MAX when no target can be reached.
+		real_t distance = FLT_MAX;
+	};
+
+private:
+	struct IncomingConnection {
+		/// Polygon that the connection starts from.
+		uint32_t polygon = 0;
+		Vector3 pathway_start;
+		Vector3 pathway_end;
+	};
+
+	struct OwnerState {
+		const NavBase *owner = nullptr;
+		real_t enter_cost = 0.0;
+		real_t travel_cost = 1.0;
+		uint32_t navigation_layers = 0;
+	};
+
+	struct Target {
+		uint32_t polygon = 0;
+		Vector3 point;
+	};
+
+	struct DistanceGreaterThan {
+		const real_t *distances = nullptr;
+		bool operator()(uint32_t p_polygon_a, uint32_t p_polygon_b) const {
+			return distances[p_polygon_a] > distances[p_polygon_b];
+		}
+	};
+
+	struct HeapIndexer {
+		uint32_t *heap_indices = nullptr;
+		void operator()(uint32_t p_polygon, uint32_t p_heap_index) const {
+			heap_indices[p_polygon] = p_heap_index;
+		}
+	};
+
+	NavMap *map = nullptr;
+	LocalVector<Vector3> targets;
+	uint32_t navigation_layers = 1;
+	bool field_dirty = true;
+
+	/// Held for writing while the field is updated during the map sync.
+	mutable RWLock field_rwlock;
+
+	uint32_t map_iteration_id = 0;
+	uint32_t polygon_count = 0;
+	/// Connections that lead into each polygon, grouped by polygon id.
+	LocalVector<uint32_t> incoming_offsets;
+	LocalVector<IncomingConnection> incoming_connections;
+	/// Costs and layers of the polygon owners when the field was last updated.
+	LocalVector<OwnerState> owner_states;
+	/// Index in `owner_states` of the owner of each polygon.
+	LocalVector<uint32_t> polygon_owner_states;
+	/// Target polygons with the target point they lead to.
+	LocalVector<Target> target_polygons;
+
+	// Per polygon search results, indexed by polygon id. Map polygons come first, then link polygons.
+	// The distance is measured from the anchor, a point on the exit pathway or the target itself.
+	LocalVector<real_t> distances;
+	LocalVector<Vector3> anchors;
+	LocalVector<Vector3> exit_starts;
+	LocalVector<Vector3> exit_ends;
+	LocalVector<uint32_t> next_polygons;
+	LocalVector<uint32_t> heap_indices;
+	LocalVector<uint8_t> polygon_states;
+
+	uint32_t last_update_polygon_count = 0;
+
+	static const gd::Polygon &_get_polygon(const NavMapIteration &p_iteration, uint32_t p_polygon_id);
+	bool _owner_accepts(const NavBase *p_owner) const;
+
+	void _build_connections(const NavMapIteration &p_iteration);
+	void _capture_owner_states(const NavMapIteration &p_iteration);
+	void _find_target_polygons(const NavMapIteration &p_iteration);
+	bool _relax(const NavMapIteration &p_iteration, uint32_t p_from_polygon, uint32_t p_to_polygon, const Vector3 &p_pathway_start, const Vector3 &p_pathway_end);
+	void _search(const NavMapIteration &p_iteration, gd::Heap<uint32_t, DistanceGreaterThan, HeapIndexer> &p_heap);
+	void _compute(const NavMapIteration &p_iteration);
+	bool _repair(const NavMapIteration &p_iteration);
+
+public:
+	NavFlowField();
+	~NavFlowField();
+
+	void set_map(NavMap *p_map);
+	NavMap *get_map() const { return map; }
+
+	void set_targets(const Vector<Vector3> &p_targets);
+	Vector<Vector3> get_targets() const;
+
+	void set_navigation_layers(uint32_t p_navigation_layers);
+	uint32_t get_navigation_layers() const { return navigation_layers; }
+
+	/// Number of polygons searched by the last update, for profiling.
+	uint32_t get_last_update_polygon_count() const { return last_update_polygon_count; }
+
+	/// Brings the field up to date with the active map iteration, called during the map sync.
+	void update(const NavMapIteration &p_iteration);
+
+	/// Samples the field at `p_count` positions, the iteration must be the one the field was last updated with.
+	void sample(const NavMapIteration &p_iteration, const Vector3 *p_positions, uint32_t p_count, Sample *r_samples) const;
+};
+
+#endif // NAV_FLOW_FIELD_H
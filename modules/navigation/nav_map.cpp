@@ -91,6 +91,7 @@ void NavMap::set_use_edge_connections(bool p_enabled) {
 		return;
 	}
 	use_edge_connections = p_enabled;
+	relink_all_regions = true;
 	regenerate_links = true;
 }
 
@@ -99,6 +100,7 @@ void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
 		return;
 	}
 	edge_connection_margin = p_edge_connection_margin;
+	relink_all_regions = true;
 	regenerate_links = true;
 }
 
@@ -123,62 +125,104 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
-Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
-	RWLockRead read_lock(map_rwlock);
-	if (iteration_id == 0) {
+Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, bool p_use_hierarchy, real_t p_suboptimality_bound) const {
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+	if (iteration.id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector<Vector3>();
 	}
 
-	return NavMeshQueries3D::polygons_get_path(
-			polygons, p_origin, p_destination, p_optimize, p_navigation_layers,
-			r_path_types, r_path_rids, r_path_owners, up, link_polygons.size());
+	gd::PathQuerySlot *query_slot = nullptr;
+	{
+		MutexLock query_slots_lock(path_query_slots_mutex);
+		if (path_query_slots.is_empty()) {
+			query_slot = memnew(gd::PathQuerySlot);
+		} else {
+			query_slot = path_query_slots[path_query_slots.size() - 1];
+			path_query_slots.remove_at(path_query_slots.size() - 1);
+		}
+	}
+
+	const Vector<Vector3> path = NavMeshQueries3D::polygons_get_path(
+			*query_slot, iteration.polygons, iteration.polygon_bvh, p_origin, p_destination, p_optimize, p_navigation_layers,
+			r_path_types, r_path_rids, r_path_owners, iteration.map_up, iteration.link_polygons.size(),
+			p_use_hierarchy ? &_get_path_hierarchy(iteration) : nullptr, p_suboptimality_bound);
+
+	{
+		MutexLock query_slots_lock(path_query_slots_mutex);
+		path_query_slots.push_back(query_slot);
+	}
+
+	return path;
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
-	RWLockRead read_lock(map_rwlock);
-	if (iteration_id == 0) {
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+	if (iteration.id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_to_segment(polygons, p_from, p_to, p_use_collision);
+	return NavMeshQueries3D::polygons_get_closest_point_to_segment(iteration.polygons, iteration.polygon_bvh, p_from, p_to, p_use_collision);
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
-	RWLockRead read_lock(map_rwlock);
-	if (iteration_id == 0) {
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+	if (iteration.id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point(iteration.polygons, iteration.polygon_bvh, p_point);
 }
 
 Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
-	RWLockRead read_lock(map_rwlock);
-	if (iteration_id == 0) {
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+	if (iteration.id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_normal(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_normal(iteration.polygons, iteration.polygon_bvh, p_point);
 }
 
 RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
-	RWLockRead read_lock(map_rwlock);
-	if (iteration_id == 0) {
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+	if (iteration.id == 0) {
 		NAVMAP_ITERATION_ZERO_ERROR_MSG();
 		return RID();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_owner(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_owner(iteration.polygons, iteration.polygon_bvh, p_point);
 }
 
 gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_point) const {
-	RWLockRead read_lock(map_rwlock);
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+
+	return NavMeshQueries3D::polygons_get_closest_point_info(iteration.polygons, iteration.polygon_bvh, p_point);
+}
 
-	return NavMeshQueries3D::polygons_get_closest_point_info(polygons, p_point);
+const NavPathHierarchy &NavMap::_get_path_hierarchy(const NavMapIteration &p_iteration) const {
+	if (!p_iteration.path_hierarchy_built.is_set()) {
+		MutexLock hierarchy_lock(p_iteration.path_hierarchy_mutex);
+		if (!p_iteration.path_hierarchy_built.is_set()) {
+			p_iteration.path_hierarchy.build(p_iteration.polygons, p_iteration.link_polygons);
+			p_iteration.path_hierarchy_built.set();
+		}
+	}
+	return p_iteration.path_hierarchy;
 }
 
 void NavMap::add_region(NavRegion *p_region) {
@@ -190,6 +234,14 @@ void NavMap::remove_region(NavRegion *p_region) {
 	int64_t region_index = regions.find(p_region);
 	if (region_index >= 0) {
 		regions.remove_at_unordered(region_index);
+
+		// The region can be freed before the next sync, so it is unlinked right away.
+		_unlink_region(p_region, &regions_to_relink);
+		region_links.erase(p_region);
+		regions_to_relink.erase(p_region);
+		for (IterationSlotLayout &layout : iteration_slot_layouts) {
+			layout.removed_regions.push_back(p_region);
+		}
 		regenerate_links = true;
 	}
 }
@@ -207,6 +259,25 @@ void NavMap::remove_link(NavLink *p_link) {
 	}
 }
 
+void NavMap::add_flow_field(NavFlowField *p_flow_field) {
+	flow_fields.push_back(p_flow_field);
+}
+
+void NavMap::remove_flow_field(NavFlowField *p_flow_field) {
+	int64_t flow_field_index = flow_fields.find(p_flow_field);
+	if (flow_field_index >= 0) {
+		flow_fields.remove_at_unordered(flow_field_index);
+	}
+}
+
+void NavMap::sample_flow_field(const NavFlowField *p_flow_field, const Vector3 *p_positions, uint32_t p_count, NavFlowField::Sample *r_samples) const {
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+
+	p_flow_field->sample(iteration, p_positions, p_count, r_samples);
+}
+
 bool NavMap::has_agent(NavAgent *agent) const {
 	return agents.has(agent);
 }
@@ -288,6 +359,16 @@ void NavMap::remove_agent_as_controlled(NavAgent *agent) {
 }
 
 Vector3 NavMap::get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const {
+	{
+		const uint32_t slot_index = iteration_slot_index.get();
+		RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+		const NavMapIteration &iteration = iteration_slots[slot_index];
+		if (!iteration.polygon_bvh.is_empty()) {
+			return NavMeshQueries3D::polygons_get_random_point(iteration.polygons, iteration.polygon_bvh, p_navigation_layers, p_uniformly);
+		}
+	}
+
+	// Before the first synchronization there are no map polygons yet, ask the regions directly.
 	RWLockRead read_lock(map_rwlock);
 
 	const LocalVector<NavRegion *> map_regions = get_regions();
@@ -353,300 +434,721 @@ Vector3 NavMap::get_random_point(uint32_t p_navigation_layers, bool p_uniformly)
 	}
 }
 
-void NavMap::sync() {
-	RWLockWrite write_lock(map_rwlock);
+bool NavMap::_connect_free_edges(const Vector3 &p_edge_p1, const Vector3 &p_edge_p2, const Vector3 &p_other_edge_p1, const Vector3 &p_other_edge_p2, real_t p_edge_connection_margin, Vector3 &r_pathway_start, Vector3 &r_pathway_end) {
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = p_edge_p2 - p_edge_p1;
+	real_t projected_p1_ratio = edge_vector.dot(p_other_edge_p1 - p_edge_p1) / (edge_vector.length_squared());
+	real_t projected_p2_ratio = edge_vector.dot(p_other_edge_p2 - p_edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return false;
+	}
 
-	// Performance Monitor
-	int _new_pm_region_count = regions.size();
-	int _new_pm_agent_count = agents.size();
-	int _new_pm_link_count = links.size();
-	int _new_pm_polygon_count = pm_polygon_count;
-	int _new_pm_edge_count = pm_edge_count;
-	int _new_pm_edge_merge_count = pm_edge_merge_count;
-	int _new_pm_edge_connection_count = pm_edge_connection_count;
-	int _new_pm_edge_free_count = pm_edge_free_count;
-	int _new_pm_obstacle_count = obstacles.size();
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + p_edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = p_other_edge_p1;
+	} else {
+		other1 = p_other_edge_p1.lerp(p_other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > p_edge_connection_margin) {
+		return false;
+	}
 
-	// Check if we need to update the links.
-	if (regenerate_polygons) {
-		for (NavRegion *region : regions) {
-			region->scratch_polygons();
-		}
-		regenerate_links = true;
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + p_edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = p_other_edge_p2;
+	} else {
+		other2 = p_other_edge_p1.lerp(p_other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > p_edge_connection_margin) {
+		return false;
 	}
 
-	for (NavRegion *region : regions) {
-		if (region->sync()) {
-			regenerate_links = true;
+	r_pathway_start = (self1 + other1) / 2.0;
+	r_pathway_end = (self2 + other2) / 2.0;
+	return true;
+}
+
+void NavMap::_unlink_region(NavRegion *p_region, HashSet<NavRegion *> *r_border_neighbors) {
+	RegionLinks *region_link = region_links.getptr(p_region);
+	if (!region_link || !region_link->linked) {
+		return;
+	}
+
+	for (const gd::EdgeKey &key : region_link->border_keys) {
+		HashMap<gd::EdgeKey, LocalVector<RegionBorderEdge>, gd::EdgeKey>::Iterator E = region_border_edges.find(key);
+		if (!E) {
+			continue;
+		}
+		LocalVector<RegionBorderEdge> &key_edges = E->value;
+		for (int64_t i = int64_t(key_edges.size()) - 1; i >= 0; i--) {
+			if (key_edges[i].region == p_region) {
+				key_edges.remove_at(i);
+			}
+		}
+		if (key_edges.is_empty()) {
+			region_border_edges.remove(E);
+			continue;
+		}
+		if (r_border_neighbors) {
+			for (const RegionBorderEdge &key_edge : key_edges) {
+				r_border_neighbors->insert(key_edge.region);
+			}
 		}
 	}
 
-	for (NavLink *link : links) {
-		if (link->check_dirty()) {
-			regenerate_links = true;
+	// Drop the connections that lead into this region.
+	for (NavRegion *neighbor : region_link->neighbors) {
+		RegionLinks *neighbor_link = region_links.getptr(neighbor);
+		ERR_CONTINUE(!neighbor_link);
+		for (int64_t i = int64_t(neighbor_link->connections.size()) - 1; i >= 0; i--) {
+			if (neighbor_link->connections[i].target != p_region) {
+				continue;
+			}
+			if (neighbor_link->connections[i].free_edge) {
+				neighbor_link->free_connection_count--;
+			}
+			neighbor_link->connections.remove_at(i);
+		}
+		const int64_t neighbor_index = neighbor_link->neighbors.find(p_region);
+		if (neighbor_index >= 0) {
+			neighbor_link->neighbors.remove_at_unordered(neighbor_index);
 		}
+		neighbor_link->version++;
 	}
 
-	if (regenerate_links) {
-		_new_pm_polygon_count = 0;
-		_new_pm_edge_count = 0;
-		_new_pm_edge_merge_count = 0;
-		_new_pm_edge_connection_count = 0;
-		_new_pm_edge_free_count = 0;
+	region_link->border_keys.clear();
+	region_link->free_edges.clear();
+	region_link->connections.clear();
+	region_link->neighbors.clear();
+	region_link->merged_key_count = 0;
+	region_link->free_connection_count = 0;
+	region_link->linked = false;
+	region_link->version++;
+}
 
-		// Remove regions connections.
-		region_external_connections.clear();
-		for (NavRegion *region : regions) {
-			region_external_connections[region] = LocalVector<gd::Edge::Connection>();
+void NavMap::_link_region_border_edges(NavRegion *p_region) {
+	RegionLinks &region_link = region_links[p_region];
+	region_link.linked = true;
+	region_link.polygons_version = p_region->get_polygons_version();
+	region_link.bounds = p_region->get_bounds();
+	region_link.version++;
+
+	const LocalVector<gd::BorderEdge> &border_edges = p_region->get_border_edges();
+	for (uint32_t border_edge_index = 0; border_edge_index < border_edges.size(); border_edge_index++) {
+		const gd::EdgeKey &key = border_edges[border_edge_index].key;
+		LocalVector<RegionBorderEdge> &key_edges = region_border_edges[key];
+		if (key_edges.size() >= 2) {
+			// The edge is already connected with another edge, it is skipped when linking.
+			ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
 		}
 
-		// Resize the polygon count.
-		int polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
+		RegionBorderEdge key_edge;
+		key_edge.region = p_region;
+		key_edge.border_edge = border_edge_index;
+		key_edges.push_back(key_edge);
+		region_link.border_keys.push_back(key);
+	}
+}
+
+void NavMap::_add_region_connection(NavRegion *p_region, const RegionConnection &p_connection) {
+	RegionLinks *region_link = region_links.getptr(p_region);
+	RegionLinks *target_link = region_links.getptr(p_connection.target);
+	ERR_FAIL_COND(!region_link || !target_link);
+
+	region_link->connections.push_back(p_connection);
+	if (p_connection.free_edge) {
+		region_link->free_connection_count++;
+	}
+	if (!region_link->neighbors.has(p_connection.target)) {
+		region_link->neighbors.push_back(p_connection.target);
+		target_link->neighbors.push_back(p_region);
+	}
+	region_link->version++;
+}
+
+void NavMap::_link_region_edges(NavRegion *p_region, const HashSet<NavRegion *> &p_linking_regions) {
+	RegionLinks *region_link = region_links.getptr(p_region);
+	ERR_FAIL_NULL(region_link);
+
+	const LocalVector<gd::Polygon> &polygons = p_region->get_polygons();
+	const LocalVector<gd::BorderEdge> &border_edges = p_region->get_border_edges();
+	const bool use_free_edges = use_edge_connections && p_region->get_use_edge_connections();
+
+	for (uint32_t border_edge_index = 0; border_edge_index < border_edges.size(); border_edge_index++) {
+		const gd::BorderEdge &border_edge = border_edges[border_edge_index];
+		const gd::Polygon &polygon = polygons[border_edge.polygon];
+		const LocalVector<RegionBorderEdge> *key_edges = region_border_edges.getptr(border_edge.key);
+		ERR_CONTINUE(!key_edges);
+
+		if (key_edges->size() == 1) {
+			if (use_free_edges) {
+				const real_t x1 = polygon.points[border_edge.edge].pos.x;
+				const real_t x2 = polygon.points[(border_edge.edge + 1) % polygon.points.size()].pos.x;
+				RegionFreeEdge free_edge;
+				free_edge.border_edge = border_edge_index;
+				free_edge.min_x = MIN(x1, x2);
+				free_edge.max_x = MAX(x1, x2);
+				region_link->free_edges.push_back(free_edge);
 			}
-			polygon_count += region->get_polygons().size();
+			continue;
+		}
+
+		// Only the first two edges of a key are merged, a region has at most one edge per key.
+		const uint32_t self_index = (*key_edges)[0].region == p_region ? 0 : 1;
+		if ((*key_edges)[self_index].region != p_region) {
+			continue;
+		}
+		if (self_index == 0) {
+			region_link->merged_key_count++;
+		}
+
+		const RegionBorderEdge &other_key_edge = (*key_edges)[1 - self_index];
+		NavRegion *other_region = other_key_edge.region;
+		const gd::BorderEdge &other_border_edge = other_region->get_border_edges()[other_key_edge.border_edge];
+		const gd::Polygon &other_polygon = other_region->get_polygons()[other_border_edge.polygon];
+
+		// Note: The pathway_start/end are full for those connection and do not need to be modified.
+		RegionConnection connection;
+		connection.polygon = border_edge.polygon;
+		connection.edge = border_edge.edge;
+		connection.target = other_region;
+		connection.target_polygon = other_border_edge.polygon;
+		connection.target_edge = other_border_edge.edge;
+		connection.pathway_start = other_polygon.points[other_border_edge.edge].pos;
+		connection.pathway_end = other_polygon.points[(other_border_edge.edge + 1) % other_polygon.points.size()].pos;
+		_add_region_connection(p_region, connection);
+
+		if (!p_linking_regions.has(other_region)) {
+			// The other region keeps its links, only the connection back to this region is missing.
+			RegionConnection back_connection;
+			back_connection.polygon = other_border_edge.polygon;
+			back_connection.edge = other_border_edge.edge;
+			back_connection.target = p_region;
+			back_connection.target_polygon = border_edge.polygon;
+			back_connection.target_edge = border_edge.edge;
+			back_connection.pathway_start = polygon.points[border_edge.edge].pos;
+			back_connection.pathway_end = polygon.points[(border_edge.edge + 1) % polygon.points.size()].pos;
+			_add_region_connection(other_region, back_connection);
 		}
-		polygons.resize(polygon_count);
+	}
+
+	region_link->free_edges.sort();
+}
 
-		// Copy all region polygons in the map.
-		polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
+void NavMap::_link_region_free_edges(NavRegion *p_region, NavRegion *p_other_region) {
+	const RegionLinks *region_link = region_links.getptr(p_region);
+	const RegionLinks *other_link = region_links.getptr(p_other_region);
+	ERR_FAIL_COND(!region_link || !other_link);
+
+	const LocalVector<gd::Polygon> &polygons = p_region->get_polygons();
+	const LocalVector<gd::BorderEdge> &border_edges = p_region->get_border_edges();
+	const LocalVector<gd::Polygon> &other_polygons = p_other_region->get_polygons();
+	const LocalVector<gd::BorderEdge> &other_border_edges = p_other_region->get_border_edges();
+
+	// The free edges are sorted along the x axis, so only edges whose extents
+	// are within the connection margin of each other are compared.
+	for (const RegionFreeEdge &free_edge : region_link->free_edges) {
+		const real_t min_x = free_edge.min_x - edge_connection_margin;
+		const real_t max_x = free_edge.max_x + edge_connection_margin;
+
+		const gd::BorderEdge &border_edge = border_edges[free_edge.border_edge];
+		const gd::Polygon &polygon = polygons[border_edge.polygon];
+		const Vector3 &edge_p1 = polygon.points[border_edge.edge].pos;
+		const Vector3 &edge_p2 = polygon.points[(border_edge.edge + 1) % polygon.points.size()].pos;
+
+		for (uint32_t i = 0; i < other_link->free_edges.size() && other_link->free_edges[i].min_x <= max_x; i++) {
+			const RegionFreeEdge &other_free_edge = other_link->free_edges[i];
+			if (other_free_edge.max_x < min_x) {
 				continue;
 			}
-			const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
-			for (uint32_t n = 0; n < polygons_source.size(); n++) {
-				polygons[polygon_count] = polygons_source[n];
-				polygons[polygon_count].id = polygon_count;
-				polygon_count++;
+
+			const gd::BorderEdge &other_border_edge = other_border_edges[other_free_edge.border_edge];
+			const gd::Polygon &other_polygon = other_polygons[other_border_edge.polygon];
+			const Vector3 &other_edge_p1 = other_polygon.points[other_border_edge.edge].pos;
+			const Vector3 &other_edge_p2 = other_polygon.points[(other_border_edge.edge + 1) % other_polygon.points.size()].pos;
+
+			// The edges can now be connected, the pathway is computed from the point of view of each edge.
+			RegionConnection connection;
+			connection.free_edge = true;
+			if (_connect_free_edges(edge_p1, edge_p2, other_edge_p1, other_edge_p2, edge_connection_margin, connection.pathway_start, connection.pathway_end)) {
+				connection.polygon = border_edge.polygon;
+				connection.edge = border_edge.edge;
+				connection.target = p_other_region;
+				connection.target_polygon = other_border_edge.polygon;
+				connection.target_edge = other_border_edge.edge;
+				_add_region_connection(p_region, connection);
+			}
+			if (_connect_free_edges(other_edge_p1, other_edge_p2, edge_p1, edge_p2, edge_connection_margin, connection.pathway_start, connection.pathway_end)) {
+				connection.polygon = other_border_edge.polygon;
+				connection.edge = other_border_edge.edge;
+				connection.target = p_region;
+				connection.target_polygon = border_edge.polygon;
+				connection.target_edge = border_edge.edge;
+				_add_region_connection(p_other_region, connection);
 			}
 		}
+	}
+}
 
-		_new_pm_polygon_count = polygon_count;
-
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
-			for (uint32_t p = 0; p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+void NavMap::_relink_regions() {
+	// Regions that shared border edges with removed regions.
+	HashSet<NavRegion *> linking_regions = regions_to_relink;
+	regions_to_relink.clear();
 
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+	HashSet<NavRegion *> changed_regions;
+	for (NavRegion *region : regions) {
+		const RegionLinks *region_link = region_links.getptr(region);
+		const bool linked = region_link && region_link->linked;
+		if (relink_all_regions || linked != region->get_enabled() || (linked && region_link->polygons_version != region->get_polygons_version())) {
+			changed_regions.insert(region);
+		}
+	}
+	relink_all_regions = false;
+
+	// The regions sharing border edges with a changed region are relinked as well,
+	// since their edges can change between merged and free.
+	for (NavRegion *region : changed_regions) {
+		linking_regions.insert(region);
+		_unlink_region(region, &linking_regions);
+		if (!region->get_enabled()) {
+			continue;
+		}
+		for (const gd::BorderEdge &border_edge : region->get_border_edges()) {
+			const LocalVector<RegionBorderEdge> *key_edges = region_border_edges.getptr(border_edge.key);
+			if (key_edges) {
+				for (const RegionBorderEdge &key_edge : *key_edges) {
+					linking_regions.insert(key_edge.region);
 				}
 			}
 		}
+	}
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-				_new_pm_edge_merge_count += 1;
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
-					free_edges.push_back(E.value[0]);
-				}
+	if (linking_regions.is_empty()) {
+		return;
+	}
+
+	for (NavRegion *region : linking_regions) {
+		_unlink_region(region, nullptr);
+	}
+
+	// Every border edge has to be known before the merged and free edges can be told apart.
+	for (NavRegion *region : linking_regions) {
+		if (region->get_enabled()) {
+			_link_region_border_edges(region);
+		}
+	}
+	for (NavRegion *region : linking_regions) {
+		if (region->get_enabled()) {
+			_link_region_edges(region, linking_regions);
+		}
+	}
+
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	for (NavRegion *region : linking_regions) {
+		const RegionLinks *region_link = region_links.getptr(region);
+		if (!region_link || !region_link->linked || region_link->free_edges.is_empty()) {
+			continue;
+		}
+		for (NavRegion *other_region : regions) {
+			if (other_region == region || (linking_regions.has(other_region) && other_region < region)) {
+				// Pairs of relinked regions are connected once.
+				continue;
 			}
+			const RegionLinks *other_link = region_links.getptr(other_region);
+			if (!other_link || !other_link->linked || other_link->free_edges.is_empty()) {
+				continue;
+			}
+			if (region_link->bounds.grow(edge_connection_margin).intersects_inclusive(other_link->bounds)) {
+				_link_region_free_edges(region, other_region);
+			}
+		}
+	}
+}
+
+void NavMap::_free_iteration_block(NavMapIteration &p_iteration, IterationSlotLayout &p_layout, const IterationRegionBlock &p_block) {
+	for (uint32_t i = p_block.offset; i < p_block.offset + p_block.polygon_count; i++) {
+		gd::Polygon &polygon = p_iteration.polygons[i];
+		polygon.owner = &unused_polygon_owner;
+		polygon.points.clear();
+		polygon.edges.clear();
+		polygon.surface_area = 0.0;
+	}
+	p_layout.used_polygon_count -= p_block.polygon_count;
+
+	if (p_block.capacity > 0) {
+		IterationFreeBlock free_block;
+		free_block.offset = p_block.offset;
+		free_block.capacity = p_block.capacity;
+		p_layout.free_blocks.push_back(free_block);
+	}
+}
+
+uint32_t NavMap::_allocate_iteration_block(NavMapIteration &p_iteration, IterationSlotLayout &p_layout, uint32_t p_polygon_count) {
+	if (p_polygon_count == 0) {
+		return p_iteration.polygons.size();
+	}
+
+	for (uint32_t i = 0; i < p_layout.free_blocks.size(); i++) {
+		IterationFreeBlock &free_block = p_layout.free_blocks[i];
+		if (free_block.capacity < p_polygon_count) {
+			continue;
+		}
+		const uint32_t offset = free_block.offset;
+		if (free_block.capacity == p_polygon_count) {
+			p_layout.free_blocks.remove_at_unordered(i);
+		} else {
+			free_block.offset += p_polygon_count;
+			free_block.capacity -= p_polygon_count;
 		}
+		return offset;
+	}
 
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		_new_pm_edge_free_count = free_edges.size();
-
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
+	const uint32_t offset = p_iteration.polygons.size();
+	p_iteration.polygons.resize(offset + p_polygon_count);
+	return offset;
+}
 
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
+void NavMap::_connect_iteration_region(NavMapIteration &p_iteration, IterationSlotLayout &p_layout, NavRegion *p_region) {
+	const IterationRegionBlock *block = p_layout.region_blocks.getptr(p_region);
+	const RegionLinks *region_link = region_links.getptr(p_region);
+	ERR_FAIL_COND(!block || !region_link);
 
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
+	for (uint32_t i = block->offset; i < block->offset + block->polygon_count; i++) {
+		for (gd::Edge &edge : p_iteration.polygons[i].edges) {
+			edge.connections.clear();
+		}
+	}
 
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
+	// Restore the edge merges done inside the region.
+	for (const gd::EdgeMerge &merge : p_region->get_edge_merges()) {
+		gd::Polygon &polygon_a = p_iteration.polygons[block->offset + merge.polygon_a];
+		gd::Polygon &polygon_b = p_iteration.polygons[block->offset + merge.polygon_b];
+
+		gd::Edge::Connection connection_a;
+		connection_a.polygon = &polygon_a;
+		connection_a.edge = merge.edge_a;
+		connection_a.pathway_start = polygon_a.points[merge.edge_a].pos;
+		connection_a.pathway_end = polygon_a.points[(merge.edge_a + 1) % polygon_a.points.size()].pos;
+
+		gd::Edge::Connection connection_b;
+		connection_b.polygon = &polygon_b;
+		connection_b.edge = merge.edge_b;
+		connection_b.pathway_start = polygon_b.points[merge.edge_b].pos;
+		connection_b.pathway_end = polygon_b.points[(merge.edge_b + 1) % polygon_b.points.size()].pos;
+
+		polygon_a.edges[merge.edge_a].connections.push_back(connection_b);
+		polygon_b.edges[merge.edge_b].connections.push_back(connection_a);
+	}
 
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
+	LocalVector<gd::Edge::Connection> &external_connections = p_iteration.region_external_connections[p_region];
+	external_connections.clear();
+	for (const RegionConnection &region_connection : region_link->connections) {
+		const IterationRegionBlock *target_block = p_layout.region_blocks.getptr(region_connection.target);
+		ERR_CONTINUE(!target_block);
+
+		gd::Edge::Connection connection;
+		connection.polygon = &p_iteration.polygons[target_block->offset + region_connection.target_polygon];
+		connection.edge = region_connection.target_edge;
+		connection.pathway_start = region_connection.pathway_start;
+		connection.pathway_end = region_connection.pathway_end;
+		p_iteration.polygons[block->offset + region_connection.polygon].edges[region_connection.edge].connections.push_back(connection);
+		if (region_connection.free_edge) {
+			external_connections.push_back(connection);
+		}
+	}
+}
+
+void NavMap::_update_iteration_links(NavMapIteration &p_iteration, IterationSlotLayout &p_layout) {
+	uint32_t polygon_count = p_iteration.polygons.size();
+	uint32_t link_poly_idx = 0;
+	p_iteration.link_polygons.resize(links.size());
+
+	// Search for polygons within range of a nav link.
+	for (const NavLink *link : links) {
+		if (!link->get_enabled()) {
+			continue;
+		}
+		const Vector3 start = link->get_start_position();
+		const Vector3 end = link->get_end_position();
+
+		gd::Polygon *closest_start_polygon = nullptr;
+		Vector3 closest_start_point;
 
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+		gd::Polygon *closest_end_polygon = nullptr;
+		Vector3 closest_end_point;
 
-				// Add the connection to the region_connection map.
-				region_external_connections[(NavRegion *)free_edge.polygon->owner].push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
+		// Pick the polygons that are within our radius and closest to the start and end points.
+		NavPolygonBVH::ClosestPoint closest_start;
+		if (p_iteration.polygon_bvh.get_closest_point(p_iteration.polygons, start, 0, link_connection_radius, closest_start)) {
+			closest_start_point = closest_start.point;
+			closest_start_polygon = &p_iteration.polygons[closest_start.polygon_index];
+		}
+
+		NavPolygonBVH::ClosestPoint closest_end;
+		if (p_iteration.polygon_bvh.get_closest_point(p_iteration.polygons, end, 0, link_connection_radius, closest_end)) {
+			closest_end_point = closest_end.point;
+			closest_end_polygon = &p_iteration.polygons[closest_end.polygon_index];
+		}
+
+		// If we have both a start and end point, then create a synthetic polygon to route through.
+		if (closest_start_polygon && closest_end_polygon) {
+			gd::Polygon &new_polygon = p_iteration.link_polygons[link_poly_idx++];
+			new_polygon.id = polygon_count++;
+			new_polygon.owner = link;
+
+			new_polygon.edges.clear();
+			new_polygon.edges.resize(4);
+			new_polygon.points.clear();
+			new_polygon.points.reserve(4);
+
+			// Build a set of vertices that create a thin polygon going from the start to the end point.
+			new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+			new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+
+			// Setup connections to go forward in the link.
+			{
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[0].pos;
+				entry_connection.pathway_end = new_polygon.points[1].pos;
+				closest_start_polygon->edges[0].connections.push_back(entry_connection);
+				p_layout.link_entry_polygons.push_back(closest_start_polygon->id);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_end_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[2].pos;
+				exit_connection.pathway_end = new_polygon.points[3].pos;
+				new_polygon.edges[2].connections.push_back(exit_connection);
+			}
+
+			// If the link is bi-directional, create connections from the end to the start.
+			if (link->is_bidirectional()) {
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[2].pos;
+				entry_connection.pathway_end = new_polygon.points[3].pos;
+				closest_end_polygon->edges[0].connections.push_back(entry_connection);
+				p_layout.link_entry_polygons.push_back(closest_end_polygon->id);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_start_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[0].pos;
+				exit_connection.pathway_end = new_polygon.points[1].pos;
+				new_polygon.edges[0].connections.push_back(exit_connection);
 			}
 		}
+	}
+	p_iteration.link_polygons.resize(link_poly_idx);
+}
 
-		uint32_t link_poly_idx = 0;
-		link_polygons.resize(links.size());
+void NavMap::_update_iteration(NavMapIteration &p_iteration, IterationSlotLayout &p_layout) {
+	// Links are rebuilt every time, remove the connections they made into the region polygons.
+	for (uint32_t polygon_index : p_layout.link_entry_polygons) {
+		if (polygon_index >= p_iteration.polygons.size() || p_iteration.polygons[polygon_index].edges.is_empty()) {
+			continue;
+		}
+		Vector<gd::Edge::Connection> &connections = p_iteration.polygons[polygon_index].edges[0].connections;
+		for (int i = connections.size() - 1; i >= 0; i--) {
+			if (connections[i].edge == -1) {
+				connections.remove_at(i);
+			}
+		}
+	}
+	p_layout.link_entry_polygons.clear();
+
+	bool blocks_changed = !p_layout.removed_regions.is_empty();
+	for (NavRegion *region : p_layout.removed_regions) {
+		HashMap<NavRegion *, IterationRegionBlock>::Iterator block = p_layout.region_blocks.find(region);
+		if (block) {
+			_free_iteration_block(p_iteration, p_layout, block->value);
+			p_layout.region_blocks.remove(block);
+		}
+		p_iteration.region_external_connections.erase(region);
+	}
+	p_layout.removed_regions.clear();
+
+	// Start over when most of the polygons are unused.
+	const bool rebuild = p_layout.rebuild || p_iteration.polygons.size() - p_layout.used_polygon_count > MAX(p_layout.used_polygon_count, 1024u);
+	if (rebuild) {
+		p_iteration.polygons.clear();
+		p_iteration.region_external_connections.clear();
+		p_layout.region_blocks.clear();
+		p_layout.free_blocks.clear();
+		p_layout.used_polygon_count = 0;
+		p_layout.rebuild = false;
+	}
 
-		// Search for polygons within range of a nav link.
-		for (const NavLink *link : links) {
-			if (!link->get_enabled()) {
-				continue;
+	// Copy the polygons of the regions that changed since this slot was last updated.
+	// The slot storage is reused, so copying the polygons mostly reuses their point and edge buffers.
+	const gd::Polygon *polygons_ptr = p_iteration.polygons.ptr();
+	HashSet<const NavBase *> changed_regions;
+	for (NavRegion *region : regions) {
+		HashMap<NavRegion *, IterationRegionBlock>::Iterator block = p_layout.region_blocks.find(region);
+		if (!region->get_enabled()) {
+			if (block) {
+				_free_iteration_block(p_iteration, p_layout, block->value);
+				p_layout.region_blocks.remove(block);
+				p_iteration.region_external_connections.erase(region);
+				blocks_changed = true;
 			}
-			const Vector3 start = link->get_start_position();
-			const Vector3 end = link->get_end_position();
-
-			gd::Polygon *closest_start_polygon = nullptr;
-			real_t closest_start_distance = link_connection_radius;
-			Vector3 closest_start_point;
-
-			gd::Polygon *closest_end_polygon = nullptr;
-			real_t closest_end_distance = link_connection_radius;
-			Vector3 closest_end_point;
-
-			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
-
-				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
-					const Vector3 start_point = start_face.get_closest_point_to(start);
-					const real_t start_distance = start_point.distance_to(start);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
-						closest_start_distance = start_distance;
-						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
-					}
-				}
+			continue;
+		}
+		if (block && block->value.polygons_version == region->get_polygons_version()) {
+			continue;
+		}
+
+		const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
+		IterationRegionBlock new_block;
+		if (block && polygons_source.size() <= block->value.capacity) {
+			new_block = block->value;
+
+			// The polygons past the new count are left unused.
+			IterationRegionBlock unused_tail;
+			unused_tail.offset = new_block.offset + polygons_source.size();
+			unused_tail.polygon_count = new_block.polygon_count > polygons_source.size() ? new_block.polygon_count - polygons_source.size() : 0;
+			_free_iteration_block(p_iteration, p_layout, unused_tail);
+			p_layout.used_polygon_count -= new_block.polygon_count - unused_tail.polygon_count;
+		} else {
+			if (block) {
+				_free_iteration_block(p_iteration, p_layout, block->value);
 			}
+			new_block.capacity = polygons_source.size();
+			new_block.offset = _allocate_iteration_block(p_iteration, p_layout, new_block.capacity);
+		}
+		new_block.polygon_count = polygons_source.size();
+		new_block.polygons_version = region->get_polygons_version();
 
-			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
-				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
-					const Vector3 end_point = end_face.get_closest_point_to(end);
-					const real_t end_distance = end_point.distance_to(end);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
-						closest_end_distance = end_distance;
-						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
-					}
-				}
+		for (uint32_t n = 0; n < polygons_source.size(); n++) {
+			gd::Polygon &polygon = p_iteration.polygons[new_block.offset + n];
+			polygon = polygons_source[n];
+			polygon.id = new_block.offset + n;
+		}
+		p_layout.used_polygon_count += new_block.polygon_count;
+		p_layout.region_blocks.insert(region, new_block);
+
+		changed_regions.insert(region);
+		blocks_changed = true;
+	}
+
+	if (rebuild) {
+		p_iteration.polygon_bvh.build(p_iteration.polygons);
+	} else if (blocks_changed) {
+		p_iteration.polygon_bvh.update(p_iteration.polygons, changed_regions);
+	}
+
+	// Connections point into the polygons, they all have to be made again if the polygons moved.
+	const bool reconnect_all = p_iteration.polygons.ptr() != polygons_ptr;
+	for (NavRegion *region : regions) {
+		if (!region->get_enabled()) {
+			continue;
+		}
+		IterationRegionBlock *block = p_layout.region_blocks.getptr(region);
+		const RegionLinks *region_link = region_links.getptr(region);
+		ERR_CONTINUE(!block || !region_link);
+		if (!reconnect_all && !changed_regions.has(region) && block->links_version == region_link->version) {
+			continue;
+		}
+		_connect_iteration_region(p_iteration, p_layout, region);
+		block->links_version = region_link->version;
+	}
+
+	_update_iteration_links(p_iteration, p_layout);
+}
+
+void NavMap::sync() {
+	// Performance Monitor
+	int _new_pm_region_count = regions.size();
+	int _new_pm_agent_count = agents.size();
+	int _new_pm_link_count = links.size();
+	int _new_pm_polygon_count = pm_polygon_count;
+	int _new_pm_edge_count = pm_edge_count;
+	int _new_pm_edge_merge_count = pm_edge_merge_count;
+	int _new_pm_edge_connection_count = pm_edge_connection_count;
+	int _new_pm_edge_free_count = pm_edge_free_count;
+	int _new_pm_obstacle_count = obstacles.size();
+
+	{
+		// Only the region polygons and the links between the regions need exclusive access,
+		// the iteration is built from them afterwards.
+		RWLockWrite write_lock(map_rwlock);
+
+		// Check if we need to update the links.
+		if (regenerate_polygons) {
+			for (NavRegion *region : regions) {
+				region->scratch_polygons();
 			}
+			regenerate_links = true;
+		}
 
-			// If we have both a start and end point, then create a synthetic polygon to route through.
-			if (closest_start_polygon && closest_end_polygon) {
-				gd::Polygon &new_polygon = link_polygons[link_poly_idx++];
-				new_polygon.id = polygon_count++;
-				new_polygon.owner = link;
-
-				new_polygon.edges.clear();
-				new_polygon.edges.resize(4);
-				new_polygon.points.clear();
-				new_polygon.points.reserve(4);
-
-				// Build a set of vertices that create a thin polygon going from the start to the end point.
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-
-				// Setup connections to go forward in the link.
-				{
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[0].pos;
-					entry_connection.pathway_end = new_polygon.points[1].pos;
-					closest_start_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_end_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[2].pos;
-					exit_connection.pathway_end = new_polygon.points[3].pos;
-					new_polygon.edges[2].connections.push_back(exit_connection);
-				}
+		for (NavRegion *region : regions) {
+			if (region->sync()) {
+				regenerate_links = true;
+			}
+		}
 
-				// If the link is bi-directional, create connections from the end to the start.
-				if (link->is_bidirectional()) {
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[2].pos;
-					entry_connection.pathway_end = new_polygon.points[3].pos;
-					closest_end_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_start_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[0].pos;
-					exit_connection.pathway_end = new_polygon.points[1].pos;
-					new_polygon.edges[0].connections.push_back(exit_connection);
-				}
+		for (NavLink *link : links) {
+			if (link->check_dirty()) {
+				regenerate_links = true;
 			}
 		}
 
+		if (regenerate_links) {
+			_relink_regions();
+		}
+	}
+
+	if (regenerate_links) {
+		_new_pm_polygon_count = 0;
+		_new_pm_edge_count = region_border_edges.size();
+		_new_pm_edge_merge_count = 0;
+		_new_pm_edge_connection_count = 0;
+		_new_pm_edge_free_count = 0;
+		for (NavRegion *region : regions) {
+			const RegionLinks *region_link = region_links.getptr(region);
+			if (!region->get_enabled() || !region_link) {
+				continue;
+			}
+			_new_pm_polygon_count += region->get_polygons().size();
+			_new_pm_edge_count += region->get_edge_merges().size();
+			_new_pm_edge_merge_count += region->get_edge_merges().size() + region_link->merged_key_count;
+			_new_pm_edge_connection_count += region_link->free_connection_count;
+			_new_pm_edge_free_count += region_link->free_edges.size();
+		}
+
+		// Build the next iteration in the slot that queries are not reading.
+		// Only queries still holding the previous iteration can delay this lock.
+		const uint32_t next_slot_index = (iteration_slot_index.get() + 1) % ITERATION_SLOT_COUNT;
+		RWLockWrite iteration_write_lock(iteration_slot_rwlocks[next_slot_index]);
+		NavMapIteration &iteration = iteration_slots[next_slot_index];
+
+		_update_iteration(iteration, iteration_slot_layouts[next_slot_index]);
+
+		// Most maps never run hierarchical queries, the hierarchy is built by the first one.
+		iteration.path_hierarchy.clear();
+		iteration.path_hierarchy_built.clear();
+
 		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
 		iteration_id = iteration_id % UINT32_MAX + 1;
+		iteration.id = iteration_id;
+		iteration.map_up = up;
+
+		// Publish the new iteration, queries started from now on read it.
+		iteration_slot_index.set(next_slot_index);
 	}
 
 	// Do we have modified obstacle positions?
@@ -667,6 +1169,8 @@ void NavMap::sync() {
 		_update_rvo_simulation();
 	}
 
+	_update_flow_fields();
+
 	regenerate_polygons = false;
 	regenerate_links = false;
 	obstacles_dirty = false;
@@ -806,6 +1310,26 @@ void NavMap::compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent)
 	(*(agent + index))->update();
 }
 
+void NavMap::_update_flow_field(uint32_t p_index, NavFlowField **p_flow_fields) {
+	p_flow_fields[p_index]->update(iteration_slots[iteration_slot_index.get()]);
+}
+
+void NavMap::_update_flow_fields() {
+	if (flow_fields.is_empty()) {
+		return;
+	}
+
+	// Fields that are up to date return early, so only changed fields cost time here.
+	if (use_threads && flow_fields.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::_update_flow_field, flow_fields.ptr(), flow_fields.size(), -1, true, SNAME("NavigationFlowFields"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < flow_fields.size(); i++) {
+			_update_flow_field(i, flow_fields.ptr());
+		}
+	}
+}
+
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 
@@ -859,7 +1383,11 @@ void NavMap::_update_merge_rasterizer_cell_dimensions() {
 int NavMap::get_region_connections_count(NavRegion *p_region) const {
 	ERR_FAIL_NULL_V(p_region, 0);
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = region_external_connections.find(p_region);
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+
+	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = iteration.region_external_connections.find(p_region);
 	if (found_connections) {
 		return found_connections->value.size();
 	}
@@ -869,7 +1397,11 @@ int NavMap::get_region_connections_count(NavRegion *p_region) const {
 Vector3 NavMap::get_region_connection_pathway_start(NavRegion *p_region, int p_connection_id) const {
 	ERR_FAIL_NULL_V(p_region, Vector3());
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = region_external_connections.find(p_region);
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+
+	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = iteration.region_external_connections.find(p_region);
 	if (found_connections) {
 		ERR_FAIL_INDEX_V(p_connection_id, int(found_connections->value.size()), Vector3());
 		return found_connections->value[p_connection_id].pathway_start;
@@ -881,7 +1413,11 @@ Vector3 NavMap::get_region_connection_pathway_start(NavRegion *p_region, int p_c
 Vector3 NavMap::get_region_connection_pathway_end(NavRegion *p_region, int p_connection_id) const {
 	ERR_FAIL_NULL_V(p_region, Vector3());
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = region_external_connections.find(p_region);
+	const uint32_t slot_index = iteration_slot_index.get();
+	RWLockRead iteration_read_lock(iteration_slot_rwlocks[slot_index]);
+	const NavMapIteration &iteration = iteration_slots[slot_index];
+
+	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>>::ConstIterator found_connections = iteration.region_external_connections.find(p_region);
 	if (found_connections) {
 		ERR_FAIL_INDEX_V(p_connection_id, int(found_connections->value.size()), Vector3());
 		return found_connections->value[p_connection_id].pathway_end;
@@ -891,9 +1427,14 @@ Vector3 NavMap::get_region_connection_pathway_end(NavRegion *p_region, int p_con
 }
 
 NavMap::NavMap() {
+	unused_polygon_owner.set_navigation_layers(0);
 	avoidance_use_multiple_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_multiple_threads");
 	avoidance_use_high_priority_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_high_priority_threads");
 }
 
 NavMap::~NavMap() {
+	for (gd::PathQuerySlot *query_slot : path_query_slots) {
+		memdelete(query_slot);
+	}
+	path_query_slots.clear();
 }
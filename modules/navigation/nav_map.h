@@ -31,11 +31,16 @@
 #ifndef NAV_MAP_H
 #define NAV_MAP_H
 
+#include "nav_base.h"
+#include "nav_flow_field.h"
+#include "nav_path_hierarchy.h"
+#include "nav_polygon_bvh.h"
 #include "nav_rid.h"
 #include "nav_utils.h"
 
 #include "core/math/math_defs.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/navigation/navigation_globals.h"
 
 #include <KdTree2d.h>
@@ -48,6 +53,26 @@ class NavRegion;
 class NavAgent;
 class NavObstacle;
 
+/// Read-only result of a map synchronization, used by the path and closest point queries.
+struct NavMapIteration {
+	uint32_t id = 0;
+	Vector3 map_up;
+
+	/// Region polygons, stored in one block per region. Polygons between the blocks are unused,
+	/// they have no points and an owner without navigation layers.
+	LocalVector<gd::Polygon> polygons;
+	LocalVector<gd::Polygon> link_polygons;
+	/// Spatial index over the map polygons.
+	NavPolygonBVH polygon_bvh;
+	/// Cluster and portal graph used by hierarchical path queries.
+	/// Built by the first query that asks for it, see `NavMap::_get_path_hierarchy()`.
+	mutable NavPathHierarchy path_hierarchy;
+	mutable Mutex path_hierarchy_mutex;
+	mutable SafeFlag path_hierarchy_built;
+
+	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>> region_external_connections;
+};
+
 class NavMap : public NavRid {
 	RWLock map_rwlock;
 
@@ -74,16 +99,109 @@ class NavMap : public NavRid {
 
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	bool relink_all_regions = true;
 
 	/// Map regions
 	LocalVector<NavRegion *> regions;
 
+	/// Connection from a polygon edge of a region to a polygon of another region.
+	struct RegionConnection {
+		uint32_t polygon = 0;
+		uint32_t edge = 0;
+		NavRegion *target = nullptr;
+		uint32_t target_polygon = 0;
+		uint32_t target_edge = 0;
+		Vector3 pathway_start;
+		Vector3 pathway_end;
+		/// Made by the edge connection margin instead of a shared edge.
+		bool free_edge = false;
+	};
+
+	struct RegionFreeEdge {
+		uint32_t border_edge = 0;
+		real_t min_x = 0.0;
+		real_t max_x = 0.0;
+
+		bool operator<(const RegionFreeEdge &p_other) const {
+			return min_x < p_other.min_x;
+		}
+	};
+
+	/// Links of a region with the other regions. They are kept from one sync to the next,
+	/// so only the regions that changed and the regions sharing border edges with them are relinked.
+	struct RegionLinks {
+		bool linked = false;
+		uint32_t polygons_version = 0;
+		/// Incremented every time the connections of the region change.
+		uint32_t version = 0;
+		AABB bounds;
+		LocalVector<gd::EdgeKey> border_keys;
+		/// Sorted along the x axis.
+		LocalVector<RegionFreeEdge> free_edges;
+		LocalVector<RegionConnection> connections;
+		/// Regions with connections to or from this region.
+		LocalVector<NavRegion *> neighbors;
+		uint32_t merged_key_count = 0;
+		uint32_t free_connection_count = 0;
+	};
+
+	struct RegionBorderEdge {
+		NavRegion *region = nullptr;
+		uint32_t border_edge = 0;
+	};
+
+	HashMap<NavRegion *, RegionLinks> region_links;
+	/// Border edges of the linked regions, in the order they were linked.
+	HashMap<gd::EdgeKey, LocalVector<RegionBorderEdge>, gd::EdgeKey> region_border_edges;
+	/// Regions that shared border edges with removed regions.
+	HashSet<NavRegion *> regions_to_relink;
+
 	/// Map links
 	LocalVector<NavLink *> links;
-	LocalVector<gd::Polygon> link_polygons;
 
-	/// Map polygons
-	LocalVector<gd::Polygon> polygons;
+	/// Map flow fields, updated at the end of every sync.
+	LocalVector<NavFlowField *> flow_fields;
+
+	/// Queries read the active iteration while sync builds the next one in the other slot,
+	/// so a sync only waits for queries that still use the iteration before the active one.
+	static const uint32_t ITERATION_SLOT_COUNT = 2;
+	NavMapIteration iteration_slots[ITERATION_SLOT_COUNT];
+	RWLock iteration_slot_rwlocks[ITERATION_SLOT_COUNT];
+	SafeNumeric<uint32_t> iteration_slot_index;
+
+	struct IterationRegionBlock {
+		uint32_t offset = 0;
+		uint32_t capacity = 0;
+		uint32_t polygon_count = 0;
+		uint32_t polygons_version = 0;
+		uint32_t links_version = 0;
+	};
+
+	struct IterationFreeBlock {
+		uint32_t offset = 0;
+		uint32_t capacity = 0;
+	};
+
+	/// Where the region polygons are in the polygons of an iteration slot. A slot is only
+	/// updated every other sync, so it keeps its own layout and the regions removed meanwhile.
+	struct IterationSlotLayout {
+		HashMap<NavRegion *, IterationRegionBlock> region_blocks;
+		LocalVector<IterationFreeBlock> free_blocks;
+		LocalVector<NavRegion *> removed_regions;
+		/// Region polygons that have connections into link polygons.
+		LocalVector<uint32_t> link_entry_polygons;
+		uint32_t used_polygon_count = 0;
+		bool rebuild = true;
+	};
+	IterationSlotLayout iteration_slot_layouts[ITERATION_SLOT_COUNT];
+
+	/// Owner of the unused polygons of the iterations.
+	NavBase unused_polygon_owner;
+
+	/// Search buffers of path queries, reused by later queries instead of being allocated each time.
+	/// Holds one slot per query that ran at the same time as others.
+	mutable Mutex path_query_slots_mutex;
+	mutable LocalVector<gd::PathQuerySlot *> path_query_slots;
 
 	/// RVO avoidance worlds
 	RVO2D::RVOSimulator2D rvo_simulation_2d;
@@ -126,8 +244,6 @@ class NavMap : public NavRid {
 	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
 
-	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>> region_external_connections;
-
 public:
 	NavMap();
 	~NavMap();
@@ -169,7 +285,7 @@ public:
 
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
-	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, bool p_use_hierarchy = false, real_t p_suboptimality_bound = 1.0) const;
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const;
 	Vector3 get_closest_point(const Vector3 &p_point) const;
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
@@ -188,6 +304,13 @@ public:
 		return links;
 	}
 
+	void add_flow_field(NavFlowField *p_flow_field);
+	void remove_flow_field(NavFlowField *p_flow_field);
+	const LocalVector<NavFlowField *> &get_flow_fields() const {
+		return flow_fields;
+	}
+	void sample_flow_field(const NavFlowField *p_flow_field, const Vector3 *p_positions, uint32_t p_count, NavFlowField::Sample *r_samples) const;
+
 	bool has_agent(NavAgent *agent) const;
 	void add_agent(NavAgent *agent);
 	void remove_agent(NavAgent *agent);
@@ -232,12 +355,31 @@ private:
 	void compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent);
 	void compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent);
 
+	void _update_flow_field(uint32_t p_index, NavFlowField **p_flow_fields);
+	void _update_flow_fields();
+
 	void _update_rvo_simulation();
 	void _update_rvo_obstacles_tree_2d();
 	void _update_rvo_agents_tree_2d();
 	void _update_rvo_agents_tree_3d();
 
 	void _update_merge_rasterizer_cell_dimensions();
+
+	void _unlink_region(NavRegion *p_region, HashSet<NavRegion *> *r_border_neighbors);
+	void _link_region_border_edges(NavRegion *p_region);
+	void _link_region_edges(NavRegion *p_region, const HashSet<NavRegion *> &p_linking_regions);
+	void _link_region_free_edges(NavRegion *p_region, NavRegion *p_other_region);
+	void _add_region_connection(NavRegion *p_region, const RegionConnection &p_connection);
+	void _relink_regions();
+
+	void _free_iteration_block(NavMapIteration &p_iteration, IterationSlotLayout &p_layout, const IterationRegionBlock &p_block);
+	uint32_t _allocate_iteration_block(NavMapIteration &p_iteration, IterationSlotLayout &p_layout, uint32_t p_polygon_count);
+	void _connect_iteration_region(NavMapIteration &p_iteration, IterationSlotLayout &p_layout, NavRegion *p_region);
+	void _update_iteration_links(NavMapIteration &p_iteration, IterationSlotLayout &p_layout);
+	void _update_iteration(NavMapIteration &p_iteration, IterationSlotLayout &p_layout);
+	const NavPathHierarchy &_get_path_hierarchy(const NavMapIteration &p_iteration) const;
+
+	static bool _connect_free_edges(const Vector3 &p_edge_p1, const Vector3 &p_edge_p2, const Vector3 &p_other_edge_p1, const Vector3 &p_other_edge_p2, real_t p_edge_connection_margin, Vector3 &r_pathway_start, Vector3 &r_pathway_end);
 };
 
 #endif // NAV_MAP_H
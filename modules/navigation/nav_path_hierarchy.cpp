@@ -0,0 +1,270 @@
+/**************************************************************************/
+/*  nav_path_hierarchy.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_path_hierarchy.h"
+
+#include "nav_base.h"
+
+#include "core/templates/sort_array.h"
+
+bool NavPathHierarchy::_cluster_accepts(const Cluster &p_cluster, uint32_t p_navigation_layers) {
+	return (p_navigation_layers & p_cluster.owner->get_navigation_layers()) != 0;
+}
+
+void NavPathHierarchy::_build_clusters(LocalVector<ClusterBuildItem> &p_items, uint32_t p_from, uint32_t p_to, const NavBase *p_owner) {
+	const uint32_t count = p_to - p_from;
+	if (count <= MAX_CLUSTER_POLYGONS) {
+		const uint32_t cluster_index = clusters.size();
+		Cluster cluster;
+		cluster.owner = p_owner;
+		clusters.push_back(cluster);
+		for (uint32_t i = p_from; i < p_to; i++) {
+			polygon_clusters[p_items[i].polygon] = cluster_index;
+		}
+		return;
+	}
+
+	AABB center_bounds(p_items[p_from].center, Vector3());
+	for (uint32_t i = p_from + 1; i < p_to; i++) {
+		center_bounds.expand_to(p_items[i].center);
+	}
+
+	const uint32_t middle = p_from + count / 2;
+	SortArray<ClusterBuildItem, ClusterBuildItemAxisComparator> sorter;
+	sorter.compare.axis = center_bounds.get_longest_axis_index();
+	sorter.nth_element(p_from, p_to, middle, p_items.ptr());
+
+	_build_clusters(p_items, p_from, middle, p_owner);
+	_build_clusters(p_items, middle, p_to, p_owner);
+}
+
+void NavPathHierarchy::_add_polygon_portals(const gd::Polygon &p_polygon, HashMap<uint64_t, uint32_t> &r_portal_map) {
+	const uint32_t from_cluster = polygon_clusters[p_polygon.id];
+
+	for (const gd::Edge &edge : p_polygon.edges) {
+		for (const gd::Edge::Connection &connection : edge.connections) {
+			const uint32_t to_cluster = polygon_clusters[connection.polygon->id];
+			if (to_cluster == from_cluster) {
+				continue;
+			}
+
+			// Every entry point into the destination cluster is on one of these pathways.
+			const uint64_t key = (uint64_t(from_cluster) << 32) | to_cluster;
+			HashMap<uint64_t, uint32_t>::Iterator E = r_portal_map.find(key);
+			if (E) {
+				AABB &bounds = portals[E->value].bounds;
+				bounds.expand_to(connection.pathway_start);
+				bounds.expand_to(connection.pathway_end);
+			} else {
+				Portal portal;
+				portal.from_cluster = from_cluster;
+				portal.to_cluster = to_cluster;
+				portal.bounds = AABB(connection.pathway_start, Vector3());
+				portal.bounds.expand_to(connection.pathway_end);
+				r_portal_map.insert(key, portals.size());
+				portals.push_back(portal);
+			}
+		}
+	}
+}
+
+void NavPathHierarchy::build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons) {
+	clear();
+
+	if (p_polygons.is_empty()) {
+		return;
+	}
+
+	polygon_clusters.resize(p_polygons.size() + p_link_polygons.size());
+	for (uint32_t &polygon_cluster : polygon_clusters) {
+		polygon_cluster = UINT32_MAX;
+	}
+
+	// Map polygons are copied region by region, so each owner is a contiguous range.
+	LocalVector<ClusterBuildItem> items;
+	uint32_t polygon_index = 0;
+	while (polygon_index < p_polygons.size()) {
+		const NavBase *owner = p_polygons[polygon_index].owner;
+
+		items.clear();
+		for (; polygon_index < p_polygons.size() && p_polygons[polygon_index].owner == owner; polygon_index++) {
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+			if (polygon.points.is_empty()) {
+				// Unused polygon, it is never connected.
+				continue;
+			}
+
+			ClusterBuildItem item;
+			item.polygon = polygon.id;
+			for (const gd::Point &point : polygon.points) {
+				item.center += point.pos;
+			}
+			item.center /= polygon.points.size();
+			items.push_back(item);
+		}
+
+		if (!items.is_empty()) {
+			_build_clusters(items, 0, items.size(), owner);
+		}
+	}
+
+	// Links are single polygons, each one is its own cluster.
+	for (const gd::Polygon &link_polygon : p_link_polygons) {
+		ERR_CONTINUE(link_polygon.id >= polygon_clusters.size());
+		Cluster cluster;
+		cluster.owner = link_polygon.owner;
+		polygon_clusters[link_polygon.id] = clusters.size();
+		clusters.push_back(cluster);
+	}
+
+	HashMap<uint64_t, uint32_t> portal_map;
+	for (const gd::Polygon &polygon : p_polygons) {
+		_add_polygon_portals(polygon, portal_map);
+	}
+	for (const gd::Polygon &link_polygon : p_link_polygons) {
+		_add_polygon_portals(link_polygon, portal_map);
+	}
+
+	portals.sort();
+
+	for (uint32_t portal_index = 0; portal_index < portals.size(); portal_index++) {
+		Cluster &from_cluster = clusters[portals[portal_index].from_cluster];
+		if (from_cluster.outgoing_portal_count == 0) {
+			from_cluster.first_outgoing_portal = portal_index;
+		}
+		from_cluster.outgoing_portal_count++;
+		clusters[portals[portal_index].to_cluster].incoming_portal_count++;
+	}
+
+	uint32_t incoming_offset = 0;
+	for (Cluster &cluster : clusters) {
+		cluster.first_incoming_portal = incoming_offset;
+		incoming_offset += cluster.incoming_portal_count;
+		cluster.incoming_portal_count = 0;
+	}
+	incoming_portals.resize(portals.size());
+	for (uint32_t portal_index = 0; portal_index < portals.size(); portal_index++) {
+		Cluster &to_cluster = clusters[portals[portal_index].to_cluster];
+		incoming_portals[to_cluster.first_incoming_portal + to_cluster.incoming_portal_count++] = portal_index;
+	}
+}
+
+void NavPathHierarchy::clear() {
+	polygon_clusters.clear();
+	clusters.clear();
+	portals.clear();
+	incoming_portals.clear();
+}
+
+bool NavPathHierarchy::compute_goal_distances(uint32_t p_start_cluster, uint32_t p_goal_cluster, const Vector3 &p_goal_point, uint32_t p_navigation_layers, GoalDistances &r_goal_distances) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_start_cluster, clusters.size(), false);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_goal_cluster, clusters.size(), false);
+
+	r_goal_distances.goal_cluster = p_goal_cluster;
+	r_goal_distances.goal_point = p_goal_point;
+	r_goal_distances.portal_distances.resize(portals.size());
+	for (real_t &portal_distance : r_goal_distances.portal_distances) {
+		portal_distance = FLT_MAX;
+	}
+
+	if (p_start_cluster == p_goal_cluster) {
+		return true;
+	}
+
+	// Dijkstra from the goal backwards over the portals.
+	gd::Heap<PortalDistance, PortalDistanceGreaterThan> open_portals;
+
+	const Cluster &goal_cluster = clusters[p_goal_cluster];
+	for (uint32_t i = 0; i < goal_cluster.incoming_portal_count; i++) {
+		const uint32_t portal_index = incoming_portals[goal_cluster.first_incoming_portal + i];
+		PortalDistance portal_distance;
+		portal_distance.portal = portal_index;
+		portal_distance.distance = Math::sqrt(gd::aabb_distance_squared_to_point(portals[portal_index].bounds, p_goal_point));
+		r_goal_distances.portal_distances[portal_index] = portal_distance.distance;
+		open_portals.push(portal_distance);
+	}
+
+	while (!open_portals.is_empty()) {
+		const PortalDistance current = open_portals.pop();
+		if (current.distance > r_goal_distances.portal_distances[current.portal]) {
+			// Already reached with a shorter distance.
+			continue;
+		}
+
+		// The portals leading into the source cluster of this portal can only be used if that cluster is on the query layers.
+		const Portal &portal = portals[current.portal];
+		const Cluster &cluster = clusters[portal.from_cluster];
+		if (!_cluster_accepts(cluster, p_navigation_layers)) {
+			continue;
+		}
+
+		for (uint32_t i = 0; i < cluster.incoming_portal_count; i++) {
+			const uint32_t incoming_portal_index = incoming_portals[cluster.first_incoming_portal + i];
+			const real_t distance = current.distance + Math::sqrt(gd::aabb_distance_squared_to_aabb(portals[incoming_portal_index].bounds, portal.bounds));
+			if (distance < r_goal_distances.portal_distances[incoming_portal_index]) {
+				r_goal_distances.portal_distances[incoming_portal_index] = distance;
+				PortalDistance portal_distance;
+				portal_distance.portal = incoming_portal_index;
+				portal_distance.distance = distance;
+				open_portals.push(portal_distance);
+			}
+		}
+	}
+
+	const Cluster &start_cluster = clusters[p_start_cluster];
+	for (uint32_t i = 0; i < start_cluster.outgoing_portal_count; i++) {
+		if (r_goal_distances.portal_distances[start_cluster.first_outgoing_portal + i] < FLT_MAX) {
+			return true;
+		}
+	}
+	return false;
+}
+
+real_t NavPathHierarchy::get_distance_to_goal(uint32_t p_cluster, const Vector3 &p_point, const GoalDistances &p_goal_distances) const {
+	const real_t direct_distance = p_point.distance_to(p_goal_distances.goal_point);
+	if (p_cluster == p_goal_distances.goal_cluster || p_cluster >= clusters.size()) {
+		return direct_distance;
+	}
+
+	const Cluster &cluster = clusters[p_cluster];
+	real_t distance = FLT_MAX;
+	for (uint32_t portal_index = cluster.first_outgoing_portal; portal_index < cluster.first_outgoing_portal + cluster.outgoing_portal_count; portal_index++) {
+		const real_t portal_distance = p_goal_distances.portal_distances[portal_index];
+		if (portal_distance == FLT_MAX) {
+			continue;
+		}
+		distance = MIN(distance, Math::sqrt(gd::aabb_distance_squared_to_point(portals[portal_index].bounds, p_point)) + portal_distance);
+	}
+
+	if (distance == FLT_MAX) {
+		return FLT_MAX;
+	}
+	return MAX(distance, direct_distance);
+}
@@ -0,0 +1,133 @@
+/**************************************************************************/
+/*  nav_path_hierarchy.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_PATH_HIERARCHY_H
+#define NAV_PATH_HIERARCHY_H
+
+#include "nav_utils.h"
+
+#include "core/math/aabb.h"
+
+class NavBase;
+
+/// Coarse graph over the polygons of a navigation map, used to guide long path queries.
+///
+/// Polygons are grouped in clusters of nearby polygons of the same owner, and
+/// every pair of clusters that is connected by polygon edges or links gets a
+/// portal that bounds all the pathways between them. For a query, distances to
+/// the goal are computed on the portal graph, which gives the polygon search a
+/// heuristic that sees around walls and skips clusters that cannot reach the goal.
+///
+/// Portal to portal distances are measured between the portal bounds, so they never
+/// overestimate the travel distance and the heuristic stays a lower bound.
+class NavPathHierarchy {
+public:
+	struct GoalDistances {
+		uint32_t goal_cluster = UINT32_MAX;
+		Vector3 goal_point;
+		// Lower bound of the distance from each portal to the goal, FLT_MAX when the goal cannot be reached.
+		LocalVector<real_t> portal_distances;
+	};
+
+private:
+	static const uint32_t MAX_CLUSTER_POLYGONS = 256;
+
+	struct Cluster {
+		const NavBase *owner = nullptr;
+		uint32_t first_outgoing_portal = 0;
+		uint32_t outgoing_portal_count = 0;
+		uint32_t first_incoming_portal = 0;
+		uint32_t incoming_portal_count = 0;
+	};
+
+	struct Portal {
+		uint32_t from_cluster = 0;
+		uint32_t to_cluster = 0;
+		AABB bounds;
+
+		bool operator<(const Portal &p_other) const {
+			return from_cluster < p_other.from_cluster || (from_cluster == p_other.from_cluster && to_cluster < p_other.to_cluster);
+		}
+	};
+
+	struct PortalDistance {
+		uint32_t portal = 0;
+		real_t distance = 0.0;
+	};
+
+	struct PortalDistanceGreaterThan {
+		bool operator()(const PortalDistance &p_a, const PortalDistance &p_b) const {
+			return p_a.distance > p_b.distance;
+		}
+	};
+
+	struct ClusterBuildItem {
+		uint32_t polygon = 0;
+		Vector3 center;
+	};
+
+	struct ClusterBuildItemAxisComparator {
+		int axis = 0;
+		bool operator()(const ClusterBuildItem &p_a, const ClusterBuildItem &p_b) const {
+			return p_a.center[axis] < p_b.center[axis];
+		}
+	};
+
+	// Cluster of every polygon, indexed by polygon id. Map polygons come first, then link polygons.
+	LocalVector<uint32_t> polygon_clusters;
+	LocalVector<Cluster> clusters;
+	// Sorted by source cluster, so the outgoing portals of a cluster are contiguous.
+	LocalVector<Portal> portals;
+	// Portal indices sorted by destination cluster.
+	LocalVector<uint32_t> incoming_portals;
+
+	void _build_clusters(LocalVector<ClusterBuildItem> &p_items, uint32_t p_from, uint32_t p_to, const NavBase *p_owner);
+	void _add_polygon_portals(const gd::Polygon &p_polygon, HashMap<uint64_t, uint32_t> &r_portal_map);
+
+	static bool _cluster_accepts(const Cluster &p_cluster, uint32_t p_navigation_layers);
+
+public:
+	bool is_empty() const { return clusters.is_empty(); }
+
+	void build(const LocalVector<gd::Polygon> &p_polygons, const LocalVector<gd::Polygon> &p_link_polygons);
+	void clear();
+
+	uint32_t get_polygon_cluster(uint32_t p_polygon_id) const {
+		return p_polygon_id < polygon_clusters.size() ? polygon_clusters[p_polygon_id] : UINT32_MAX;
+	}
+
+	/// Computes the portal distances to `p_goal_point` inside `p_goal_cluster`.
+	/// Returns `false` when `p_start_cluster` cannot reach the goal cluster on the portal graph.
+	bool compute_goal_distances(uint32_t p_start_cluster, uint32_t p_goal_cluster, const Vector3 &p_goal_point, uint32_t p_navigation_layers, GoalDistances &r_goal_distances) const;
+	/// Lower bound of the distance from `p_point` in `p_cluster` to the goal, FLT_MAX when the goal cannot be reached.
+	real_t get_distance_to_goal(uint32_t p_cluster, const Vector3 &p_point, const GoalDistances &p_goal_distances) const;
+};
+
+#endif // NAV_PATH_HIERARCHY_H
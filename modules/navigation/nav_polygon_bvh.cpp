@@ -0,0 +1,515 @@
+/**************************************************************************/
+/*  nav_polygon_bvh.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_polygon_bvh.h"
+
+#include "nav_base.h"
+
+#include "core/math/face3.h"
+#include "core/math/geometry_3d.h"
+#include "core/templates/sort_array.h"
+
+// Polygon bounds are grown by this margin so that the epsilon used by the
+// face intersection tests can never reject a hit the tree has culled.
+#define NAV_POLYGON_BVH_BOUNDS_MARGIN 0.001
+
+// Slab test that also accepts flat boxes, returns the segment parameter where it enters the box.
+static _FORCE_INLINE_ bool _aabb_intersects_segment(const AABB &p_aabb, const Vector3 &p_from, const Vector3 &p_dir, real_t &r_enter) {
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	real_t t_min = 0.0;
+	real_t t_max = 1.0;
+	for (int i = 0; i < 3; i++) {
+		if (Math::is_zero_approx(p_dir[i])) {
+			if (p_from[i] < p_aabb.position[i] || p_from[i] > end[i]) {
+				return false;
+			}
+			continue;
+		}
+		const real_t inv_dir = 1.0 / p_dir[i];
+		real_t t_enter = (p_aabb.position[i] - p_from[i]) * inv_dir;
+		real_t t_exit = (end[i] - p_from[i]) * inv_dir;
+		if (t_enter > t_exit) {
+			SWAP(t_enter, t_exit);
+		}
+		t_min = MAX(t_min, t_enter);
+		t_max = MIN(t_max, t_exit);
+		if (t_min > t_max) {
+			return false;
+		}
+	}
+	r_enter = t_min;
+	return true;
+}
+
+bool NavPolygonBVH::_owner_accepts(const NavBase *p_owner, uint32_t p_navigation_layers) {
+	return p_navigation_layers == 0 || (p_navigation_layers & p_owner->get_navigation_layers()) != 0;
+}
+
+void NavPolygonBVH::_closest_point_on_polygon(const gd::Polygon &p_polygon, const Vector3 &p_point, uint32_t p_polygon_index, ClosestPoint &r_closest) {
+	for (uint32_t point_id = 2; point_id < p_polygon.points.size(); point_id++) {
+		const Face3 face(p_polygon.points[0].pos, p_polygon.points[point_id - 1].pos, p_polygon.points[point_id].pos);
+		const Vector3 closest_point_on_face = face.get_closest_point_to(p_point);
+		const real_t distance_squared = closest_point_on_face.distance_squared_to(p_point);
+		if (distance_squared < r_closest.distance_squared) {
+			r_closest.polygon_index = p_polygon_index;
+			r_closest.point = closest_point_on_face;
+			r_closest.normal = face.get_plane().normal;
+			r_closest.distance_squared = distance_squared;
+		}
+	}
+}
+
+uint32_t NavPolygonBVH::_build_node(LocalVector<BuildItem> &p_items, uint32_t p_from, uint32_t p_to, bool p_emit_items) {
+	const uint32_t count = p_to - p_from;
+	if (!p_emit_items && count == 1) {
+		// Top level leaves are the owner subtree roots themselves.
+		return p_items[p_from].index;
+	}
+
+	AABB aabb = p_items[p_from].aabb;
+	AABB center_bounds(p_items[p_from].center, Vector3());
+	for (uint32_t i = p_from + 1; i < p_to; i++) {
+		aabb.merge_with(p_items[i].aabb);
+		center_bounds.expand_to(p_items[i].center);
+	}
+
+	const uint32_t node_index = nodes.size();
+	nodes.push_back(Node());
+	nodes[node_index].aabb = aabb;
+
+	if (p_emit_items && count <= MAX_LEAF_ITEMS) {
+		Node &node = nodes[node_index];
+		node.first_item = items.size();
+		node.item_count = count;
+		for (uint32_t i = p_from; i < p_to; i++) {
+			items.push_back(p_items[i].index);
+			item_aabbs.push_back(p_items[i].aabb);
+		}
+		return node_index;
+	}
+
+	// Median split keeps the tree balanced, so the traversal stack depth stays bounded.
+	const uint32_t middle = p_from + count / 2;
+	SortArray<BuildItem, BuildItemAxisComparator> sorter;
+	sorter.compare.axis = center_bounds.get_longest_axis_index();
+	sorter.nth_element(p_from, p_to, middle, p_items.ptr());
+
+	const uint32_t left = _build_node(p_items, p_from, middle, p_emit_items);
+	const uint32_t right = _build_node(p_items, middle, p_to, p_emit_items);
+	nodes[node_index].children[0] = left;
+	nodes[node_index].children[1] = right;
+	return node_index;
+}
+
+void NavPolygonBVH::_build_owners(const LocalVector<gd::Polygon> &p_polygons, const HashSet<const NavBase *> *p_changed_owners) {
+	// Subtrees that may be kept, the others become unused nodes.
+	HashMap<const NavBase *, Owner> previous_owners;
+	if (p_changed_owners) {
+		for (const Owner &owner : owners) {
+			if (p_changed_owners->has(owner.owner)) {
+				unused_node_count += owner.node_count;
+			} else {
+				previous_owners.insert(owner.owner, owner);
+			}
+		}
+		unused_node_count += top_level_node_count;
+	}
+	owners.clear();
+	top_level_node_count = 0;
+
+	if (p_polygons.is_empty()) {
+		clear();
+		return;
+	}
+
+	polygon_area_prefix.resize(p_polygons.size());
+	items.reserve(p_polygons.size());
+	item_aabbs.reserve(p_polygons.size());
+
+	LocalVector<BuildItem> polygon_items;
+	LocalVector<BuildItem> owner_items;
+
+	// Map polygons are copied region by region, so each owner is a contiguous range.
+	uint32_t polygon_index = 0;
+	while (polygon_index < p_polygons.size()) {
+		Owner owner;
+		owner.owner = p_polygons[polygon_index].owner;
+		owner.first_polygon = polygon_index;
+
+		HashMap<const NavBase *, Owner>::Iterator previous_owner = previous_owners.find(owner.owner);
+		if (previous_owner) {
+			const Owner previous = previous_owner->value;
+			previous_owners.remove(previous_owner);
+
+			const uint32_t end = previous.first_polygon + previous.polygon_count;
+			if (previous.first_polygon == polygon_index && end <= p_polygons.size() && (end == p_polygons.size() || p_polygons[end].owner != owner.owner)) {
+				// The polygons of this owner did not change, neither did their subtree.
+				owner = previous;
+				nodes[owner.root].owner = owners.size();
+
+				BuildItem owner_item;
+				owner_item.index = owner.root;
+				owner_item.aabb = nodes[owner.root].aabb;
+				owner_item.center = owner_item.aabb.get_center();
+				owner_items.push_back(owner_item);
+
+				owners.push_back(owner);
+				polygon_index = end;
+				continue;
+			}
+			unused_node_count += previous.node_count;
+		}
+
+		polygon_items.clear();
+		real_t surface_area = 0.0;
+		for (; polygon_index < p_polygons.size() && p_polygons[polygon_index].owner == owner.owner; polygon_index++) {
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+			surface_area += polygon.surface_area;
+			polygon_area_prefix[polygon_index] = surface_area;
+
+			if (polygon.points.size() < 3) {
+				continue;
+			}
+
+			BuildItem item;
+			item.index = polygon_index;
+			item.aabb.position = polygon.points[0].pos;
+			for (uint32_t point_id = 1; point_id < polygon.points.size(); point_id++) {
+				item.aabb.expand_to(polygon.points[point_id].pos);
+			}
+			item.aabb.grow_by(NAV_POLYGON_BVH_BOUNDS_MARGIN);
+			item.center = item.aabb.get_center();
+			polygon_items.push_back(item);
+		}
+
+		if (polygon_items.is_empty()) {
+			continue;
+		}
+
+		owner.polygon_count = polygon_index - owner.first_polygon;
+		owner.surface_area = surface_area;
+		owner.root = _build_node(polygon_items, 0, polygon_items.size(), true);
+		owner.node_count = nodes.size() - owner.root;
+		nodes[owner.root].owner = owners.size();
+
+		BuildItem owner_item;
+		owner_item.index = owner.root;
+		owner_item.aabb = nodes[owner.root].aabb;
+		owner_item.center = owner_item.aabb.get_center();
+		owner_items.push_back(owner_item);
+
+		owners.push_back(owner);
+	}
+
+	for (const KeyValue<const NavBase *, Owner> &E : previous_owners) {
+		unused_node_count += E.value.node_count;
+	}
+
+	if (owners.is_empty()) {
+		clear();
+		return;
+	}
+
+	const uint32_t top_level_first_node = nodes.size();
+	root = _build_node(owner_items, 0, owner_items.size(), false);
+	top_level_node_count = nodes.size() - top_level_first_node;
+}
+
+void NavPolygonBVH::build(const LocalVector<gd::Polygon> &p_polygons) {
+	clear();
+	_build_owners(p_polygons, nullptr);
+}
+
+void NavPolygonBVH::update(const LocalVector<gd::Polygon> &p_polygons, const HashSet<const NavBase *> &p_changed_owners) {
+	if (owners.is_empty() || unused_node_count > nodes.size() / 2) {
+		// Nothing to keep, or too many unused nodes to keep growing the tree.
+		build(p_polygons);
+		return;
+	}
+	_build_owners(p_polygons, &p_changed_owners);
+}
+
+void NavPolygonBVH::clear() {
+	nodes.clear();
+	owners.clear();
+	items.clear();
+	item_aabbs.clear();
+	polygon_area_prefix.clear();
+	root = 0;
+	top_level_node_count = 0;
+	unused_node_count = 0;
+}
+
+bool NavPolygonBVH::get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point, uint32_t p_navigation_layers, real_t p_max_distance, ClosestPoint &r_closest) const {
+	r_closest = ClosestPoint();
+	if (owners.is_empty()) {
+		return false;
+	}
+	if (p_max_distance < FLT_MAX) {
+		r_closest.distance_squared = p_max_distance * p_max_distance;
+	}
+
+	uint32_t stack[MAX_DEPTH];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		if (gd::aabb_distance_squared_to_point(node.aabb, p_point) >= r_closest.distance_squared) {
+			continue;
+		}
+		if (node.owner >= 0 && !_owner_accepts(owners[node.owner].owner, p_navigation_layers)) {
+			continue;
+		}
+
+		if (node.item_count > 0) {
+			for (uint32_t i = node.first_item; i < node.first_item + node.item_count; i++) {
+				if (gd::aabb_distance_squared_to_point(item_aabbs[i], p_point) >= r_closest.distance_squared) {
+					continue;
+				}
+				_closest_point_on_polygon(p_polygons[items[i]], p_point, items[i], r_closest);
+			}
+			continue;
+		}
+
+		ERR_FAIL_COND_V(stack_size + 2 > MAX_DEPTH, r_closest.polygon_index != UINT32_MAX);
+
+		// Push the farther child first so the closer one is visited first and tightens the bound early.
+		const real_t distance_0 = gd::aabb_distance_squared_to_point(nodes[node.children[0]].aabb, p_point);
+		const real_t distance_1 = gd::aabb_distance_squared_to_point(nodes[node.children[1]].aabb, p_point);
+		if (distance_0 <= distance_1) {
+			stack[stack_size++] = node.children[1];
+			stack[stack_size++] = node.children[0];
+		} else {
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	return r_closest.polygon_index != UINT32_MAX;
+}
+
+bool NavPolygonBVH::get_closest_segment_intersection(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, uint32_t p_navigation_layers, Vector3 &r_point) const {
+	if (owners.is_empty()) {
+		return false;
+	}
+
+	const Vector3 dir = p_to - p_from;
+	const real_t length = dir.length();
+	real_t closest_distance = FLT_MAX;
+	bool found = false;
+
+	uint32_t stack[MAX_DEPTH];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		real_t enter = 0.0;
+		if (!_aabb_intersects_segment(node.aabb, p_from, dir, enter) || (found && enter * length > closest_distance)) {
+			continue;
+		}
+		if (node.owner >= 0 && !_owner_accepts(owners[node.owner].owner, p_navigation_layers)) {
+			continue;
+		}
+
+		if (node.item_count > 0) {
+			for (uint32_t i = node.first_item; i < node.first_item + node.item_count; i++) {
+				if (!_aabb_intersects_segment(item_aabbs[i], p_from, dir, enter)) {
+					continue;
+				}
+				const gd::Polygon &polygon = p_polygons[items[i]];
+				for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+					const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+					Vector3 intersection_point;
+					if (face.intersects_segment(p_from, p_to, &intersection_point)) {
+						const real_t distance = p_from.distance_to(intersection_point);
+						if (!found || distance < closest_distance) {
+							r_point = intersection_point;
+							closest_distance = distance;
+							found = true;
+						}
+					}
+				}
+			}
+			continue;
+		}
+
+		ERR_FAIL_COND_V(stack_size + 2 > MAX_DEPTH, found);
+		stack[stack_size++] = node.children[0];
+		stack[stack_size++] = node.children[1];
+	}
+
+	return found;
+}
+
+bool NavPolygonBVH::get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, uint32_t p_navigation_layers, Vector3 &r_point) const {
+	if (owners.is_empty()) {
+		return false;
+	}
+
+	// The distance between the boxes of the segment and of a node is a lower bound for the distance between their contents.
+	AABB segment_aabb(p_from, Vector3());
+	segment_aabb.expand_to(p_to);
+
+	real_t closest_distance = FLT_MAX;
+	bool found = false;
+
+	uint32_t stack[MAX_DEPTH];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+		if (found && gd::aabb_distance_squared_to_aabb(node.aabb, segment_aabb) >= closest_distance * closest_distance) {
+			continue;
+		}
+		if (node.owner >= 0 && !_owner_accepts(owners[node.owner].owner, p_navigation_layers)) {
+			continue;
+		}
+
+		if (node.item_count > 0) {
+			for (uint32_t i = node.first_item; i < node.first_item + node.item_count; i++) {
+				if (found && gd::aabb_distance_squared_to_aabb(item_aabbs[i], segment_aabb) >= closest_distance * closest_distance) {
+					continue;
+				}
+				const gd::Polygon &polygon = p_polygons[items[i]];
+				for (uint32_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+					const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+
+					const Vector3 from_closest = face.get_closest_point_to(p_from);
+					const real_t from_distance = p_from.distance_to(from_closest);
+					if (from_distance < closest_distance) {
+						r_point = from_closest;
+						closest_distance = from_distance;
+						found = true;
+					}
+
+					const Vector3 to_closest = face.get_closest_point_to(p_to);
+					const real_t to_distance = p_to.distance_to(to_closest);
+					if (to_distance < closest_distance) {
+						r_point = to_closest;
+						closest_distance = to_distance;
+						found = true;
+					}
+				}
+				// The shortest distance can also be between a point on a polygon edge and a point on the segment.
+				for (uint32_t point_id = 0; point_id < polygon.points.size(); point_id++) {
+					Vector3 a, b;
+					Geometry3D::get_closest_points_between_segments(
+							p_from,
+							p_to,
+							polygon.points[point_id].pos,
+							polygon.points[(point_id + 1) % polygon.points.size()].pos,
+							a,
+							b);
+
+					const real_t distance = a.distance_to(b);
+					if (distance < closest_distance) {
+						r_point = b;
+						closest_distance = distance;
+						found = true;
+					}
+				}
+			}
+			continue;
+		}
+
+		ERR_FAIL_COND_V(stack_size + 2 > MAX_DEPTH, found);
+
+		const real_t distance_0 = gd::aabb_distance_squared_to_aabb(nodes[node.children[0]].aabb, segment_aabb);
+		const real_t distance_1 = gd::aabb_distance_squared_to_aabb(nodes[node.children[1]].aabb, segment_aabb);
+		if (distance_0 <= distance_1) {
+			stack[stack_size++] = node.children[1];
+			stack[stack_size++] = node.children[0];
+		} else {
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	return found;
+}
+
+uint32_t NavPolygonBVH::get_random_polygon(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_navigation_layers, bool p_uniformly) const {
+	LocalVector<uint32_t> accessible_owners;
+	real_t accumulated_surface_area = 0.0;
+
+	for (uint32_t owner_index = 0; owner_index < owners.size(); owner_index++) {
+		const Owner &owner = owners[owner_index];
+		if ((p_navigation_layers & owner.owner->get_navigation_layers()) == 0) {
+			continue;
+		}
+		if (p_uniformly) {
+			if (owner.surface_area == 0.0) {
+				continue;
+			}
+			accumulated_surface_area += owner.surface_area;
+		}
+		accessible_owners.push_back(owner_index);
+	}
+
+	if (accessible_owners.is_empty()) {
+		return UINT32_MAX;
+	}
+
+	if (!p_uniformly) {
+		const Owner &owner = owners[accessible_owners[Math::random(int(0), accessible_owners.size() - 1)]];
+		return owner.first_polygon + Math::random(int(0), owner.polygon_count - 1);
+	}
+
+	real_t area_position = Math::random(real_t(0), accumulated_surface_area);
+	const Owner *random_owner = &owners[accessible_owners[accessible_owners.size() - 1]];
+	for (uint32_t owner_index : accessible_owners) {
+		if (area_position < owners[owner_index].surface_area) {
+			random_owner = &owners[owner_index];
+			break;
+		}
+		area_position -= owners[owner_index].surface_area;
+	}
+
+	// Binary search for the first polygon whose running area sum passes the random position.
+	area_position = Math::random(real_t(0), random_owner->surface_area);
+	uint32_t low = random_owner->first_polygon;
+	uint32_t high = random_owner->first_polygon + random_owner->polygon_count - 1;
+	while (low < high) {
+		const uint32_t middle = low + (high - low) / 2;
+		if (polygon_area_prefix[middle] > area_position) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+	// Skip back over zero area polygons at the end of the range.
+	while (low > random_owner->first_polygon && p_polygons[low].surface_area == 0.0) {
+		low--;
+	}
+	return low;
+}
@@ -0,0 +1,133 @@
+/**************************************************************************/
+/*  nav_polygon_bvh.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_POLYGON_BVH_H
+#define NAV_POLYGON_BVH_H
+
+#include "nav_utils.h"
+
+#include "core/math/aabb.h"
+#include "core/templates/hash_set.h"
+
+class NavBase;
+
+/// Static bounding volume hierarchy over the polygons of a navigation map.
+///
+/// The tree is built in two levels: every polygon owner (region) gets its own
+/// subtree, and a top level is built over the owner subtrees. The navigation
+/// layers of an owner are read when its subtree root is reached, so layer
+/// changes do not require a rebuild and whole regions are skipped at once.
+///
+/// For the closest point queries a navigation layers mask of 0 means that no
+/// layer filtering is done.
+class NavPolygonBVH {
+public:
+	struct ClosestPoint {
+		uint32_t polygon_index = UINT32_MAX;
+		Vector3 point;
+		Vector3 normal;
+		real_t distance_squared = FLT_MAX;
+	};
+
+private:
+	static const uint32_t MAX_LEAF_ITEMS = 4;
+	static const uint32_t MAX_DEPTH = 128;
+
+	struct Node {
+		AABB aabb;
+		// Leaves reference a range of `items`, internal nodes have `item_count == 0`.
+		uint32_t first_item = 0;
+		uint32_t item_count = 0;
+		uint32_t children[2] = { 0, 0 };
+		// Index in `owners` when this node is the root of an owner subtree, -1 otherwise.
+		int32_t owner = -1;
+	};
+
+	struct Owner {
+		const NavBase *owner = nullptr;
+		uint32_t first_polygon = 0;
+		uint32_t polygon_count = 0;
+		uint32_t root = 0;
+		// Nodes of the subtree, stored after `root`.
+		uint32_t node_count = 0;
+		real_t surface_area = 0.0;
+	};
+
+	struct BuildItem {
+		uint32_t index = 0;
+		AABB aabb;
+		Vector3 center;
+	};
+
+	struct BuildItemAxisComparator {
+		int axis = 0;
+		bool operator()(const BuildItem &p_a, const BuildItem &p_b) const {
+			return p_a.center[axis] < p_b.center[axis];
+		}
+	};
+
+	LocalVector<Node> nodes;
+	LocalVector<Owner> owners;
+	// Map polygon indices in tree order, and their bounds.
+	LocalVector<uint32_t> items;
+	LocalVector<AABB> item_aabbs;
+	// Running sum of the polygon surface areas, per map polygon, restarting for every owner.
+	LocalVector<real_t> polygon_area_prefix;
+	uint32_t root = 0;
+	uint32_t top_level_node_count = 0;
+	// Nodes left behind by updates, reclaimed by the next full build.
+	uint32_t unused_node_count = 0;
+
+	uint32_t _build_node(LocalVector<BuildItem> &p_items, uint32_t p_from, uint32_t p_to, bool p_emit_items);
+	void _build_owners(const LocalVector<gd::Polygon> &p_polygons, const HashSet<const NavBase *> *p_changed_owners);
+
+	static bool _owner_accepts(const NavBase *p_owner, uint32_t p_navigation_layers);
+	static void _closest_point_on_polygon(const gd::Polygon &p_polygon, const Vector3 &p_point, uint32_t p_polygon_index, ClosestPoint &r_closest);
+
+public:
+	bool is_empty() const { return owners.is_empty(); }
+
+	void build(const LocalVector<gd::Polygon> &p_polygons);
+	/// Rebuilds the subtrees of `p_changed_owners` and the top level, and keeps the subtrees
+	/// of the other owners when they still cover the same polygons.
+	void update(const LocalVector<gd::Polygon> &p_polygons, const HashSet<const NavBase *> &p_changed_owners);
+	void clear();
+
+	/// Finds the closest point on the polygons strictly closer than `p_max_distance`.
+	bool get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point, uint32_t p_navigation_layers, real_t p_max_distance, ClosestPoint &r_closest) const;
+	/// Finds the intersection of the segment with the polygons closest to `p_from`.
+	bool get_closest_segment_intersection(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, uint32_t p_navigation_layers, Vector3 &r_point) const;
+	/// Finds the point on the polygons closest to the segment, for segments that do not intersect any polygon.
+	bool get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, uint32_t p_navigation_layers, Vector3 &r_point) const;
+	/// Picks a random polygon of the owners that match `p_navigation_layers`, optionally weighted by surface area.
+	uint32_t get_random_polygon(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_navigation_layers, bool p_uniformly) const;
+};
+
+#endif // NAV_POLYGON_BVH_H
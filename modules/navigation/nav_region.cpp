@@ -143,8 +143,12 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	edge_merges.clear();
+	border_edges.clear();
+	bounds = AABB();
 	surface_area = 0.0;
 	polygons_dirty = false;
+	polygons_version++;
 
 	if (map == nullptr) {
 		return;
@@ -166,6 +170,7 @@ void NavRegion::update_polygons() {
 	polygons.resize(pending_navmesh_polygons.size());
 
 	real_t _new_region_surface_area = 0.0;
+	bool first_point = true;
 
 	// Build
 	int navigation_mesh_polygon_index = 0;
@@ -211,6 +216,13 @@ void NavRegion::update_polygons() {
 			Vector3 point_position = transform.xform(vertices_r[idx]);
 			polygon.points[j].pos = point_position;
 			polygon.points[j].key = map->get_point_key(point_position);
+
+			if (first_point) {
+				bounds.position = point_position;
+				first_point = false;
+			} else {
+				bounds.expand_to(point_position);
+			}
 		}
 
 		if (!valid) {
@@ -219,4 +231,43 @@ void NavRegion::update_polygons() {
 	}
 
 	surface_area = _new_region_surface_area;
+
+	update_edge_merges();
+}
+
+void NavRegion::update_edge_merges() {
+	// Group all edges per key.
+	HashMap<gd::EdgeKey, LocalVector<gd::BorderEdge>, gd::EdgeKey> connections;
+	for (uint32_t polygon_index = 0; polygon_index < polygons.size(); polygon_index++) {
+		const gd::Polygon &polygon = polygons[polygon_index];
+		for (uint32_t p = 0; p < polygon.points.size(); p++) {
+			const int next_point = (p + 1) % polygon.points.size();
+
+			gd::BorderEdge edge;
+			edge.polygon = polygon_index;
+			edge.edge = p;
+			edge.key = gd::EdgeKey(polygon.points[p].key, polygon.points[next_point].key);
+
+			LocalVector<gd::BorderEdge> &key_edges = connections[edge.key];
+			if (key_edges.size() <= 1) {
+				key_edges.push_back(edge);
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+			}
+		}
+	}
+
+	for (const KeyValue<gd::EdgeKey, LocalVector<gd::BorderEdge>> &E : connections) {
+		if (E.value.size() == 2) {
+			gd::EdgeMerge merge;
+			merge.polygon_a = E.value[0].polygon;
+			merge.edge_a = E.value[0].edge;
+			merge.polygon_b = E.value[1].polygon;
+			merge.edge_b = E.value[1].edge;
+			edge_merges.push_back(merge);
+		} else {
+			border_edges.push_back(E.value[0]);
+		}
+	}
 }
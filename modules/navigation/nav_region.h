@@ -50,6 +50,13 @@ class NavRegion : public NavBase {
 
 	/// Cache
 	LocalVector<gd::Polygon> polygons;
+	/// Edges merged between polygons of this region, and the edges left for the map to connect.
+	/// They only change with the polygons, so the map does not need to relink them every sync.
+	LocalVector<gd::EdgeMerge> edge_merges;
+	LocalVector<gd::BorderEdge> border_edges;
+	/// Incremented every time the polygons are rebuilt, so the map knows which regions to relink.
+	uint32_t polygons_version = 0;
+	AABB bounds;
 
 	real_t surface_area = 0.0;
 
@@ -90,6 +97,17 @@ public:
 		return polygons;
 	}
 
+	const LocalVector<gd::EdgeMerge> &get_edge_merges() const {
+		return edge_merges;
+	}
+
+	const LocalVector<gd::BorderEdge> &get_border_edges() const {
+		return border_edges;
+	}
+
+	uint32_t get_polygons_version() const { return polygons_version; }
+	const AABB &get_bounds() const { return bounds; }
+
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, bool p_use_collision) const;
 	gd::ClosestPointQueryResult get_closest_point_info(const Vector3 &p_point) const;
 	Vector3 get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const;
@@ -100,6 +118,7 @@ public:
 
 private:
 	void update_polygons();
+	void update_edge_merges();
 };
 
 #endif // NAV_REGION_H
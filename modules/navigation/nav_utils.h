@@ -31,6 +31,7 @@
 #ifndef NAV_UTILS_H
 #define NAV_UTILS_H
 
+#include "core/math/aabb.h"
 #include "core/math/vector3.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hashfuncs.h"
@@ -113,6 +114,21 @@ struct Polygon {
 	real_t surface_area = 0.0;
 };
 
+/// Two edges of polygons of the same region that share their points.
+struct EdgeMerge {
+	uint32_t polygon_a = 0;
+	uint32_t edge_a = 0;
+	uint32_t polygon_b = 0;
+	uint32_t edge_b = 0;
+};
+
+/// An edge that is not shared with another polygon of the same region.
+struct BorderEdge {
+	uint32_t polygon = 0;
+	uint32_t edge = 0;
+	EdgeKey key;
+};
+
 struct NavigationPoly {
 	/// This poly.
 	const Polygon *poly = nullptr;
@@ -169,6 +185,27 @@ struct NavPolyHeapIndexer {
 	}
 };
 
+inline real_t aabb_distance_squared_to_point(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	real_t distance_squared = 0.0;
+	for (int i = 0; i < 3; i++) {
+		const real_t gap = MAX(MAX(p_aabb.position[i] - p_point[i], p_point[i] - end[i]), real_t(0.0));
+		distance_squared += gap * gap;
+	}
+	return distance_squared;
+}
+
+inline real_t aabb_distance_squared_to_aabb(const AABB &p_aabb, const AABB &p_other) {
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	const Vector3 other_end = p_other.position + p_other.size;
+	real_t distance_squared = 0.0;
+	for (int i = 0; i < 3; i++) {
+		const real_t gap = MAX(MAX(p_aabb.position[i] - other_end[i], p_other.position[i] - end[i]), real_t(0.0));
+		distance_squared += gap * gap;
+	}
+	return distance_squared;
+}
+
 struct ClosestPointQueryResult {
 	Vector3 point;
 	Vector3 normal;
@@ -298,6 +335,19 @@ private:
 		}
 	}
 };
+
+/// Search buffers of a path query, kept between queries so repeated searches don't reallocate them.
+struct PathQuerySlot {
+	LocalVector<NavigationPoly> navigation_polys;
+	Heap<NavigationPoly *, NavPolyTravelCostGreaterThan, NavPolyHeapIndexer> traversable_polys;
+
+	void reset(uint32_t p_navigation_poly_count) {
+		traversable_polys.clear();
+		// `clear()` keeps the capacity, so this only reallocates when the map grew.
+		navigation_polys.clear();
+		navigation_polys.resize(p_navigation_poly_count);
+	}
+};
 } // namespace gd
 
 #endif // NAV_UTILS_H
@@ -0,0 +1,223 @@
+/**************************************************************************/
+/*  test_raycast_occlusion_cull.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RAYCAST_OCCLUSION_CULL_H
+#define TEST_RAYCAST_OCCLUSION_CULL_H
+
+#include "../raycast_occlusion_cull.h"
+
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+#include "servers/rendering/raster_occlusion_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRaycastOcclusionCull {
+
+// Two rows of walls with gaps in front of a camera looking down -Z,
+// set up the same way in any occlusion culling backend.
+class OccluderWalls {
+	RendererSceneOcclusionCull *backend = nullptr;
+	RID occluder;
+	RID scenario = RID::from_uint64(1);
+	RID buffer = RID::from_uint64(2);
+	Vector<RID> instances;
+
+	void _add_wall(const Vector3 &p_center, const Vector2 &p_size) {
+		RID instance = RID::from_uint64(100 + instances.size());
+		backend->scenario_set_instance(scenario, instance, occluder, Transform3D(Basis().scaled(Vector3(p_size.x, p_size.y, 1)), p_center), true);
+		instances.push_back(instance);
+	}
+
+public:
+	Transform3D cam_transform;
+	Projection cam_projection = Projection::create_perspective(75, 16.0 / 9.0, 0.05, 200);
+
+	OccluderWalls(RendererSceneOcclusionCull *p_backend) {
+		backend = p_backend;
+
+		// A unit quad in the XY plane, scaled into walls.
+		PackedVector3Array vertices;
+		vertices.push_back(Vector3(-0.5, -0.5, 0));
+		vertices.push_back(Vector3(0.5, -0.5, 0));
+		vertices.push_back(Vector3(0.5, 0.5, 0));
+		vertices.push_back(Vector3(-0.5, 0.5, 0));
+		PackedInt32Array indices;
+		indices.push_back(0);
+		indices.push_back(1);
+		indices.push_back(2);
+		indices.push_back(0);
+		indices.push_back(2);
+		indices.push_back(3);
+
+		occluder = backend->occluder_allocate();
+		backend->occluder_initialize(occluder);
+		backend->occluder_set_mesh(occluder, vertices, indices);
+
+		backend->add_scenario(scenario);
+		for (int i = 0; i < 3; i++) {
+			_add_wall(Vector3(-12 + i * 12, 0, -15), Vector2(8, 10));
+		}
+		for (int i = 0; i < 4; i++) {
+			_add_wall(Vector3(-24 + i * 18, 2, -35), Vector2(10, 14));
+		}
+
+		backend->add_buffer(buffer);
+		backend->buffer_set_scenario(buffer, scenario);
+		backend->buffer_set_size(buffer, Vector2i(320, 180));
+	}
+
+	~OccluderWalls() {
+		for (const RID &instance : instances) {
+			backend->scenario_remove_instance(scenario, instance);
+		}
+		backend->remove_buffer(buffer);
+		backend->remove_scenario(scenario);
+		backend->free_occluder(occluder);
+	}
+
+	void update() {
+		backend->buffer_update(buffer, cam_transform, cam_projection, false);
+	}
+
+	bool is_occluded(const AABB &p_box) {
+		const Vector3 end = p_box.get_end();
+		const real_t bounds[6] = { p_box.position.x, p_box.position.y, p_box.position.z, end.x, end.y, end.z };
+		uint64_t occlusion_timeout = 0;
+		return backend->buffer_get_ptr(buffer)->is_occluded(bounds, cam_transform.origin, cam_transform.affine_inverse(), cam_projection, cam_projection.get_z_near(), occlusion_timeout);
+	}
+
+	// Embree builds the scene on a separate thread, so the first updates may still see an empty scene.
+	bool wait_for_occluders() {
+		const AABB behind_middle_wall(Vector3(-1, -1, -30), Vector3(2, 2, 2));
+		for (int i = 0; i < 500; i++) {
+			update();
+			if (is_occluded(behind_middle_wall)) {
+				return true;
+			}
+			OS::get_singleton()->delay_usec(1000);
+		}
+		return false;
+	}
+};
+
+static Vector<AABB> create_boxes(int p_count) {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(31);
+
+	Vector<AABB> boxes;
+	for (int i = 0; i < p_count; i++) {
+		Vector3 position(rng->randf_range(-60, 60), rng->randf_range(-30, 30), rng->randf_range(-100, -5));
+		Vector3 size(rng->randf_range(0.5, 3), rng->randf_range(0.5, 3), rng->randf_range(0.5, 3));
+		boxes.push_back(AABB(position, size));
+	}
+	return boxes;
+}
+
+// Occlusion timers would delay the results otherwise.
+class JitterDisabled {
+	bool jitter_was_enabled = false;
+
+public:
+	JitterDisabled() {
+		jitter_was_enabled = RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled;
+		RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = false;
+	}
+
+	~JitterDisabled() {
+		RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = jitter_was_enabled;
+	}
+};
+
+TEST_CASE("[RaycastOcclusionCull] The raster backend culls the same boxes as the raycast backend") {
+	JitterDisabled jitter_disabled;
+	RasterOcclusionCull raster;
+	RaycastOcclusionCull raycast;
+
+	OccluderWalls raster_walls(&raster);
+	OccluderWalls raycast_walls(&raycast);
+	raster_walls.update();
+	REQUIRE(raycast_walls.wait_for_occluders());
+
+	const Vector<AABB> boxes = create_boxes(4000);
+	int raster_culled = 0;
+	int raycast_culled = 0;
+	int raster_only_culled = 0;
+	for (const AABB &box : boxes) {
+		bool raster_occluded = raster_walls.is_occluded(box);
+		bool raycast_occluded = raycast_walls.is_occluded(box);
+		raster_culled += raster_occluded;
+		raycast_culled += raycast_occluded;
+		raster_only_culled += raster_occluded && !raycast_occluded;
+	}
+
+	REQUIRE(raycast_culled > 0);
+	// The backends sample pixels slightly differently, so boxes at the edges of walls may differ.
+	CHECK_MESSAGE(Math::abs(raster_culled - raycast_culled) <= raycast_culled / 20, vformat("Raster culled %d boxes, raycast culled %d.", raster_culled, raycast_culled));
+	CHECK_MESSAGE(raster_only_culled <= raycast_culled / 20, vformat("%d boxes were only culled by the raster backend.", raster_only_culled));
+}
+
+TEST_CASE("[Stress][RaycastOcclusionCull] Updating the raster and raycast occlusion buffers") {
+	JitterDisabled jitter_disabled;
+	RasterOcclusionCull raster;
+	RaycastOcclusionCull raycast;
+
+	OccluderWalls raster_walls(&raster);
+	OccluderWalls raycast_walls(&raycast);
+	raster_walls.update();
+	REQUIRE(raycast_walls.wait_for_occluders());
+
+	const int update_count = 100;
+	OccluderWalls *walls[2] = { &raster_walls, &raycast_walls };
+	uint64_t usec[2] = {};
+	for (int mode = 0; mode < 2; mode++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < update_count; i++) {
+			walls[mode]->update();
+		}
+		usec[mode] = OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	const Vector<AABB> boxes = create_boxes(20000);
+	int culled[2] = {};
+	for (int mode = 0; mode < 2; mode++) {
+		for (const AABB &box : boxes) {
+			culled[mode] += walls[mode]->is_occluded(box);
+		}
+	}
+
+	MESSAGE("Occlusion buffer updates over ", update_count, " frames, raster: ", usec[0], " usec, raycast: ", usec[1], " usec.");
+	MESSAGE("Boxes culled out of ", boxes.size(), ", raster: ", culled[0], ", raycast: ", culled[1], ".");
+}
+
+} // namespace TestRaycastOcclusionCull
+
+#endif // TEST_RAYCAST_OCCLUSION_CULL_H
@@ -34,8 +34,7 @@
 #define FLOOR_ANGLE_THRESHOLD 0.01
 
 bool CharacterBody2D::move_and_slide() {
-	// Hack in order to work with calling from _process as well as from _physics_process; calling from thread is risky.
-	double delta = Engine::get_singleton()->is_in_physics_frame() ? get_physics_process_delta_time() : get_process_delta_time();
+	double delta = _get_slide_delta();
 
 	Vector2 current_platform_velocity = platform_velocity;
 	Transform2D gt = get_global_transform();
@@ -109,6 +108,90 @@ bool CharacterBody2D::move_and_slide() {
 	return motion_results.size() > 0;
 }
 
+void CharacterBody2D::move_and_slide_batch(const TypedArray<CharacterBody2D> &p_bodies) {
+	LocalVector<CharacterBody2D *> bodies;
+	bodies.reserve(p_bodies.size());
+	for (int i = 0; i < p_bodies.size(); i++) {
+		CharacterBody2D *body = Object::cast_to<CharacterBody2D>(p_bodies[i]);
+		ERR_CONTINUE_MSG(!body, "Only CharacterBody2D nodes can be moved in a batch.");
+		ERR_CONTINUE(!body->is_inside_tree());
+		bodies.push_back(body);
+	}
+
+	// The first slide motion of every body only depends on its current state,
+	// so it can be tested up front for the whole crowd in one server call.
+	LocalVector<CharacterBody2D *> batched_bodies;
+	LocalVector<RID> rids;
+	LocalVector<PhysicsServer2D::MotionParameters> parameters;
+	batched_bodies.reserve(bodies.size());
+	rids.reserve(bodies.size());
+	parameters.reserve(bodies.size());
+
+	for (CharacterBody2D *body : bodies) {
+		body->batched_motion.pending = false;
+		if ((body->on_floor || body->on_wall) && body->platform_rid.is_valid()) {
+			// The platform motion is tested first and moves the body, so the slide motion can't be predicted.
+			continue;
+		}
+
+		Vector2 motion = body->velocity * body->_get_slide_delta();
+
+		batched_bodies.push_back(body);
+		rids.push_back(body->get_rid());
+		parameters.push_back(body->_get_slide_motion_parameters(motion));
+	}
+
+	if (!batched_bodies.is_empty()) {
+		LocalVector<PhysicsServer2D::MotionResult> results;
+		LocalVector<bool> collided;
+		results.resize(batched_bodies.size());
+		collided.resize(batched_bodies.size());
+
+		PhysicsServer2D::get_singleton()->body_test_motion_batch(rids.ptr(), parameters.ptr(), results.ptr(), collided.ptr(), batched_bodies.size());
+
+		for (uint32_t i = 0; i < batched_bodies.size(); i++) {
+			BatchedMotion &batched_motion = batched_bodies[i]->batched_motion;
+			batched_motion.parameters = parameters[i];
+			batched_motion.result = results[i];
+			batched_motion.collided = collided[i];
+			batched_motion.pending = true;
+		}
+	}
+
+	for (CharacterBody2D *body : bodies) {
+		body->move_and_slide();
+		body->batched_motion.pending = false;
+	}
+}
+
+bool CharacterBody2D::_test_motion(const PhysicsServer2D::MotionParameters &p_parameters, PhysicsServer2D::MotionResult &r_result) {
+	if (batched_motion.pending) {
+		// Only the first motion test of move_and_slide() can match the batched one.
+		batched_motion.pending = false;
+
+		const PhysicsServer2D::MotionParameters &batched = batched_motion.parameters;
+		if (p_parameters.from == batched.from && p_parameters.motion == batched.motion && p_parameters.margin == batched.margin &&
+				p_parameters.collide_separation_ray == batched.collide_separation_ray && p_parameters.recovery_as_collision == batched.recovery_as_collision &&
+				p_parameters.exclude_bodies.is_empty() && p_parameters.exclude_objects.is_empty()) {
+			r_result = batched_motion.result;
+			return batched_motion.collided;
+		}
+	}
+
+	return PhysicsBody2D::_test_motion(p_parameters, r_result);
+}
+
+double CharacterBody2D::_get_slide_delta() const {
+	// Hack in order to work with calling from _process as well as from _physics_process; calling from thread is risky.
+	return Engine::get_singleton()->is_in_physics_frame() ? get_physics_process_delta_time() : get_process_delta_time();
+}
+
+PhysicsServer2D::MotionParameters CharacterBody2D::_get_slide_motion_parameters(const Vector2 &p_motion) const {
+	PhysicsServer2D::MotionParameters parameters(get_global_transform(), p_motion, margin);
+	parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
+	return parameters;
+}
+
 void CharacterBody2D::_move_and_slide_grounded(double p_delta, bool p_was_on_floor) {
 	Vector2 motion = velocity * p_delta;
 	Vector2 motion_slide_up = motion.slide(up_direction);
@@ -132,8 +215,7 @@ void CharacterBody2D::_move_and_slide_grounded(double p_delta, bool p_was_on_flo
 	Vector2 last_travel;
 
 	for (int iteration = 0; iteration < max_slides; ++iteration) {
-		PhysicsServer2D::MotionParameters parameters(get_global_transform(), motion, margin);
-		parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
+		PhysicsServer2D::MotionParameters parameters = _get_slide_motion_parameters(motion);
 
 		Vector2 prev_position = parameters.from.columns[2];
 
@@ -289,8 +371,7 @@ void CharacterBody2D::_move_and_slide_floating(double p_delta) {
 
 	bool first_slide = true;
 	for (int iteration = 0; iteration < max_slides; ++iteration) {
-		PhysicsServer2D::MotionParameters parameters(get_global_transform(), motion, margin);
-		parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
+		PhysicsServer2D::MotionParameters parameters = _get_slide_motion_parameters(motion);
 
 		PhysicsServer2D::MotionResult result;
 		bool collided = move_and_collide(parameters, result, false, false);
@@ -659,6 +740,7 @@ void CharacterBody2D::_validate_property(PropertyInfo &p_property) const {
 
 void CharacterBody2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("move_and_slide"), &CharacterBody2D::move_and_slide);
+	ClassDB::bind_static_method("CharacterBody2D", D_METHOD("move_and_slide_batch", "bodies"), &CharacterBody2D::move_and_slide_batch);
 	ClassDB::bind_method(D_METHOD("apply_floor_snap"), &CharacterBody2D::apply_floor_snap);
 
 	ClassDB::bind_method(D_METHOD("set_velocity", "velocity"), &CharacterBody2D::set_velocity);
@@ -48,6 +48,7 @@ public:
 		PLATFORM_ON_LEAVE_DO_NOTHING,
 	};
 	bool move_and_slide();
+	static void move_and_slide_batch(const TypedArray<CharacterBody2D> &p_bodies);
 	void apply_floor_snap();
 
 	const Vector2 &get_velocity() const;
@@ -147,6 +148,19 @@ private:
 	Vector<PhysicsServer2D::MotionResult> motion_results;
 	Vector<Ref<KinematicCollision2D>> slide_colliders;
 
+	// Motion tested ahead of time by move_and_slide_batch().
+	struct BatchedMotion {
+		PhysicsServer2D::MotionParameters parameters;
+		PhysicsServer2D::MotionResult result;
+		bool collided = false;
+		bool pending = false;
+	};
+
+	BatchedMotion batched_motion;
+
+	double _get_slide_delta() const;
+	PhysicsServer2D::MotionParameters _get_slide_motion_parameters(const Vector2 &p_motion) const;
+
 	void _move_and_slide_floating(double p_delta);
 	void _move_and_slide_grounded(double p_delta, bool p_was_on_floor);
 
@@ -164,6 +178,8 @@ protected:
 	void _notification(int p_what);
 	static void _bind_methods();
 	void _validate_property(PropertyInfo &p_property) const;
+
+	virtual bool _test_motion(const PhysicsServer2D::MotionParameters &p_parameters, PhysicsServer2D::MotionResult &r_result) override;
 };
 
 VARIANT_ENUM_CAST(CharacterBody2D::MotionMode);
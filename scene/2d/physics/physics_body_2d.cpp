@@ -66,12 +66,16 @@ Ref<KinematicCollision2D> PhysicsBody2D::_move(const Vector2 &p_motion, bool p_t
 	return Ref<KinematicCollision2D>();
 }
 
+bool PhysicsBody2D::_test_motion(const PhysicsServer2D::MotionParameters &p_parameters, PhysicsServer2D::MotionResult &r_result) {
+	return PhysicsServer2D::get_singleton()->body_test_motion(get_rid(), p_parameters, &r_result);
+}
+
 bool PhysicsBody2D::move_and_collide(const PhysicsServer2D::MotionParameters &p_parameters, PhysicsServer2D::MotionResult &r_result, bool p_test_only, bool p_cancel_sliding) {
 	if (is_only_update_transform_changes_enabled()) {
 		ERR_PRINT("Move functions do not work together with 'sync to physics' option. See the documentation for details.");
 	}
 
-	bool colliding = PhysicsServer2D::get_singleton()->body_test_motion(get_rid(), p_parameters, &r_result);
+	bool colliding = _test_motion(p_parameters, r_result);
 
 	// Restore direction of motion to be along original motion,
 	// in order to avoid sliding due to recovery,
@@ -343,6 +343,18 @@ void MeshInstance3D::_notification(int p_what) {
 	}
 }
 
+void MeshInstance3D::set_batched(bool p_batched) {
+	if (batched == p_batched) {
+		return;
+	}
+	batched = p_batched;
+	_update_visibility();
+}
+
+bool MeshInstance3D::is_batched() const {
+	return batched;
+}
+
 int MeshInstance3D::get_surface_override_material_count() const {
 	return surface_override_materials.size();
 }
@@ -45,6 +45,7 @@ protected:
 	Ref<Skin> skin_internal;
 	Ref<SkinReference> skin_ref;
 	NodePath skeleton_path = NodePath("..");
+	bool batched = false;
 
 	LocalVector<float> blend_shape_tracks;
 	HashMap<StringName, int> blend_shape_properties;
@@ -62,6 +63,8 @@ protected:
 	void _notification(int p_what);
 	static void _bind_methods();
 
+	virtual bool _is_drawn_elsewhere() const override { return batched; }
+
 	bool _property_can_revert(const StringName &p_name) const;
 	bool _property_get_revert(const StringName &p_name, Variant &r_property) const;
 
@@ -77,6 +80,10 @@ public:
 
 	Ref<SkinReference> get_skin_reference() const;
 
+	// Set by StaticBatch3D while the mesh is drawn as part of a merged one.
+	void set_batched(bool p_batched);
+	bool is_batched() const;
+
 	int get_blend_shape_count() const;
 	int find_blend_shape_by_name(const StringName &p_name);
 	float get_blend_shape_value(int p_blend_shape) const;
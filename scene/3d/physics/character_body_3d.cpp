@@ -34,14 +34,9 @@
 #define FLOOR_ANGLE_THRESHOLD 0.01
 
 bool CharacterBody3D::move_and_slide() {
-	// Hack in order to work with calling from _process as well as from _physics_process; calling from thread is risky
-	double delta = Engine::get_singleton()->is_in_physics_frame() ? get_physics_process_delta_time() : get_process_delta_time();
+	double delta = _get_slide_delta();
 
-	for (int i = 0; i < 3; i++) {
-		if (locked_axis & (1 << i)) {
-			velocity[i] = 0.0;
-		}
-	}
+	_apply_velocity_axis_lock();
 
 	Transform3D gt = get_global_transform();
 	previous_position = gt.origin;
@@ -130,6 +125,103 @@ bool CharacterBody3D::move_and_slide() {
 	return motion_results.size() > 0;
 }
 
+void CharacterBody3D::move_and_slide_batch(const TypedArray<CharacterBody3D> &p_bodies) {
+	LocalVector<CharacterBody3D *> bodies;
+	bodies.reserve(p_bodies.size());
+	for (int i = 0; i < p_bodies.size(); i++) {
+		CharacterBody3D *body = Object::cast_to<CharacterBody3D>(p_bodies[i]);
+		ERR_CONTINUE_MSG(!body, "Only CharacterBody3D nodes can be moved in a batch.");
+		ERR_CONTINUE(!body->is_inside_tree());
+		bodies.push_back(body);
+	}
+
+	// The first slide motion of every body only depends on its current state,
+	// so it can be tested up front for the whole crowd in one server call.
+	LocalVector<CharacterBody3D *> batched_bodies;
+	LocalVector<RID> rids;
+	LocalVector<PhysicsServer3D::MotionParameters> parameters;
+	batched_bodies.reserve(bodies.size());
+	rids.reserve(bodies.size());
+	parameters.reserve(bodies.size());
+
+	for (CharacterBody3D *body : bodies) {
+		body->batched_motion.pending = false;
+		if ((body->collision_state.floor || body->collision_state.wall) && body->platform_rid.is_valid()) {
+			// The platform motion is tested first and moves the body, so the slide motion can't be predicted.
+			continue;
+		}
+
+		body->_apply_velocity_axis_lock();
+		Vector3 motion = body->velocity * body->_get_slide_delta();
+
+		batched_bodies.push_back(body);
+		rids.push_back(body->get_rid());
+		parameters.push_back(body->_get_slide_motion_parameters(motion));
+	}
+
+	if (!batched_bodies.is_empty()) {
+		LocalVector<PhysicsServer3D::MotionResult> results;
+		LocalVector<bool> collided;
+		results.resize(batched_bodies.size());
+		collided.resize(batched_bodies.size());
+
+		PhysicsServer3D::get_singleton()->body_test_motion_batch(rids.ptr(), parameters.ptr(), results.ptr(), collided.ptr(), batched_bodies.size());
+
+		for (uint32_t i = 0; i < batched_bodies.size(); i++) {
+			BatchedMotion &batched_motion = batched_bodies[i]->batched_motion;
+			batched_motion.parameters = parameters[i];
+			batched_motion.result = results[i];
+			batched_motion.collided = collided[i];
+			batched_motion.pending = true;
+		}
+	}
+
+	for (CharacterBody3D *body : bodies) {
+		body->move_and_slide();
+		body->batched_motion.pending = false;
+	}
+}
+
+bool CharacterBody3D::_test_motion(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result) {
+	if (batched_motion.pending) {
+		// Only the first motion test of move_and_slide() can match the batched one.
+		batched_motion.pending = false;
+
+		const PhysicsServer3D::MotionParameters &batched = batched_motion.parameters;
+		if (p_parameters.from == batched.from && p_parameters.motion == batched.motion && p_parameters.margin == batched.margin &&
+				p_parameters.max_collisions == batched.max_collisions && p_parameters.collide_separation_ray == batched.collide_separation_ray &&
+				p_parameters.recovery_as_collision == batched.recovery_as_collision &&
+				p_parameters.exclude_bodies.is_empty() && p_parameters.exclude_objects.is_empty()) {
+			r_result = batched_motion.result;
+			return batched_motion.collided;
+		}
+	}
+
+	return PhysicsBody3D::_test_motion(p_parameters, r_result);
+}
+
+double CharacterBody3D::_get_slide_delta() const {
+	// Hack in order to work with calling from _process as well as from _physics_process; calling from thread is risky
+	return Engine::get_singleton()->is_in_physics_frame() ? get_physics_process_delta_time() : get_process_delta_time();
+}
+
+void CharacterBody3D::_apply_velocity_axis_lock() {
+	for (int i = 0; i < 3; i++) {
+		if (locked_axis & (1 << i)) {
+			velocity[i] = 0.0;
+		}
+	}
+}
+
+PhysicsServer3D::MotionParameters CharacterBody3D::_get_slide_motion_parameters(const Vector3 &p_motion) const {
+	PhysicsServer3D::MotionParameters parameters(get_global_transform(), p_motion, margin);
+	if (motion_mode == MOTION_MODE_GROUNDED) {
+		parameters.max_collisions = 6; // There can be 4 collisions between 2 walls + 2 more for the floor.
+	}
+	parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
+	return parameters;
+}
+
 void CharacterBody3D::_move_and_slide_grounded(double p_delta, bool p_was_on_floor) {
 	Vector3 motion = velocity * p_delta;
 	Vector3 motion_slide_up = motion.slide(up_direction);
@@ -156,9 +248,7 @@ void CharacterBody3D::_move_and_slide_grounded(double p_delta, bool p_was_on_flo
 	Vector3 total_travel;
 
 	for (int iteration = 0; iteration < max_slides; ++iteration) {
-		PhysicsServer3D::MotionParameters parameters(get_global_transform(), motion, margin);
-		parameters.max_collisions = 6; // There can be 4 collisions between 2 walls + 2 more for the floor.
-		parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
+		PhysicsServer3D::MotionParameters parameters = _get_slide_motion_parameters(motion);
 
 		PhysicsServer3D::MotionResult result;
 		bool collided = move_and_collide(parameters, result, false, !sliding_enabled);
@@ -403,8 +493,7 @@ void CharacterBody3D::_move_and_slide_floating(double p_delta) {
 
 	bool first_slide = true;
 	for (int iteration = 0; iteration < max_slides; ++iteration) {
-		PhysicsServer3D::MotionParameters parameters(get_global_transform(), motion, margin);
-		parameters.recovery_as_collision = true; // Also report collisions generated only from recovery.
+		PhysicsServer3D::MotionParameters parameters = _get_slide_motion_parameters(motion);
 
 		PhysicsServer3D::MotionResult result;
 		bool collided = move_and_collide(parameters, result, false, false);
@@ -846,6 +935,7 @@ void CharacterBody3D::_notification(int p_what) {
 
 void CharacterBody3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("move_and_slide"), &CharacterBody3D::move_and_slide);
+	ClassDB::bind_static_method("CharacterBody3D", D_METHOD("move_and_slide_batch", "bodies"), &CharacterBody3D::move_and_slide_batch);
 	ClassDB::bind_method(D_METHOD("apply_floor_snap"), &CharacterBody3D::apply_floor_snap);
 
 	ClassDB::bind_method(D_METHOD("set_velocity", "velocity"), &CharacterBody3D::set_velocity);
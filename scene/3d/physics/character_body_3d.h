@@ -48,6 +48,7 @@ public:
 		PLATFORM_ON_LEAVE_DO_NOTHING,
 	};
 	bool move_and_slide();
+	static void move_and_slide_batch(const TypedArray<CharacterBody3D> &p_bodies);
 	void apply_floor_snap();
 
 	const Vector3 &get_velocity() const;
@@ -165,6 +166,20 @@ private:
 	Vector<PhysicsServer3D::MotionResult> motion_results;
 	Vector<Ref<KinematicCollision3D>> slide_colliders;
 
+	// Motion tested ahead of time by move_and_slide_batch().
+	struct BatchedMotion {
+		PhysicsServer3D::MotionParameters parameters;
+		PhysicsServer3D::MotionResult result;
+		bool collided = false;
+		bool pending = false;
+	};
+
+	BatchedMotion batched_motion;
+
+	double _get_slide_delta() const;
+	void _apply_velocity_axis_lock();
+	PhysicsServer3D::MotionParameters _get_slide_motion_parameters(const Vector3 &p_motion) const;
+
 	void _move_and_slide_floating(double p_delta);
 	void _move_and_slide_grounded(double p_delta, bool p_was_on_floor);
 
@@ -181,6 +196,8 @@ protected:
 	void _notification(int p_what);
 	static void _bind_methods();
 	void _validate_property(PropertyInfo &p_property) const;
+
+	virtual bool _test_motion(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result) override;
 };
 
 VARIANT_ENUM_CAST(CharacterBody3D::MotionMode);
@@ -105,8 +105,12 @@ Ref<KinematicCollision3D> PhysicsBody3D::_move(const Vector3 &p_motion, bool p_t
 	return Ref<KinematicCollision3D>();
 }
 
+bool PhysicsBody3D::_test_motion(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result) {
+	return PhysicsServer3D::get_singleton()->body_test_motion(get_rid(), p_parameters, &r_result);
+}
+
 bool PhysicsBody3D::move_and_collide(const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult &r_result, bool p_test_only, bool p_cancel_sliding) {
-	bool colliding = PhysicsServer3D::get_singleton()->body_test_motion(get_rid(), p_parameters, &r_result);
+	bool colliding = _test_motion(p_parameters, r_result);
 
 	// Restore direction of motion to be along original motion,
 	// in order to avoid sliding due to recovery,
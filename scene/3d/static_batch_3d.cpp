@@ -0,0 +1,369 @@
+/**************************************************************************/
+/*  static_batch_3d.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "static_batch_3d.h"
+
+#include "core/config/engine.h"
+#include "core/object/worker_thread_pool.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/3d/soft_body_3d.h"
+#include "scene/main/viewport.h"
+#include "scene/resources/3d/importer_mesh.h"
+#include "scene/resources/3d/skin.h"
+#include "scene/resources/surface_tool.h"
+
+// Attributes SurfaceTool can carry through a merge. Surfaces using anything else (skinning, custom channels) are left alone.
+static const uint64_t BATCH_FORMAT_MASK = RS::ARRAY_FORMAT_VERTEX | RS::ARRAY_FORMAT_NORMAL | RS::ARRAY_FORMAT_TANGENT | RS::ARRAY_FORMAT_COLOR | RS::ARRAY_FORMAT_TEX_UV | RS::ARRAY_FORMAT_TEX_UV2;
+static const uint64_t UNSUPPORTED_FORMAT_MASK = RS::ARRAY_FORMAT_BONES | RS::ARRAY_FORMAT_WEIGHTS | RS::ARRAY_FORMAT_CUSTOM0 | RS::ARRAY_FORMAT_CUSTOM1 | RS::ARRAY_FORMAT_CUSTOM2 | RS::ARRAY_FORMAT_CUSTOM3;
+
+bool StaticBatch3D::_is_batchable(const MeshInstance3D *p_mesh_instance) {
+	if (!p_mesh_instance->is_visible_in_tree() || p_mesh_instance->is_batched() || Object::cast_to<SoftBody3D>(p_mesh_instance)) {
+		return false;
+	}
+
+	Ref<Mesh> mesh = p_mesh_instance->get_mesh();
+	if (mesh.is_null() || mesh->get_surface_count() == 0 || mesh->get_blend_shape_count() > 0 || p_mesh_instance->get_skin().is_valid()) {
+		return false;
+	}
+
+	// Per-instance settings that can't be expressed once the geometry is merged.
+	if (p_mesh_instance->get_material_overlay().is_valid() || p_mesh_instance->get_transparency() > 0.0 || p_mesh_instance->get_visibility_range_begin() > 0.0 || p_mesh_instance->get_visibility_range_end() > 0.0 || p_mesh_instance->get_extra_cull_margin() > 0.0 || p_mesh_instance->get_custom_aabb() != AABB() || p_mesh_instance->has_instance_shader_parameters()) {
+		return false;
+	}
+
+	// Baked GI (lightmaps, VoxelGI) is bound to the source node and its own UV2 layout.
+	if (p_mesh_instance->get_gi_mode() == GeometryInstance3D::GI_MODE_STATIC) {
+		return false;
+	}
+
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+		if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES || (mesh->surface_get_format(i) & UNSUPPORTED_FORMAT_MASK)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void StaticBatch3D::_collect_sources(Node *p_node, LocalVector<MeshInstance3D *> &r_sources) const {
+	if (Object::cast_to<StaticBatch3D>(p_node)) {
+		// Nested batches take care of their own subtree.
+		return;
+	}
+	if (Object::cast_to<Viewport>(p_node)) {
+		// Nodes below a viewport render in its own world.
+		return;
+	}
+
+	MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(p_node);
+	if (mesh_instance && _is_batchable(mesh_instance)) {
+		r_sources.push_back(mesh_instance);
+	}
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_collect_sources(p_node->get_child(i), r_sources);
+	}
+}
+
+void StaticBatch3D::_build_group(uint32_t p_index, Group *p_groups) {
+	Group &group = p_groups[p_index];
+
+	Ref<SurfaceTool> surface_tool;
+	surface_tool.instantiate();
+	surface_tool->begin(Mesh::PRIMITIVE_TRIANGLES);
+
+	LocalVector<SurfaceTool::Vertex> vertices;
+	int vertex_offset = 0;
+
+	for (const Part &part : group.parts) {
+		uint64_t format = 0;
+		SurfaceTool::create_vertex_array_from_arrays(part.arrays, vertices, &format);
+
+		const Basis normal_basis = part.xform.basis.inverse().transposed();
+		// Mirrored transforms flip the winding order and the bitangent direction.
+		const bool mirrored = part.xform.basis.determinant() < 0.0;
+
+		for (const SurfaceTool::Vertex &vertex : vertices) {
+			if (format & RS::ARRAY_FORMAT_COLOR) {
+				surface_tool->set_color(vertex.color);
+			}
+			if (format & RS::ARRAY_FORMAT_NORMAL) {
+				surface_tool->set_normal(normal_basis.xform(vertex.normal).normalized());
+			}
+			if (format & RS::ARRAY_FORMAT_TANGENT) {
+				float binormal_sign = vertex.binormal.dot(vertex.normal.cross(vertex.tangent)) < 0.0 ? -1.0 : 1.0;
+				if (mirrored) {
+					binormal_sign = -binormal_sign;
+				}
+				surface_tool->set_tangent(Plane(part.xform.basis.xform(vertex.tangent).normalized(), binormal_sign));
+			}
+			if (format & RS::ARRAY_FORMAT_TEX_UV) {
+				surface_tool->set_uv(vertex.uv);
+			}
+			if (format & RS::ARRAY_FORMAT_TEX_UV2) {
+				surface_tool->set_uv2(vertex.uv2);
+			}
+			surface_tool->add_vertex(part.xform.xform(vertex.vertex));
+		}
+
+		Vector<int> indices = part.arrays[RS::ARRAY_INDEX];
+		if (indices.is_empty()) {
+			indices.resize(vertices.size());
+			int *w = indices.ptrw();
+			for (uint32_t i = 0; i < vertices.size(); i++) {
+				w[i] = i;
+			}
+		}
+
+		const int *r = indices.ptr();
+		for (int i = 0; i + 2 < indices.size(); i += 3) {
+			surface_tool->add_index(vertex_offset + r[i]);
+			surface_tool->add_index(vertex_offset + r[mirrored ? i + 2 : i + 1]);
+			surface_tool->add_index(vertex_offset + r[mirrored ? i + 1 : i + 2]);
+		}
+
+		vertex_offset += vertices.size();
+	}
+
+	Array arrays = surface_tool->commit_to_arrays();
+
+	if (!generate_lods) {
+		group.arrays = arrays;
+		return;
+	}
+
+	// Simplify the merged surface as a whole, so each cell keeps its own LOD chain.
+	Ref<ImporterMesh> importer_mesh;
+	importer_mesh.instantiate();
+	importer_mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, arrays);
+	importer_mesh->generate_lods(60.0, 25.0, Array());
+
+	group.arrays = importer_mesh->get_surface_arrays(0);
+	for (int i = 0; i < importer_mesh->get_surface_lod_count(0); i++) {
+		group.lods[importer_mesh->get_surface_lod_size(0, i)] = importer_mesh->get_surface_lod_indices(0, i);
+	}
+}
+
+void StaticBatch3D::_update_batch_transforms() {
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	Transform3D global_transform = get_global_transform();
+	for (const Batch &batch : batches) {
+		RS::get_singleton()->instance_set_transform(batch.instance, global_transform);
+	}
+}
+
+void StaticBatch3D::_update_batch_visibility() {
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	bool visible = is_visible_in_tree();
+	for (const Batch &batch : batches) {
+		RS::get_singleton()->instance_set_visible(batch.instance, visible);
+	}
+}
+
+void StaticBatch3D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_READY: {
+			// Keep the source nodes editable in the editor.
+			if (!Engine::get_singleton()->is_editor_hint()) {
+				rebuild();
+			}
+		} break;
+
+		case NOTIFICATION_EXIT_TREE: {
+			clear();
+			// Batch again the next time the node enters the tree.
+			request_ready();
+		} break;
+
+		case NOTIFICATION_TRANSFORM_CHANGED: {
+			_update_batch_transforms();
+		} break;
+
+		case NOTIFICATION_VISIBILITY_CHANGED: {
+			_update_batch_visibility();
+		} break;
+	}
+}
+
+void StaticBatch3D::set_cell_size(float p_size) {
+	ERR_FAIL_COND(p_size <= 0.0);
+	cell_size = p_size;
+	if (built) {
+		rebuild();
+	}
+}
+
+float StaticBatch3D::get_cell_size() const {
+	return cell_size;
+}
+
+void StaticBatch3D::set_generate_lods(bool p_enable) {
+	generate_lods = p_enable;
+	if (built) {
+		rebuild();
+	}
+}
+
+bool StaticBatch3D::is_generating_lods() const {
+	return generate_lods;
+}
+
+void StaticBatch3D::rebuild() {
+	ERR_FAIL_COND_MSG(!is_inside_tree(), "StaticBatch3D can only be rebuilt while inside the scene tree.");
+
+	clear();
+
+	LocalVector<MeshInstance3D *> mesh_instances;
+	for (int i = 0; i < get_child_count(); i++) {
+		_collect_sources(get_child(i), mesh_instances);
+	}
+
+	// Surfaces are grouped by material, render settings and the cell their owner's center falls into,
+	// so a batch never spans more than roughly one cell and is still culled at that granularity.
+	LocalVector<Group> groups;
+	HashMap<GroupKey, uint32_t, GroupKey> group_map;
+	Transform3D inv_global_transform = get_global_transform().affine_inverse();
+
+	for (MeshInstance3D *mesh_instance : mesh_instances) {
+		Ref<Mesh> mesh = mesh_instance->get_mesh();
+		Transform3D xform = inv_global_transform * mesh_instance->get_global_transform();
+		Vector3i cell = Vector3i((xform.xform(mesh->get_aabb()).get_center() / cell_size).floor());
+
+		for (int i = 0; i < mesh->get_surface_count(); i++) {
+			Ref<Material> material = mesh_instance->get_active_material(i);
+
+			GroupKey key;
+			key.material = material.is_valid() ? material->get_instance_id() : ObjectID();
+			key.format = mesh->surface_get_format(i) & BATCH_FORMAT_MASK;
+			key.cell = cell;
+			key.layers = mesh_instance->get_layer_mask();
+			key.cast_shadows = mesh_instance->get_cast_shadows_setting();
+
+			uint32_t *group_index = group_map.getptr(key);
+			if (!group_index) {
+				Group group;
+				group.key = key;
+				group.material = material;
+				groups.push_back(group);
+				group_index = &group_map.insert(key, groups.size() - 1)->value;
+			}
+
+			Part part;
+			part.arrays = mesh->surface_get_arrays(i);
+			part.xform = xform;
+			groups[*group_index].parts.push_back(part);
+		}
+
+		sources.push_back(mesh_instance->get_instance_id());
+		mesh_instance->set_batched(true);
+	}
+
+	if (groups.size()) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &StaticBatch3D::_build_group, groups.ptr(), groups.size(), -1, true, SNAME("StaticBatch3DBuild"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+
+	RID scenario = get_world_3d()->get_scenario();
+	for (const Group &group : groups) {
+		PackedVector3Array vertices = group.arrays.size() == RS::ARRAY_MAX ? PackedVector3Array(group.arrays[RS::ARRAY_VERTEX]) : PackedVector3Array();
+		if (vertices.is_empty()) {
+			continue;
+		}
+
+		Batch batch;
+		batch.mesh.instantiate();
+		batch.mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, group.arrays, TypedArray<Array>(), group.lods);
+		batch.mesh->surface_set_material(0, group.material);
+
+		batch.instance = RS::get_singleton()->instance_create2(batch.mesh->get_rid(), scenario);
+		RS::get_singleton()->instance_set_layer_mask(batch.instance, group.key.layers);
+		RS::get_singleton()->instance_geometry_set_cast_shadows_setting(batch.instance, RS::ShadowCastingSetting(group.key.cast_shadows));
+		batches.push_back(batch);
+	}
+
+	built = true;
+	_update_batch_transforms();
+	_update_batch_visibility();
+}
+
+void StaticBatch3D::clear() {
+	for (const Batch &batch : batches) {
+		RS::get_singleton()->free(batch.instance);
+	}
+	batches.clear();
+
+	for (const ObjectID &id : sources) {
+		MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(ObjectDB::get_instance(id));
+		if (mesh_instance) {
+			mesh_instance->set_batched(false);
+		}
+	}
+	sources.clear();
+
+	built = false;
+}
+
+int StaticBatch3D::get_source_instance_count() const {
+	return sources.size();
+}
+
+int StaticBatch3D::get_batch_instance_count() const {
+	return batches.size();
+}
+
+void StaticBatch3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_cell_size", "size"), &StaticBatch3D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &StaticBatch3D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("set_generate_lods", "enable"), &StaticBatch3D::set_generate_lods);
+	ClassDB::bind_method(D_METHOD("is_generating_lods"), &StaticBatch3D::is_generating_lods);
+
+	ClassDB::bind_method(D_METHOD("rebuild"), &StaticBatch3D::rebuild);
+	ClassDB::bind_method(D_METHOD("clear"), &StaticBatch3D::clear);
+
+	ClassDB::bind_method(D_METHOD("get_source_instance_count"), &StaticBatch3D::get_source_instance_count);
+	ClassDB::bind_method(D_METHOD("get_batch_instance_count"), &StaticBatch3D::get_batch_instance_count);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cell_size", PROPERTY_HINT_RANGE, "0.1,1024,0.1,or_greater,suffix:m"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "generate_lods"), "set_generate_lods", "is_generating_lods");
+}
+
+StaticBatch3D::StaticBatch3D() {
+	set_notify_transform(true);
+}
+
+StaticBatch3D::~StaticBatch3D() {
+	clear();
+}
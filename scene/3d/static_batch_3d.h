@@ -0,0 +1,121 @@
+/**************************************************************************/
+/*  static_batch_3d.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef STATIC_BATCH_3D_H
+#define STATIC_BATCH_3D_H
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "scene/3d/visual_instance_3d.h"
+#include "scene/resources/mesh.h"
+
+class MeshInstance3D;
+
+class StaticBatch3D : public Node3D {
+	GDCLASS(StaticBatch3D, Node3D);
+
+	struct GroupKey {
+		ObjectID material;
+		uint64_t format = 0;
+		Vector3i cell;
+		uint32_t layers = 0;
+		GeometryInstance3D::ShadowCastingSetting cast_shadows = GeometryInstance3D::SHADOW_CASTING_SETTING_ON;
+
+		static uint32_t hash(const GroupKey &p_key) {
+			uint32_t h = hash_murmur3_one_64(uint64_t(p_key.material));
+			h = hash_murmur3_one_64(p_key.format, h);
+			h = hash_murmur3_one_32(uint32_t(p_key.cell.x), h);
+			h = hash_murmur3_one_32(uint32_t(p_key.cell.y), h);
+			h = hash_murmur3_one_32(uint32_t(p_key.cell.z), h);
+			h = hash_murmur3_one_32(p_key.layers, h);
+			h = hash_murmur3_one_32(uint32_t(p_key.cast_shadows), h);
+			return hash_fmix32(h);
+		}
+
+		bool operator==(const GroupKey &p_key) const {
+			return material == p_key.material && format == p_key.format && cell == p_key.cell && layers == p_key.layers && cast_shadows == p_key.cast_shadows;
+		}
+	};
+
+	struct Part {
+		Array arrays;
+		Transform3D xform;
+	};
+
+	struct Group {
+		GroupKey key;
+		Ref<Material> material;
+		LocalVector<Part> parts;
+
+		// Filled in by the worker threads.
+		Array arrays;
+		Dictionary lods;
+	};
+
+	struct Batch {
+		Ref<ArrayMesh> mesh;
+		RID instance;
+	};
+
+	float cell_size = 32.0;
+	bool generate_lods = true;
+
+	LocalVector<ObjectID> sources;
+	LocalVector<Batch> batches;
+	bool built = false;
+
+	static bool _is_batchable(const MeshInstance3D *p_mesh_instance);
+	void _collect_sources(Node *p_node, LocalVector<MeshInstance3D *> &r_sources) const;
+	void _build_group(uint32_t p_index, Group *p_groups);
+	void _update_batch_transforms();
+	void _update_batch_visibility();
+
+protected:
+	void _notification(int p_what);
+	static void _bind_methods();
+
+public:
+	void set_cell_size(float p_size);
+	float get_cell_size() const;
+
+	void set_generate_lods(bool p_enable);
+	bool is_generating_lods() const;
+
+	void rebuild();
+	void clear();
+
+	int get_source_instance_count() const;
+	int get_batch_instance_count() const;
+
+	StaticBatch3D();
+	~StaticBatch3D();
+};
+
+#endif // STATIC_BATCH_3D_H
@@ -44,7 +44,7 @@ void VisualInstance3D::_update_visibility() {
 	}
 
 	bool already_visible = _is_vi_visible();
-	bool visible = is_visible_in_tree();
+	bool visible = is_visible_in_tree() && !_is_drawn_elsewhere();
 	_set_vi_visible(visible);
 
 	// If making visible, make sure the rendering server is up to date with the transform.
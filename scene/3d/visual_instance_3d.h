@@ -44,6 +44,8 @@ class VisualInstance3D : public Node3D {
 
 protected:
 	void _update_visibility();
+	// Hidden from the RenderingServer while something else draws it, whatever its visibility.
+	virtual bool _is_drawn_elsewhere() const { return false; }
 
 	virtual void _physics_interpolated_changed() override;
 	void set_instance_use_identity_transform(bool p_enable);
@@ -190,6 +192,7 @@ public:
 
 	void set_instance_shader_parameter(const StringName &p_name, const Variant &p_value);
 	Variant get_instance_shader_parameter(const StringName &p_name) const;
+	bool has_instance_shader_parameters() const { return !instance_shader_parameters.is_empty(); }
 
 	void set_custom_aabb(AABB p_aabb);
 	AABB get_custom_aabb() const;
@@ -33,6 +33,7 @@
 
 #include "core/config/engine.h"
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/2d/audio_stream_player_2d.h"
 #include "scene/animation/animation_player.h"
 #include "scene/audio/audio_stream_player.h"
@@ -42,10 +43,13 @@
 
 #ifndef _3D_DISABLED
 #include "scene/3d/audio_stream_player_3d.h"
+#include "scene/3d/camera_3d.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
 #include "scene/3d/skeleton_modifier_3d.h"
+#include "scene/3d/visible_on_screen_notifier_3d.h"
+#include "scene/main/viewport.h"
 #endif // _3D_DISABLED
 
 #ifdef TOOLS_ENABLED
@@ -473,6 +477,14 @@ bool AnimationMixer::is_deterministic() const {
 	return deterministic;
 }
 
+void AnimationMixer::set_parallel_evaluation(bool p_enabled) {
+	parallel_evaluation = p_enabled;
+}
+
+bool AnimationMixer::is_parallel_evaluation() const {
+	return parallel_evaluation;
+}
+
 void AnimationMixer::set_callback_mode_process(AnimationCallbackModeProcess p_mode) {
 	if (callback_mode_process == p_mode) {
 		return;
@@ -513,6 +525,72 @@ AnimationMixer::AnimationCallbackModeDiscrete AnimationMixer::get_callback_mode_
 	return callback_mode_discrete;
 }
 
+void AnimationMixer::set_lod_enabled(bool p_enabled) {
+	lod_enabled = p_enabled;
+	lod_interval = 1;
+	lod_frames_since_update = 0;
+	lod_accumulated_delta = 0.0;
+}
+
+bool AnimationMixer::is_lod_enabled() const {
+	return lod_enabled;
+}
+
+void AnimationMixer::set_lod_distance(real_t p_distance) {
+	ERR_FAIL_COND(p_distance < 0.0);
+	lod_distance = p_distance;
+}
+
+real_t AnimationMixer::get_lod_distance() const {
+	return lod_distance;
+}
+
+void AnimationMixer::set_lod_max_interval(int p_interval) {
+	ERR_FAIL_COND(p_interval < 1);
+	lod_max_interval = p_interval;
+}
+
+int AnimationMixer::get_lod_max_interval() const {
+	return lod_max_interval;
+}
+
+void AnimationMixer::set_lod_offscreen_interval(int p_interval) {
+	ERR_FAIL_COND(p_interval < 1);
+	lod_offscreen_interval = p_interval;
+}
+
+int AnimationMixer::get_lod_offscreen_interval() const {
+	return lod_offscreen_interval;
+}
+
+void AnimationMixer::set_lod_visibility_notifier(const NodePath &p_path) {
+	lod_visibility_notifier = p_path;
+}
+
+NodePath AnimationMixer::get_lod_visibility_notifier() const {
+	return lod_visibility_notifier;
+}
+
+void AnimationMixer::set_lod_max_bone_depth(int p_depth) {
+	lod_max_bone_depth = p_depth;
+}
+
+int AnimationMixer::get_lod_max_bone_depth() const {
+	return lod_max_bone_depth;
+}
+
+void AnimationMixer::set_lod_interpolate(bool p_interpolate) {
+	lod_interpolate = p_interpolate;
+}
+
+bool AnimationMixer::is_lod_interpolating() const {
+	return lod_interpolate;
+}
+
+int AnimationMixer::get_lod_interval() const {
+	return lod_interval;
+}
+
 void AnimationMixer::set_audio_max_polyphony(int p_audio_max_polyphony) {
 	ERR_FAIL_COND(p_audio_max_polyphony < 0 || p_audio_max_polyphony > 128);
 	audio_max_polyphony = p_audio_max_polyphony;
@@ -741,6 +819,9 @@ bool AnimationMixer::_update_caches() {
 							if (bone_idx != -1) {
 								has_rest = true;
 								track_xform->bone_idx = bone_idx;
+								for (int parent = sk->get_bone_parent(bone_idx); parent >= 0; parent = sk->get_bone_parent(parent)) {
+									track_xform->bone_depth++;
+								}
 								Transform3D rest = sk->get_bone_rest(bone_idx);
 								track_xform->init_loc = rest.origin;
 								track_xform->init_rot = rest.basis.get_rotation_quaternion();
@@ -946,6 +1027,175 @@ void AnimationMixer::_process_animation(double p_delta, bool p_update_only) {
 	clear_animation_instances();
 }
 
+LocalVector<AnimationMixer::ParallelEvaluation> AnimationMixer::parallel_queue;
+
+bool AnimationMixer::_can_evaluate_in_parallel() const {
+	// Script overrides of _post_process_key_value() can't run on worker threads,
+	// and mixers processed in a sub-thread group are already off the main thread.
+	return parallel_evaluation && Thread::is_main_thread() && !GDVIRTUAL_IS_OVERRIDDEN(_post_process_key_value);
+}
+
+void AnimationMixer::_queue_parallel_evaluation(double p_delta) {
+	if (parallel_queue.is_empty()) {
+		// Runs once all nodes have been processed this frame (or physics step).
+		callable_mp_static(&AnimationMixer::_flush_parallel_queue).call_deferred();
+	}
+
+	ParallelEvaluation evaluation;
+	evaluation.mixer_id = get_instance_id();
+	evaluation.delta = p_delta;
+	parallel_queue.push_back(evaluation);
+}
+
+void AnimationMixer::_blend_process_parallel(void *p_userdata, uint32_t p_index) {
+	ParallelEvaluation &evaluation = static_cast<ParallelEvaluation *>(p_userdata)[p_index];
+	if (evaluation.mixer) {
+		evaluation.mixer->_blend_process(evaluation.delta, false, BLEND_PROCESS_TRACKS_TRANSFORM);
+	}
+}
+
+void AnimationMixer::_flush_parallel_queue() {
+	LocalVector<ParallelEvaluation> evaluations;
+	SWAP(evaluations, parallel_queue);
+
+	// Everything that can run user code, or touches other nodes, stays on the main thread and in queue order.
+	for (ParallelEvaluation &evaluation : evaluations) {
+		AnimationMixer *mixer = Object::cast_to<AnimationMixer>(ObjectDB::get_instance(evaluation.mixer_id));
+		if (!mixer || !mixer->is_inside_tree() || !mixer->active) {
+			continue;
+		}
+		mixer->_blend_init();
+		if (!mixer->_blend_pre_process(evaluation.delta, mixer->track_count, mixer->track_map)) {
+			mixer->clear_animation_instances();
+			continue;
+		}
+		mixer->_blend_capture(evaluation.delta);
+		mixer->_blend_calc_total_weight();
+		// Already known not to be overridden, skip the virtual lookup on the worker threads.
+		mixer->is_GDVIRTUAL_CALL_post_process_key_value = false;
+		evaluation.mixer = mixer;
+	}
+
+	// Pre-processing may have freed mixers that come later in the queue.
+	for (ParallelEvaluation &evaluation : evaluations) {
+		if (evaluation.mixer && !ObjectDB::get_instance(evaluation.mixer_id)) {
+			evaluation.mixer = nullptr;
+		}
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&AnimationMixer::_blend_process_parallel, evaluations.ptr(), evaluations.size(), -1, true, SNAME("AnimationMixerBlendProcess"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	for (const ParallelEvaluation &evaluation : evaluations) {
+		if (!evaluation.mixer) {
+			continue;
+		}
+		// Signals emitted while applying earlier mixers may have freed this one.
+		AnimationMixer *mixer = Object::cast_to<AnimationMixer>(ObjectDB::get_instance(evaluation.mixer_id));
+		if (!mixer) {
+			continue;
+		}
+		mixer->_blend_process(evaluation.delta, false, BLEND_PROCESS_TRACKS_OTHER);
+		mixer->_blend_apply();
+		mixer->_blend_post_process();
+		mixer->emit_signal(SNAME("mixer_applied"));
+		mixer->clear_animation_instances();
+	}
+}
+
+int AnimationMixer::_lod_get_target_interval() {
+#ifndef _3D_DISABLED
+	if (!lod_visibility_notifier.is_empty()) {
+		VisibleOnScreenNotifier3D *notifier = Object::cast_to<VisibleOnScreenNotifier3D>(get_node_or_null(lod_visibility_notifier));
+		if (notifier && !notifier->is_on_screen()) {
+			return lod_offscreen_interval;
+		}
+	}
+
+	if (Math::is_zero_approx(lod_distance)) {
+		return 1;
+	}
+	Node3D *root = Object::cast_to<Node3D>(get_node_or_null(root_node));
+	Camera3D *camera = get_viewport() ? get_viewport()->get_camera_3d() : nullptr;
+	if (!root || !camera) {
+		return 1;
+	}
+
+	// One more frame between updates for each multiple of lod_distance.
+	real_t distance = camera->get_global_transform().origin.distance_to(root->get_global_transform().origin);
+	return CLAMP(1 + int(distance / lod_distance), 1, lod_max_interval);
+#else
+	return 1;
+#endif // _3D_DISABLED
+}
+
+bool AnimationMixer::_lod_process(double &r_delta) {
+	if (!lod_enabled || !Thread::is_main_thread()) {
+		lod_interval = 1;
+		return true;
+	}
+
+	lod_accumulated_delta += r_delta;
+	lod_frames_since_update++;
+
+	if (lod_evaluated && lod_frames_since_update < lod_interval) {
+		if (lod_interpolate) {
+			_lod_apply_interpolated(real_t(lod_frames_since_update) / lod_interval);
+		}
+#ifndef _3D_DISABLED
+		// The motion of skipped frames is reported by the next update, which covers their time.
+		root_motion_position = Vector3(0, 0, 0);
+		root_motion_rotation = Quaternion(0, 0, 0, 1);
+		root_motion_scale = Vector3(0, 0, 0);
+#endif // _3D_DISABLED
+		return false;
+	}
+
+	// Evaluate with the time of all skipped frames, so keys in between still fire.
+	r_delta = lod_accumulated_delta;
+	lod_accumulated_delta = 0.0;
+	lod_frames_since_update = 0;
+	lod_interval = _lod_get_target_interval();
+
+#ifndef _3D_DISABLED
+	// The pose of the last update becomes the start of the next interpolation.
+	for (const KeyValue<Animation::TypeHash, TrackCache *> &K : track_cache) {
+		if (K.value->type != Animation::TYPE_POSITION_3D) {
+			continue;
+		}
+		TrackCacheTransform *t = static_cast<TrackCacheTransform *>(K.value);
+		t->lod_prev_valid = lod_evaluated && (deterministic || !Math::is_zero_approx(t->total_weight));
+		t->lod_prev_loc = t->loc;
+		t->lod_prev_rot = t->rot;
+		t->lod_prev_scale = t->scale;
+	}
+#endif // _3D_DISABLED
+
+	lod_evaluated = true;
+	return true;
+}
+
+void AnimationMixer::_lod_apply_interpolated(real_t p_weight) {
+#ifndef _3D_DISABLED
+	for (const KeyValue<Animation::TypeHash, TrackCache *> &K : track_cache) {
+		TrackCache *track = K.value;
+		if (track->type != Animation::TYPE_POSITION_3D || track->root_motion) {
+			continue;
+		}
+		if (!deterministic && Math::is_zero_approx(track->total_weight)) {
+			continue;
+		}
+		TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
+		if (!t->lod_prev_valid || _lod_is_bone_skipped(t)) {
+			continue;
+		}
+		if (!_apply_transform_track(t, t->lod_prev_loc.lerp(t->loc, p_weight), t->lod_prev_rot.slerp(t->rot, p_weight), t->lod_prev_scale.lerp(t->scale, p_weight))) {
+			return;
+		}
+	}
+#endif // _3D_DISABLED
+}
+
 Variant AnimationMixer::_post_process_key_value(const Ref<Animation> &p_anim, int p_track, Variant p_value, ObjectID p_object_id, int p_object_sub_idx) {
 #ifndef _3D_DISABLED
 	switch (p_anim->track_get_type(p_track)) {
@@ -1108,7 +1358,7 @@ void AnimationMixer::_blend_calc_total_weight() {
 	}
 }
 
-void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
+void AnimationMixer::_blend_process(double p_delta, bool p_update_only, BlendProcessTracks p_tracks) {
 	// Apply value/transform/blend/bezier blends to track caches and execute method/audio/animation tracks.
 #ifdef TOOLS_ENABLED
 	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
@@ -1129,6 +1379,12 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 		bool seeked_backward = signbit(p_delta);
 #ifndef _3D_DISABLED
 		bool calc_root = !seeked || is_external_seeking;
+		// Sample all transform tracks at the current time in one pass, root motion samples at other times are done per track.
+		// Skipped bones would be sampled for nothing, so those frames keep sampling per track.
+		bool use_transform_samples = p_tracks != BLEND_PROCESS_TRACKS_OTHER && !(lod_interval > 1 && lod_max_bone_depth >= 0);
+		if (use_transform_samples) {
+			a->sample_transform_tracks(time, transform_samples, false, ai.playback_info.key_cursor);
+		}
 #endif // _3D_DISABLED
 		const Vector<Animation::Track *> tracks = a->get_tracks();
 		Animation::Track *const *tracks_ptr = tracks.ptr();
@@ -1159,6 +1415,17 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 				blend = blend / track->total_weight;
 			}
 			Animation::TrackType ttype = animation_track->type;
+			if (p_tracks != BLEND_PROCESS_TRACKS_ALL) {
+				bool is_transform = ttype == Animation::TYPE_POSITION_3D || ttype == Animation::TYPE_ROTATION_3D || ttype == Animation::TYPE_SCALE_3D || ttype == Animation::TYPE_BLEND_SHAPE;
+				if (is_transform != (p_tracks == BLEND_PROCESS_TRACKS_TRANSFORM)) {
+					continue;
+				}
+			}
+#ifndef _3D_DISABLED
+			if ((ttype == Animation::TYPE_POSITION_3D || ttype == Animation::TYPE_ROTATION_3D || ttype == Animation::TYPE_SCALE_3D) && _lod_is_bone_skipped(static_cast<TrackCacheTransform *>(track))) {
+				continue;
+			}
+#endif // _3D_DISABLED
 			track->root_motion = root_motion_track == animation_track->path;
 			switch (ttype) {
 				case Animation::TYPE_POSITION_3D: {
@@ -1240,8 +1507,12 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 					}
 					{
 						Vector3 loc;
-						Error err = a->try_position_track_interpolate(i, time, &loc);
-						if (err != OK) {
+						if (use_transform_samples) {
+							if (!transform_samples.valid[i]) {
+								continue;
+							}
+							loc = transform_samples.positions[i];
+						} else if (a->try_position_track_interpolate(i, time, &loc, false, ai.playback_info.key_cursor ? ai.playback_info.key_cursor->get(i) : nullptr) != OK) {
 							continue;
 						}
 						loc = post_process_key_value(a, i, loc, t->object_id, t->bone_idx);
@@ -1327,8 +1598,12 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 					}
 					{
 						Quaternion rot;
-						Error err = a->try_rotation_track_interpolate(i, time, &rot);
-						if (err != OK) {
+						if (use_transform_samples) {
+							if (!transform_samples.valid[i]) {
+								continue;
+							}
+							rot = transform_samples.rotations[i];
+						} else if (a->try_rotation_track_interpolate(i, time, &rot, false, ai.playback_info.key_cursor ? ai.playback_info.key_cursor->get(i) : nullptr) != OK) {
 							continue;
 						}
 						rot = post_process_key_value(a, i, rot, t->object_id, t->bone_idx);
@@ -1415,8 +1690,12 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 					}
 					{
 						Vector3 scale;
-						Error err = a->try_scale_track_interpolate(i, time, &scale);
-						if (err != OK) {
+						if (use_transform_samples) {
+							if (!transform_samples.valid[i]) {
+								continue;
+							}
+							scale = transform_samples.scales[i];
+						} else if (a->try_scale_track_interpolate(i, time, &scale, false, ai.playback_info.key_cursor ? ai.playback_info.key_cursor->get(i) : nullptr) != OK) {
 							continue;
 						}
 						scale = post_process_key_value(a, i, scale, t->object_id, t->bone_idx);
@@ -1431,9 +1710,12 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 					}
 					TrackCacheBlendShape *t = static_cast<TrackCacheBlendShape *>(track);
 					float value;
-					Error err = a->try_blend_shape_track_interpolate(i, time, &value);
-					//ERR_CONTINUE(err!=OK); //used for testing, should be removed
-					if (err != OK) {
+					if (use_transform_samples) {
+						if (!transform_samples.valid[i]) {
+							continue;
+						}
+						value = transform_samples.blend_shapes[i];
+					} else if (a->try_blend_shape_track_interpolate(i, time, &value, false, ai.playback_info.key_cursor ? ai.playback_info.key_cursor->get(i) : nullptr) != OK) {
 						continue;
 					}
 					value = post_process_key_value(a, i, value, t->object_id, t->shape_index);
@@ -1739,6 +2021,42 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 	is_GDVIRTUAL_CALL_post_process_key_value = true;
 }
 
+#ifndef _3D_DISABLED
+bool AnimationMixer::_apply_transform_track(const TrackCacheTransform *p_track, const Vector3 &p_loc, const Quaternion &p_rot, const Vector3 &p_scale) {
+	if (p_track->skeleton_id.is_valid() && p_track->bone_idx >= 0) {
+		Skeleton3D *t_skeleton = Object::cast_to<Skeleton3D>(ObjectDB::get_instance(p_track->skeleton_id));
+		if (!t_skeleton) {
+			return false;
+		}
+		if (p_track->loc_used) {
+			t_skeleton->set_bone_pose_position(p_track->bone_idx, p_loc);
+		}
+		if (p_track->rot_used) {
+			t_skeleton->set_bone_pose_rotation(p_track->bone_idx, p_rot);
+		}
+		if (p_track->scale_used) {
+			t_skeleton->set_bone_pose_scale(p_track->bone_idx, p_scale);
+		}
+
+	} else if (!p_track->skeleton_id.is_valid()) {
+		Node3D *t_node_3d = Object::cast_to<Node3D>(ObjectDB::get_instance(p_track->object_id));
+		if (!t_node_3d) {
+			return false;
+		}
+		if (p_track->loc_used) {
+			t_node_3d->set_position(p_loc);
+		}
+		if (p_track->rot_used) {
+			t_node_3d->set_rotation(p_rot.get_euler());
+		}
+		if (p_track->scale_used) {
+			t_node_3d->set_scale(p_scale);
+		}
+	}
+	return true;
+}
+#endif // _3D_DISABLED
+
 void AnimationMixer::_blend_apply() {
 	// Finally, set the tracks.
 	for (const KeyValue<Animation::TypeHash, TrackCache *> &K : track_cache) {
@@ -1759,35 +2077,12 @@ void AnimationMixer::_blend_apply() {
 					root_motion_position_accumulator = t->loc;
 					root_motion_rotation_accumulator = t->rot;
 					root_motion_scale_accumulator = t->scale;
-				} else if (t->skeleton_id.is_valid() && t->bone_idx >= 0) {
-					Skeleton3D *t_skeleton = Object::cast_to<Skeleton3D>(ObjectDB::get_instance(t->skeleton_id));
-					if (!t_skeleton) {
-						return;
-					}
-					if (t->loc_used) {
-						t_skeleton->set_bone_pose_position(t->bone_idx, t->loc);
-					}
-					if (t->rot_used) {
-						t_skeleton->set_bone_pose_rotation(t->bone_idx, t->rot);
-					}
-					if (t->scale_used) {
-						t_skeleton->set_bone_pose_scale(t->bone_idx, t->scale);
-					}
-
-				} else if (!t->skeleton_id.is_valid()) {
-					Node3D *t_node_3d = Object::cast_to<Node3D>(ObjectDB::get_instance(t->object_id));
-					if (!t_node_3d) {
+				} else if (!_lod_is_bone_skipped(t)) {
+					// While the LOD interpolates, the pose of the previous update is shown first.
+					bool use_prev = lod_interval > 1 && lod_interpolate && t->lod_prev_valid;
+					if (!_apply_transform_track(t, use_prev ? t->lod_prev_loc : t->loc, use_prev ? t->lod_prev_rot : t->rot, use_prev ? t->lod_prev_scale : t->scale)) {
 						return;
 					}
-					if (t->loc_used) {
-						t_node_3d->set_position(t->loc);
-					}
-					if (t->rot_used) {
-						t_node_3d->set_rotation(t->rot.get_euler());
-					}
-					if (t->scale_used) {
-						t_node_3d->set_scale(t->scale);
-					}
 				}
 #endif // _3D_DISABLED
 			} break;
@@ -2226,14 +2521,24 @@ void AnimationMixer::_notification(int p_what) {
 		} break;
 
 		case NOTIFICATION_INTERNAL_PROCESS: {
-			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_IDLE) {
-				_process_animation(get_process_delta_time());
+			double delta = get_process_delta_time();
+			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_IDLE && _lod_process(delta)) {
+				if (_can_evaluate_in_parallel()) {
+					_queue_parallel_evaluation(delta);
+				} else {
+					_process_animation(delta);
+				}
 			}
 		} break;
 
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
-			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_PHYSICS) {
-				_process_animation(get_physics_process_delta_time());
+			double delta = get_physics_process_delta_time();
+			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_PHYSICS && _lod_process(delta)) {
+				if (_can_evaluate_in_parallel()) {
+					_queue_parallel_evaluation(delta);
+				} else {
+					_process_animation(delta);
+				}
 			}
 		} break;
 
@@ -2285,6 +2590,9 @@ void AnimationMixer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_deterministic", "deterministic"), &AnimationMixer::set_deterministic);
 	ClassDB::bind_method(D_METHOD("is_deterministic"), &AnimationMixer::is_deterministic);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_evaluation", "enabled"), &AnimationMixer::set_parallel_evaluation);
+	ClassDB::bind_method(D_METHOD("is_parallel_evaluation"), &AnimationMixer::is_parallel_evaluation);
+
 	ClassDB::bind_method(D_METHOD("set_root_node", "path"), &AnimationMixer::set_root_node);
 	ClassDB::bind_method(D_METHOD("get_root_node"), &AnimationMixer::get_root_node);
 
@@ -2297,6 +2605,23 @@ void AnimationMixer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_callback_mode_discrete", "mode"), &AnimationMixer::set_callback_mode_discrete);
 	ClassDB::bind_method(D_METHOD("get_callback_mode_discrete"), &AnimationMixer::get_callback_mode_discrete);
 
+	/* ---- Level of detail ---- */
+	ClassDB::bind_method(D_METHOD("set_lod_enabled", "enabled"), &AnimationMixer::set_lod_enabled);
+	ClassDB::bind_method(D_METHOD("is_lod_enabled"), &AnimationMixer::is_lod_enabled);
+	ClassDB::bind_method(D_METHOD("set_lod_distance", "distance"), &AnimationMixer::set_lod_distance);
+	ClassDB::bind_method(D_METHOD("get_lod_distance"), &AnimationMixer::get_lod_distance);
+	ClassDB::bind_method(D_METHOD("set_lod_max_interval", "interval"), &AnimationMixer::set_lod_max_interval);
+	ClassDB::bind_method(D_METHOD("get_lod_max_interval"), &AnimationMixer::get_lod_max_interval);
+	ClassDB::bind_method(D_METHOD("set_lod_offscreen_interval", "interval"), &AnimationMixer::set_lod_offscreen_interval);
+	ClassDB::bind_method(D_METHOD("get_lod_offscreen_interval"), &AnimationMixer::get_lod_offscreen_interval);
+	ClassDB::bind_method(D_METHOD("set_lod_visibility_notifier", "path"), &AnimationMixer::set_lod_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("get_lod_visibility_notifier"), &AnimationMixer::get_lod_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("set_lod_max_bone_depth", "depth"), &AnimationMixer::set_lod_max_bone_depth);
+	ClassDB::bind_method(D_METHOD("get_lod_max_bone_depth"), &AnimationMixer::get_lod_max_bone_depth);
+	ClassDB::bind_method(D_METHOD("set_lod_interpolate", "interpolate"), &AnimationMixer::set_lod_interpolate);
+	ClassDB::bind_method(D_METHOD("is_lod_interpolating"), &AnimationMixer::is_lod_interpolating);
+	ClassDB::bind_method(D_METHOD("get_lod_interval"), &AnimationMixer::get_lod_interval);
+
 	/* ---- Audio ---- */
 	ClassDB::bind_method(D_METHOD("set_audio_max_polyphony", "max_polyphony"), &AnimationMixer::set_audio_max_polyphony);
 	ClassDB::bind_method(D_METHOD("get_audio_max_polyphony"), &AnimationMixer::get_audio_max_polyphony);
@@ -2326,12 +2651,22 @@ void AnimationMixer::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deterministic"), "set_deterministic", "is_deterministic");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_evaluation"), "set_parallel_evaluation", "is_parallel_evaluation");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "reset_on_save", PROPERTY_HINT_NONE, ""), "set_reset_on_save_enabled", "is_reset_on_save_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_node"), "set_root_node", "get_root_node");
 
 	ADD_GROUP("Root Motion", "root_motion_");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_motion_track"), "set_root_motion_track", "get_root_motion_track");
 
+	ADD_GROUP("LOD", "lod_");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "lod_enabled"), "set_lod_enabled", "is_lod_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_distance", PROPERTY_HINT_RANGE, "0,1000,0.1,or_greater,suffix:m"), "set_lod_distance", "get_lod_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_max_interval", PROPERTY_HINT_RANGE, "1,60,1,or_greater"), "set_lod_max_interval", "get_lod_max_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_offscreen_interval", PROPERTY_HINT_RANGE, "1,60,1,or_greater"), "set_lod_offscreen_interval", "get_lod_offscreen_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "lod_visibility_notifier", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "VisibleOnScreenNotifier3D"), "set_lod_visibility_notifier", "get_lod_visibility_notifier");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_max_bone_depth", PROPERTY_HINT_RANGE, "-1,64,1,or_greater"), "set_lod_max_bone_depth", "get_lod_max_bone_depth");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "lod_interpolate"), "set_lod_interpolate", "is_lod_interpolating");
+
 	ADD_GROUP("Audio", "audio_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "audio_max_polyphony", PROPERTY_HINT_RANGE, "1,127,1"), "set_audio_max_polyphony", "get_audio_max_polyphony");
 
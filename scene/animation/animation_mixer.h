@@ -92,6 +92,7 @@ public:
 		Animation::LoopedFlag looped_flag = Animation::LOOPED_FLAG_NONE;
 		real_t weight = 0.0;
 		Vector<real_t> track_weights;
+		Animation::KeyCursor *key_cursor = nullptr; // Owned by whatever produces the playback, so it lasts across frames.
 	};
 
 	struct AnimationInstance {
@@ -176,6 +177,13 @@ protected:
 		Vector3 loc;
 		Quaternion rot;
 		Vector3 scale;
+		int bone_depth = 0; // Number of parent bones, used to find low importance bones for the LOD.
+
+		// Pose of the previous LOD update, interpolated from while updates are skipped.
+		bool lod_prev_valid = false;
+		Vector3 lod_prev_loc;
+		Quaternion lod_prev_rot;
+		Vector3 lod_prev_scale;
 
 		TrackCacheTransform(const TrackCacheTransform &p_other) :
 				TrackCache(p_other),
@@ -191,7 +199,12 @@ protected:
 				init_scale(p_other.init_scale),
 				loc(p_other.loc),
 				rot(p_other.rot),
-				scale(p_other.scale) {
+				scale(p_other.scale),
+				bone_depth(p_other.bone_depth),
+				lod_prev_valid(p_other.lod_prev_valid),
+				lod_prev_loc(p_other.lod_prev_loc),
+				lod_prev_rot(p_other.lod_prev_rot),
+				lod_prev_scale(p_other.lod_prev_scale) {
 		}
 
 		TrackCacheTransform() {
@@ -327,6 +340,44 @@ protected:
 	HashMap<NodePath, int> track_map;
 	int track_count = 0;
 	bool deterministic = false;
+	Animation::TransformTrackSamples transform_samples; // Scratch buffer for the animation being blended.
+
+	/* ---- Parallel evaluation ---- */
+	struct ParallelEvaluation {
+		ObjectID mixer_id;
+		AnimationMixer *mixer = nullptr;
+		double delta = 0.0;
+	};
+	bool parallel_evaluation = false;
+	static LocalVector<ParallelEvaluation> parallel_queue; // Only touched from the main thread.
+	static void _flush_parallel_queue();
+	static void _blend_process_parallel(void *p_userdata, uint32_t p_index);
+	bool _can_evaluate_in_parallel() const;
+	void _queue_parallel_evaluation(double p_delta);
+
+	/* ---- Level of detail ---- */
+	bool lod_enabled = false;
+	real_t lod_distance = 20.0;
+	int lod_max_interval = 4;
+	int lod_offscreen_interval = 8;
+	NodePath lod_visibility_notifier;
+	int lod_max_bone_depth = -1;
+	bool lod_interpolate = true;
+
+	int lod_interval = 1; // Frames between the last update and the next one.
+	int lod_frames_since_update = 0;
+	double lod_accumulated_delta = 0.0;
+	bool lod_evaluated = false;
+
+	int _lod_get_target_interval();
+	bool _lod_process(double &r_delta);
+	void _lod_apply_interpolated(real_t p_weight);
+	_FORCE_INLINE_ bool _lod_is_bone_skipped(const TrackCacheTransform *p_track) const {
+		return lod_interval > 1 && lod_max_bone_depth >= 0 && p_track->bone_depth > lod_max_bone_depth;
+	}
+#ifndef _3D_DISABLED
+	bool _apply_transform_track(const TrackCacheTransform *p_track, const Vector3 &p_loc, const Quaternion &p_rot, const Vector3 &p_scale);
+#endif // _3D_DISABLED
 
 	/* ---- Root motion accumulator for Skeleton3D ---- */
 	NodePath root_motion_track;
@@ -363,11 +414,17 @@ protected:
 	Variant post_process_key_value(const Ref<Animation> &p_anim, int p_track, Variant p_value, ObjectID p_object_id, int p_object_sub_idx = -1);
 	GDVIRTUAL5RC(Variant, _post_process_key_value, Ref<Animation>, int, Variant, ObjectID, int);
 
+	enum BlendProcessTracks {
+		BLEND_PROCESS_TRACKS_ALL,
+		BLEND_PROCESS_TRACKS_TRANSFORM, // Position, rotation, scale and blend shape tracks, which only write to the track caches.
+		BLEND_PROCESS_TRACKS_OTHER,
+	};
+
 	void _blend_init();
 	virtual bool _blend_pre_process(double p_delta, int p_track_count, const HashMap<NodePath, int> &p_track_map);
 	virtual void _blend_capture(double p_delta);
 	void _blend_calc_total_weight(); // For undeterministic blending.
-	void _blend_process(double p_delta, bool p_update_only = false);
+	void _blend_process(double p_delta, bool p_update_only = false, BlendProcessTracks p_tracks = BLEND_PROCESS_TRACKS_ALL);
 	void _blend_apply();
 	virtual void _blend_post_process();
 	void _call_object(ObjectID p_object_id, const StringName &p_method, const Vector<Variant> &p_params, bool p_deferred);
@@ -422,6 +479,9 @@ public:
 	void set_deterministic(bool p_deterministic);
 	bool is_deterministic() const;
 
+	void set_parallel_evaluation(bool p_enabled);
+	bool is_parallel_evaluation() const;
+
 	void set_root_node(const NodePath &p_path);
 	NodePath get_root_node() const;
 
@@ -434,6 +494,30 @@ public:
 	void set_callback_mode_discrete(AnimationCallbackModeDiscrete p_mode);
 	AnimationCallbackModeDiscrete get_callback_mode_discrete() const;
 
+	/* ---- Level of detail ---- */
+	void set_lod_enabled(bool p_enabled);
+	bool is_lod_enabled() const;
+
+	void set_lod_distance(real_t p_distance);
+	real_t get_lod_distance() const;
+
+	void set_lod_max_interval(int p_interval);
+	int get_lod_max_interval() const;
+
+	void set_lod_offscreen_interval(int p_interval);
+	int get_lod_offscreen_interval() const;
+
+	void set_lod_visibility_notifier(const NodePath &p_path);
+	NodePath get_lod_visibility_notifier() const;
+
+	void set_lod_max_bone_depth(int p_depth);
+	int get_lod_max_bone_depth() const;
+
+	void set_lod_interpolate(bool p_interpolate);
+	bool is_lod_interpolating() const;
+
+	int get_lod_interval() const;
+
 	/* ---- Audio ---- */
 	void set_audio_max_polyphony(int p_audio_max_polyphony);
 	int get_audio_max_polyphony() const;
@@ -250,6 +250,8 @@ void AnimationPlayer::_process_playback_data(PlaybackData &cd, double p_delta, f
 	pi.is_external_seeking = !p_internal_seeked && !p_started;
 	pi.looped_flag = looped_flag;
 	pi.weight = p_blend;
+	// Blends can be erased (e.g. by a method track) while their instances are still being blended, so only the current playback keeps a cursor.
+	pi.key_cursor = p_is_current ? &cd.key_cursor : nullptr;
 	make_animation_instance(cd.from->name, pi);
 }
 
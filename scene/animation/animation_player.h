@@ -70,6 +70,7 @@ private:
 		float speed_scale = 1.0;
 		double start_time = 0.0;
 		double end_time = 0.0;
+		Animation::KeyCursor key_cursor;
 	};
 
 	struct Blend {
@@ -122,6 +122,7 @@ void AnimationNode::get_child_nodes(List<ChildNode> *r_child_nodes) {
 void AnimationNode::blend_animation(const StringName &p_animation, AnimationMixer::PlaybackInfo p_playback_info) {
 	ERR_FAIL_NULL(process_state);
 	p_playback_info.track_weights = node_state.track_weights;
+	p_playback_info.key_cursor = &process_state->tree->key_cursor_map[node_state.base_path];
 	process_state->tree->make_animation_instance(p_animation, p_playback_info);
 }
 
@@ -605,6 +606,10 @@ Ref<AnimationRootNode> AnimationTree::get_root_animation_node() const {
 
 bool AnimationTree::_blend_pre_process(double p_delta, int p_track_count, const HashMap<NodePath, int> &p_track_map) {
 	_update_properties(); // If properties need updating, update them.
+	if (key_cursor_map_dirty) {
+		key_cursor_map.clear();
+		key_cursor_map_dirty = false;
+	}
 
 	if (!root_animation_node.is_valid()) {
 		return false;
@@ -786,6 +791,7 @@ void AnimationTree::_update_properties() {
 	property_parent_map.clear();
 	input_activity_map.clear();
 	input_activity_map_get.clear();
+	key_cursor_map_dirty = true;
 
 	if (root_animation_node.is_valid()) {
 		_update_properties_for_node(Animation::PARAMETERS_BASE_PATH, root_animation_node);
@@ -270,6 +270,11 @@ private:
 	HashMap<StringName, Vector<Activity>> input_activity_map;
 	HashMap<StringName, Vector<Activity> *> input_activity_map_get;
 
+	// Keyed by the base path of the node blending the animation. Only pruned before making
+	// animation instances, since the instances point into it until they are blended.
+	HashMap<StringName, Animation::KeyCursor> key_cursor_map;
+	bool key_cursor_map_dirty = false;
+
 	NodePath animation_player;
 
 	void _setup_animation_player();
@@ -1189,7 +1189,7 @@ Error Animation::position_track_get_key(int p_track, int p_key, Vector3 *r_posit
 	return OK;
 }
 
-Error Animation::try_position_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward) const {
+Error Animation::try_position_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward, int *r_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_POSITION_3D, ERR_INVALID_PARAMETER);
@@ -1206,7 +1206,7 @@ Error Animation::try_position_track_interpolate(int p_track, double p_time, Vect
 
 	bool ok = false;
 
-	Vector3 tk = _interpolate(tt->positions, p_time, tt->interpolation, tt->loop_wrap, &ok, p_backward);
+	Vector3 tk = _interpolate(tt->positions, p_time, tt->interpolation, tt->loop_wrap, &ok, p_backward, r_cursor);
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1269,7 +1269,7 @@ Error Animation::rotation_track_get_key(int p_track, int p_key, Quaternion *r_ro
 	return OK;
 }
 
-Error Animation::try_rotation_track_interpolate(int p_track, double p_time, Quaternion *r_interpolation, bool p_backward) const {
+Error Animation::try_rotation_track_interpolate(int p_track, double p_time, Quaternion *r_interpolation, bool p_backward, int *r_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_ROTATION_3D, ERR_INVALID_PARAMETER);
@@ -1286,7 +1286,7 @@ Error Animation::try_rotation_track_interpolate(int p_track, double p_time, Quat
 
 	bool ok = false;
 
-	Quaternion tk = _interpolate(rt->rotations, p_time, rt->interpolation, rt->loop_wrap, &ok, p_backward);
+	Quaternion tk = _interpolate(rt->rotations, p_time, rt->interpolation, rt->loop_wrap, &ok, p_backward, r_cursor);
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1349,7 +1349,7 @@ Error Animation::scale_track_get_key(int p_track, int p_key, Vector3 *r_scale) c
 	return OK;
 }
 
-Error Animation::try_scale_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward) const {
+Error Animation::try_scale_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward, int *r_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_SCALE_3D, ERR_INVALID_PARAMETER);
@@ -1366,7 +1366,7 @@ Error Animation::try_scale_track_interpolate(int p_track, double p_time, Vector3
 
 	bool ok = false;
 
-	Vector3 tk = _interpolate(st->scales, p_time, st->interpolation, st->loop_wrap, &ok, p_backward);
+	Vector3 tk = _interpolate(st->scales, p_time, st->interpolation, st->loop_wrap, &ok, p_backward, r_cursor);
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1429,7 +1429,7 @@ Error Animation::blend_shape_track_get_key(int p_track, int p_key, float *r_blen
 	return OK;
 }
 
-Error Animation::try_blend_shape_track_interpolate(int p_track, double p_time, float *r_interpolation, bool p_backward) const {
+Error Animation::try_blend_shape_track_interpolate(int p_track, double p_time, float *r_interpolation, bool p_backward, int *r_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_BLEND_SHAPE, ERR_INVALID_PARAMETER);
@@ -1446,7 +1446,7 @@ Error Animation::try_blend_shape_track_interpolate(int p_track, double p_time, f
 
 	bool ok = false;
 
-	float tk = _interpolate(bst->blend_shapes, p_time, bst->interpolation, bst->loop_wrap, &ok, p_backward);
+	float tk = _interpolate(bst->blend_shapes, p_time, bst->interpolation, bst->loop_wrap, &ok, p_backward, r_cursor);
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1463,6 +1463,40 @@ float Animation::blend_shape_track_interpolate(int p_track, double p_time, bool
 	return ret;
 }
 
+void Animation::sample_transform_tracks(double p_time, TransformTrackSamples &r_samples, bool p_backward, KeyCursor *r_cursor) const {
+	uint32_t count = tracks.size();
+	r_samples.positions.resize(count);
+	r_samples.rotations.resize(count);
+	r_samples.scales.resize(count);
+	r_samples.blend_shapes.resize(count);
+	r_samples.valid.resize(count);
+
+	for (uint32_t i = 0; i < count; i++) {
+		const Track *t = tracks[i];
+		r_samples.valid[i] = 0;
+		if (!t->enabled) {
+			continue;
+		}
+		int *cursor = r_cursor ? r_cursor->get(i) : nullptr;
+		switch (t->type) {
+			case TYPE_POSITION_3D: {
+				r_samples.valid[i] = try_position_track_interpolate(i, p_time, &r_samples.positions[i], p_backward, cursor) == OK;
+			} break;
+			case TYPE_ROTATION_3D: {
+				r_samples.valid[i] = try_rotation_track_interpolate(i, p_time, &r_samples.rotations[i], p_backward, cursor) == OK;
+			} break;
+			case TYPE_SCALE_3D: {
+				r_samples.valid[i] = try_scale_track_interpolate(i, p_time, &r_samples.scales[i], p_backward, cursor) == OK;
+			} break;
+			case TYPE_BLEND_SHAPE: {
+				r_samples.valid[i] = try_blend_shape_track_interpolate(i, p_time, &r_samples.blend_shapes[i], p_backward, cursor) == OK;
+			} break;
+			default: {
+			} break;
+		}
+	}
+}
+
 ////
 
 void Animation::track_remove_key_at_time(int p_track, double p_time) {
@@ -2405,7 +2439,23 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, real_t p_tr
 }
 
 template <typename K>
-int Animation::_find(const Vector<K> &p_keys, double p_time, bool p_backward, bool p_limit) const {
+bool Animation::_is_find_result(const K *p_keys, int p_len, double p_time, bool p_backward, int p_index) {
+	// Whether the binary search in _find() would return p_index. It only ever returns an exact match
+	// or the key right before (after, when going backward) p_time, which can be checked locally.
+	if (p_index < 0 || p_index >= p_len) {
+		return false;
+	}
+	if (Math::is_equal_approx(p_time, (double)p_keys[p_index].time)) {
+		return true;
+	}
+	if (!p_backward) {
+		return p_keys[p_index].time < p_time && (p_index + 1 == p_len || (p_time < p_keys[p_index + 1].time && !Math::is_equal_approx(p_time, (double)p_keys[p_index + 1].time)));
+	}
+	return p_keys[p_index].time > p_time && (p_index == 0 || (p_keys[p_index - 1].time < p_time && !Math::is_equal_approx(p_time, (double)p_keys[p_index - 1].time)));
+}
+
+template <typename K>
+int Animation::_find(const Vector<K> &p_keys, double p_time, bool p_backward, bool p_limit, int *r_cursor) const {
 	int len = p_keys.size();
 	if (len == 0) {
 		return -2;
@@ -2423,11 +2473,25 @@ int Animation::_find(const Vector<K> &p_keys, double p_time, bool p_backward, bo
 
 	const K *keys = &p_keys[0];
 
-	while (low <= high) {
+	bool found = false;
+	if (r_cursor) {
+		// Sequential sampling almost always lands on the previous key or the one after it,
+		// so check those before falling back to the binary search.
+		int step = p_backward ? -1 : 1;
+		for (int i = 0; i < 2 && !found; i++) {
+			int candidate = *r_cursor + i * step;
+			if (_is_find_result(keys, len, p_time, p_backward, candidate)) {
+				middle = candidate;
+				found = true;
+			}
+		}
+	}
+
+	while (!found && low <= high) {
 		middle = (low + high) / 2;
 
 		if (Math::is_equal_approx(p_time, (double)keys[middle].time)) { //match
-			return middle;
+			found = true;
 		} else if (p_time < keys[middle].time) {
 			high = middle - 1; //search low end of array
 		} else {
@@ -2435,16 +2499,26 @@ int Animation::_find(const Vector<K> &p_keys, double p_time, bool p_backward, bo
 		}
 	}
 
-	if (!p_backward) {
-		if (keys[middle].time > p_time) {
-			middle--;
-		}
-	} else {
-		if (keys[middle].time < p_time) {
-			middle++;
+	if (!found) {
+		if (!p_backward) {
+			if (keys[middle].time > p_time) {
+				middle--;
+			}
+		} else {
+			if (keys[middle].time < p_time) {
+				middle++;
+			}
 		}
 	}
 
+	if (r_cursor) {
+		*r_cursor = middle;
+	}
+
+	if (found) {
+		return middle;
+	}
+
 	if (p_limit) {
 		double diff = length - keys[middle].time;
 		if ((signbit(keys[middle].time) && !Math::is_zero_approx(keys[middle].time)) || (signbit(diff) && !Math::is_zero_approx(diff))) {
@@ -2525,8 +2599,13 @@ Variant Animation::_cubic_interpolate_angle_in_time(const Variant &p_pre_a, cons
 }
 
 template <typename T>
-T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, bool p_backward) const {
-	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, bool p_backward, int *r_cursor) const {
+	int len;
+	if (!p_keys.is_empty() && p_keys[p_keys.size() - 1].time < length) {
+		len = p_keys.size(); // Common case, no keys past the end.
+	} else {
+		len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	}
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
@@ -2543,7 +2622,7 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 		return p_keys[0].value;
 	}
 
-	int idx = _find(p_keys, p_time, p_backward);
+	int idx = _find(p_keys, p_time, p_backward, false, r_cursor);
 
 	ERR_FAIL_COND_V(idx == -2, T());
 	int maxi = len - 1;
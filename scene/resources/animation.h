@@ -116,6 +116,33 @@ public:
 		virtual ~Track() {}
 	};
 
+	// Remembers, per track, the key found by the last sample of one playback.
+	// Passing it to sequential samples lets most key lookups skip the binary search.
+	struct KeyCursor {
+		LocalVector<int> keys;
+
+		_FORCE_INLINE_ int *get(int p_track) {
+			if (unlikely(uint32_t(p_track) >= keys.size())) {
+				uint32_t from = keys.size();
+				keys.resize(p_track + 1);
+				for (uint32_t i = from; i < keys.size(); i++) {
+					keys[i] = -1;
+				}
+			}
+			return &keys[p_track];
+		}
+		void reset() { keys.clear(); }
+	};
+
+	// Output of sample_transform_tracks(), one entry per track. Only the array matching a track's type is meaningful.
+	struct TransformTrackSamples {
+		LocalVector<Vector3> positions;
+		LocalVector<Quaternion> rotations;
+		LocalVector<Vector3> scales;
+		LocalVector<float> blend_shapes;
+		LocalVector<uint8_t> valid;
+	};
+
 private:
 	struct Key {
 		real_t transition = 1.0;
@@ -262,8 +289,9 @@ private:
 	int _marker_insert(double p_time, Vector<MarkerKey> &p_keys, const MarkerKey &p_value);
 
 	template <typename K>
-
-	inline int _find(const Vector<K> &p_keys, double p_time, bool p_backward = false, bool p_limit = false) const;
+	static bool _is_find_result(const K *p_keys, int p_len, double p_time, bool p_backward, int p_index);
+	template <typename K>
+	inline int _find(const Vector<K> &p_keys, double p_time, bool p_backward = false, bool p_limit = false, int *r_cursor = nullptr) const;
 
 	_FORCE_INLINE_ Vector3 _interpolate(const Vector3 &p_a, const Vector3 &p_b, real_t p_c) const;
 	_FORCE_INLINE_ Quaternion _interpolate(const Quaternion &p_a, const Quaternion &p_b, real_t p_c) const;
@@ -278,7 +306,7 @@ private:
 	_FORCE_INLINE_ Variant _cubic_interpolate_angle_in_time(const Variant &p_pre_a, const Variant &p_a, const Variant &p_b, const Variant &p_post_b, real_t p_c, real_t p_pre_a_t, real_t p_b_t, real_t p_post_b_t) const;
 
 	template <typename T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, bool p_backward = false) const;
+	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, bool p_backward = false, int *r_cursor = nullptr) const;
 
 	template <typename T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, double from_time, double to_time, List<int> *p_indices, bool p_is_backward) const;
@@ -453,24 +481,26 @@ public:
 
 	int position_track_insert_key(int p_track, double p_time, const Vector3 &p_position);
 	Error position_track_get_key(int p_track, int p_key, Vector3 *r_position) const;
-	Error try_position_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward = false) const;
+	Error try_position_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward = false, int *r_cursor = nullptr) const;
 	Vector3 position_track_interpolate(int p_track, double p_time, bool p_backward = false) const;
 
 	int rotation_track_insert_key(int p_track, double p_time, const Quaternion &p_rotation);
 	Error rotation_track_get_key(int p_track, int p_key, Quaternion *r_rotation) const;
-	Error try_rotation_track_interpolate(int p_track, double p_time, Quaternion *r_interpolation, bool p_backward = false) const;
+	Error try_rotation_track_interpolate(int p_track, double p_time, Quaternion *r_interpolation, bool p_backward = false, int *r_cursor = nullptr) const;
 	Quaternion rotation_track_interpolate(int p_track, double p_time, bool p_backward = false) const;
 
 	int scale_track_insert_key(int p_track, double p_time, const Vector3 &p_scale);
 	Error scale_track_get_key(int p_track, int p_key, Vector3 *r_scale) const;
-	Error try_scale_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward = false) const;
+	Error try_scale_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward = false, int *r_cursor = nullptr) const;
 	Vector3 scale_track_interpolate(int p_track, double p_time, bool p_backward = false) const;
 
 	int blend_shape_track_insert_key(int p_track, double p_time, float p_blend);
 	Error blend_shape_track_get_key(int p_track, int p_key, float *r_blend) const;
-	Error try_blend_shape_track_interpolate(int p_track, double p_time, float *r_blend, bool p_backward = false) const;
+	Error try_blend_shape_track_interpolate(int p_track, double p_time, float *r_blend, bool p_backward = false, int *r_cursor = nullptr) const;
 	float blend_shape_track_interpolate(int p_track, double p_time, bool p_backward = false) const;
 
+	void sample_transform_tracks(double p_time, TransformTrackSamples &r_samples, bool p_backward = false, KeyCursor *r_cursor = nullptr) const;
+
 	void track_set_interpolation_type(int p_track, InterpolationType p_interp);
 	InterpolationType track_get_interpolation_type(int p_track) const;
 
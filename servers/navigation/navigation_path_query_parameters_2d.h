@@ -88,6 +88,12 @@ public:
 
 	void set_simplify_epsilon(real_t p_epsilon);
 	real_t get_simplify_epsilon() const;
+
+	void set_use_hierarchical_pathfinding(bool p_enabled);
+	bool get_use_hierarchical_pathfinding() const;
+
+	void set_hierarchical_suboptimality_bound(real_t p_bound);
+	real_t get_hierarchical_suboptimality_bound() const;
 };
 
 VARIANT_ENUM_CAST(NavigationPathQueryParameters2D::PathfindingAlgorithm);
@@ -135,6 +135,22 @@ real_t NavigationPathQueryParameters3D::get_simplify_epsilon() const {
 	return parameters.simplify_epsilon;
 }
 
+void NavigationPathQueryParameters3D::set_use_hierarchical_pathfinding(bool p_enabled) {
+	parameters.use_hierarchical_pathfinding = p_enabled;
+}
+
+bool NavigationPathQueryParameters3D::get_use_hierarchical_pathfinding() const {
+	return parameters.use_hierarchical_pathfinding;
+}
+
+void NavigationPathQueryParameters3D::set_hierarchical_suboptimality_bound(real_t p_bound) {
+	parameters.hierarchical_suboptimality_bound = MAX(1.0, p_bound);
+}
+
+real_t NavigationPathQueryParameters3D::get_hierarchical_suboptimality_bound() const {
+	return parameters.hierarchical_suboptimality_bound;
+}
+
 void NavigationPathQueryParameters3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_pathfinding_algorithm", "pathfinding_algorithm"), &NavigationPathQueryParameters3D::set_pathfinding_algorithm);
 	ClassDB::bind_method(D_METHOD("get_pathfinding_algorithm"), &NavigationPathQueryParameters3D::get_pathfinding_algorithm);
@@ -163,6 +179,12 @@ void NavigationPathQueryParameters3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_simplify_epsilon", "epsilon"), &NavigationPathQueryParameters3D::set_simplify_epsilon);
 	ClassDB::bind_method(D_METHOD("get_simplify_epsilon"), &NavigationPathQueryParameters3D::get_simplify_epsilon);
 
+	ClassDB::bind_method(D_METHOD("set_use_hierarchical_pathfinding", "enabled"), &NavigationPathQueryParameters3D::set_use_hierarchical_pathfinding);
+	ClassDB::bind_method(D_METHOD("get_use_hierarchical_pathfinding"), &NavigationPathQueryParameters3D::get_use_hierarchical_pathfinding);
+
+	ClassDB::bind_method(D_METHOD("set_hierarchical_suboptimality_bound", "bound"), &NavigationPathQueryParameters3D::set_hierarchical_suboptimality_bound);
+	ClassDB::bind_method(D_METHOD("get_hierarchical_suboptimality_bound"), &NavigationPathQueryParameters3D::get_hierarchical_suboptimality_bound);
+
 	ADD_PROPERTY(PropertyInfo(Variant::RID, "map"), "set_map", "get_map");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "start_position"), "set_start_position", "get_start_position");
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "target_position"), "set_target_position", "get_target_position");
@@ -172,6 +194,8 @@ void NavigationPathQueryParameters3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "metadata_flags", PROPERTY_HINT_FLAGS, "Include Types,Include RIDs,Include Owners"), "set_metadata_flags", "get_metadata_flags");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "simplify_path"), "set_simplify_path", "get_simplify_path");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "simplify_epsilon"), "set_simplify_epsilon", "get_simplify_epsilon");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_hierarchical_pathfinding"), "set_use_hierarchical_pathfinding", "get_use_hierarchical_pathfinding");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "hierarchical_suboptimality_bound", PROPERTY_HINT_RANGE, "1.0,10.0,0.01,or_greater"), "set_hierarchical_suboptimality_bound", "get_hierarchical_suboptimality_bound");
 
 	BIND_ENUM_CONSTANT(PATHFINDING_ALGORITHM_ASTAR);
 
@@ -68,6 +68,8 @@ struct PathQueryParameters {
 	BitField<PathMetadataFlags> metadata_flags = PATH_INCLUDE_ALL;
 	bool simplify_path = false;
 	real_t simplify_epsilon = 0.0;
+	bool use_hierarchical_pathfinding = false;
+	real_t hierarchical_suboptimality_bound = 1.0;
 };
 
 struct PathQueryResult {
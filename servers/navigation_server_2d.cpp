@@ -63,6 +63,8 @@ void NavigationServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_random_point", "map", "navigation_layers", "uniformly"), &NavigationServer2D::map_get_random_point);
 
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result"), &NavigationServer2D::query_path);
+	ClassDB::bind_method(D_METHOD("query_path_batch_async", "parameters", "results", "callback"), &NavigationServer2D::query_path_batch_async, DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("is_query_path_batch_completed", "batch_id"), &NavigationServer2D::is_query_path_batch_completed);
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer2D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_enabled", "region", "enabled"), &NavigationServer2D::region_set_enabled);
@@ -161,6 +163,17 @@ void NavigationServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("obstacle_set_avoidance_layers", "obstacle", "layers"), &NavigationServer2D::obstacle_set_avoidance_layers);
 	ClassDB::bind_method(D_METHOD("obstacle_get_avoidance_layers", "obstacle"), &NavigationServer2D::obstacle_get_avoidance_layers);
 
+	ClassDB::bind_method(D_METHOD("flow_field_create"), &NavigationServer2D::flow_field_create);
+	ClassDB::bind_method(D_METHOD("flow_field_set_map", "flow_field", "map"), &NavigationServer2D::flow_field_set_map);
+	ClassDB::bind_method(D_METHOD("flow_field_get_map", "flow_field"), &NavigationServer2D::flow_field_get_map);
+	ClassDB::bind_method(D_METHOD("flow_field_set_targets", "flow_field", "targets"), &NavigationServer2D::flow_field_set_targets);
+	ClassDB::bind_method(D_METHOD("flow_field_get_targets", "flow_field"), &NavigationServer2D::flow_field_get_targets);
+	ClassDB::bind_method(D_METHOD("flow_field_set_navigation_layers", "flow_field", "navigation_layers"), &NavigationServer2D::flow_field_set_navigation_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_get_navigation_layers", "flow_field"), &NavigationServer2D::flow_field_get_navigation_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_get_direction", "flow_field", "position"), &NavigationServer2D::flow_field_get_direction);
+	ClassDB::bind_method(D_METHOD("flow_field_get_distance", "flow_field", "position"), &NavigationServer2D::flow_field_get_distance);
+	ClassDB::bind_method(D_METHOD("flow_field_get_directions", "flow_field", "positions"), &NavigationServer2D::flow_field_get_directions);
+
 	ClassDB::bind_method(D_METHOD("parse_source_geometry_data", "navigation_polygon", "source_geometry_data", "root_node", "callback"), &NavigationServer2D::parse_source_geometry_data, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("bake_from_source_geometry_data", "navigation_polygon", "source_geometry_data", "callback"), &NavigationServer2D::bake_from_source_geometry_data, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("bake_from_source_geometry_data_async", "navigation_polygon", "source_geometry_data", "callback"), &NavigationServer2D::bake_from_source_geometry_data_async, DEFVAL(Callable()));
@@ -292,9 +292,28 @@ public:
 	virtual void obstacle_set_avoidance_layers(RID p_obstacle, uint32_t p_layers) = 0;
 	virtual uint32_t obstacle_get_avoidance_layers(RID p_obstacle) const = 0;
 
+	/// Creates the flow field.
+	/// A flow field stores the travel cost from every map polygon to the closest of its targets,
+	/// so agents that share those targets can sample a direction instead of querying their own path.
+	virtual RID flow_field_create() = 0;
+	virtual void flow_field_set_map(RID p_flow_field, RID p_map) = 0;
+	virtual RID flow_field_get_map(RID p_flow_field) const = 0;
+	virtual void flow_field_set_targets(RID p_flow_field, const Vector<Vector2> &p_targets) = 0;
+	virtual Vector<Vector2> flow_field_get_targets(RID p_flow_field) const = 0;
+	virtual void flow_field_set_navigation_layers(RID p_flow_field, uint32_t p_navigation_layers) = 0;
+	virtual uint32_t flow_field_get_navigation_layers(RID p_flow_field) const = 0;
+	virtual Vector2 flow_field_get_direction(RID p_flow_field, const Vector2 &p_position) const = 0;
+	virtual real_t flow_field_get_distance(RID p_flow_field, const Vector2 &p_position) const = 0;
+	virtual Vector<Vector2> flow_field_get_directions(RID p_flow_field, const Vector<Vector2> &p_positions) const = 0;
+
 	/// Returns a customized navigation path using a query parameters object
 	virtual void query_path(const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result) const = 0;
 
+	/// Runs a batch of path queries on the WorkerThreadPool.
+	/// The results are written to the result objects during the next sync after all queries finished.
+	virtual uint32_t query_path_batch_async(const TypedArray<NavigationPathQueryParameters2D> &p_query_parameters, const TypedArray<NavigationPathQueryResult2D> &p_query_results, const Callable &p_callback = Callable()) = 0;
+	virtual bool is_query_path_batch_completed(uint32_t p_batch_id) const = 0;
+
 	virtual void init() = 0;
 	virtual void sync() = 0;
 	virtual void finish() = 0;
@@ -73,6 +73,8 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_random_point", "map", "navigation_layers", "uniformly"), &NavigationServer3D::map_get_random_point);
 
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result"), &NavigationServer3D::query_path);
+	ClassDB::bind_method(D_METHOD("query_path_batch_async", "parameters", "results", "callback"), &NavigationServer3D::query_path_batch_async, DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("is_query_path_batch_completed", "batch_id"), &NavigationServer3D::is_query_path_batch_completed);
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_enabled", "region", "enabled"), &NavigationServer3D::region_set_enabled);
@@ -185,6 +187,17 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("obstacle_set_avoidance_layers", "obstacle", "layers"), &NavigationServer3D::obstacle_set_avoidance_layers);
 	ClassDB::bind_method(D_METHOD("obstacle_get_avoidance_layers", "obstacle"), &NavigationServer3D::obstacle_get_avoidance_layers);
 
+	ClassDB::bind_method(D_METHOD("flow_field_create"), &NavigationServer3D::flow_field_create);
+	ClassDB::bind_method(D_METHOD("flow_field_set_map", "flow_field", "map"), &NavigationServer3D::flow_field_set_map);
+	ClassDB::bind_method(D_METHOD("flow_field_get_map", "flow_field"), &NavigationServer3D::flow_field_get_map);
+	ClassDB::bind_method(D_METHOD("flow_field_set_targets", "flow_field", "targets"), &NavigationServer3D::flow_field_set_targets);
+	ClassDB::bind_method(D_METHOD("flow_field_get_targets", "flow_field"), &NavigationServer3D::flow_field_get_targets);
+	ClassDB::bind_method(D_METHOD("flow_field_set_navigation_layers", "flow_field", "navigation_layers"), &NavigationServer3D::flow_field_set_navigation_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_get_navigation_layers", "flow_field"), &NavigationServer3D::flow_field_get_navigation_layers);
+	ClassDB::bind_method(D_METHOD("flow_field_get_direction", "flow_field", "position"), &NavigationServer3D::flow_field_get_direction);
+	ClassDB::bind_method(D_METHOD("flow_field_get_distance", "flow_field", "position"), &NavigationServer3D::flow_field_get_distance);
+	ClassDB::bind_method(D_METHOD("flow_field_get_directions", "flow_field", "positions"), &NavigationServer3D::flow_field_get_directions);
+
 #ifndef _3D_DISABLED
 	ClassDB::bind_method(D_METHOD("parse_source_geometry_data", "navigation_mesh", "source_geometry_data", "root_node", "callback"), &NavigationServer3D::parse_source_geometry_data, DEFVAL(Callable()));
 	ClassDB::bind_method(D_METHOD("bake_from_source_geometry_data", "navigation_mesh", "source_geometry_data", "callback"), &NavigationServer3D::bake_from_source_geometry_data, DEFVAL(Callable()));
@@ -327,6 +327,20 @@ public:
 	virtual void obstacle_set_avoidance_layers(RID p_obstacle, uint32_t p_layers) = 0;
 	virtual uint32_t obstacle_get_avoidance_layers(RID p_obstacle) const = 0;
 
+	/// Creates the flow field.
+	/// A flow field stores the travel cost from every map polygon to the closest of its targets,
+	/// so agents that share those targets can sample a direction instead of querying their own path.
+	virtual RID flow_field_create() = 0;
+	virtual void flow_field_set_map(RID p_flow_field, RID p_map) = 0;
+	virtual RID flow_field_get_map(RID p_flow_field) const = 0;
+	virtual void flow_field_set_targets(RID p_flow_field, const Vector<Vector3> &p_targets) = 0;
+	virtual Vector<Vector3> flow_field_get_targets(RID p_flow_field) const = 0;
+	virtual void flow_field_set_navigation_layers(RID p_flow_field, uint32_t p_navigation_layers) = 0;
+	virtual uint32_t flow_field_get_navigation_layers(RID p_flow_field) const = 0;
+	virtual Vector3 flow_field_get_direction(RID p_flow_field, const Vector3 &p_position) const = 0;
+	virtual real_t flow_field_get_distance(RID p_flow_field, const Vector3 &p_position) const = 0;
+	virtual Vector<Vector3> flow_field_get_directions(RID p_flow_field, const Vector<Vector3> &p_positions) const = 0;
+
 	/// Destroy the `RID`
 	virtual void free(RID p_object) = 0;
 
@@ -347,6 +361,16 @@ public:
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const = 0;
 
+	/// Runs a batch of path queries on the WorkerThreadPool.
+	/// The results are written to the result objects during the next sync after all queries finished.
+	virtual uint32_t query_path_batch_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback = Callable()) = 0;
+	virtual bool is_query_path_batch_completed(uint32_t p_batch_id) const = 0;
+
+	/// Starts the queries of a batch, returns the batch id or 0 on failure.
+	virtual uint32_t _query_path_batch_async(const LocalVector<NavigationUtilities::PathQueryParameters> &p_parameters) = 0;
+	/// Returns `false` while the queries of the batch are still running, otherwise takes the results and releases the batch.
+	virtual bool _query_path_batch_get_results(uint32_t p_batch_id, LocalVector<NavigationUtilities::PathQueryResult> &r_results) = 0;
+
 #ifndef _3D_DISABLED
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) = 0;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) = 0;
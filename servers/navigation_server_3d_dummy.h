@@ -177,6 +177,16 @@ public:
 	Vector<Vector3> obstacle_get_vertices(RID p_obstacle) const override { return Vector<Vector3>(); }
 	void obstacle_set_avoidance_layers(RID p_obstacle, uint32_t p_layers) override {}
 	uint32_t obstacle_get_avoidance_layers(RID p_obstacle) const override { return 0; }
+	RID flow_field_create() override { return RID(); }
+	void flow_field_set_map(RID p_flow_field, RID p_map) override {}
+	RID flow_field_get_map(RID p_flow_field) const override { return RID(); }
+	void flow_field_set_targets(RID p_flow_field, const Vector<Vector3> &p_targets) override {}
+	Vector<Vector3> flow_field_get_targets(RID p_flow_field) const override { return Vector<Vector3>(); }
+	void flow_field_set_navigation_layers(RID p_flow_field, uint32_t p_navigation_layers) override {}
+	uint32_t flow_field_get_navigation_layers(RID p_flow_field) const override { return 0; }
+	Vector3 flow_field_get_direction(RID p_flow_field, const Vector3 &p_position) const override { return Vector3(); }
+	real_t flow_field_get_distance(RID p_flow_field, const Vector3 &p_position) const override { return FLT_MAX; }
+	Vector<Vector3> flow_field_get_directions(RID p_flow_field, const Vector<Vector3> &p_positions) const override { return Vector<Vector3>(); }
 
 #ifndef _3D_DISABLED
 	void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) override {}
@@ -198,6 +208,10 @@ public:
 	void finish() override {}
 
 	NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override { return NavigationUtilities::PathQueryResult(); }
+	uint32_t query_path_batch_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results, const Callable &p_callback = Callable()) override { return 0; }
+	bool is_query_path_batch_completed(uint32_t p_batch_id) const override { return true; }
+	uint32_t _query_path_batch_async(const LocalVector<NavigationUtilities::PathQueryParameters> &p_parameters) override { return 0; }
+	bool _query_path_batch_get_results(uint32_t p_batch_id, LocalVector<NavigationUtilities::PathQueryResult> &r_results) override { return true; }
 	int get_process_info(ProcessInfo p_info) const override { return 0; }
 
 	void set_debug_enabled(bool p_enabled) {}
@@ -617,6 +617,20 @@ bool PhysicsServer2D::_body_test_motion(RID p_body, const Ref<PhysicsTestMotionP
 	return body_test_motion(p_body, p_parameters->get_parameters(), result_ptr);
 }
 
+PackedByteArray PhysicsServer2D::space_save_state(RID p_space) {
+	ERR_FAIL_V_MSG(PackedByteArray(), "Saving the state of a space is not supported by this physics server.");
+}
+
+bool PhysicsServer2D::space_restore_state(RID p_space, const PackedByteArray &p_state) {
+	ERR_FAIL_V_MSG(false, "Restoring the state of a space is not supported by this physics server.");
+}
+
+void PhysicsServer2D::body_test_motion_batch(const RID *p_bodies, const MotionParameters *p_parameters, MotionResult *r_results, bool *r_collided, int p_count) {
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = body_test_motion(p_bodies[i], p_parameters[i], r_results ? &r_results[i] : nullptr);
+	}
+}
+
 void PhysicsServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("world_boundary_shape_create"), &PhysicsServer2D::world_boundary_shape_create);
 	ClassDB::bind_method(D_METHOD("separation_ray_shape_create"), &PhysicsServer2D::separation_ray_shape_create);
@@ -638,6 +652,8 @@ void PhysicsServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer2D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer2D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer2D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_state", "space"), &PhysicsServer2D::space_save_state);
+	ClassDB::bind_method(D_METHOD("space_restore_state", "space", "state"), &PhysicsServer2D::space_restore_state);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer2D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer2D::area_set_space);
@@ -910,6 +926,8 @@ PhysicsServer2D::PhysicsServer2D() {
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.01,10,0.01,or_greater"), 0.3);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_constraint_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.2);
+	GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "physics/2d/broad_phase", PROPERTY_HINT_ENUM, "BVH,Spatial Hash"), 0);
+	GLOBAL_DEF_RST(PropertyInfo(Variant::FLOAT, "physics/2d/spatial_hash_cell_size", PROPERTY_HINT_RANGE, "1,1024,1,or_greater,suffix:px"), 128.0);
 }
 
 PhysicsServer2D::~PhysicsServer2D() {
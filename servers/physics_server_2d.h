@@ -276,6 +276,10 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// Snapshots of the body and contact state of a space, used for rollback.
+	virtual PackedByteArray space_save_state(RID p_space);
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state);
+
 	//missing space parameters
 
 	/* AREA API */
@@ -522,6 +526,10 @@ public:
 	};
 
 	virtual bool body_test_motion(RID p_body, const MotionParameters &p_parameters, MotionResult *r_result = nullptr) = 0;
+	// Tests the motion of several bodies at once. Every motion is tested against the state of the
+	// space at the time of the call, so bodies in the batch don't see each other move.
+	// Servers may process the batch in parallel; the default implementation is serial.
+	virtual void body_test_motion_batch(const RID *p_bodies, const MotionParameters *p_parameters, MotionResult *r_results, bool *r_collided, int p_count);
 
 	/* JOINT API */
 
@@ -662,6 +662,20 @@ bool PhysicsServer3D::_body_test_motion(RID p_body, const Ref<PhysicsTestMotionP
 	return body_test_motion(p_body, p_parameters->get_parameters(), result_ptr);
 }
 
+void PhysicsServer3D::body_test_motion_batch(const RID *p_bodies, const MotionParameters *p_parameters, MotionResult *r_results, bool *r_collided, int p_count) {
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = body_test_motion(p_bodies[i], p_parameters[i], r_results ? &r_results[i] : nullptr);
+	}
+}
+
+PackedByteArray PhysicsServer3D::space_save_state(RID p_space) {
+	ERR_FAIL_V_MSG(PackedByteArray(), "Saving the state of a space is not supported by this physics server.");
+}
+
+bool PhysicsServer3D::space_restore_state(RID p_space, const PackedByteArray &p_state) {
+	ERR_FAIL_V_MSG(false, "Restoring the state of a space is not supported by this physics server.");
+}
+
 RID PhysicsServer3D::shape_create(ShapeType p_shape) {
 	switch (p_shape) {
 		case SHAPE_WORLD_BOUNDARY:
@@ -716,6 +730,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_state", "space"), &PhysicsServer3D::space_save_state);
+	ClassDB::bind_method(D_METHOD("space_restore_state", "space", "state"), &PhysicsServer3D::space_restore_state);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -128,6 +128,16 @@ public:
 		return physics_server_3d->space_get_contact_count(p_space);
 	}
 
+	virtual PackedByteArray space_save_state(RID p_space) override {
+		ERR_FAIL_COND_V(!Thread::is_main_thread(), PackedByteArray());
+		return physics_server_3d->space_save_state(p_space);
+	}
+
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state) override {
+		ERR_FAIL_COND_V(!Thread::is_main_thread(), false);
+		return physics_server_3d->space_restore_state(p_space, p_state);
+	}
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -264,6 +274,11 @@ public:
 		return physics_server_3d->body_test_motion(p_body, p_parameters, r_result);
 	}
 
+	void body_test_motion_batch(const RID *p_bodies, const MotionParameters *p_parameters, MotionResult *r_results, bool *r_collided, int p_count) override {
+		ERR_FAIL_COND(!Thread::is_main_thread());
+		physics_server_3d->body_test_motion_batch(p_bodies, p_parameters, r_results, r_collided, p_count);
+	}
+
 	// this function only works on physics process, errors and returns null otherwise
 	PhysicsDirectBodyState3D *body_get_direct_state(RID p_body) override {
 		ERR_FAIL_COND_V(!Thread::is_main_thread(), nullptr);
@@ -47,7 +47,10 @@ LightStorage::~LightStorage() {
 }
 
 bool LightStorage::free(RID p_rid) {
-	if (owns_lightmap(p_rid)) {
+	if (owns_light(p_rid)) {
+		light_free(p_rid);
+		return true;
+	} else if (owns_lightmap(p_rid)) {
 		lightmap_free(p_rid);
 		return true;
 	} else if (owns_lightmap_instance(p_rid)) {
@@ -58,6 +61,65 @@ bool LightStorage::free(RID p_rid) {
 	return false;
 }
 
+/* LIGHT API */
+
+RID LightStorage::directional_light_allocate() {
+	return light_owner.allocate_rid();
+}
+
+void LightStorage::directional_light_initialize(RID p_rid) {
+	Light light;
+	light.type = RS::LIGHT_DIRECTIONAL;
+	light_owner.initialize_rid(p_rid, light);
+}
+
+RID LightStorage::omni_light_allocate() {
+	return light_owner.allocate_rid();
+}
+
+void LightStorage::omni_light_initialize(RID p_rid) {
+	Light light;
+	light.type = RS::LIGHT_OMNI;
+	light_owner.initialize_rid(p_rid, light);
+}
+
+RID LightStorage::spot_light_allocate() {
+	return light_owner.allocate_rid();
+}
+
+void LightStorage::spot_light_initialize(RID p_rid) {
+	Light light;
+	light.type = RS::LIGHT_SPOT;
+	light_owner.initialize_rid(p_rid, light);
+}
+
+void LightStorage::light_free(RID p_rid) {
+	light_owner.free(p_rid);
+}
+
+void LightStorage::light_set_param(RID p_light, RS::LightParam p_param, float p_value) {
+	Light *light = light_owner.get_or_null(p_light);
+	ERR_FAIL_NULL(light);
+	ERR_FAIL_INDEX(p_param, RS::LIGHT_PARAM_MAX);
+
+	light->param[p_param] = p_value;
+}
+
+RS::LightType LightStorage::light_get_type(RID p_light) const {
+	const Light *light = light_owner.get_or_null(p_light);
+	ERR_FAIL_NULL_V(light, RS::LIGHT_OMNI);
+
+	return light->type;
+}
+
+float LightStorage::light_get_param(RID p_light, RS::LightParam p_param) {
+	const Light *light = light_owner.get_or_null(p_light);
+	ERR_FAIL_NULL_V(light, 0);
+	ERR_FAIL_INDEX_V(p_param, RS::LIGHT_PARAM_MAX, 0);
+
+	return light->param[p_param];
+}
+
 /* LIGHTMAP API */
 
 RID LightStorage::lightmap_allocate() {
@@ -0,0 +1,513 @@
+/**************************************************************************/
+/*  raster_occlusion_cull.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "raster_occlusion_cull.h"
+
+#include "core/object/worker_thread_pool.h"
+
+RasterOcclusionCull *RasterOcclusionCull::raster_singleton = nullptr;
+
+void RasterOcclusionCull::RasterHZBuffer::clear() {
+	HZBuffer::clear();
+
+	view_vertices.clear();
+	triangles.clear();
+	tile_triangles.clear();
+	tile_grid_size = Size2i();
+}
+
+void RasterOcclusionCull::RasterHZBuffer::resize(const Size2i &p_size) {
+	if (p_size == Size2i()) {
+		clear();
+		return;
+	}
+
+	if (!sizes.is_empty() && p_size == sizes[0]) {
+		return; // Size didn't change
+	}
+
+	HZBuffer::resize(p_size);
+
+	tile_grid_size = Size2i(Math::division_round_up(p_size.x, (int)TILE_SIZE), Math::division_round_up(p_size.y, (int)TILE_SIZE));
+	tile_triangles.resize(tile_grid_size.x * tile_grid_size.y);
+}
+
+void RasterOcclusionCull::RasterHZBuffer::begin(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	cam_inv_transform = p_cam_transform.affine_inverse();
+	cam_projection = p_cam_projection;
+	cam_orthogonal = p_cam_orthogonal;
+	z_near = p_cam_projection.get_z_near();
+
+	// Match the raycast backend, where rays that hit nothing end slightly past the far plane.
+	clear_depth = p_cam_projection.get_z_far() * 1.05f;
+	debug_tex_range = clear_depth;
+
+	triangles.clear();
+	for (LocalVector<uint32_t> &tile : tile_triangles) {
+		tile.clear();
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::add_occluder(const LocalVector<Vector3> &p_vertices, const LocalVector<uint32_t> &p_indices) {
+	ERR_FAIL_COND(is_empty());
+
+	const uint32_t vertex_count = p_vertices.size();
+	view_vertices.resize(vertex_count);
+	for (uint32_t i = 0; i < vertex_count; i++) {
+		view_vertices[i] = cam_inv_transform.xform(p_vertices[i]);
+	}
+
+	const uint32_t index_count = p_indices.size() - p_indices.size() % 3;
+	for (uint32_t i = 0; i < index_count; i += 3) {
+		const uint32_t a = p_indices[i + 0];
+		const uint32_t b = p_indices[i + 1];
+		const uint32_t c = p_indices[i + 2];
+		if (a >= vertex_count || b >= vertex_count || c >= vertex_count) {
+			continue;
+		}
+		_clip_and_add_triangle(view_vertices[a], view_vertices[b], view_vertices[c]);
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::_clip_and_add_triangle(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) {
+	const real_t near_z = -z_near;
+
+	if (p_a.z <= near_z && p_b.z <= near_z && p_c.z <= near_z) {
+		// Fully in front of the near plane, the common case.
+		_add_triangle(p_a, p_b, p_c);
+		return;
+	}
+
+	// Clip against the near plane, which can turn the triangle into a quad.
+	const Vector3 input[3] = { p_a, p_b, p_c };
+	Vector3 output[4];
+	int output_count = 0;
+
+	for (int i = 0; i < 3; i++) {
+		const Vector3 &current = input[i];
+		const Vector3 &next = input[(i + 1) % 3];
+		const bool current_inside = current.z <= near_z;
+		const bool next_inside = next.z <= near_z;
+
+		if (current_inside) {
+			output[output_count++] = current;
+		}
+		if (current_inside != next_inside) {
+			output[output_count++] = current.lerp(next, (near_z - current.z) / (next.z - current.z));
+		}
+	}
+
+	if (output_count < 3) {
+		return;
+	}
+
+	_add_triangle(output[0], output[1], output[2]);
+	if (output_count == 4) {
+		_add_triangle(output[0], output[2], output[3]);
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::_add_triangle(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) {
+	const Size2i &buffer_size = sizes[0];
+	const Vector3 view[3] = { p_a, p_b, p_c };
+
+	Triangle triangle;
+	for (int i = 0; i < 3; i++) {
+		const Vector4 clip = cam_projection.xform(Vector4(view[i].x, view[i].y, view[i].z, 1.0));
+		triangle.vertices[i] = Vector2((clip.x / clip.w * 0.5 + 0.5) * buffer_size.x, (clip.y / clip.w * 0.5 + 0.5) * buffer_size.y);
+
+		// Store the depth the same way the raycast backend does, as the distance along the view direction.
+		const float depth = MAX(-view[i].z, z_near);
+		triangle.depths[i] = cam_orthogonal ? depth : 1.0f / depth;
+	}
+
+	Vector2 screen_min = triangle.vertices[0].min(triangle.vertices[1]).min(triangle.vertices[2]);
+	Vector2 screen_max = triangle.vertices[0].max(triangle.vertices[1]).max(triangle.vertices[2]);
+
+	// Pixels are sampled at their center.
+	const int min_x = MAX(0, (int)Math::ceil(screen_min.x - 0.5f));
+	const int min_y = MAX(0, (int)Math::ceil(screen_min.y - 0.5f));
+	const int max_x = MIN(buffer_size.x - 1, (int)Math::floor(screen_max.x - 0.5f));
+	const int max_y = MIN(buffer_size.y - 1, (int)Math::floor(screen_max.y - 0.5f));
+
+	if (min_x > max_x || min_y > max_y) {
+		return;
+	}
+
+	const real_t area = (triangle.vertices[1] - triangle.vertices[0]).cross(triangle.vertices[2] - triangle.vertices[0]);
+	if (Math::is_zero_approx(area)) {
+		return;
+	}
+
+	if (area < 0) {
+		// Occluders are double sided, make the winding consistent for the edge tests.
+		SWAP(triangle.vertices[1], triangle.vertices[2]);
+		SWAP(triangle.depths[1], triangle.depths[2]);
+	}
+
+	triangle.rect = Rect2i(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+
+	const uint32_t triangle_index = triangles.size();
+	triangles.push_back(triangle);
+
+	for (int y = min_y / TILE_SIZE; y <= max_y / TILE_SIZE; y++) {
+		for (int x = min_x / TILE_SIZE; x <= max_x / TILE_SIZE; x++) {
+			tile_triangles[y * tile_grid_size.x + x].push_back(triangle_index);
+		}
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::_raster_tile(uint32_t p_tile, const Size2i *p_size) {
+	const int tile_x = (p_tile % tile_grid_size.x) * TILE_SIZE;
+	const int tile_y = (p_tile / tile_grid_size.x) * TILE_SIZE;
+	const int tile_w = MIN((int)TILE_SIZE, p_size->x - tile_x);
+	const int tile_h = MIN((int)TILE_SIZE, p_size->y - tile_y);
+
+	float depth[TILE_SIZE * TILE_SIZE];
+	for (int i = 0; i < TILE_SIZE * TILE_SIZE; i++) {
+		depth[i] = clear_depth;
+	}
+
+	const Vector2 tile_origin(tile_x, tile_y);
+
+	for (const uint32_t triangle_index : tile_triangles[p_tile]) {
+		const Triangle &triangle = triangles[triangle_index];
+
+		// Work relative to the tile to keep precision.
+		const Vector2 v0 = triangle.vertices[0] - tile_origin;
+		const Vector2 v1 = triangle.vertices[1] - tile_origin;
+		const Vector2 v2 = triangle.vertices[2] - tile_origin;
+
+		// Edge functions as e(x, y) = a * x + b * y + c, positive inside.
+		const float e0_a = v1.y - v2.y, e0_b = v2.x - v1.x, e0_c = v1.x * v2.y - v1.y * v2.x;
+		const float e1_a = v2.y - v0.y, e1_b = v0.x - v2.x, e1_c = v2.x * v0.y - v2.y * v0.x;
+		const float e2_a = v0.y - v1.y, e2_b = v1.x - v0.x, e2_c = v0.x * v1.y - v0.y * v1.x;
+		const float inv_area = 1.0f / (e0_c + e1_c + e2_c);
+
+		// The depth attribute is a plane in screen space too.
+		const float d_a = (e0_a * triangle.depths[0] + e1_a * triangle.depths[1] + e2_a * triangle.depths[2]) * inv_area;
+		const float d_b = (e0_b * triangle.depths[0] + e1_b * triangle.depths[1] + e2_b * triangle.depths[2]) * inv_area;
+		const float d_c = (e0_c * triangle.depths[0] + e1_c * triangle.depths[1] + e2_c * triangle.depths[2]) * inv_area;
+
+		const int min_x = MAX(triangle.rect.position.x - tile_x, 0) & ~(LANE_COUNT - 1);
+		const int min_y = MAX(triangle.rect.position.y - tile_y, 0);
+		const int max_x = MIN(triangle.rect.get_end().x - tile_x, tile_w);
+		const int max_y = MIN(triangle.rect.get_end().y - tile_y, tile_h);
+
+		for (int y = min_y; y < max_y; y++) {
+			float *row = &depth[y * TILE_SIZE];
+			const float py = y + 0.5f;
+
+			for (int x = min_x; x < max_x; x += LANE_COUNT) {
+				// Masked lanes, branchless so it can be vectorized.
+				for (int lane = 0; lane < LANE_COUNT; lane++) {
+					const float px = x + lane + 0.5f;
+					const float e0 = e0_a * px + e0_b * py + e0_c;
+					const float e1 = e1_a * px + e1_b * py + e1_c;
+					const float e2 = e2_a * px + e2_b * py + e2_c;
+					const float attribute = d_a * px + d_b * py + d_c;
+					const float d = cam_orthogonal ? attribute : 1.0f / attribute;
+					const bool covered = (e0 >= 0.0f) & (e1 >= 0.0f) & (e2 >= 0.0f) & (d < row[x + lane]);
+					row[x + lane] = covered ? d : row[x + lane];
+				}
+			}
+		}
+	}
+
+	float *dst = mips[0];
+	for (int y = 0; y < tile_h; y++) {
+		memcpy(&dst[(tile_y + y) * p_size->x + tile_x], &depth[y * TILE_SIZE], tile_w * sizeof(float));
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::rasterize() {
+	if (is_empty()) {
+		return;
+	}
+
+	const Size2i size = sizes[0];
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RasterHZBuffer::_raster_tile, &size, tile_triangles.size(), -1, true, SNAME("RasterOcclusionCullRasterize"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	update_mips();
+}
+
+////////////////////////////////////////////////////////
+
+bool RasterOcclusionCull::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RasterOcclusionCull::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RasterOcclusionCull::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RasterOcclusionCull::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	for (const InstanceID &E : occluder->users) {
+		Scenario *scenario = scenarios.getptr(E.scenario);
+		ERR_CONTINUE(!scenario);
+		ERR_CONTINUE(!scenario->instances.has(E.instance));
+
+		if (!scenario->dirty_instances.has(E.instance)) {
+			scenario->dirty_instances.insert(E.instance);
+			scenario->dirty_instances_array.push_back(E.instance);
+		}
+	}
+}
+
+void RasterOcclusionCull::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_scenario(RID p_scenario) {
+	ERR_FAIL_COND(scenarios.has(p_scenario));
+	scenarios[p_scenario] = Scenario();
+}
+
+void RasterOcclusionCull::remove_scenario(RID p_scenario) {
+	ERR_FAIL_COND(!scenarios.has(p_scenario));
+	scenarios.erase(p_scenario);
+}
+
+void RasterOcclusionCull::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	if (!scenario->instances.has(p_instance)) {
+		scenario->instances[p_instance] = OccluderInstance();
+	}
+
+	OccluderInstance &instance = scenario->instances[p_instance];
+
+	bool changed = false;
+
+	if (instance.removed) {
+		instance.removed = false;
+		scenario->removed_instances.erase(p_instance);
+		changed = true; // It was removed and re-added, we might have missed some changes
+	}
+
+	if (instance.occluder != p_occluder) {
+		Occluder *old_occluder = occluder_owner.get_or_null(instance.occluder);
+		if (old_occluder) {
+			old_occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		instance.occluder = p_occluder;
+
+		if (p_occluder.is_valid()) {
+			Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+			ERR_FAIL_NULL(occluder);
+			occluder->users.insert(InstanceID(p_scenario, p_instance));
+		}
+		changed = true;
+	}
+
+	if (instance.xform != p_xform) {
+		instance.xform = p_xform;
+		changed = true;
+	}
+
+	instance.enabled = p_enabled;
+
+	if (changed && !scenario->dirty_instances.has(p_instance)) {
+		scenario->dirty_instances.insert(p_instance);
+		scenario->dirty_instances_array.push_back(p_instance);
+	}
+}
+
+void RasterOcclusionCull::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	OccluderInstance *instance = scenario->instances.getptr(p_instance);
+	if (instance && !instance->removed) {
+		Occluder *occluder = occluder_owner.get_or_null(instance->occluder);
+		if (occluder) {
+			occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		scenario->removed_instances.push_back(p_instance);
+		instance->removed = true;
+	}
+}
+
+void RasterOcclusionCull::Scenario::_update_dirty_instance(uint32_t p_idx, RID *p_instances) {
+	OccluderInstance *occ_inst = instances.getptr(p_instances[p_idx]);
+
+	if (!occ_inst) {
+		return;
+	}
+
+	Occluder *occ = raster_singleton->occluder_owner.get_or_null(occ_inst->occluder);
+
+	if (!occ) {
+		return;
+	}
+
+	const int vertex_count = occ->vertices.size();
+	const Vector3 *read_ptr = occ->vertices.ptr();
+
+	occ_inst->xformed_vertices.resize(vertex_count);
+	for (int i = 0; i < vertex_count; i++) {
+		occ_inst->xformed_vertices[i] = occ_inst->xform.xform(read_ptr[i]);
+		if (i == 0) {
+			occ_inst->aabb = AABB(occ_inst->xformed_vertices[i], Vector3());
+		} else {
+			occ_inst->aabb.expand_to(occ_inst->xformed_vertices[i]);
+		}
+	}
+
+	occ_inst->indices.resize(occ->indices.size());
+	memcpy(occ_inst->indices.ptr(), occ->indices.ptr(), occ->indices.size() * sizeof(int32_t));
+}
+
+void RasterOcclusionCull::Scenario::update() {
+	for (const RID &instance : removed_instances) {
+		instances.erase(instance);
+	}
+	removed_instances.clear();
+
+	if (dirty_instances_array.is_empty()) {
+		return;
+	}
+
+	if (dirty_instances_array.size() / WorkerThreadPool::get_singleton()->get_thread_count() > 128) {
+		// Lots of instances, use per-instance threading
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &Scenario::_update_dirty_instance, dirty_instances_array.ptr(), dirty_instances_array.size(), -1, true, SNAME("RasterOcclusionCullUpdate"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < dirty_instances_array.size(); i++) {
+			_update_dirty_instance(i, dirty_instances_array.ptr());
+		}
+	}
+
+	dirty_instances.clear();
+	dirty_instances_array.clear();
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RasterOcclusionCull::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+void RasterOcclusionCull::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RasterOcclusionCull::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RasterOcclusionCull::buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	RasterHZBuffer *buffer = buffers.getptr(p_buffer);
+	if (!buffer) {
+		return;
+	}
+
+	Scenario *scenario = scenarios.getptr(buffer->scenario_rid);
+	if (buffer->is_empty() || !scenario) {
+		return;
+	}
+
+	scenario->update();
+
+	Projection jittered_proj = _jitter_projection(p_cam_projection, buffer->get_occlusion_buffer_size());
+	buffer->begin(p_cam_transform, jittered_proj, p_cam_orthogonal);
+
+	const Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+
+	for (const KeyValue<RID, OccluderInstance> &E : scenario->instances) {
+		const OccluderInstance &occ_inst = E.value;
+		if (!occ_inst.enabled || occ_inst.xformed_vertices.is_empty() || !occluder_owner.owns(occ_inst.occluder)) {
+			continue;
+		}
+
+		bool inside = true;
+		for (const Plane &plane : planes) {
+			const Vector3 &min = occ_inst.aabb.position;
+			const Vector3 max = occ_inst.aabb.get_end();
+			const Vector3 inner_corner((plane.normal.x > 0) ? min.x : max.x, (plane.normal.y > 0) ? min.y : max.y, (plane.normal.z > 0) ? min.z : max.z);
+			if (plane.is_point_over(inner_corner)) {
+				inside = false;
+				break;
+			}
+		}
+
+		if (inside) {
+			buffer->add_occluder(occ_inst.xformed_vertices, occ_inst.indices);
+		}
+	}
+
+	buffer->rasterize();
+}
+
+RasterOcclusionCull::HZBuffer *RasterOcclusionCull::buffer_get_ptr(RID p_buffer) {
+	return buffers.getptr(p_buffer);
+}
+
+RID RasterOcclusionCull::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
+
+RasterOcclusionCull::RasterOcclusionCull() {
+	raster_singleton = this;
+}
+
+RasterOcclusionCull::~RasterOcclusionCull() {
+	raster_singleton = nullptr;
+}
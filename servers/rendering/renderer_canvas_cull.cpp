@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/math/geometry_2d.h"
 #include "core/math/transform_interpolator.h"
+#include "core/object/worker_thread_pool.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -44,14 +45,132 @@
 // while not making lines appear too soft.
 const static float FEATHER_SIZE = 1.25f;
 
+void RendererCanvasCull::_cull_canvas_job(const CullJob &p_job, const Rect2 &p_clip_rect, uint32_t p_canvas_cull_mask, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, CullOutput *r_output) {
+	if (p_job.attach) {
+		_attach_canvas_item_for_draw(p_job.item, p_job.canvas_clip, r_z_list, r_z_last_list, p_job.xform, p_clip_rect, p_job.global_rect, p_job.modulate, p_job.z, p_job.material_owner, false, nullptr, r_output);
+	} else {
+		_cull_canvas_item(p_job.item, p_job.xform, p_clip_rect, p_job.modulate, p_job.z, r_z_list, r_z_last_list, p_job.canvas_clip, p_job.material_owner, true, p_canvas_cull_mask, Point2(), 1, nullptr, r_output);
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_batch(uint32_t p_batch, CullBatchData *p_data) {
+	CullBatch &batch = cull_batches[p_batch];
+	CullThreadLists &lists = cull_thread_lists[WorkerThreadPool::get_thread_index() + 1];
+
+	for (uint32_t i = 0; i < batch.job_count; i++) {
+		_cull_canvas_job(cull_jobs[batch.first_job + i], p_data->clip_rect, p_data->canvas_cull_mask, lists.z_list, lists.z_last_list, &batch.output);
+	}
+
+	// Keep the non-empty lists, and leave the thread's lists empty for its next batch.
+	batch.z_lists.clear();
+	for (int i = 0; i < z_range; i++) {
+		if (lists.z_list[i]) {
+			CullBatch::ZList batch_z_list;
+			batch_z_list.zidx = i;
+			batch_z_list.first = lists.z_list[i];
+			batch_z_list.last = lists.z_last_list[i];
+			batch.z_lists.push_back(batch_z_list);
+
+			lists.z_list[i] = nullptr;
+			lists.z_last_list[i] = nullptr;
+		}
+	}
+}
+
+void RendererCanvasCull::_apply_cull_output(CullOutput &r_output) {
+	for (Item::VisibilityNotifierData *visibility_notifier : r_output.visible_notifiers) {
+		if (!visibility_notifier->visible_element.in_list()) {
+			visibility_notifier_list.add(&visibility_notifier->visible_element);
+			visibility_notifier->just_visible = true;
+		}
+	}
+	r_output.visible_notifiers.clear();
+
+	if (r_output.redraw_requested) {
+		RenderingServerDefault::redraw_request();
+		r_output.redraw_requested = false;
+	}
+}
+
 void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info) {
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
+	cull_jobs.clear();
 	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, p_canvas_cull_mask, Point2(), 1, nullptr);
+		CullJob job;
+		job.item = p_child_items[i].item;
+		job.xform = p_transform;
+		job.modulate = Color(1, 1, 1, 1);
+		cull_jobs.push_back(job);
+	}
+
+	const uint32_t thread_count = WorkerThreadPool::get_singleton()->get_thread_count();
+	if (thread_count > 1) {
+		// Split the top of the tree until there are enough subtrees to keep all threads busy.
+		for (uint32_t depth = 0; depth < CULL_MAX_EXPAND_DEPTH && cull_jobs.size() < thread_count * CULL_JOBS_PER_THREAD; depth++) {
+			bool expanded = false;
+			cull_jobs_expanded.clear();
+			for (const CullJob &job : cull_jobs) {
+				Item *ci = job.item;
+				if (job.attach || ci->sort_y || ci->canvas_group || ci->repeat_source || ci->child_items.is_empty()) {
+					cull_jobs_expanded.push_back(job);
+					continue;
+				}
+				_cull_canvas_item(ci, job.xform, p_clip_rect, job.modulate, job.z, z_list, z_last_list, job.canvas_clip, job.material_owner, true, p_canvas_cull_mask, Point2(), 1, nullptr, &cull_output, &cull_jobs_expanded);
+				expanded = true;
+			}
+			SWAP(cull_jobs, cull_jobs_expanded);
+			if (!expanded) {
+				break;
+			}
+		}
+	}
+
+	if (thread_count > 1 && cull_jobs.size() >= threaded_cull_minimum_jobs) {
+		if (cull_thread_lists.is_empty()) {
+			cull_thread_lists.resize(thread_count + 1);
+			for (CullThreadLists &lists : cull_thread_lists) {
+				lists.z_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+				lists.z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+				memset(lists.z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+				memset(lists.z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+			}
+		}
+
+		const uint32_t batch_count = MIN(cull_jobs.size(), thread_count * CULL_BATCHES_PER_THREAD);
+		cull_batches.resize(batch_count);
+		for (uint32_t i = 0; i < batch_count; i++) {
+			cull_batches[i].first_job = cull_jobs.size() * i / batch_count;
+			cull_batches[i].job_count = cull_jobs.size() * (i + 1) / batch_count - cull_batches[i].first_job;
+		}
+
+		CullBatchData batch_data;
+		batch_data.clip_rect = p_clip_rect;
+		batch_data.canvas_cull_mask = p_canvas_cull_mask;
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererCanvasCull::_cull_canvas_batch, &batch_data, batch_count, -1, true, SNAME("RenderCullCanvasItems"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		// Chain the Z lists of the batches in job order.
+		for (CullBatch &batch : cull_batches) {
+			for (const CullBatch::ZList &batch_z_list : batch.z_lists) {
+				if (z_last_list[batch_z_list.zidx]) {
+					z_last_list[batch_z_list.zidx]->next = batch_z_list.first;
+				} else {
+					z_list[batch_z_list.zidx] = batch_z_list.first;
+				}
+				z_last_list[batch_z_list.zidx] = batch_z_list.last;
+			}
+			_apply_cull_output(batch.output);
+		}
+	} else {
+		for (const CullJob &job : cull_jobs) {
+			_cull_canvas_job(job, p_clip_rect, p_canvas_cull_mask, z_list, z_last_list, &cull_output);
+		}
+		_apply_cull_output(cull_output);
 	}
 
 	RendererCanvasRender::Item *list = nullptr;
@@ -124,7 +243,7 @@ void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner, RID_Owner<Renderer
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
-void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *ci, RendererCanvasCull::Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &p_modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from) {
+void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *ci, RendererCanvasCull::Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &p_modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from, CullOutput *r_output) {
 	if (ci->copy_back_buffer) {
 		ci->copy_back_buffer->screen_rect = p_transform.xform(ci->copy_back_buffer->rect).intersection(p_clip_rect);
 	}
@@ -196,7 +315,7 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 		//something to draw?
 
 		if (ci->update_when_visible) {
-			RenderingServerDefault::redraw_request();
+			r_output->redraw_requested = true;
 		}
 
 		if (ci->commands != nullptr || ci->copy_back_buffer) {
@@ -224,8 +343,7 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 
 		if (ci->visibility_notifier) {
 			if (!ci->visibility_notifier->visible_element.in_list()) {
-				visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
-				ci->visibility_notifier->just_visible = true;
+				r_output->visible_notifiers.push_back(ci->visibility_notifier);
 			}
 
 			ci->visibility_notifier->visible_in_frame = RSG::rasterizer->get_frame_number();
@@ -236,7 +354,180 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 	}
 }
 
-void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item) {
+static bool _is_spatially_indexable(const RendererCanvasCull::Item *p_item) {
+	// Only leaves whose drawing is fully described by their rect can be skipped by the index.
+	if (!p_item->child_items.is_empty() || p_item->canvas_group || p_item->copy_back_buffer || p_item->vp_render || p_item->repeat_source) {
+		return false;
+	}
+
+	const RendererCanvasCull::Item::Command *c = p_item->commands;
+	while (c) {
+		// Rects of these come from storage and can change without the canvas item knowing.
+		if (c->type == RendererCanvasCull::Item::Command::TYPE_MESH || c->type == RendererCanvasCull::Item::Command::TYPE_MULTIMESH || c->type == RendererCanvasCull::Item::Command::TYPE_PARTICLES) {
+			return false;
+		}
+		c = c->next;
+	}
+
+	return true;
+}
+
+void RendererCanvasCull::_spatial_index_add_item(Item *p_owner, Item *p_item) {
+	DEV_ASSERT(p_item->spatial_index_owner == nullptr);
+	p_item->spatial_index_owner = p_owner;
+	_mark_spatial_index_dirty(p_item);
+}
+
+void RendererCanvasCull::_spatial_index_remove_item(Item *p_item) {
+	Item *owner = p_item->spatial_index_owner;
+	if (!owner) {
+		return;
+	}
+	Item::SpatialIndex *spatial_index = owner->spatial_index;
+
+	if (p_item->spatial_index_id.is_valid()) {
+		spatial_index->bvh.remove(p_item->spatial_index_id);
+		p_item->spatial_index_id = DynamicBVH::ID();
+	}
+
+	if (p_item->spatial_index_dirty_slot != -1) {
+		Item *moved = spatial_index->dirty_items[spatial_index->dirty_items.size() - 1];
+		moved->spatial_index_dirty_slot = p_item->spatial_index_dirty_slot;
+		spatial_index->dirty_items.remove_at_unordered(p_item->spatial_index_dirty_slot);
+		p_item->spatial_index_dirty_slot = -1;
+	}
+
+	if (p_item->spatial_index_unindexed_slot != -1) {
+		Item *moved = spatial_index->unindexed_items[spatial_index->unindexed_items.size() - 1];
+		moved->spatial_index_unindexed_slot = p_item->spatial_index_unindexed_slot;
+		spatial_index->unindexed_items.remove_at_unordered(p_item->spatial_index_unindexed_slot);
+		p_item->spatial_index_unindexed_slot = -1;
+	}
+
+	p_item->spatial_index_owner = nullptr;
+}
+
+void RendererCanvasCull::_spatial_index_release(Item *p_owner) {
+	if (!p_owner->spatial_index) {
+		return;
+	}
+
+	for (Item *child : p_owner->child_items) {
+		if (child->spatial_index_owner == p_owner) {
+			child->spatial_index_owner = nullptr;
+			child->spatial_index_id = DynamicBVH::ID();
+			child->spatial_index_dirty_slot = -1;
+			child->spatial_index_unindexed_slot = -1;
+		}
+	}
+
+	memdelete(p_owner->spatial_index);
+	p_owner->spatial_index = nullptr;
+}
+
+void RendererCanvasCull::_spatial_index_update(Item *p_owner) {
+	Item::SpatialIndex *spatial_index = p_owner->spatial_index;
+
+	for (Item *item : spatial_index->dirty_items) {
+		item->spatial_index_dirty_slot = -1;
+
+		if (!_is_spatially_indexable(item)) {
+			if (item->spatial_index_id.is_valid()) {
+				spatial_index->bvh.remove(item->spatial_index_id);
+				item->spatial_index_id = DynamicBVH::ID();
+			}
+			if (item->spatial_index_unindexed_slot == -1) {
+				item->spatial_index_unindexed_slot = spatial_index->unindexed_items.size();
+				spatial_index->unindexed_items.push_back(item);
+			}
+			continue;
+		}
+
+		if (item->spatial_index_unindexed_slot != -1) {
+			Item *moved = spatial_index->unindexed_items[spatial_index->unindexed_items.size() - 1];
+			moved->spatial_index_unindexed_slot = item->spatial_index_unindexed_slot;
+			spatial_index->unindexed_items.remove_at_unordered(item->spatial_index_unindexed_slot);
+			item->spatial_index_unindexed_slot = -1;
+		}
+
+		Rect2 rect = item->get_rect();
+		if (item->visibility_notifier && item->visibility_notifier->area.size != Vector2()) {
+			rect = rect.merge(item->visibility_notifier->area);
+		}
+
+		Rect2 bounds = item->xform_curr.xform(rect);
+		if (item->interpolated) {
+			// Cover the whole interpolated motion, the previous transform is only reset on ticks.
+			const Transform2D &prev = item->xform_prev;
+			const Transform2D &curr = item->xform_curr;
+			bounds = bounds.merge(prev.xform(rect));
+
+			if (prev.columns[0] != curr.columns[0] || prev.columns[1] != curr.columns[1]) {
+				// Rotation is interpolated too, so the rect can stick out of both ends in between.
+				// Column lengths (scale) are interpolated linearly, which bounds the rect's reach
+				// from the origin, and the origin moves along a straight line.
+				const real_t scale_x = MAX(prev.columns[0].length(), curr.columns[0].length());
+				const real_t scale_y = MAX(prev.columns[1].length(), curr.columns[1].length());
+				const Vector2 end = rect.get_end();
+				const real_t reach = MAX(Math::abs(rect.position.x), Math::abs(end.x)) * scale_x + MAX(Math::abs(rect.position.y), Math::abs(end.y)) * scale_y;
+
+				Rect2 motion(prev.get_origin(), Size2());
+				motion.expand_to(curr.get_origin());
+				bounds = bounds.merge(motion.grow(reach));
+			}
+		}
+
+		AABB aabb(Vector3(bounds.position.x, bounds.position.y, 0), Vector3(bounds.size.x, bounds.size.y, 0));
+		if (item->spatial_index_id.is_valid()) {
+			spatial_index->bvh.update(item->spatial_index_id, aabb);
+		} else {
+			item->spatial_index_id = spatial_index->bvh.insert(aabb, item);
+		}
+	}
+
+	spatial_index->dirty_items.clear();
+	spatial_index->bvh.update_wide_nodes();
+}
+
+void RendererCanvasCull::_spatial_index_cull(Item *p_owner, const Transform2D &p_xform, const Rect2 &p_clip_rect) {
+	Item::SpatialIndex *spatial_index = p_owner->spatial_index;
+	LocalVector<Item *> &cull_result = spatial_index->cull_result;
+
+	cull_result.clear();
+	_spatial_index_update(p_owner);
+
+	if (p_xform.determinant() == 0) {
+		for (Item *child : p_owner->child_items) {
+			cull_result.push_back(child);
+		}
+		return;
+	}
+
+	// Children are indexed in the owner's space, so bring the clip rect there.
+	// Grow it on both sides to account for transform snapping.
+	Rect2 local_clip = p_xform.affine_inverse().xform(Rect2(Point2(), p_clip_rect.size).grow(1.0)).grow(1.0);
+
+	struct CullResult {
+		LocalVector<Item *> *result = nullptr;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			result->push_back((Item *)p_data);
+			return false;
+		}
+	};
+
+	CullResult cull;
+	cull.result = &cull_result;
+	spatial_index->bvh.aabb_query(AABB(Vector3(local_clip.position.x, local_clip.position.y, 0), Vector3(local_clip.size.x, local_clip.size.y, 0)), cull);
+
+	for (Item *item : spatial_index->unindexed_items) {
+		cull_result.push_back(item);
+	}
+
+	// Restore the draw order of the children.
+	cull_result.sort_custom<ItemSpatialIndexOrderSort>();
+}
+
+void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item, CullOutput *r_output, LocalVector<CullJob> *r_jobs) {
 	Item *ci = p_canvas_item;
 
 	if (!ci->visible) {
@@ -250,9 +541,21 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 	if (ci->children_order_dirty) {
 		ci->child_items.sort_custom<ItemIndexSort>();
 		ci->children_order_dirty = false;
+
+		if (ci->spatial_index) {
+			for (int i = 0; i < ci->child_items.size(); i++) {
+				ci->child_items[i]->spatial_index_order = i;
+			}
+		}
 	}
 
-	Rect2 rect = ci->get_rect();
+	Rect2 rect;
+	if (ci->is_rect_cached()) {
+		rect = ci->get_rect();
+	} else {
+		MutexLock lock(rect_mutex);
+		rect = ci->get_rect();
+	}
 
 	if (ci->visibility_notifier) {
 		if (ci->visibility_notifier->area.size != Vector2()) {
@@ -377,7 +680,7 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			sorter.sort(child_items, child_item_count);
 
 			for (i = 0; i < child_item_count; i++) {
-				_cull_canvas_item(child_items[i], final_xform * child_items[i]->ysort_xform, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false, p_canvas_cull_mask, child_items[i]->repeat_size, child_items[i]->repeat_times, child_items[i]->repeat_source_item);
+				_cull_canvas_item(child_items[i], final_xform * child_items[i]->ysort_xform, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false, p_canvas_cull_mask, child_items[i]->repeat_size, child_items[i]->repeat_times, child_items[i]->repeat_source_item, r_output);
 			}
 		} else {
 			RendererCanvasRender::Item *canvas_group_from = nullptr;
@@ -387,7 +690,7 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 				canvas_group_from = r_z_last_list[zidx];
 			}
 
-			_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, final_xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from);
+			_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, final_xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from, r_output);
 		}
 	} else {
 		RendererCanvasRender::Item *canvas_group_from = nullptr;
@@ -397,18 +700,59 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			canvas_group_from = r_z_last_list[zidx];
 		}
 
+		if (ci->spatial_index && !use_canvas_group && !(repeat_source_item && (repeat_size.x || repeat_size.y))) {
+			_spatial_index_cull(ci, final_xform, p_clip_rect);
+			child_item_count = ci->spatial_index->cull_result.size();
+			child_items = ci->spatial_index->cull_result.ptr();
+		}
+
+		if (r_jobs) {
+			// Defer the children and the item itself, in the same order they would be processed below.
+			DEV_ASSERT(!use_canvas_group && !repeat_source_item);
+
+			CullJob job;
+			job.modulate = modulate;
+			job.z = p_z;
+			job.material_owner = p_material_owner;
+
+			job.xform = final_xform;
+			job.canvas_clip = (Item *)ci->final_clip_owner;
+			for (int i = 0; i < child_item_count; i++) {
+				if (child_items[i]->behind) {
+					job.item = child_items[i];
+					r_jobs->push_back(job);
+				}
+			}
+
+			job.item = ci;
+			job.attach = true;
+			job.global_rect = global_rect;
+			job.canvas_clip = p_canvas_clip;
+			r_jobs->push_back(job);
+
+			job.attach = false;
+			job.canvas_clip = (Item *)ci->final_clip_owner;
+			for (int i = 0; i < child_item_count; i++) {
+				if (!child_items[i]->behind) {
+					job.item = child_items[i];
+					r_jobs->push_back(job);
+				}
+			}
+			return;
+		}
+
 		for (int i = 0; i < child_item_count; i++) {
 			if (!child_items[i]->behind && !use_canvas_group) {
 				continue;
 			}
-			_cull_canvas_item(child_items[i], final_xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, p_canvas_cull_mask, repeat_size, repeat_times, repeat_source_item);
+			_cull_canvas_item(child_items[i], final_xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, p_canvas_cull_mask, repeat_size, repeat_times, repeat_source_item, r_output);
 		}
-		_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, final_xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from);
+		_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, final_xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from, r_output);
 		for (int i = 0; i < child_item_count; i++) {
 			if (child_items[i]->behind || use_canvas_group) {
 				continue;
 			}
-			_cull_canvas_item(child_items[i], final_xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, p_canvas_cull_mask, repeat_size, repeat_times, repeat_source_item);
+			_cull_canvas_item(child_items[i], final_xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, p_canvas_cull_mask, repeat_size, repeat_times, repeat_source_item, r_output);
 		}
 	}
 }
@@ -469,6 +813,7 @@ void RendererCanvasCull::canvas_set_item_repeat(RID p_item, const Point2 &p_repe
 	canvas_item->repeat_source_item = is_repeat_source ? canvas_item : nullptr;
 	canvas_item->repeat_size = p_repeat_size;
 	canvas_item->repeat_times = p_repeat_times;
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_set_modulate(RID p_canvas, const Color &p_color) {
@@ -511,6 +856,9 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
 			}
+
+			_spatial_index_remove_item(canvas_item);
+			_mark_spatial_index_dirty(item_owner);
 		}
 
 		canvas_item->parent = RID();
@@ -532,6 +880,11 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
 			}
 
+			if (item_owner->spatial_index) {
+				_spatial_index_add_item(item_owner, canvas_item);
+			}
+			_mark_spatial_index_dirty(item_owner);
+
 		} else {
 			ERR_FAIL_MSG("Invalid parent.");
 		}
@@ -570,6 +923,7 @@ void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D
 	}
 
 	canvas_item->xform_curr = p_transform;
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_visibility_layer(RID p_item, uint32_t p_visibility_layer) {
@@ -606,6 +960,8 @@ void RendererCanvasCull::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
+
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_modulate(RID p_item, const Color &p_color) {
@@ -639,6 +995,7 @@ void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandPrimitive *line = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_NULL(line);
@@ -868,6 +1225,7 @@ void RendererCanvasCull::canvas_item_add_polyline(RID p_item, const Vector<Point
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Color color = Color(1, 1, 1, 1);
 
@@ -1138,6 +1496,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 		}
 		Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 		ERR_FAIL_NULL(canvas_item);
+		_mark_spatial_index_dirty(canvas_item);
 
 		Vector<Color> colors;
 		if (p_colors.size() == 1) {
@@ -1180,6 +1539,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1344,6 +1704,7 @@ void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	static const int circle_segments = 64;
 
@@ -1435,6 +1796,7 @@ void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1466,6 +1828,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 void RendererCanvasCull::canvas_item_add_msdf_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, int p_outline_size, float p_px_range, float p_scale) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1500,6 +1863,7 @@ void RendererCanvasCull::canvas_item_add_msdf_texture_rect_region(RID p_item, co
 void RendererCanvasCull::canvas_item_add_lcd_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1532,6 +1896,7 @@ void RendererCanvasCull::canvas_item_add_lcd_texture_rect_region(RID p_item, con
 void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, bool p_clip_uv) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1573,6 +1938,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const R
 void RendererCanvasCull::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, RS::NinePatchAxisMode p_x_axis_mode, RS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_NULL(style);
@@ -1597,6 +1963,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_NULL(prim);
@@ -1623,6 +1990,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 #ifdef DEBUG_ENABLED
 	int pointcount = p_points.size();
 	ERR_FAIL_COND(pointcount < 3);
@@ -1644,6 +2012,7 @@ void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2
 void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights, RID p_texture, int p_count) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	int vertex_count = p_points.size();
 	ERR_FAIL_COND(vertex_count == 0);
@@ -1665,6 +2034,7 @@ void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector
 void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_NULL(tr);
@@ -1674,6 +2044,7 @@ void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transfo
 void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform, const Color &p_modulate, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
 	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
@@ -1693,6 +2064,7 @@ void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, con
 void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_NULL(part);
@@ -1707,6 +2079,7 @@ void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles,
 void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_NULL(mm);
@@ -1718,6 +2091,7 @@ void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_NULL(ci);
@@ -1727,6 +2101,7 @@ void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 void RendererCanvasCull::canvas_item_add_animation_slice(RID p_item, double p_animation_length, double p_slice_begin, double p_slice_end, double p_offset) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_mark_spatial_index_dirty(canvas_item);
 
 	Item::CommandAnimationSlice *as = canvas_item->alloc_command<Item::CommandAnimationSlice>();
 	ERR_FAIL_NULL(as);
@@ -1745,6 +2120,25 @@ void RendererCanvasCull::canvas_item_set_sort_children_by_y(RID p_item, bool p_e
 	_mark_ysort_dirty(canvas_item, canvas_item_owner);
 }
 
+void RendererCanvasCull::canvas_item_set_use_spatial_index(RID p_item, bool p_enable) {
+	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
+	ERR_FAIL_NULL(canvas_item);
+
+	if (p_enable == (canvas_item->spatial_index != nullptr)) {
+		return;
+	}
+
+	if (p_enable) {
+		canvas_item->spatial_index = memnew(Item::SpatialIndex);
+		for (Item *child : canvas_item->child_items) {
+			_spatial_index_add_item(canvas_item, child);
+		}
+		canvas_item->children_order_dirty = true; // Assigns the draw order of the children.
+	} else {
+		_spatial_index_release(canvas_item);
+	}
+}
+
 void RendererCanvasCull::canvas_item_set_z_index(RID p_item, int p_z) {
 	ERR_FAIL_COND(p_z < RS::CANVAS_ITEM_Z_MIN || p_z > RS::CANVAS_ITEM_Z_MAX);
 
@@ -1805,6 +2199,8 @@ void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 		canvas_item->copy_back_buffer->rect = p_rect;
 		canvas_item->copy_back_buffer->full = p_rect == Rect2();
 	}
+
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_clear(RID p_item) {
@@ -1812,6 +2208,7 @@ void RendererCanvasCull::canvas_item_clear(RID p_item) {
 	ERR_FAIL_NULL(canvas_item);
 
 	canvas_item->clear();
+	_mark_spatial_index_dirty(canvas_item);
 #ifdef DEBUG_ENABLED
 	if (debug_redraw) {
 		canvas_item->debug_redraw_time = debug_redraw_time;
@@ -1870,6 +2267,8 @@ void RendererCanvasCull::canvas_item_set_visibility_notifier(RID p_item, bool p_
 			canvas_item->visibility_notifier = nullptr;
 		}
 	}
+
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_debug_redraw(bool p_enabled) {
@@ -1885,12 +2284,14 @@ void RendererCanvasCull::canvas_item_set_interpolated(RID p_item, bool p_interpo
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
 	canvas_item->interpolated = p_interpolated;
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_reset_physics_interpolation(RID p_item) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
 	canvas_item->xform_prev = canvas_item->xform_curr;
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 // Useful especially for origin shifting.
@@ -1899,6 +2300,7 @@ void RendererCanvasCull::canvas_item_transform_physics_interpolation(RID p_item,
 	ERR_FAIL_NULL(canvas_item);
 	canvas_item->xform_prev = p_transform * canvas_item->xform_prev;
 	canvas_item->xform_curr = p_transform * canvas_item->xform_curr;
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::CanvasGroupMode p_mode, float p_clear_margin, bool p_fit_empty, float p_fit_margin, bool p_blur_mipmaps) {
@@ -1920,6 +2322,8 @@ void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::Canva
 		canvas_item->canvas_group->blur_mipmaps = p_blur_mipmaps;
 		canvas_item->canvas_group->clear_margin = p_clear_margin;
 	}
+
+	_mark_spatial_index_dirty(canvas_item);
 }
 
 RID RendererCanvasCull::canvas_light_allocate() {
@@ -2425,9 +2829,14 @@ bool RendererCanvasCull::free(RID p_rid) {
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
 				}
+
+				_spatial_index_remove_item(canvas_item);
+				_mark_spatial_index_dirty(item_owner);
 			}
 		}
 
+		_spatial_index_release(canvas_item);
+
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 			canvas_item->child_items[i]->parent = RID();
 		}
@@ -2614,4 +3023,8 @@ RendererCanvasCull::RendererCanvasCull() {
 RendererCanvasCull::~RendererCanvasCull() {
 	memfree(z_list);
 	memfree(z_last_list);
+	for (CullThreadLists &lists : cull_thread_lists) {
+		memfree(lists.z_list);
+		memfree(lists.z_last_list);
+	}
 }
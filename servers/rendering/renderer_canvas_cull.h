@@ -31,6 +31,8 @@
 #ifndef RENDERER_CANVAS_CULL_H
 #define RENDERER_CANVAS_CULL_H
 
+#include "core/math/dynamic_bvh.h"
+#include "core/os/mutex.h"
 #include "core/templates/paged_allocator.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
@@ -72,6 +74,22 @@ public:
 
 		VisibilityNotifierData *visibility_notifier = nullptr;
 
+		// Optional index of the direct children by their rect in this item's space,
+		// so culling large flat subtrees only visits the children that are on screen.
+		struct SpatialIndex {
+			DynamicBVH bvh;
+			LocalVector<Item *> unindexed_items; // Children that can't be culled by rect and are always visited.
+			LocalVector<Item *> dirty_items;
+			LocalVector<Item *> cull_result;
+		};
+
+		SpatialIndex *spatial_index = nullptr;
+		Item *spatial_index_owner = nullptr; // Parent whose spatial index holds this item.
+		DynamicBVH::ID spatial_index_id;
+		int32_t spatial_index_dirty_slot = -1;
+		int32_t spatial_index_unindexed_slot = -1;
+		uint32_t spatial_index_order = 0; // Position in the parent's sorted children.
+
 		Item() {
 			children_order_dirty = true;
 			E = nullptr;
@@ -96,6 +114,12 @@ public:
 		}
 	};
 
+	struct ItemSpatialIndexOrderSort {
+		_FORCE_INLINE_ bool operator()(const Item *p_left, const Item *p_right) const {
+			return p_left->spatial_index_order < p_right->spatial_index_order;
+		}
+	};
+
 	struct ItemPtrSort {
 		_FORCE_INLINE_ bool operator()(const Item *p_left, const Item *p_right) const {
 			if (Math::is_equal_approx(p_left->ysort_pos.y, p_right->ysort_pos.y)) {
@@ -180,14 +204,90 @@ public:
 	double debug_redraw_time = 0;
 	Color debug_redraw_color;
 
+	// Trees that split into fewer jobs than this are culled on the calling thread.
+	uint32_t threaded_cull_minimum_jobs = 64;
+
 	PagedAllocator<Item::VisibilityNotifierData> visibility_notifier_allocator;
 	SelfList<Item::VisibilityNotifierData>::List visibility_notifier_list;
 
-	_FORCE_INLINE_ void _attach_canvas_item_for_draw(Item *ci, Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from);
+	// Side effects of culling on shared state, applied once culling is done
+	// so subtrees can be culled on several threads.
+	struct CullOutput {
+		LocalVector<Item::VisibilityNotifierData *> visible_notifiers;
+		bool redraw_requested = false;
+	};
+
+	_FORCE_INLINE_ void _attach_canvas_item_for_draw(Item *ci, Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from, CullOutput *r_output);
 
 private:
+	// The top of the canvas tree is expanded into an ordered list of jobs: subtrees
+	// to cull and items to draw. Contiguous ranges of jobs are culled on worker threads
+	// into their own Z lists, which are then chained in job order, so the result is
+	// the same as culling the whole tree recursively.
+	struct CullJob {
+		Item *item = nullptr;
+		bool attach = false; // Draw the item itself instead of culling its subtree.
+		Transform2D xform; // Parent transform, or the final transform when attaching.
+		Rect2 global_rect;
+		Color modulate;
+		int z = 0;
+		Item *canvas_clip = nullptr;
+		Item *material_owner = nullptr;
+	};
+
+	struct CullBatch {
+		uint32_t first_job = 0;
+		uint32_t job_count = 0;
+
+		struct ZList {
+			int zidx = 0;
+			RendererCanvasRender::Item *first = nullptr;
+			RendererCanvasRender::Item *last = nullptr;
+		};
+		LocalVector<ZList> z_lists;
+		CullOutput output;
+	};
+
+	struct CullBatchData {
+		Rect2 clip_rect;
+		uint32_t canvas_cull_mask = 0;
+	};
+
+	struct CullThreadLists {
+		RendererCanvasRender::Item **z_list = nullptr;
+		RendererCanvasRender::Item **z_last_list = nullptr;
+	};
+
+	static constexpr uint32_t CULL_JOBS_PER_THREAD = 16;
+	static constexpr uint32_t CULL_BATCHES_PER_THREAD = 4;
+	static constexpr uint32_t CULL_MAX_EXPAND_DEPTH = 4;
+
+	LocalVector<CullJob> cull_jobs;
+	LocalVector<CullJob> cull_jobs_expanded;
+	LocalVector<CullBatch> cull_batches;
+	LocalVector<CullThreadLists> cull_thread_lists; // One per worker thread, plus one for any other thread.
+	CullOutput cull_output;
+	BinaryMutex rect_mutex; // Item rects may come from storage, which isn't thread safe.
+
+	void _cull_canvas_job(const CullJob &p_job, const Rect2 &p_clip_rect, uint32_t p_canvas_cull_mask, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, CullOutput *r_output);
+	void _cull_canvas_batch(uint32_t p_batch, CullBatchData *p_data);
+	void _apply_cull_output(CullOutput &r_output);
+
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info = nullptr);
-	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item);
+	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item, CullOutput *r_output, LocalVector<CullJob> *r_jobs = nullptr);
+
+	_FORCE_INLINE_ void _mark_spatial_index_dirty(Item *p_item) {
+		if (p_item->spatial_index_owner && p_item->spatial_index_dirty_slot == -1) {
+			LocalVector<Item *> &dirty_items = p_item->spatial_index_owner->spatial_index->dirty_items;
+			p_item->spatial_index_dirty_slot = dirty_items.size();
+			dirty_items.push_back(p_item);
+		}
+	}
+	void _spatial_index_add_item(Item *p_owner, Item *p_item);
+	void _spatial_index_remove_item(Item *p_item);
+	void _spatial_index_release(Item *p_owner);
+	void _spatial_index_update(Item *p_owner);
+	void _spatial_index_cull(Item *p_owner, const Transform2D &p_xform, const Rect2 &p_clip_rect);
 
 	static constexpr int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
@@ -251,6 +351,7 @@ public:
 	void canvas_item_add_animation_slice(RID p_item, double p_animation_length, double p_slice_begin, double p_slice_end, double p_offset);
 
 	void canvas_item_set_sort_children_by_y(RID p_item, bool p_enable);
+	void canvas_item_set_use_spatial_index(RID p_item, bool p_enable);
 	void canvas_item_set_z_index(RID p_item, int p_z);
 	void canvas_item_set_z_as_relative_to_parent(RID p_item, bool p_enable);
 	void canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect);
@@ -34,7 +34,7 @@
 RendererCanvasRender *RendererCanvasRender::singleton = nullptr;
 
 const Rect2 &RendererCanvasRender::Item::get_rect() const {
-	if (custom_rect || (!rect_dirty && !update_when_visible && skeleton == RID())) {
+	if (is_rect_cached()) {
 		return rect;
 	}
 
@@ -368,6 +368,10 @@ public:
 
 		Rect2 global_rect_cache;
 
+		// When false, get_rect() recomputes the rect, which may read mesh and particles storage.
+		_FORCE_INLINE_ bool is_rect_cached() const {
+			return custom_rect || (!rect_dirty && !update_when_visible && skeleton == RID());
+		}
 		const Rect2 &get_rect() const;
 
 		Command *commands = nullptr;
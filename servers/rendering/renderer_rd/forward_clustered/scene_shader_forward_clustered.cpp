@@ -141,10 +141,11 @@ void SceneShaderForwardClustered::ShaderData::set_code(const String &p_code) {
 
 	actions.uniforms = &uniforms;
 
-	MutexLock lock(SceneShaderForwardClustered::singleton_mutex);
 	Error err = SceneShaderForwardClustered::singleton->compiler.compile(RS::SHADER_SPATIAL, code, &actions, path, gen_code);
 	ERR_FAIL_COND_MSG(err != OK, "Shader compilation failed.");
 
+	MutexLock lock(SceneShaderForwardClustered::singleton_mutex);
+
 	if (version.is_null()) {
 		version = SceneShaderForwardClustered::singleton->shader.version_create();
 	}
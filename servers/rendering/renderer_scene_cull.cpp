@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "raster_occlusion_cull.h"
 #include "rendering_light_culler.h"
 #include "rendering_server_constants.h"
 #include "rendering_server_default.h"
@@ -1237,6 +1238,36 @@ void RendererSceneCull::instance_set_ignore_culling(RID p_instance, bool p_enabl
 	}
 }
 
+void RendererSceneCull::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	for (int i = 0; i < p_instances.size(); i++) {
+		instance_set_transform(p_instances[i], p_transforms[i]);
+	}
+}
+
+void RendererSceneCull::instances_set_visible(const Vector<RID> &p_instances, bool p_visible) {
+	for (const RID &instance : p_instances) {
+		instance_set_visible(instance, p_visible);
+	}
+}
+
+void RendererSceneCull::instances_set_custom_aabbs(const Vector<RID> &p_instances, const Vector<AABB> &p_aabbs) {
+	ERR_FAIL_COND(p_instances.size() != p_aabbs.size());
+
+	for (int i = 0; i < p_instances.size(); i++) {
+		instance_set_custom_aabb(p_instances[i], p_aabbs[i]);
+	}
+}
+
+void RendererSceneCull::instances_geometry_set_shader_parameter(const Vector<RID> &p_instances, const StringName &p_parameter, const Vector<Variant> &p_values) {
+	ERR_FAIL_COND(p_instances.size() != p_values.size());
+
+	for (int i = 0; i < p_instances.size(); i++) {
+		instance_geometry_set_shader_parameter(p_instances[i], p_parameter, p_values[i]);
+	}
+}
+
 Vector<ObjectID> RendererSceneCull::instances_cull_aabb(const AABB &p_aabb, RID p_scenario) const {
 	Vector<ObjectID> instances;
 	Scenario *scenario = scenario_owner.get_or_null(p_scenario);
@@ -1698,6 +1729,21 @@ uint32_t RendererSceneCull::get_pipeline_compilations(RS::PipelineSource p_sourc
 	return scene_render->get_pipeline_compilations(p_source);
 }
 
+TypedArray<Dictionary> RendererSceneCull::get_shadow_cull_timings() const {
+	TypedArray<Dictionary> timings;
+	timings.resize(shadow_cull_timings.size());
+	for (uint32_t i = 0; i < shadow_cull_timings.size(); i++) {
+		const ShadowCullTiming &timing = shadow_cull_timings[i];
+		Dictionary d;
+		d["instance"] = timing.light;
+		d["pass"] = timing.pass;
+		d["instance_count"] = timing.instance_count;
+		d["cull_time"] = double(timing.cull_time_usec) / 1000.0;
+		timings[i] = d;
+	}
+	return timings;
+}
+
 void RendererSceneCull::instance_geometry_get_shader_parameter_list(RID p_instance, List<PropertyInfo> *p_parameters) const {
 	const Instance *instance = const_cast<RendererSceneCull *>(this)->instance_owner.get_or_null(p_instance);
 	ERR_FAIL_NULL(instance);
@@ -2466,13 +2512,14 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 	}
 }
 
-bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_screen_mesh_lod_threshold, uint32_t p_visible_layers) {
+bool RendererSceneCull::_light_instance_setup_shadow_views(Instance *p_instance, int32_t p_regular_light_id) {
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
 	Transform3D light_transform = p_instance->transform;
 	light_transform.orthonormalize(); //scale does not count on lights
 
-	bool animated_material_found = false;
+	// Tighter caster culling only applies when the shadow is not fully updated.
+	int32_t regular_light_id = light->is_shadow_update_full() ? -1 : p_regular_light_id;
 
 	switch (RSG::light_storage->light_get_type(p_instance->base)) {
 		case RS::LIGHT_DIRECTIONAL: {
@@ -2486,8 +2533,6 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 				}
 				for (int i = 0; i < 2; i++) {
 					//using this one ensures that raster deferred will have it
-					RENDER_TIMESTAMP("Cull OmniLight3D Shadow Paraboloid, Half " + itos(i));
-
 					real_t radius = RSG::light_storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
 
 					real_t z = i == 0 ? -1 : 1;
@@ -2500,49 +2545,14 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
 
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+					ShadowCullView &view = shadow_cull_views[max_shadows_used];
+					view.light = p_instance;
+					view.pass = i;
+					view.planes = planes;
+					view.regular_light_id = regular_light_id;
 
 					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
 
-					if (!light->is_shadow_update_full()) {
-						light_culler->cull_regular_light(instance_shadow_cull_result);
-					}
-
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-
-							if (instance->mesh_instance.is_valid()) {
-								RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
-
-						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
-
-					RSG::mesh_storage->update_mesh_instances();
-
 					RSG::light_storage->light_instance_set_shadow_transform(light->instance, Projection(), light_transform, radius, 0, i, 0);
 					shadow_data.light = light->instance;
 					shadow_data.pass = i;
@@ -2558,7 +2568,6 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 				cm.set_perspective(90, 1, radius * 0.005f, radius);
 
 				for (int i = 0; i < 6; i++) {
-					RENDER_TIMESTAMP("Cull OmniLight3D Shadow Cube, Side " + itos(i));
 					//using this one ensures that raster deferred will have it
 
 					static const Vector3 view_normals[6] = {
@@ -2580,49 +2589,14 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 					Transform3D xform = light_transform * Transform3D().looking_at(view_normals[i], view_up[i]);
 
-					Vector<Plane> planes = cm.get_projection_planes(xform);
-
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+					ShadowCullView &view = shadow_cull_views[max_shadows_used];
+					view.light = p_instance;
+					view.pass = i;
+					view.planes = cm.get_projection_planes(xform);
+					view.regular_light_id = regular_light_id;
 
 					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
 
-					if (!light->is_shadow_update_full()) {
-						light_culler->cull_regular_light(instance_shadow_cull_result);
-					}
-
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							if (instance->mesh_instance.is_valid()) {
-								RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
-
-						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
-
-					RSG::mesh_storage->update_mesh_instances();
 					RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i, 0);
 
 					shadow_data.light = light->instance;
@@ -2635,8 +2609,6 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 		} break;
 		case RS::LIGHT_SPOT: {
-			RENDER_TIMESTAMP("Cull SpotLight3D Shadow");
-
 			if (max_shadows_used + 1 > MAX_UPDATE_SHADOWS) {
 				return true;
 			}
@@ -2647,58 +2619,118 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 			Projection cm;
 			cm.set_perspective(angle * 2.0, 1.0, 0.005f * radius, radius);
 
-			Vector<Plane> planes = cm.get_projection_planes(light_transform);
+			ShadowCullView &view = shadow_cull_views[max_shadows_used];
+			view.light = p_instance;
+			view.pass = 0;
+			view.planes = cm.get_projection_planes(light_transform);
+			view.regular_light_id = regular_light_id;
 
-			instance_shadow_cull_result.clear();
+			RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
 
-			Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
+			RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
+			shadow_data.light = light->instance;
+			shadow_data.pass = 0;
 
-			struct CullConvex {
-				PagedArray<Instance *> *result;
-				_FORCE_INLINE_ bool operator()(void *p_data) {
-					Instance *p_instance = (Instance *)p_data;
-					result->push_back(p_instance);
-					return false;
-				}
-			};
+		} break;
+	}
 
-			CullConvex cull_convex;
-			cull_convex.result = &instance_shadow_cull_result;
+	return false;
+}
 
-			p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+void RendererSceneCull::_scene_cull_shadow_view(uint32_t p_index, ShadowCullData *p_cull_data) {
+	uint64_t time_usec = OS::get_singleton()->get_ticks_usec();
 
-			RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
+	const uint32_t shadow_index = p_cull_data->first_shadow + p_index;
+	ShadowCullView &view = shadow_cull_views[shadow_index];
+	RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[shadow_index];
 
-			if (!light->is_shadow_update_full()) {
-				light_culler->cull_regular_light(instance_shadow_cull_result);
-			}
+	view.cull_result.clear();
+	view.mesh_instances.clear();
+	view.animated_material_found = false;
 
-			for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_visible_layers & instance->layer_mask)) {
-					continue;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
+	Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(view.planes.ptr(), view.planes.size());
 
-					if (instance->mesh_instance.is_valid()) {
-						RSG::mesh_storage->mesh_instance_check_for_update(instance->mesh_instance);
-					}
-				}
-				shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
+	struct CullConvex {
+		PagedArray<Instance *> *result;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			Instance *p_instance = (Instance *)p_data;
+			result->push_back(p_instance);
+			return false;
+		}
+	};
+
+	CullConvex cull_convex;
+	cull_convex.result = &view.cull_result;
+
+	p_cull_data->scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(view.planes.ptr(), view.planes.size(), points.ptr(), points.size(), cull_convex);
+
+	light_culler->cull_stored_regular_light(view.cull_result, view.regular_light_id);
+
+	for (int j = 0; j < (int)view.cull_result.size(); j++) {
+		Instance *instance = view.cull_result[j];
+		if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows || !(p_cull_data->visible_layers & instance->layer_mask)) {
+			continue;
+		} else {
+			if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+				view.animated_material_found = true;
 			}
 
-			RSG::mesh_storage->update_mesh_instances();
+			if (instance->mesh_instance.is_valid()) {
+				// Checked for updates once all views are culled, the mesh storage isn't thread safe.
+				view.mesh_instances.push_back(instance->mesh_instance);
+			}
+		}
 
-			RSG::light_storage->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
-			shadow_data.light = light->instance;
-			shadow_data.pass = 0;
+		shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
+	}
 
-		} break;
+	view.cull_time_usec = OS::get_singleton()->get_ticks_usec() - time_usec;
+}
+
+void RendererSceneCull::_scene_cull_shadow_views(Scenario *p_scenario, uint32_t p_visible_layers, uint32_t p_first_shadow) {
+	if (max_shadows_used <= p_first_shadow) {
+		return;
+	}
+
+	RENDER_TIMESTAMP("Cull Light3D Shadows");
+
+	ShadowCullData cull_data;
+	cull_data.scenario = p_scenario;
+	cull_data.visible_layers = p_visible_layers;
+	cull_data.first_shadow = p_first_shadow;
+
+	const uint32_t view_count = max_shadows_used - p_first_shadow;
+	if (view_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_scene_cull_shadow_view, &cull_data, view_count, -1, true, SNAME("RenderCullShadows"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_scene_cull_shadow_view(0, &cull_data);
+	}
+
+	for (uint32_t i = p_first_shadow; i < max_shadows_used; i++) {
+		ShadowCullView &view = shadow_cull_views[i];
+
+		for (const RID &mesh_instance : view.mesh_instances) {
+			RSG::mesh_storage->mesh_instance_check_for_update(mesh_instance);
+		}
+
+		if (view.animated_material_found) {
+			static_cast<InstanceLightData *>(view.light->base_data)->make_shadow_dirty();
+		}
+
+		ShadowCullTiming timing;
+		timing.light = view.light->self;
+		timing.pass = view.pass;
+		timing.instance_count = render_shadow_data[i].instances.size();
+		timing.cull_time_usec = view.cull_time_usec;
+		shadow_cull_timings.push_back(timing);
+
+		view.light = nullptr;
+		view.planes.clear();
+		view.cull_result.clear();
 	}
 
-	return animated_material_found;
+	RSG::mesh_storage->update_mesh_instances();
 }
 
 void RendererSceneCull::render_camera(const Ref<RenderSceneBuffers> &p_render_buffers, RID p_camera, RID p_scenario, RID p_viewport, Size2 p_viewport_size, uint32_t p_jitter_phase_count, float p_screen_mesh_lod_threshold, RID p_shadow_atlas, Ref<XRInterface> &p_xr_interface, RenderInfo *r_render_info) {
@@ -2831,7 +2863,7 @@ void RendererSceneCull::_visibility_cull(const VisibilityCullData &cull_data, ui
 			}
 		}
 
-		int range_check = _visibility_range_check<true>(vd, cull_data.camera_position, cull_data.viewport_mask);
+		int range_check = _visibility_range_check<true>(vd, cull_data.camera_position.distance_to(vd.position), cull_data.viewport_mask);
 
 		if (range_check == -1) {
 			idata.flags |= InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN;
@@ -2854,8 +2886,8 @@ void RendererSceneCull::_visibility_cull(const VisibilityCullData &cull_data, ui
 }
 
 template <bool p_fade_check>
-int RendererSceneCull::_visibility_range_check(InstanceVisibilityData &r_vis_data, const Vector3 &p_camera_pos, uint64_t p_viewport_mask) {
-	float dist = p_camera_pos.distance_to(r_vis_data.position);
+int RendererSceneCull::_visibility_range_check(InstanceVisibilityData &r_vis_data, float p_distance, uint64_t p_viewport_mask) {
+	float dist = p_distance;
 	const RS::VisibilityRangeFadeMode &fade_mode = r_vis_data.fade_mode;
 
 	float begin_offset = -r_vis_data.range_begin_margin;
@@ -2911,6 +2943,51 @@ void RendererSceneCull::_scene_cull_threaded(uint32_t p_thread, CullData *cull_d
 	_scene_cull(*cull_data, scene_cull_result_threads[p_thread], cull_from, cull_to);
 }
 
+void RendererSceneCull::_scene_cull_block(const CullData &cull_data, uint64_t p_from, uint32_t p_count, uint8_t *r_in_view, float *r_distance) {
+	const Scenario *scenario = cull_data.scenario;
+	const Frustum &frustum = cull_data.cull->frustum;
+	const Vector3 &camera_position = cull_data.cam_transform.origin;
+
+	// Gather the block into structure-of-arrays form, so the passes below are
+	// branchless loops over lanes that the compiler can vectorize.
+	real_t bounds[6][CULL_BLOCK_SIZE];
+	uint32_t ranged[CULL_BLOCK_SIZE]; // Lanes of instances with a visibility range.
+	uint32_t ranged_count = 0;
+
+	for (uint32_t j = 0; j < p_count; j++) {
+		const InstanceData &idata = scenario->instance_data[p_from + j];
+		const InstanceBounds &instance_bounds = scenario->instance_aabbs[p_from + j];
+		for (uint32_t k = 0; k < 6; k++) {
+			bounds[k][j] = instance_bounds.bounds[k];
+		}
+
+		if (idata.visibility_index != -1) {
+			ranged[ranged_count++] = j;
+		}
+
+		r_in_view[j] = (cull_data.visible_layers & idata.layer_mask) != 0;
+	}
+
+	// Same test as InstanceBounds::in_frustum(). The plane signs don't depend on the instance, so each plane is one pass.
+	for (uint32_t i = 0; i < frustum.plane_count; i++) {
+		const Plane &plane = frustum.planes_ptr[i];
+		const real_t *min_x = bounds[frustum.plane_signs_ptr[i].signs[0]];
+		const real_t *min_y = bounds[frustum.plane_signs_ptr[i].signs[1]];
+		const real_t *min_z = bounds[frustum.plane_signs_ptr[i].signs[2]];
+
+		for (uint32_t j = 0; j < p_count; j++) {
+			r_in_view[j] &= !((plane.normal.x * min_x[j] + plane.normal.y * min_y[j] + plane.normal.z * min_z[j]) - plane.d >= 0.0);
+		}
+	}
+
+	// Camera distances for the visibility range checks. Most instances have no range, so only those that do pay for the square root.
+	for (uint32_t r = 0; r < ranged_count; r++) {
+		const uint32_t j = ranged[r];
+		const InstanceData &idata = scenario->instance_data[p_from + j];
+		r_distance[j] = camera_position.distance_to(scenario->instance_visibility[idata.visibility_index].position);
+	}
+}
+
 void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to) {
 	uint64_t frame_number = RSG::rasterizer->get_frame_number();
 	float lightmap_probe_update_speed = RSG::light_storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
@@ -2923,9 +3000,18 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 	Transform3D inv_cam_transform = cull_data.cam_transform.inverse();
 	float z_near = cull_data.camera_matrix->get_z_near();
 
+	// Layer mask, main frustum and camera distance are evaluated for a whole block up front.
+	uint8_t block_in_view[CULL_BLOCK_SIZE];
+	float block_distance[CULL_BLOCK_SIZE];
+
 	for (uint64_t i = p_from; i < p_to; i++) {
 		bool mesh_visible = false;
 
+		uint32_t block_index = (i - p_from) % CULL_BLOCK_SIZE;
+		if (block_index == 0) {
+			_scene_cull_block(cull_data, i, MIN(uint64_t(CULL_BLOCK_SIZE), p_to - i), block_in_view, block_distance);
+		}
+
 		InstanceData &idata = cull_data.scenario->instance_data[i];
 		uint32_t visibility_flags = idata.flags & (InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE | InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN | InstanceData::FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN);
 		int32_t visibility_check = -1;
@@ -2933,13 +3019,14 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 #define HIDDEN_BY_VISIBILITY_CHECKS (visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE || visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN)
 #define LAYER_CHECK (cull_data.visible_layers & idata.layer_mask)
 #define IN_FRUSTUM(f) (cull_data.scenario->instance_aabbs[i].in_frustum(f))
-#define VIS_RANGE_CHECK ((idata.visibility_index == -1) || _visibility_range_check<false>(cull_data.scenario->instance_visibility[idata.visibility_index], cull_data.cam_transform.origin, cull_data.visibility_viewport_mask) == 0)
+#define IN_VIEW (block_in_view[block_index])
+#define VIS_RANGE_CHECK ((idata.visibility_index == -1) || _visibility_range_check<false>(cull_data.scenario->instance_visibility[idata.visibility_index], block_distance[block_index], cull_data.visibility_viewport_mask) == 0)
 #define VIS_PARENT_CHECK (_visibility_parent_check(cull_data, idata))
 #define VIS_CHECK (visibility_check < 0 ? (visibility_check = (visibility_flags != InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK || (VIS_RANGE_CHECK && VIS_PARENT_CHECK))) : visibility_check)
 #define OCCLUSION_CULLED (cull_data.occlusion_buffer != nullptr && (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_OCCLUSION_CULLING) == 0 && cull_data.occlusion_buffer->is_occluded(cull_data.scenario->instance_aabbs[i].bounds, cull_data.cam_transform.origin, inv_cam_transform, *cull_data.camera_matrix, z_near, cull_data.scenario->instance_data[i].occlusion_timeout))
 
 		if (!HIDDEN_BY_VISIBILITY_CHECKS) {
-			if ((LAYER_CHECK && IN_FRUSTUM(cull_data.cull->frustum) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
+			if ((IN_VIEW && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
 				uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 				if (base_type == RS::INSTANCE_LIGHT) {
 					cull_result.lights.push_back(idata.instance);
@@ -3149,6 +3236,7 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 #undef HIDDEN_BY_VISIBILITY_CHECKS
 #undef LAYER_CHECK
 #undef IN_FRUSTUM
+#undef IN_VIEW
 #undef VIS_RANGE_CHECK
 #undef VIS_PARENT_CHECK
 #undef VIS_CHECK
@@ -3197,6 +3285,10 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 
 	scene_render->set_scene_pass(render_pass);
 
+	// Culling runs on the collapsed wide trees, which are only built here as the indexers are not modified during the cull.
+	scenario->indexers[Scenario::INDEXER_GEOMETRY].update_wide_nodes();
+	scenario->indexers[Scenario::INDEXER_VOLUMES].update_wide_nodes();
+
 	if (p_reflection_probe.is_null()) {
 		//no rendering code here, this is only to set up what needs to be done, request regions, etc.
 		scene_render->sdfgi_update(p_render_buffers, p_environment, camera_position); //update conditions for SDFGI (whether its used or not)
@@ -3382,6 +3474,9 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 		}
 
 		// Positional Shadows
+		// Views are set up serially (shadow atlas and light storage aren't thread safe), then culled in parallel.
+		const uint32_t first_positional_shadow = max_shadows_used;
+
 		for (uint32_t i = 0; i < (uint32_t)scene_cull_result.lights.size(); i++) {
 			Instance *ins = scene_cull_result.lights[i];
 
@@ -3469,6 +3564,8 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			// so that we can turn off tighter caster culling.
 			light->detect_light_intersects_multiple_cameras(Engine::get_singleton()->get_frames_drawn());
 
+			int32_t regular_light_id = -1;
+
 			if (light->is_shadow_dirty()) {
 				// Dirty shadows have no need to be drawn if
 				// the light volume doesn't intersect the camera frustum.
@@ -3476,7 +3573,10 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 				// Returns false if the entire light can be culled.
 				bool allow_redraw = light_culler->prepare_regular_light(*ins);
 
-				// Directional lights aren't handled here, _light_instance_update_shadow is called from elsewhere.
+				// Keep the cull planes around, the shadow views are culled after all lights are prepared.
+				regular_light_id = light_culler->store_regular_light();
+
+				// Directional lights aren't handled here, _light_instance_setup_shadow_views is called from elsewhere.
 				// Checking for this in case this changes, as this is assumed.
 				DEV_CHECK_ONCE(RSG::light_storage->light_get_type(ins->base) != RS::LIGHT_DIRECTIONAL);
 
@@ -3496,17 +3596,17 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 
 			if (redraw && max_shadows_used < MAX_UPDATE_SHADOWS) {
 				//must redraw!
-				RENDER_TIMESTAMP("> Render Light3D " + itos(i));
-				if (_light_instance_update_shadow(ins, p_camera_data->main_transform, p_camera_data->main_projection, p_camera_data->is_orthogonal, p_camera_data->vaspect, p_shadow_atlas, scenario, p_screen_mesh_lod_threshold, p_visible_layers)) {
+				if (_light_instance_setup_shadow_views(ins, regular_light_id)) {
 					light->make_shadow_dirty();
 				}
-				RENDER_TIMESTAMP("< Render Light3D " + itos(i));
 			} else {
 				if (redraw) {
 					light->make_shadow_dirty();
 				}
 			}
 		}
+
+		_scene_cull_shadow_views(scenario, p_visible_layers, first_positional_shadow);
 	}
 
 	//render SDFGI
@@ -4301,6 +4401,8 @@ void RendererSceneCull::update() {
 	scene_render->update();
 	update_dirty_instances();
 	render_particle_colliders();
+
+	shadow_cull_timings.clear();
 }
 
 bool RendererSceneCull::free(RID p_rid) {
@@ -4508,7 +4610,9 @@ RendererSceneCull::RendererSceneCull() {
 	singleton = this;
 
 	instance_cull_result.set_page_pool(&instance_cull_page_pool);
-	instance_shadow_cull_result.set_page_pool(&instance_cull_page_pool);
+	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
+		shadow_cull_views[i].cull_result.set_page_pool(&instance_cull_page_pool);
+	}
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.set_page_pool(&geometry_instance_cull_page_pool);
@@ -4528,7 +4632,8 @@ RendererSceneCull::RendererSceneCull() {
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count()); //make sure there is at least one thread per CPU
 	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = GLOBAL_GET("rendering/occlusion_culling/jitter_projection");
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	// Used unless a module such as raycast provides a different backend.
+	raster_occlusion_culling = memnew(RasterOcclusionCull);
 
 	light_culler = memnew(RenderingLightCuller);
 
@@ -4539,7 +4644,9 @@ RendererSceneCull::RendererSceneCull() {
 
 RendererSceneCull::~RendererSceneCull() {
 	instance_cull_result.reset();
-	instance_shadow_cull_result.reset();
+	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
+		shadow_cull_views[i].cull_result.reset();
+	}
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.reset();
@@ -4554,8 +4661,8 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	scene_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (raster_occlusion_culling) {
+		memdelete(raster_occlusion_culling);
 	}
 
 	if (light_culler) {
@@ -129,7 +129,7 @@ public:
 
 	/* VISIBILITY NOTIFIER API */
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling = nullptr;
+	RendererSceneOcclusionCull *raster_occlusion_culling = nullptr;
 
 	/* SCENARIO API */
 
@@ -911,7 +911,6 @@ public:
 	PagedArrayPool<RID> rid_cull_page_pool;
 
 	PagedArray<Instance *> instance_cull_result;
-	PagedArray<Instance *> instance_shadow_cull_result;
 
 	struct InstanceCullResult {
 		PagedArray<RenderGeometryInstance *> geometry_instances;
@@ -1039,6 +1038,36 @@ public:
 	RendererSceneRender::RenderShadowData render_shadow_data[MAX_UPDATE_SHADOWS];
 	uint32_t max_shadows_used = 0;
 
+	// Positional light shadow views are culled in parallel, each view using the
+	// buffers that match its slot in render_shadow_data.
+	struct ShadowCullView {
+		Instance *light = nullptr;
+		uint32_t pass = 0;
+		Vector<Plane> planes;
+		int32_t regular_light_id = -1; // Stored light culler planes, -1 when updating the full shadow.
+
+		PagedArray<Instance *> cull_result;
+		LocalVector<RID> mesh_instances;
+		bool animated_material_found = false;
+		uint64_t cull_time_usec = 0;
+	};
+
+	struct ShadowCullData {
+		Scenario *scenario = nullptr;
+		uint32_t visible_layers = 0;
+		uint32_t first_shadow = 0;
+	};
+
+	struct ShadowCullTiming {
+		RID light;
+		uint32_t pass = 0;
+		uint32_t instance_count = 0;
+		uint64_t cull_time_usec = 0;
+	};
+
+	ShadowCullView shadow_cull_views[MAX_UPDATE_SHADOWS];
+	LocalVector<ShadowCullTiming> shadow_cull_timings; // Cleared at the start of each frame.
+
 	RendererSceneRender::RenderSDFGIData render_sdfgi_data[SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE];
 	RendererSceneRender::RenderSDFGIUpdateData sdfgi_update_data;
 
@@ -1077,6 +1106,11 @@ public:
 
 	virtual void instance_set_ignore_culling(RID p_instance, bool p_enabled);
 
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms);
+	virtual void instances_set_visible(const Vector<RID> &p_instances, bool p_visible);
+	virtual void instances_set_custom_aabbs(const Vector<RID> &p_instances, const Vector<AABB> &p_aabbs);
+	virtual void instances_geometry_set_shader_parameter(const Vector<RID> &p_instances, const StringName &p_parameter, const Vector<Variant> &p_values);
+
 	bool _update_instance_visibility_depth(Instance *p_instance);
 	void _update_instance_visibility_dependencies(Instance *p_instance);
 
@@ -1104,6 +1138,7 @@ public:
 
 	virtual void mesh_generate_pipelines(RID p_mesh, bool p_background_compilation);
 	virtual uint32_t get_pipeline_compilations(RS::PipelineSource p_source);
+	virtual TypedArray<Dictionary> get_shadow_cull_timings() const;
 
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
@@ -1113,7 +1148,9 @@ public:
 
 	void _light_instance_setup_directional_shadow(int p_shadow_index, Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_scren_mesh_lod_threshold, uint32_t p_visible_layers = 0xFFFFFF);
+	_FORCE_INLINE_ bool _light_instance_setup_shadow_views(Instance *p_instance, int32_t p_regular_light_id);
+	void _scene_cull_shadow_view(uint32_t p_index, ShadowCullData *p_cull_data);
+	void _scene_cull_shadow_views(Scenario *p_scenario, uint32_t p_visible_layers, uint32_t p_first_shadow);
 
 	RID _render_get_environment(RID p_camera, RID p_scenario);
 	RID _render_get_compositor(RID p_camera, RID p_scenario);
@@ -1167,7 +1204,7 @@ public:
 	void _visibility_cull_threaded(uint32_t p_thread, VisibilityCullData *cull_data);
 	void _visibility_cull(const VisibilityCullData &cull_data, uint64_t p_from, uint64_t p_to);
 	template <bool p_fade_check>
-	_FORCE_INLINE_ int _visibility_range_check(InstanceVisibilityData &r_vis_data, const Vector3 &p_camera_pos, uint64_t p_viewport_mask);
+	_FORCE_INLINE_ int _visibility_range_check(InstanceVisibilityData &r_vis_data, float p_distance, uint64_t p_viewport_mask);
 
 	struct CullData {
 		Cull *cull = nullptr;
@@ -1181,7 +1218,12 @@ public:
 		uint64_t visibility_viewport_mask;
 	};
 
+	// Instances are pre-culled in blocks of this size, see _scene_cull_block().
+	static const uint32_t CULL_BLOCK_SIZE = 64;
+
 	void _scene_cull_threaded(uint32_t p_thread, CullData *cull_data);
+	// r_distance is only written for instances with a visibility range.
+	void _scene_cull_block(const CullData &cull_data, uint64_t p_from, uint32_t p_count, uint8_t *r_in_view, float *r_distance);
 	void _scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to);
 	_FORCE_INLINE_ bool _visibility_parent_check(const CullData &p_cull_data, const InstanceData &p_instance_data);
 
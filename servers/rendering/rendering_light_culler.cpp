@@ -151,13 +151,38 @@ bool RenderingLightCuller::cull_directional_light(const RendererSceneCull::Insta
 }
 
 void RenderingLightCuller::cull_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result) {
+	_cull_regular_light(r_instance_shadow_cull_result, data.regular_cull_planes, data.out_of_range);
+}
+
+int32_t RenderingLightCuller::store_regular_light() {
+	if (!data.is_active()) {
+		return -1;
+	}
+
+	int32_t regular_light_id = data.stored_regular_cull_planes.size();
+	data.stored_regular_cull_planes.push_back(data.regular_cull_planes);
+	data.stored_regular_cull_planes[regular_light_id].out_of_range = data.out_of_range;
+	return regular_light_id;
+}
+
+void RenderingLightCuller::cull_stored_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result, int32_t p_regular_light_id) {
+	if (p_regular_light_id == -1) {
+		return;
+	}
+	ERR_FAIL_INDEX(p_regular_light_id, (int32_t)data.stored_regular_cull_planes.size());
+
+	const LightCullPlanes &cull_planes = data.stored_regular_cull_planes[p_regular_light_id];
+	_cull_regular_light(r_instance_shadow_cull_result, cull_planes, cull_planes.out_of_range);
+}
+
+void RenderingLightCuller::_cull_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result, const LightCullPlanes &p_cull_planes, bool p_out_of_range) {
 	if (!data.is_active() || !is_caster_culling_active()) {
 		return;
 	}
 
 	// If the light is out of range, no need to check anything, just return 0 casters.
 	// Ideally an out of range light should not even be drawn AT ALL (no shadow map, no PCF etc).
-	if (data.out_of_range) {
+	if (p_out_of_range) {
 		return;
 	}
 
@@ -182,13 +207,13 @@ void RenderingLightCuller::cull_regular_light(PagedArray<RendererSceneCull::Inst
 		real_t r_min, r_max;
 		bool show = true;
 
-		for (int p = 0; p < data.regular_cull_planes.num_cull_planes; p++) {
+		for (int p = 0; p < p_cull_planes.num_cull_planes; p++) {
 			// As we only need r_min, could this be optimized?
-			bb.project_range_in_plane(data.regular_cull_planes.cull_planes[p], r_min, r_max);
+			bb.project_range_in_plane(p_cull_planes.cull_planes[p], r_min, r_max);
 
 #ifdef LIGHT_CULLER_DEBUG_LOGGING
 			if (is_logging()) {
-				print_line("\tplane " + itos(p) + " : " + String(data.regular_cull_planes.cull_planes[p]) + " r_min " + String(Variant(r_min)) + " r_max " + String(Variant(r_max)));
+				print_line("\tplane " + itos(p) + " : " + String(p_cull_planes.cull_planes[p]) + " r_min " + String(Variant(r_min)) + " r_max " + String(Variant(r_max)));
 			}
 #endif
 
@@ -515,6 +540,7 @@ bool RenderingLightCuller::prepare_camera(const Transform3D &p_cam_transform, co
 #endif
 
 	data.directional_cull_planes.resize(0);
+	data.stored_regular_cull_planes.clear();
 
 #ifdef LIGHT_CULLER_DEBUG_LOGGING
 	if (is_logging()) {
@@ -140,6 +140,11 @@ public:
 	// Cull according to the regular light planes that were setup in the previous call to prepare_regular_light.
 	void cull_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result);
 
+	// Regular lights can also be stored after being prepared, and then culled multithreaded chopping and
+	// changing between different regular_light_id. Returns -1 if the culler is not active.
+	int32_t store_regular_light();
+	void cull_stored_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result, int32_t p_regular_light_id);
+
 	// Directional lights are prepared in advance, and can be culled multithreaded chopping and changing between
 	// different directional_light_id.
 	void prepare_directional_light(const RendererSceneCull::Instance *p_instance, int32_t p_directional_light_id);
@@ -156,12 +161,14 @@ private:
 		void add_cull_plane(const Plane &p);
 		Plane cull_planes[MAX_CULL_PLANES];
 		int num_cull_planes = 0;
+		bool out_of_range = false; // Only used by stored regular lights.
 #ifdef LIGHT_CULLER_DEBUG_DIRECTIONAL_LIGHT
 		uint32_t rejected_count = 0;
 #endif
 	};
 
 	bool _prepare_light(const RendererSceneCull::Instance &p_instance, int32_t p_directional_light_id = -1);
+	void _cull_regular_light(PagedArray<RendererSceneCull::Instance *> &r_instance_shadow_cull_result, const LightCullPlanes &p_cull_planes, bool p_out_of_range);
 
 	// Avoid adding extra culling planes derived from near colinear triangles.
 	// The normals derived from these will be inaccurate, and can lead to false
@@ -227,6 +234,9 @@ private:
 		// (OMNI, SPOT). These lights reuse the same set of cull plane data.
 		LightCullPlanes regular_cull_planes;
 
+		// Copies of the regular cull planes, for regular lights culled multithreaded.
+		LocalVector<LightCullPlanes> stored_regular_cull_planes;
+
 #ifdef LIGHT_CULLER_DEBUG_REGULAR_LIGHT
 		uint32_t regular_rejected_count = 0;
 #endif
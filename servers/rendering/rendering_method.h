@@ -98,6 +98,11 @@ public:
 	virtual void instance_set_extra_visibility_margin(RID p_instance, real_t p_margin) = 0;
 	virtual void instance_set_visibility_parent(RID p_instance, RID p_parent_instance) = 0;
 
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) = 0;
+	virtual void instances_set_visible(const Vector<RID> &p_instances, bool p_visible) = 0;
+	virtual void instances_set_custom_aabbs(const Vector<RID> &p_instances, const Vector<AABB> &p_aabbs) = 0;
+	virtual void instances_geometry_set_shader_parameter(const Vector<RID> &p_instances, const StringName &p_parameter, const Vector<Variant> &p_values) = 0;
+
 	virtual void instance_set_ignore_culling(RID p_instance, bool p_enabled) = 0;
 
 	// don't use these in a game!
@@ -123,6 +128,10 @@ public:
 	virtual void mesh_generate_pipelines(RID p_mesh, bool p_background_compilation) = 0;
 	virtual uint32_t get_pipeline_compilations(RS::PipelineSource p_source) = 0;
 
+	/* DEBUG */
+
+	virtual TypedArray<Dictionary> get_shadow_cull_timings() const = 0;
+
 	/* SKY API */
 
 	virtual RID sky_allocate() = 0;
@@ -886,11 +886,18 @@ public:
 
 	FUNC2(instance_set_ignore_culling, RID, bool)
 
+	FUNC2(instances_set_transforms, const Vector<RID> &, const Vector<Transform3D> &)
+	FUNC2(instances_set_visible, const Vector<RID> &, bool)
+	FUNC2(instances_set_custom_aabbs, const Vector<RID> &, const Vector<AABB> &)
+	FUNC3(instances_geometry_set_shader_parameter, const Vector<RID> &, const StringName &, const Vector<Variant> &)
+
 	// don't use these in a game!
 	FUNC2RC(Vector<ObjectID>, instances_cull_aabb, const AABB &, RID)
 	FUNC3RC(Vector<ObjectID>, instances_cull_ray, const Vector3 &, const Vector3 &, RID)
 	FUNC2RC(Vector<ObjectID>, instances_cull_convex, const Vector<Plane> &, RID)
 
+	FUNC0RC(TypedArray<Dictionary>, get_shadow_cull_timings)
+
 	FUNC3(instance_geometry_set_flag, RID, InstanceFlags, bool)
 	FUNC2(instance_geometry_set_cast_shadows_setting, RID, ShadowCastingSetting)
 	FUNC2(instance_geometry_set_material_override, RID, RID)
@@ -974,6 +981,7 @@ public:
 	FUNC5(canvas_item_add_animation_slice, RID, double, double, double, double)
 
 	FUNC2(canvas_item_set_sort_children_by_y, RID, bool)
+	FUNC2(canvas_item_set_use_spatial_index, RID, bool)
 	FUNC2(canvas_item_set_z_index, RID, int)
 	FUNC2(canvas_item_set_z_as_relative_to_parent, RID, bool)
 	FUNC3(canvas_item_set_copy_to_backbuffer, RID, bool, const Rect2 &)
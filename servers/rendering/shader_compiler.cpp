@@ -1471,7 +1471,7 @@ ShaderLanguage::DataType ShaderCompiler::_get_global_shader_uniform_type(const S
 	return (ShaderLanguage::DataType)RS::global_shader_uniform_type_get_shader_datatype(gvt);
 }
 
-Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+Error ShaderCompiler::_compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
 	SL::ShaderCompileInfo info;
 	info.functions = ShaderTypes::get_singleton()->get_functions(p_mode);
 	info.render_modes = ShaderTypes::get_singleton()->get_modes(p_mode);
@@ -1579,6 +1579,144 @@ Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, Ident
 	return OK;
 }
 
+ShaderCompiler *ShaderCompiler::_acquire_compiler() {
+	MutexLock lock(mutex);
+	if (!compiling) {
+		compiling = true;
+		return this;
+	}
+
+	if (!free_compilers.is_empty()) {
+		ShaderCompiler *compiler = free_compilers[free_compilers.size() - 1];
+		free_compilers.resize(free_compilers.size() - 1);
+		return compiler;
+	}
+
+	ShaderCompiler *compiler = memnew(ShaderCompiler);
+	compiler->initialize(actions);
+	return compiler;
+}
+
+void ShaderCompiler::_release_compiler(ShaderCompiler *p_compiler) {
+	MutexLock lock(mutex);
+	if (p_compiler == this) {
+		compiling = false;
+	} else {
+		free_compilers.push_back(p_compiler);
+	}
+}
+
+Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+	ERR_FAIL_INDEX_V(p_mode, RS::SHADER_MAX, ERR_INVALID_PARAMETER);
+
+	{
+		MutexLock lock(mutex);
+		HashMap<String, CacheEntry>::Iterator E = cache[p_mode].find(p_code);
+		if (E && E->value.global_shader_uniforms_version == global_shader_uniforms_version.get()) {
+			const CacheEntry &entry = E->value;
+
+			for (const StringName &render_mode : entry.render_modes) {
+				if (p_actions->render_mode_flags.has(render_mode)) {
+					*p_actions->render_mode_flags[render_mode] = true;
+				}
+				if (p_actions->render_mode_values.has(render_mode)) {
+					Pair<int *, int> &p = p_actions->render_mode_values[render_mode];
+					*p.first = p.second;
+				}
+			}
+			for (const StringName &usage_flag : entry.usage_flags) {
+				bool **flag = p_actions->usage_flag_pointers.getptr(usage_flag);
+				if (flag) {
+					**flag = true;
+				}
+			}
+			for (const StringName &write_flag : entry.write_flags) {
+				bool **flag = p_actions->write_flag_pointers.getptr(write_flag);
+				if (flag) {
+					**flag = true;
+				}
+			}
+			if (p_actions->uniforms) {
+				for (const KeyValue<StringName, ShaderLanguage::ShaderNode::Uniform> &uniform : entry.uniforms) {
+					p_actions->uniforms->insert(uniform.key, uniform.value);
+				}
+			}
+
+			r_gen_code = entry.gen_code;
+			return OK;
+		}
+	}
+
+	// Compile with the flags pointing to local storage, to find out which ones the shader sets.
+	IdentifierActions recording_actions = *p_actions;
+
+	LocalVector<bool> usage_flags;
+	usage_flags.resize(recording_actions.usage_flag_pointers.size());
+	uint32_t flag_index = 0;
+	for (KeyValue<StringName, bool *> &E : recording_actions.usage_flag_pointers) {
+		usage_flags[flag_index] = false;
+		E.value = &usage_flags[flag_index++];
+	}
+
+	LocalVector<bool> write_flags;
+	write_flags.resize(recording_actions.write_flag_pointers.size());
+	flag_index = 0;
+	for (KeyValue<StringName, bool *> &E : recording_actions.write_flag_pointers) {
+		write_flags[flag_index] = false;
+		E.value = &write_flags[flag_index++];
+	}
+
+	CacheEntry entry;
+	entry.global_shader_uniforms_version = global_shader_uniforms_version.get();
+	recording_actions.uniforms = &entry.uniforms;
+
+	ShaderCompiler *compiler = _acquire_compiler();
+	Error err = compiler->_compile(p_mode, p_code, &recording_actions, p_path, r_gen_code);
+	if (err == OK) {
+		entry.render_modes = compiler->parser.get_shader()->render_modes;
+	}
+	_release_compiler(compiler);
+
+	if (err != OK) {
+		return err;
+	}
+
+	flag_index = 0;
+	for (const KeyValue<StringName, bool *> &E : p_actions->usage_flag_pointers) {
+		if (usage_flags[flag_index++]) {
+			*E.value = true;
+			entry.usage_flags.push_back(E.key);
+		}
+	}
+	flag_index = 0;
+	for (const KeyValue<StringName, bool *> &E : p_actions->write_flag_pointers) {
+		if (write_flags[flag_index++]) {
+			*E.value = true;
+			entry.write_flags.push_back(E.key);
+		}
+	}
+	if (p_actions->uniforms) {
+		for (const KeyValue<StringName, ShaderLanguage::ShaderNode::Uniform> &uniform : entry.uniforms) {
+			p_actions->uniforms->insert(uniform.key, uniform.value);
+		}
+	}
+
+	entry.gen_code = r_gen_code;
+
+	MutexLock lock(mutex);
+	if (cache[p_mode].size() >= CACHE_MAX_ENTRIES) {
+		// Drop the oldest entry, HashMap keeps insertion order.
+		cache[p_mode].remove(cache[p_mode].begin());
+	}
+	cache[p_mode].insert(p_code, entry);
+
+	return OK;
+}
+
+void ShaderCompiler::global_shader_uniforms_changed() {
+	global_shader_uniforms_version.increment();
+}
+
 void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	actions = p_actions;
 
@@ -1604,5 +1742,13 @@ void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	texture_functions.insert("texelFetch");
 }
 
+SafeNumeric<uint64_t> ShaderCompiler::global_shader_uniforms_version;
+
 ShaderCompiler::ShaderCompiler() {
 }
+
+ShaderCompiler::~ShaderCompiler() {
+	for (ShaderCompiler *compiler : free_compilers) {
+		memdelete(compiler);
+	}
+}
@@ -31,7 +31,9 @@
 #ifndef SHADER_COMPILER_H
 #define SHADER_COMPILER_H
 
+#include "core/os/mutex.h"
 #include "core/templates/pair.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/rendering/shader_language.h"
 #include "servers/rendering_server.h"
 
@@ -127,11 +129,45 @@ private:
 
 	static ShaderLanguage::DataType _get_global_shader_uniform_type(const StringName &p_name);
 
+	Error _compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
+
+	// Front-end results are cached by shader code, so identical shaders (e.g. from
+	// duplicated or imported materials) are only parsed and translated once.
+	// The effects of the compilation on the identifier actions are stored by name,
+	// and replayed on the actions of each caller.
+	struct CacheEntry {
+		uint64_t global_shader_uniforms_version = 0;
+		GeneratedCode gen_code;
+		Vector<StringName> render_modes;
+		Vector<StringName> usage_flags;
+		Vector<StringName> write_flags;
+		HashMap<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+	};
+
+	static constexpr uint32_t CACHE_MAX_ENTRIES = 256;
+	static SafeNumeric<uint64_t> global_shader_uniforms_version;
+
+	HashMap<String, CacheEntry> cache[RS::SHADER_MAX];
+
+	// Compilation state isn't shareable, so shaders compiled at the same time on
+	// several threads each get a compiler of their own.
+	Mutex mutex;
+	bool compiling = false;
+	LocalVector<ShaderCompiler *> free_compilers;
+
+	ShaderCompiler *_acquire_compiler();
+	void _release_compiler(ShaderCompiler *p_compiler);
+
 public:
+	// Safe to call from several threads at once.
 	Error compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
 
+	// Global shader uniform types affect parsing, so cached results must be discarded when they change.
+	static void global_shader_uniforms_changed();
+
 	void initialize(DefaultIdentifierActions p_actions);
 	ShaderCompiler();
+	~ShaderCompiler();
 };
 
 #endif // SHADER_COMPILER_H
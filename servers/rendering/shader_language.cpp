@@ -30,6 +30,7 @@
 
 #include "shader_language.h"
 
+#include "core/os/mutex.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/templates/local_vector.h"
@@ -725,9 +726,8 @@ ShaderLanguage::Token ShaderLanguage::_get_token() {
 
 					static bool suffix_lut[CASE_MAX][127];
 
-					if (!is_const_suffix_lut_initialized) {
-						is_const_suffix_lut_initialized = true;
-
+					// Static initialization is thread safe, shaders may be parsed on several threads.
+					static const bool is_const_suffix_lut_initialized = []() {
 						for (int i = 0; i < 127; i++) {
 							char t = char(i);
 
@@ -737,7 +737,9 @@ ShaderLanguage::Token ShaderLanguage::_get_token() {
 							suffix_lut[CASE_SIGN_AFTER_EXPONENT][i] = t == 'f';
 							suffix_lut[CASE_NONE][i] = false;
 						}
-					}
+						return true;
+					}();
+					(void)is_const_suffix_lut_initialized;
 
 					String str;
 					int i = 0;
@@ -3512,6 +3514,9 @@ const ShaderLanguage::BuiltinFuncDef ShaderLanguage::builtin_func_defs[] = {
 };
 
 HashSet<StringName> global_func_set;
+// Parsers may be created on several threads. The set is filled before the first
+// one is used and cleared once the last one is gone, so it's only locked here.
+static BinaryMutex global_func_set_mutex;
 
 const ShaderLanguage::BuiltinFuncOutArgs ShaderLanguage::builtin_func_out_args[] = {
 	{ "modf", { 1, -1 } },
@@ -3542,7 +3547,6 @@ const ShaderLanguage::BuiltinEntry ShaderLanguage::frag_only_func_defs[] = {
 	{ nullptr }
 };
 
-bool ShaderLanguage::is_const_suffix_lut_initialized = false;
 
 bool ShaderLanguage::_validate_function_call(BlockNode *p_block, const FunctionInfo &p_function_info, OperatorNode *p_func, DataType *r_ret_type, StringName *r_ret_type_str, bool *r_is_custom_function) {
 	ERR_FAIL_COND_V(p_func->op != OP_CALL && p_func->op != OP_CONSTRUCT, false);
@@ -11446,16 +11450,19 @@ ShaderLanguage::ShaderLanguage() {
 	nodes = nullptr;
 	completion_class = TAG_GLOBAL;
 
-	if (instance_counter == 0) {
-		int idx = 0;
-		while (builtin_func_defs[idx].name) {
-			if (builtin_func_defs[idx].tag == SubClassTag::TAG_GLOBAL) {
-				global_func_set.insert(builtin_func_defs[idx].name);
+	{
+		MutexLock lock(global_func_set_mutex);
+		if (instance_counter == 0) {
+			int idx = 0;
+			while (builtin_func_defs[idx].name) {
+				if (builtin_func_defs[idx].tag == SubClassTag::TAG_GLOBAL) {
+					global_func_set.insert(builtin_func_defs[idx].name);
+				}
+				idx++;
 			}
-			idx++;
 		}
+		instance_counter++;
 	}
-	instance_counter++;
 
 #ifdef DEBUG_ENABLED
 	warnings_check_map.insert(ShaderWarning::UNUSED_CONSTANT, &used_constants);
@@ -11470,6 +11477,7 @@ ShaderLanguage::ShaderLanguage() {
 
 ShaderLanguage::~ShaderLanguage() {
 	clear();
+	MutexLock lock(global_func_set_mutex);
 	instance_counter--;
 	if (instance_counter == 0) {
 		global_func_set.clear();
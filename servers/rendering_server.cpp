@@ -104,6 +104,81 @@ PackedInt64Array RenderingServer::_instances_cull_convex_bind(const TypedArray<P
 	return to_int_array(ids);
 }
 
+void RenderingServer::_instances_set_transforms_bind(const TypedArray<RID> &p_instances, const PackedFloat32Array &p_transforms) {
+	ERR_FAIL_COND_MSG(p_transforms.size() != p_instances.size() * 12, "The transforms array must contain 12 floats per instance.");
+
+	Vector<RID> instances;
+	instances.resize(p_instances.size());
+	Vector<Transform3D> transforms;
+	transforms.resize(p_instances.size());
+
+	RID *instances_ptrw = instances.ptrw();
+	Transform3D *transforms_ptrw = transforms.ptrw();
+	const float *data = p_transforms.ptr();
+	for (int i = 0; i < p_instances.size(); i++) {
+		instances_ptrw[i] = p_instances[i];
+
+		// Same layout as MultiMesh buffers.
+		Transform3D &t = transforms_ptrw[i];
+		t.basis.rows[0] = Vector3(data[0], data[1], data[2]);
+		t.origin.x = data[3];
+		t.basis.rows[1] = Vector3(data[4], data[5], data[6]);
+		t.origin.y = data[7];
+		t.basis.rows[2] = Vector3(data[8], data[9], data[10]);
+		t.origin.z = data[11];
+		data += 12;
+	}
+
+	instances_set_transforms(instances, transforms);
+}
+
+void RenderingServer::_instances_set_visible_bind(const TypedArray<RID> &p_instances, bool p_visible) {
+	Vector<RID> instances;
+	instances.resize(p_instances.size());
+	RID *instances_ptrw = instances.ptrw();
+	for (int i = 0; i < p_instances.size(); i++) {
+		instances_ptrw[i] = p_instances[i];
+	}
+
+	instances_set_visible(instances, p_visible);
+}
+
+void RenderingServer::_instances_set_custom_aabbs_bind(const TypedArray<RID> &p_instances, const TypedArray<AABB> &p_aabbs) {
+	ERR_FAIL_COND(p_aabbs.size() != p_instances.size());
+
+	Vector<RID> instances;
+	instances.resize(p_instances.size());
+	Vector<AABB> aabbs;
+	aabbs.resize(p_aabbs.size());
+
+	RID *instances_ptrw = instances.ptrw();
+	AABB *aabbs_ptrw = aabbs.ptrw();
+	for (int i = 0; i < p_instances.size(); i++) {
+		instances_ptrw[i] = p_instances[i];
+		aabbs_ptrw[i] = p_aabbs[i];
+	}
+
+	instances_set_custom_aabbs(instances, aabbs);
+}
+
+void RenderingServer::_instances_geometry_set_shader_parameter_bind(const TypedArray<RID> &p_instances, const StringName &p_parameter, const Array &p_values) {
+	ERR_FAIL_COND(p_values.size() != p_instances.size());
+
+	Vector<RID> instances;
+	instances.resize(p_instances.size());
+	Vector<Variant> values;
+	values.resize(p_values.size());
+
+	RID *instances_ptrw = instances.ptrw();
+	Variant *values_ptrw = values.ptrw();
+	for (int i = 0; i < p_instances.size(); i++) {
+		instances_ptrw[i] = p_instances[i];
+		values_ptrw[i] = p_values[i];
+	}
+
+	instances_geometry_set_shader_parameter(instances, p_parameter, values);
+}
+
 RID RenderingServer::get_test_texture() {
 	if (test_texture.is_valid()) {
 		return test_texture;
@@ -3144,6 +3219,11 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("instance_set_visibility_parent", "instance", "parent"), &RenderingServer::instance_set_visibility_parent);
 	ClassDB::bind_method(D_METHOD("instance_set_ignore_culling", "instance", "enabled"), &RenderingServer::instance_set_ignore_culling);
 
+	ClassDB::bind_method(D_METHOD("instances_set_transforms", "instances", "transforms"), &RenderingServer::_instances_set_transforms_bind);
+	ClassDB::bind_method(D_METHOD("instances_set_visible", "instances", "visible"), &RenderingServer::_instances_set_visible_bind);
+	ClassDB::bind_method(D_METHOD("instances_set_custom_aabbs", "instances", "aabbs"), &RenderingServer::_instances_set_custom_aabbs_bind);
+	ClassDB::bind_method(D_METHOD("instances_geometry_set_shader_parameter", "instances", "parameter", "values"), &RenderingServer::_instances_geometry_set_shader_parameter_bind);
+
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_flag", "instance", "flag", "enabled"), &RenderingServer::instance_geometry_set_flag);
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_cast_shadows_setting", "instance", "shadow_casting_setting"), &RenderingServer::instance_geometry_set_cast_shadows_setting);
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_material_override", "instance", "material"), &RenderingServer::instance_geometry_set_material_override);
@@ -3265,6 +3345,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("canvas_item_add_clip_ignore", "item", "ignore"), &RenderingServer::canvas_item_add_clip_ignore);
 	ClassDB::bind_method(D_METHOD("canvas_item_add_animation_slice", "item", "animation_length", "slice_begin", "slice_end", "offset"), &RenderingServer::canvas_item_add_animation_slice, DEFVAL(0.0));
 	ClassDB::bind_method(D_METHOD("canvas_item_set_sort_children_by_y", "item", "enabled"), &RenderingServer::canvas_item_set_sort_children_by_y);
+	ClassDB::bind_method(D_METHOD("canvas_item_set_use_spatial_index", "item", "enabled"), &RenderingServer::canvas_item_set_use_spatial_index);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_z_index", "item", "z_index"), &RenderingServer::canvas_item_set_z_index);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_z_as_relative_to_parent", "item", "enabled"), &RenderingServer::canvas_item_set_z_as_relative_to_parent);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_copy_to_backbuffer", "item", "enabled", "rect"), &RenderingServer::canvas_item_set_copy_to_backbuffer);
@@ -3438,6 +3519,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_render_loop_enabled", "enabled"), &RenderingServer::set_render_loop_enabled);
 
 	ClassDB::bind_method(D_METHOD("get_frame_setup_time_cpu"), &RenderingServer::get_frame_setup_time_cpu);
+	ClassDB::bind_method(D_METHOD("get_shadow_cull_timings"), &RenderingServer::get_shadow_cull_timings);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "render_loop_enabled"), "set_render_loop_enabled", "is_render_loop_enabled");
 
@@ -1387,6 +1387,17 @@ public:
 
 	virtual void instance_set_ignore_culling(RID p_instance, bool p_enabled) = 0;
 
+	// Bulk versions of the above, for updating many instances in a single call.
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) = 0;
+	virtual void instances_set_visible(const Vector<RID> &p_instances, bool p_visible) = 0;
+	virtual void instances_set_custom_aabbs(const Vector<RID> &p_instances, const Vector<AABB> &p_aabbs) = 0;
+	virtual void instances_geometry_set_shader_parameter(const Vector<RID> &p_instances, const StringName &p_parameter, const Vector<Variant> &p_values) = 0;
+
+	void _instances_set_transforms_bind(const TypedArray<RID> &p_instances, const PackedFloat32Array &p_transforms);
+	void _instances_set_visible_bind(const TypedArray<RID> &p_instances, bool p_visible);
+	void _instances_set_custom_aabbs_bind(const TypedArray<RID> &p_instances, const TypedArray<AABB> &p_aabbs);
+	void _instances_geometry_set_shader_parameter_bind(const TypedArray<RID> &p_instances, const StringName &p_parameter, const Array &p_values);
+
 	// Don't use these in a game!
 	virtual Vector<ObjectID> instances_cull_aabb(const AABB &p_aabb, RID p_scenario = RID()) const = 0;
 	virtual Vector<ObjectID> instances_cull_ray(const Vector3 &p_from, const Vector3 &p_to, RID p_scenario = RID()) const = 0;
@@ -1517,6 +1528,7 @@ public:
 	virtual void canvas_item_add_animation_slice(RID p_item, double p_animation_length, double p_slice_begin, double p_slice_end, double p_offset) = 0;
 
 	virtual void canvas_item_set_sort_children_by_y(RID p_item, bool p_enable) = 0;
+	virtual void canvas_item_set_use_spatial_index(RID p_item, bool p_enable) = 0;
 	virtual void canvas_item_set_z_index(RID p_item, int p_z) = 0;
 	virtual void canvas_item_set_z_as_relative_to_parent(RID p_item, bool p_enable) = 0;
 	virtual void canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect) = 0;
@@ -1735,6 +1747,7 @@ public:
 	virtual uint64_t get_frame_profile_frame() = 0;
 
 	virtual double get_frame_setup_time_cpu() const = 0;
+	virtual TypedArray<Dictionary> get_shadow_cull_timings() const = 0;
 
 	virtual void gi_set_use_half_resolution(bool p_enable) = 0;
 
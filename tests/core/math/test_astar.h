@@ -85,6 +85,32 @@ TEST_CASE("[AStar3D] ABCX path") {
 	CHECK(path[3] == ABCX::C);
 }
 
+TEST_CASE("[AStar3D] Paths batch") {
+	ABCX abcx;
+	PackedInt64Array from_ids = { ABCX::A, ABCX::X, ABCX::C, ABCX::B };
+	PackedInt64Array to_ids = { ABCX::C, ABCX::C, ABCX::C, ABCX::X };
+	TypedArray<PackedInt64Array> paths = abcx.get_paths_batch(from_ids, to_ids);
+	REQUIRE(paths.size() == from_ids.size());
+	for (int i = 0; i < from_ids.size(); i++) {
+		CHECK(PackedInt64Array(paths[i]) == abcx.get_id_path(from_ids[i], to_ids[i]));
+	}
+	CHECK(PackedInt64Array(paths[2]).size() == 1);
+
+	// Paths to disabled points are empty, unless partial paths are allowed.
+	abcx.set_point_disabled(ABCX::C);
+	paths = abcx.get_paths_batch(from_ids, to_ids);
+	CHECK(PackedInt64Array(paths[0]).is_empty());
+	CHECK(PackedInt64Array(paths[3]) == abcx.get_id_path(ABCX::B, ABCX::X));
+	paths = abcx.get_paths_batch(from_ids, to_ids, true);
+	CHECK(PackedInt64Array(paths[0]) == abcx.get_id_path(ABCX::A, ABCX::C, true));
+	CHECK_FALSE(PackedInt64Array(paths[0]).is_empty());
+
+	ERR_PRINT_OFF;
+	paths = abcx.get_paths_batch(from_ids, PackedInt64Array());
+	ERR_PRINT_ON;
+	CHECK(paths.is_empty());
+}
+
 TEST_CASE("[AStar3D] Add/Remove") {
 	AStar3D a;
 
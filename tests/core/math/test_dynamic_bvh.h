@@ -0,0 +1,274 @@
+/**************************************************************************/
+/*  test_dynamic_bvh.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_DYNAMIC_BVH_H
+#define TEST_DYNAMIC_BVH_H
+
+#include "core/math/dynamic_bvh.h"
+#include "core/math/geometry_3d.h"
+#include "core/math/projection.h"
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDynamicBVH {
+
+struct CountResult {
+	uint64_t count = 0;
+
+	bool operator()(void *p_data) {
+		count++;
+		return false;
+	}
+};
+
+struct CollectResult {
+	Vector<uint64_t> items;
+
+	bool operator()(void *p_data) {
+		items.push_back((uint64_t)p_data);
+		return false;
+	}
+};
+
+// Keeps two trees with the same contents, only one of them using the wide node array.
+class TwinBVH {
+	Ref<RandomNumberGenerator> rng;
+	Vector<DynamicBVH::ID> binary_ids;
+	Vector<DynamicBVH::ID> wide_ids;
+
+public:
+	DynamicBVH binary;
+	DynamicBVH wide;
+	int mismatches = 0;
+
+	AABB random_box() {
+		Vector3 position(rng->randf_range(-100, 100), rng->randf_range(-100, 100), rng->randf_range(-100, 100));
+		Vector3 size(rng->randf_range(0.1, 5), rng->randf_range(0.1, 5), rng->randf_range(0.1, 5));
+		return AABB(position, size);
+	}
+
+	void insert(int p_count) {
+		for (int i = 0; i < p_count; i++) {
+			AABB box = random_box();
+			// Userdata only identifies the item, it's never dereferenced.
+			void *userdata = (void *)(uint64_t)(binary_ids.size() + 1);
+			binary_ids.push_back(binary.insert(box, userdata));
+			wide_ids.push_back(wide.insert(box, userdata));
+		}
+	}
+
+	void move(int p_count) {
+		for (int i = 0; i < p_count; i++) {
+			int index = rng->randi_range(0, binary_ids.size() - 1);
+			if (!binary_ids[index].is_valid()) {
+				continue;
+			}
+			AABB box = random_box();
+			binary.update(binary_ids[index], box);
+			wide.update(wide_ids[index], box);
+		}
+	}
+
+	void remove(int p_count) {
+		for (int i = 0; i < p_count; i++) {
+			int index = rng->randi_range(0, binary_ids.size() - 1);
+			if (!binary_ids[index].is_valid()) {
+				continue;
+			}
+			binary.remove(binary_ids[index]);
+			wide.remove(wide_ids[index]);
+			binary_ids.write[index] = DynamicBVH::ID();
+			wide_ids.write[index] = DynamicBVH::ID();
+		}
+	}
+
+	void compare_aabb_query(const AABB &p_box) {
+		CollectResult binary_result;
+		CollectResult wide_result;
+		binary.aabb_query(p_box, binary_result);
+		wide.aabb_query(p_box, wide_result);
+		binary_result.items.sort();
+		wide_result.items.sort();
+		if (binary_result.items != wide_result.items) {
+			mismatches++;
+		}
+	}
+
+	void compare_convex_query(const Vector<Plane> &p_planes) {
+		Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(p_planes.ptr(), p_planes.size());
+		CollectResult binary_result;
+		CollectResult wide_result;
+		binary.convex_query(p_planes.ptr(), p_planes.size(), points.ptr(), points.size(), binary_result);
+		wide.convex_query(p_planes.ptr(), p_planes.size(), points.ptr(), points.size(), wide_result);
+		binary_result.items.sort();
+		wide_result.items.sort();
+		if (binary_result.items != wide_result.items) {
+			mismatches++;
+		}
+	}
+
+	void compare_queries() {
+		for (int i = 0; i < 32; i++) {
+			AABB box = random_box();
+			box.size *= 10;
+			compare_aabb_query(box);
+		}
+		for (int i = 0; i < 16; i++) {
+			Vector3 eye(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50));
+			Vector3 target(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50));
+			if (eye.is_equal_approx(target)) {
+				continue;
+			}
+			Transform3D camera = Transform3D().looking_at(target - eye, Math::abs((target - eye).normalized().y) > 0.99 ? Vector3(1, 0, 0) : Vector3(0, 1, 0));
+			camera.origin = eye;
+			Projection projection = Projection::create_perspective(rng->randf_range(30, 90), 16.0 / 9.0, 0.05, rng->randf_range(20, 200));
+			compare_convex_query(projection.get_projection_planes(camera));
+		}
+	}
+
+	TwinBVH() {
+		rng.instantiate();
+		rng->set_seed(42);
+	}
+};
+
+TEST_CASE("[DynamicBVH] Wide node queries match the binary tree") {
+	TwinBVH bvh;
+	bvh.insert(2000);
+	CHECK_FALSE(bvh.wide.has_wide_nodes());
+
+	bvh.wide.update_wide_nodes();
+	REQUIRE(bvh.wide.has_wide_nodes());
+	CHECK_FALSE(bvh.binary.has_wide_nodes());
+	bvh.compare_queries();
+	CHECK_MESSAGE(bvh.mismatches == 0, "Queries should match after building the wide nodes.");
+
+	SUBCASE("Moving leaves refits the wide nodes") {
+		bvh.move(100);
+		CHECK(bvh.wide.has_wide_nodes());
+		bvh.compare_queries();
+		CHECK_MESSAGE(bvh.mismatches == 0, "Queries should match after moving leaves.");
+
+		// Enough refits to trigger a rebuild.
+		bvh.move(1000);
+		bvh.wide.update_wide_nodes();
+		CHECK(bvh.wide.has_wide_nodes());
+		bvh.compare_queries();
+		CHECK_MESSAGE(bvh.mismatches == 0, "Queries should match after rebuilding the wide nodes.");
+	}
+
+	SUBCASE("Removing leaves refits the wide nodes") {
+		bvh.remove(500);
+		CHECK(bvh.wide.has_wide_nodes());
+		bvh.compare_queries();
+		CHECK_MESSAGE(bvh.mismatches == 0, "Queries should match after removing leaves.");
+
+		bvh.remove(1000);
+		bvh.move(200);
+		bvh.compare_queries();
+		CHECK_MESSAGE(bvh.mismatches == 0, "Queries should match after removing and moving leaves.");
+	}
+
+	SUBCASE("Inserting leaves invalidates the wide nodes") {
+		bvh.insert(100);
+		CHECK_FALSE(bvh.wide.has_wide_nodes());
+		bvh.compare_queries();
+		CHECK_MESSAGE(bvh.mismatches == 0, "Queries should fall back to the binary tree.");
+
+		bvh.wide.update_wide_nodes();
+		CHECK(bvh.wide.has_wide_nodes());
+		bvh.compare_queries();
+		CHECK_MESSAGE(bvh.mismatches == 0, "Queries should match after rebuilding the wide nodes.");
+	}
+
+	SUBCASE("Clearing invalidates the wide nodes") {
+		bvh.wide.clear();
+		CHECK_FALSE(bvh.wide.has_wide_nodes());
+		CollectResult result;
+		bvh.wide.aabb_query(AABB(Vector3(-1000, -1000, -1000), Vector3(2000, 2000, 2000)), result);
+		CHECK(result.items.is_empty());
+	}
+}
+
+TEST_CASE("[Stress][DynamicBVH] Frustum culling 100000 instances") {
+	TwinBVH bvh;
+	bvh.insert(100000);
+
+	uint64_t build_begin = OS::get_singleton()->get_ticks_usec();
+	bvh.wide.update_wide_nodes();
+	uint64_t build_usec = OS::get_singleton()->get_ticks_usec() - build_begin;
+	REQUIRE(bvh.wide.has_wide_nodes());
+
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(7);
+
+	struct Frustum {
+		Vector<Plane> planes;
+		Vector<Vector3> points;
+	};
+	Vector<Frustum> frustums;
+	while (frustums.size() < 64) {
+		Vector3 eye(rng->randf_range(-100, 100), rng->randf_range(-100, 100), rng->randf_range(-100, 100));
+		Vector3 target(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50));
+		if (eye.is_equal_approx(target)) {
+			continue;
+		}
+		Transform3D camera = Transform3D().looking_at(target - eye, Math::abs((target - eye).normalized().y) > 0.99 ? Vector3(1, 0, 0) : Vector3(0, 1, 0));
+		camera.origin = eye;
+		Projection projection = Projection::create_perspective(75, 16.0 / 9.0, 0.05, 150);
+		Frustum frustum;
+		frustum.planes = projection.get_projection_planes(camera);
+		frustum.points = Geometry3D::compute_convex_mesh_points(frustum.planes.ptr(), frustum.planes.size());
+		frustums.push_back(frustum);
+	}
+
+	uint64_t usec[2] = {};
+	uint64_t counts[2] = {};
+	DynamicBVH *trees[2] = { &bvh.binary, &bvh.wide };
+	for (int mode = 0; mode < 2; mode++) {
+		CountResult result;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (const Frustum &frustum : frustums) {
+			trees[mode]->convex_query(frustum.planes.ptr(), frustum.planes.size(), frustum.points.ptr(), frustum.points.size(), result);
+		}
+		usec[mode] = OS::get_singleton()->get_ticks_usec() - begin;
+		counts[mode] = result.count;
+	}
+	CHECK(counts[0] == counts[1]);
+
+	MESSAGE("Culling 100000 instances with ", frustums.size(), " frustums, binary tree: ", usec[0], " usec, wide nodes: ", usec[1], " usec (built in ", build_usec, " usec).");
+}
+
+} // namespace TestDynamicBVH
+
+#endif // TEST_DYNAMIC_BVH_H
@@ -446,6 +446,98 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+class MultiProducerState {
+public:
+	static const int PRODUCER_COUNT = 4;
+
+	CommandQueueMT command_queue;
+	Thread producer_threads[PRODUCER_COUNT];
+	SafeNumeric<int> producers_done;
+	SafeNumeric<int> sync_errors;
+	int commands_per_producer = 0;
+
+	// Only touched by the consumer.
+	int last_sequence[PRODUCER_COUNT] = {};
+	int order_errors = 0;
+	int total_count = 0;
+
+	void consume(int p_producer, int p_sequence) {
+		if (p_sequence != last_sequence[p_producer] + 1) {
+			order_errors++;
+		}
+		last_sequence[p_producer] = p_sequence;
+		total_count++;
+	}
+
+	int get_last_sequence(int p_producer) {
+		return last_sequence[p_producer];
+	}
+
+	struct ProducerData {
+		MultiProducerState *state = nullptr;
+		int index = 0;
+	} producer_data[PRODUCER_COUNT];
+
+	static void producer_loop(void *p_userdata) {
+		ProducerData *data = static_cast<ProducerData *>(p_userdata);
+		MultiProducerState *state = data->state;
+		for (int i = 1; i <= state->commands_per_producer; i++) {
+			if (i % 1000 == 0) {
+				// Syncing must see every command this thread pushed before.
+				int last = 0;
+				state->command_queue.push_and_ret(state, &MultiProducerState::get_last_sequence, data->index, &last);
+				if (last != i - 1) {
+					state->sync_errors.increment();
+				}
+			}
+			state->command_queue.push(state, &MultiProducerState::consume, data->index, i);
+		}
+		state->producers_done.increment();
+	}
+
+	void run(int p_commands_per_producer) {
+		commands_per_producer = p_commands_per_producer;
+		for (int i = 0; i < PRODUCER_COUNT; i++) {
+			producer_data[i].state = this;
+			producer_data[i].index = i;
+			producer_threads[i].start(&MultiProducerState::producer_loop, &producer_data[i]);
+		}
+		while (producers_done.get() < PRODUCER_COUNT) {
+			command_queue.flush_all();
+		}
+		for (int i = 0; i < PRODUCER_COUNT; i++) {
+			producer_threads[i].wait_to_finish();
+		}
+		command_queue.flush_all();
+	}
+};
+
+TEST_CASE("[CommandQueue] Test multiple producers") {
+	MultiProducerState state;
+	state.run(5000);
+
+	CHECK_MESSAGE(state.order_errors == 0,
+			"Commands from each producer should be executed in the order they were pushed.");
+	CHECK_MESSAGE(state.sync_errors.get() == 0,
+			"Syncing should wait for all the commands pushed before by the same producer.");
+	CHECK_MESSAGE(state.total_count == MultiProducerState::PRODUCER_COUNT * 5000,
+			"Every pushed command should have been executed.");
+}
+
+TEST_CASE("[Stress][CommandQueue] Multiple producers throughput") {
+	const int commands_per_producer = 500000;
+	MultiProducerState state;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	state.run(commands_per_producer);
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(state.order_errors == 0);
+	CHECK(state.sync_errors.get() == 0);
+	CHECK(state.total_count == MultiProducerState::PRODUCER_COUNT * commands_per_producer);
+	MESSAGE("Pushed and flushed ", state.total_count, " commands in ", elapsed / 1000, " ms.");
+}
 } // namespace TestCommandQueue
 
 #endif // TEST_COMMAND_QUEUE_H
@@ -31,6 +31,7 @@
 #ifndef TEST_ANIMATION_H
 #define TEST_ANIMATION_H
 
+#include "core/os/os.h"
 #include "scene/resources/animation.h"
 
 #include "tests/test_macros.h"
@@ -309,6 +310,158 @@ TEST_CASE("[Animation] Create Bezier track") {
 	ERR_PRINT_ON;
 }
 
+TEST_CASE("[Animation] Sampling with a key cursor") {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(2.0);
+	const int track_index = animation->add_track(Animation::TYPE_POSITION_3D);
+	animation->track_set_path(track_index, NodePath("Enemy:position"));
+	for (int i = 0; i <= 20; i++) {
+		animation->position_track_insert_key(track_index, i * 0.1, Vector3(i, i * i, -i));
+	}
+
+	SUBCASE("Forward playback matches sampling without a cursor") {
+		int cursor = -1;
+		for (double time = -0.05; time < 2.1; time += 1.0 / 60.0) {
+			Vector3 expected;
+			Vector3 sampled;
+			CHECK(animation->try_position_track_interpolate(track_index, time, &expected) == OK);
+			CHECK(animation->try_position_track_interpolate(track_index, time, &sampled, false, &cursor) == OK);
+			CHECK(sampled.is_equal_approx(expected));
+		}
+	}
+
+	SUBCASE("Backward playback matches sampling without a cursor") {
+		int cursor = -1;
+		for (double time = 2.05; time > -0.1; time -= 1.0 / 60.0) {
+			Vector3 expected;
+			Vector3 sampled;
+			CHECK(animation->try_position_track_interpolate(track_index, time, &expected, true) == OK);
+			CHECK(animation->try_position_track_interpolate(track_index, time, &sampled, true, &cursor) == OK);
+			CHECK(sampled.is_equal_approx(expected));
+		}
+	}
+
+	SUBCASE("Seeking and sampling exactly on keys matches sampling without a cursor") {
+		int cursor = -1;
+		const double times[] = { 1.5, 0.2, 0.2, 0.3, 1.9, 0.0, 2.0, 0.7, 0.75 };
+		for (double time : times) {
+			Vector3 expected;
+			Vector3 sampled;
+			CHECK(animation->try_position_track_interpolate(track_index, time, &expected) == OK);
+			CHECK(animation->try_position_track_interpolate(track_index, time, &sampled, false, &cursor) == OK);
+			CHECK(sampled.is_equal_approx(expected));
+		}
+	}
+}
+
+TEST_CASE("[Animation] Batch sampling of transform tracks") {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(1.0);
+	const int position_track = animation->add_track(Animation::TYPE_POSITION_3D);
+	animation->track_set_path(position_track, NodePath("Enemy:position"));
+	animation->position_track_insert_key(position_track, 0.0, Vector3(0, 1, 2));
+	animation->position_track_insert_key(position_track, 0.5, Vector3(3.5, 4, 5));
+	const int rotation_track = animation->add_track(Animation::TYPE_ROTATION_3D);
+	animation->track_set_path(rotation_track, NodePath("Enemy:rotation"));
+	animation->rotation_track_insert_key(rotation_track, 0.0, Quaternion::from_euler(Vector3(0, 1, 2)));
+	animation->rotation_track_insert_key(rotation_track, 0.5, Quaternion::from_euler(Vector3(3.5, 4, 5)));
+	const int scale_track = animation->add_track(Animation::TYPE_SCALE_3D);
+	animation->track_set_path(scale_track, NodePath("Enemy:scale"));
+	animation->scale_track_insert_key(scale_track, 0.0, Vector3(1, 1, 1));
+	animation->scale_track_insert_key(scale_track, 1.0, Vector3(2, 3, 4));
+	const int blend_shape_track = animation->add_track(Animation::TYPE_BLEND_SHAPE);
+	animation->track_set_path(blend_shape_track, NodePath("Enemy:blend"));
+	animation->blend_shape_track_insert_key(blend_shape_track, 0.0, 0.0);
+	animation->blend_shape_track_insert_key(blend_shape_track, 1.0, 1.0);
+	const int value_track = animation->add_track(Animation::TYPE_VALUE);
+	animation->track_set_path(value_track, NodePath("Enemy:visible"));
+	animation->track_insert_key(value_track, 0.0, true);
+	const int disabled_track = animation->add_track(Animation::TYPE_POSITION_3D);
+	animation->track_set_path(disabled_track, NodePath("Enemy/Child:position"));
+	animation->position_track_insert_key(disabled_track, 0.0, Vector3());
+	animation->track_set_enabled(disabled_track, false);
+
+	Animation::TransformTrackSamples samples;
+	Animation::KeyCursor cursor;
+	for (double time = 0.0; time <= 1.0; time += 0.1) {
+		animation->sample_transform_tracks(time, samples, false, &cursor);
+		REQUIRE(samples.valid.size() == uint32_t(animation->get_track_count()));
+
+		CHECK(samples.valid[position_track]);
+		CHECK(samples.positions[position_track].is_equal_approx(animation->position_track_interpolate(position_track, time)));
+		CHECK(samples.valid[rotation_track]);
+		CHECK(samples.rotations[rotation_track].is_equal_approx(animation->rotation_track_interpolate(rotation_track, time)));
+		CHECK(samples.valid[scale_track]);
+		CHECK(samples.scales[scale_track].is_equal_approx(animation->scale_track_interpolate(scale_track, time)));
+		CHECK(samples.valid[blend_shape_track]);
+		CHECK(samples.blend_shapes[blend_shape_track] == doctest::Approx(animation->blend_shape_track_interpolate(blend_shape_track, time)));
+		CHECK(!samples.valid[value_track]);
+		CHECK(!samples.valid[disabled_track]);
+	}
+
+	// Compressed tracks go through the same entry point.
+	animation->compress();
+	CHECK(animation->track_is_compressed(position_track));
+	animation->sample_transform_tracks(0.25, samples, false, &cursor);
+	CHECK(samples.valid[position_track]);
+	CHECK(samples.positions[position_track].is_equal_approx(animation->position_track_interpolate(position_track, 0.25)));
+}
+
+TEST_CASE("[Stress][Animation] Sampling a 150 bone rig forward") {
+	const int bone_count = 150;
+	const double length = 2.0;
+	const int keys_per_second = 30;
+
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(length);
+	for (int bone = 0; bone < bone_count; bone++) {
+		String path = vformat("Skeleton3D:bone_%d", bone);
+		const int position_track = animation->add_track(Animation::TYPE_POSITION_3D);
+		animation->track_set_path(position_track, NodePath(path));
+		const int rotation_track = animation->add_track(Animation::TYPE_ROTATION_3D);
+		animation->track_set_path(rotation_track, NodePath(path));
+		const int scale_track = animation->add_track(Animation::TYPE_SCALE_3D);
+		animation->track_set_path(scale_track, NodePath(path));
+		for (int key = 0; key <= length * keys_per_second; key++) {
+			double time = double(key) / keys_per_second;
+			real_t phase = time * 3.0 + bone * 0.1;
+			animation->position_track_insert_key(position_track, time, Vector3(Math::sin(phase), Math::cos(phase), bone * 0.05));
+			animation->rotation_track_insert_key(rotation_track, time, Quaternion::from_euler(Vector3(phase, phase * 0.5, 0.0)));
+			animation->scale_track_insert_key(scale_track, time, Vector3(1, 1, 1) * (1.0 + 0.1 * Math::sin(phase)));
+		}
+	}
+
+	// 100 seconds of playback at 60 FPS.
+	const int frame_count = 6000;
+	Animation::TransformTrackSamples plain_samples;
+	Animation::TransformTrackSamples cursor_samples;
+	Animation::KeyCursor cursor;
+	uint64_t plain_usec = 0;
+	uint64_t cursor_usec = 0;
+	bool matches = true;
+
+	for (int frame = 0; frame < frame_count; frame++) {
+		double time = Math::fmod(frame / 60.0, length);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		animation->sample_transform_tracks(time, plain_samples);
+		uint64_t middle = OS::get_singleton()->get_ticks_usec();
+		animation->sample_transform_tracks(time, cursor_samples, false, &cursor);
+		uint64_t end = OS::get_singleton()->get_ticks_usec();
+		plain_usec += middle - begin;
+		cursor_usec += end - middle;
+
+		for (int i = 0; i < animation->get_track_count(); i++) {
+			if (plain_samples.positions[i] != cursor_samples.positions[i] || plain_samples.rotations[i] != cursor_samples.rotations[i] || plain_samples.scales[i] != cursor_samples.scales[i]) {
+				matches = false;
+			}
+		}
+	}
+
+	CHECK_MESSAGE(matches, "Sampling with a cursor should give the same poses as sampling without one.");
+	MESSAGE("Sampled ", frame_count, " frames of ", bone_count, " bones in ", plain_usec / 1000, " ms without cursors and ", cursor_usec / 1000, " ms with cursors.");
+}
+
 } // namespace TestAnimation
 
 #endif // TEST_ANIMATION_H
@@ -0,0 +1,437 @@
+/**************************************************************************/
+/*  test_animation_mixer.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_ANIMATION_MIXER_H
+#define TEST_ANIMATION_MIXER_H
+
+#include "core/os/os.h"
+#include "scene/3d/camera_3d.h"
+#include "scene/3d/node_3d.h"
+#include "scene/3d/skeleton_3d.h"
+#include "scene/3d/visible_on_screen_notifier_3d.h"
+#include "scene/animation/animation_player.h"
+#include "scene/main/window.h"
+#include "scene/resources/animation.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAnimationMixer {
+
+class MethodCallRecorder : public Node {
+	GDCLASS(MethodCallRecorder, Node);
+
+protected:
+	static void _bind_methods() {
+		ClassDB::bind_method(D_METHOD("record", "name"), &MethodCallRecorder::record);
+	}
+
+public:
+	PackedStringArray calls;
+
+	void record(const String &p_name) {
+		calls.push_back(p_name);
+	}
+};
+
+// Moves and rotates "Target", and calls record() on "../Recorder" with the character name at 0.05 seconds.
+static Ref<Animation> create_character_animation(const String &p_name) {
+	Ref<Animation> animation;
+	animation.instantiate();
+	animation->set_length(1.0);
+
+	int position_track = animation->add_track(Animation::TYPE_POSITION_3D);
+	animation->track_set_path(position_track, NodePath("Target"));
+	animation->position_track_insert_key(position_track, 0.0, Vector3());
+	animation->position_track_insert_key(position_track, 1.0, Vector3(10, -4, 2));
+
+	int rotation_track = animation->add_track(Animation::TYPE_ROTATION_3D);
+	animation->track_set_path(rotation_track, NodePath("Target"));
+	animation->rotation_track_insert_key(rotation_track, 0.0, Quaternion());
+	animation->rotation_track_insert_key(rotation_track, 1.0, Quaternion(Vector3(0, 1, 0), Math_PI * 0.75));
+
+	int method_track = animation->add_track(Animation::TYPE_METHOD);
+	animation->track_set_path(method_track, NodePath("../Recorder"));
+	Dictionary key;
+	key["method"] = "record";
+	Array args;
+	args.push_back(p_name);
+	key["args"] = args;
+	animation->track_insert_key(method_track, 0.05, key);
+
+	return animation;
+}
+
+struct Character {
+	Node3D *root = nullptr;
+	Node3D *target = nullptr;
+	AnimationPlayer *player = nullptr;
+};
+
+static Character add_character(Node *p_scene, const String &p_name, bool p_parallel) {
+	Character character;
+	character.root = memnew(Node3D);
+	character.root->set_name(p_name);
+	p_scene->add_child(character.root);
+
+	character.target = memnew(Node3D);
+	character.target->set_name("Target");
+	character.root->add_child(character.target);
+
+	Ref<AnimationLibrary> library;
+	library.instantiate();
+	library->add_animation("move", create_character_animation(p_name));
+
+	character.player = memnew(AnimationPlayer);
+	character.player->set_callback_mode_method(AnimationMixer::ANIMATION_CALLBACK_MODE_METHOD_IMMEDIATE);
+	character.player->set_parallel_evaluation(p_parallel);
+	character.player->add_animation_library("", library);
+	character.root->add_child(character.player);
+	character.player->play("move");
+
+	return character;
+}
+
+TEST_CASE("[SceneTree][AnimationMixer] Parallel evaluation") {
+	GDREGISTER_CLASS(MethodCallRecorder);
+
+	Node *scene = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(scene);
+
+	MethodCallRecorder *recorder = memnew(MethodCallRecorder);
+	recorder->set_name("Recorder");
+	scene->add_child(recorder);
+
+	SUBCASE("Poses match serial evaluation") {
+		const int character_count = 4;
+		Vector<Character> serial;
+		Vector<Character> parallel;
+		for (int i = 0; i < character_count; i++) {
+			serial.push_back(add_character(scene, vformat("Serial%d", i), false));
+			parallel.push_back(add_character(scene, vformat("Parallel%d", i), true));
+		}
+
+		for (int frame = 0; frame < 5; frame++) {
+			SceneTree::get_singleton()->process(0.1);
+
+			for (int i = 0; i < character_count; i++) {
+				const Transform3D &serial_transform = serial[i].target->get_transform();
+				const Transform3D &parallel_transform = parallel[i].target->get_transform();
+				CHECK_MESSAGE(parallel_transform.is_equal_approx(serial_transform), vformat("Frame %d, character %d should have the same pose in both modes.", frame, i));
+			}
+		}
+		// Make sure the animation actually moved the targets.
+		CHECK_FALSE(parallel[0].target->get_position().is_zero_approx());
+	}
+
+	SUBCASE("Method tracks fire in queue order") {
+		add_character(scene, "First", true);
+		add_character(scene, "Second", true);
+		add_character(scene, "Third", true);
+
+		// The first frame only starts playback, the second one passes the method key.
+		SceneTree::get_singleton()->process(0.1);
+		SceneTree::get_singleton()->process(0.1);
+
+		REQUIRE(recorder->calls.size() == 3);
+		CHECK(recorder->calls[0] == "First");
+		CHECK(recorder->calls[1] == "Second");
+		CHECK(recorder->calls[2] == "Third");
+	}
+
+	memdelete(scene);
+}
+
+TEST_CASE("[Stress][SceneTree][AnimationMixer] Evaluating a crowd of 500 characters") {
+	GDREGISTER_CLASS(MethodCallRecorder);
+
+	const int character_count = 500;
+	// Stays within the one second animation, so every frame evaluates all the characters.
+	const int frame_count = 60;
+
+	uint64_t usec[2] = {};
+	for (int mode = 0; mode < 2; mode++) {
+		bool parallel = mode == 1;
+
+		Node *scene = memnew(Node);
+		SceneTree::get_singleton()->get_root()->add_child(scene);
+
+		MethodCallRecorder *recorder = memnew(MethodCallRecorder);
+		recorder->set_name("Recorder");
+		scene->add_child(recorder);
+
+		for (int i = 0; i < character_count; i++) {
+			add_character(scene, vformat("Character%d", i), parallel);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int frame = 0; frame < frame_count; frame++) {
+			SceneTree::get_singleton()->process(0.016);
+		}
+		usec[mode] = OS::get_singleton()->get_ticks_usec() - begin;
+
+		CHECK(recorder->calls.size() == character_count);
+
+		memdelete(scene);
+	}
+
+	MESSAGE(character_count, " characters over ", frame_count, " frames, serial: ", usec[0], " usec, parallel: ", usec[1], " usec.");
+}
+
+TEST_CASE("[SceneTree][AnimationMixer] Update rate level of detail") {
+	Window *root = SceneTree::get_singleton()->get_root();
+
+	Camera3D *camera = memnew(Camera3D);
+	root->add_child(camera);
+	camera->make_current();
+
+	// 25 units from the camera, so one update every 3 frames with a LOD distance of 10.
+	Node3D *character = memnew(Node3D);
+	character->set_position(Vector3(0, 0, -25));
+	root->add_child(character);
+
+	Node3D *target = memnew(Node3D);
+	target->set_name("Target");
+	character->add_child(target);
+
+	// Moves "Target" along X at 10 units per second.
+	Ref<Animation> animation;
+	animation.instantiate();
+	animation->set_length(10.0);
+	int position_track = animation->add_track(Animation::TYPE_POSITION_3D);
+	animation->track_set_path(position_track, NodePath("Target"));
+	animation->position_track_insert_key(position_track, 0.0, Vector3());
+	animation->position_track_insert_key(position_track, 10.0, Vector3(100, 0, 0));
+
+	Ref<AnimationLibrary> library;
+	library.instantiate();
+	library->add_animation("move", animation);
+
+	AnimationPlayer *player = memnew(AnimationPlayer);
+	player->add_animation_library("", library);
+	player->set_lod_enabled(true);
+	player->set_lod_distance(10.0);
+	player->set_lod_max_interval(4);
+
+	SUBCASE("Skipped frames interpolate the previous update with one interval of latency") {
+		character->add_child(player);
+		player->play("move");
+
+		// The first frame only starts playback, the next update is 3 frames later and covers all 3 of them.
+		// From then on, the pose lags one interval behind and is interpolated in between.
+		const real_t expected_x[] = { 0, 0, 0, 0, 1, 2, 3, 4, 5, 6 };
+		int frame = 0;
+		for (real_t x : expected_x) {
+			SceneTree::get_singleton()->process(0.1);
+			CHECK(player->get_lod_interval() == 3);
+			CHECK_MESSAGE(target->get_position().x == doctest::Approx(x), vformat("Unexpected pose on frame %d.", frame));
+			frame++;
+		}
+	}
+
+	SUBCASE("No interpolation holds the pose of the last update") {
+		player->set_lod_interpolate(false);
+		character->add_child(player);
+		player->play("move");
+
+		const real_t expected_x[] = { 0, 0, 0, 3, 3, 3, 6 };
+		int frame = 0;
+		for (real_t x : expected_x) {
+			SceneTree::get_singleton()->process(0.1);
+			CHECK_MESSAGE(target->get_position().x == doctest::Approx(x), vformat("Unexpected pose on frame %d.", frame));
+			frame++;
+		}
+	}
+
+	SUBCASE("The interval follows the distance to the camera") {
+		character->add_child(player);
+		player->play("move");
+
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(player->get_lod_interval() == 3);
+
+		// Takes effect on the next update.
+		character->set_position(Vector3(0, 0, -5));
+		SceneTree::get_singleton()->process(0.1);
+		SceneTree::get_singleton()->process(0.1);
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(player->get_lod_interval() == 1);
+
+		character->set_position(Vector3(0, 0, -500));
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(player->get_lod_interval() == 4);
+
+		player->set_lod_enabled(false);
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(player->get_lod_interval() == 1);
+	}
+
+	SUBCASE("Root motion is only reported once per update") {
+		player->set_root_motion_track(NodePath("Target"));
+		character->add_child(player);
+		player->play("move");
+
+		const real_t expected_motion_x[] = { 0, 0, 0, 3, 0, 0, 3 };
+		real_t total_motion_x = 0;
+		int frame = 0;
+		for (real_t expected : expected_motion_x) {
+			SceneTree::get_singleton()->process(0.1);
+			real_t motion_x = player->get_root_motion_position().x;
+			CHECK_MESSAGE(motion_x == doctest::Approx(expected), vformat("Unexpected root motion on frame %d.", frame));
+			total_motion_x += motion_x;
+			frame++;
+		}
+		// Same as evaluating every frame.
+		CHECK(total_motion_x == doctest::Approx(6.0));
+		// The root motion track isn't applied to its node.
+		CHECK(target->get_position().is_zero_approx());
+	}
+
+	SUBCASE("Bones deeper than the maximum depth are frozen while throttled") {
+		Skeleton3D *skeleton = memnew(Skeleton3D);
+		skeleton->set_name("Skeleton");
+		character->add_child(skeleton);
+		int root_bone = skeleton->add_bone("Root");
+		int middle_bone = skeleton->add_bone("Middle");
+		skeleton->set_bone_parent(middle_bone, root_bone);
+		int deep_bone = skeleton->add_bone("Deep");
+		skeleton->set_bone_parent(deep_bone, middle_bone);
+
+		int root_track = animation->add_track(Animation::TYPE_POSITION_3D);
+		animation->track_set_path(root_track, NodePath("Skeleton:Root"));
+		animation->position_track_insert_key(root_track, 0.0, Vector3());
+		animation->position_track_insert_key(root_track, 10.0, Vector3(100, 0, 0));
+		int deep_track = animation->add_track(Animation::TYPE_POSITION_3D);
+		animation->track_set_path(deep_track, NodePath("Skeleton:Deep"));
+		animation->position_track_insert_key(deep_track, 0.0, Vector3());
+		animation->position_track_insert_key(deep_track, 10.0, Vector3(0, 100, 0));
+
+		player->set_lod_max_bone_depth(1);
+		character->add_child(player);
+		player->play("move");
+
+		for (int frame = 0; frame < 7; frame++) {
+			SceneTree::get_singleton()->process(0.1);
+		}
+		CHECK(player->get_lod_interval() == 3);
+		CHECK(skeleton->get_bone_pose_position(root_bone).x > 0);
+		CHECK_MESSAGE(skeleton->get_bone_pose_position(deep_bone).is_zero_approx(), "The deep bone should not be updated while the interval is above one.");
+
+		// Once close enough to update every frame, the deep bone catches up with the animation.
+		character->set_position(Vector3(0, 0, -5));
+		for (int frame = 0; frame < 4; frame++) {
+			SceneTree::get_singleton()->process(0.1);
+		}
+		CHECK(player->get_lod_interval() == 1);
+		CHECK(skeleton->get_bone_pose_position(deep_bone).y > 0);
+	}
+
+	SUBCASE("An off-screen notifier uses the off-screen interval") {
+		// Nothing is drawn while testing, so the notifier never reports being on screen.
+		VisibleOnScreenNotifier3D *notifier = memnew(VisibleOnScreenNotifier3D);
+		notifier->set_name("Notifier");
+		character->add_child(notifier);
+
+		player->set_lod_offscreen_interval(6);
+		player->set_lod_visibility_notifier(NodePath("../Notifier"));
+		character->add_child(player);
+		player->play("move");
+
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(player->get_lod_interval() == 6);
+
+		// Being close to the camera doesn't matter while off screen.
+		character->set_position(Vector3(0, 0, -5));
+		for (int frame = 0; frame < 6; frame++) {
+			SceneTree::get_singleton()->process(0.1);
+		}
+		CHECK(player->get_lod_interval() == 6);
+
+		// Without a notifier, the interval follows the distance again.
+		player->set_lod_visibility_notifier(NodePath());
+		for (int frame = 0; frame < 6; frame++) {
+			SceneTree::get_singleton()->process(0.1);
+		}
+		CHECK(player->get_lod_interval() == 1);
+	}
+
+	memdelete(character);
+	memdelete(camera);
+}
+
+TEST_CASE("[Stress][SceneTree][AnimationMixer] Throttling a crowd of 1000 characters") {
+	GDREGISTER_CLASS(MethodCallRecorder);
+
+	Window *root = SceneTree::get_singleton()->get_root();
+
+	Camera3D *camera = memnew(Camera3D);
+	root->add_child(camera);
+	camera->make_current();
+
+	const int character_count = 1000;
+	// Stays within the one second animation, so no character stops playing.
+	const int frame_count = 60;
+
+	uint64_t usec[2] = {};
+	for (int mode = 0; mode < 2; mode++) {
+		bool lod = mode == 1;
+
+		Node *scene = memnew(Node);
+		root->add_child(scene);
+
+		MethodCallRecorder *recorder = memnew(MethodCallRecorder);
+		recorder->set_name("Recorder");
+		scene->add_child(recorder);
+
+		// A crowd stretching up to 200 units away from the camera.
+		for (int i = 0; i < character_count; i++) {
+			Character character = add_character(scene, vformat("Character%d", i), false);
+			character.root->set_position(Vector3((i % 20) * 2 - 20, 0, -(i / 20) * 4.0));
+			character.player->set_lod_enabled(lod);
+			character.player->set_lod_distance(10.0);
+			character.player->set_lod_max_interval(8);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int frame = 0; frame < frame_count; frame++) {
+			SceneTree::get_singleton()->process(0.016);
+		}
+		usec[mode] = OS::get_singleton()->get_ticks_usec() - begin;
+
+		memdelete(scene);
+	}
+
+	MESSAGE(character_count, " characters over ", frame_count, " frames, every frame: ", usec[0], " usec, with level of detail: ", usec[1], " usec.");
+
+	memdelete(camera);
+}
+
+} // namespace TestAnimationMixer
+
+#endif // TEST_ANIMATION_MIXER_H
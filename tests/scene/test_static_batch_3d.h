@@ -0,0 +1,157 @@
+/**************************************************************************/
+/*  test_static_batch_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STATIC_BATCH_3D_H
+#define TEST_STATIC_BATCH_3D_H
+
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/3d/static_batch_3d.h"
+#include "scene/main/viewport.h"
+#include "scene/main/window.h"
+#include "scene/resources/3d/primitive_meshes.h"
+#include "scene/resources/material.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStaticBatch3D {
+
+static MeshInstance3D *add_mesh_instance(Node *p_parent, const Ref<Mesh> &p_mesh, const Vector3 &p_position) {
+	MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
+	mesh_instance->set_mesh(p_mesh);
+	mesh_instance->set_position(p_position);
+	mesh_instance->set_gi_mode(GeometryInstance3D::GI_MODE_DISABLED);
+	p_parent->add_child(mesh_instance);
+	return mesh_instance;
+}
+
+// Only instances the RenderingServer would draw are found.
+static bool is_drawn(const MeshInstance3D *p_mesh_instance) {
+	Vector<ObjectID> drawn = RS::get_singleton()->instances_cull_aabb(AABB(Vector3(-1000, -1000, -1000), Vector3(2000, 2000, 2000)), p_mesh_instance->get_world_3d()->get_scenario());
+	return drawn.has(p_mesh_instance->get_instance_id());
+}
+
+TEST_CASE("[SceneTree][StaticBatch3D] Merging mesh instances") {
+	Ref<StandardMaterial3D> material;
+	material.instantiate();
+	Ref<BoxMesh> box;
+	box.instantiate();
+	box->set_material(material);
+
+	Ref<StandardMaterial3D> other_material;
+	other_material.instantiate();
+	Ref<BoxMesh> other_box;
+	other_box.instantiate();
+	other_box->set_material(other_material);
+
+	StaticBatch3D *batch = memnew(StaticBatch3D);
+	batch->set_generate_lods(false);
+
+	// Same material and cell, merged together.
+	MeshInstance3D *first = add_mesh_instance(batch, box, Vector3(0, 0, 0));
+	MeshInstance3D *second = add_mesh_instance(batch, box, Vector3(2, 0, 0));
+	// Another material, and another cell.
+	MeshInstance3D *other = add_mesh_instance(batch, other_box, Vector3(0, 2, 0));
+	MeshInstance3D *far = add_mesh_instance(batch, box, Vector3(100, 0, 0));
+
+	// Left alone.
+	MeshInstance3D *static_gi = add_mesh_instance(batch, box, Vector3(0, 0, 2));
+	static_gi->set_gi_mode(GeometryInstance3D::GI_MODE_STATIC);
+	MeshInstance3D *shader_parameter = add_mesh_instance(batch, box, Vector3(0, 0, 4));
+	ERR_PRINT_OFF;
+	shader_parameter->set_instance_shader_parameter("tint", Color(1, 0, 0));
+	ERR_PRINT_ON;
+	SubViewport *viewport = memnew(SubViewport);
+	batch->add_child(viewport);
+	MeshInstance3D *in_viewport = add_mesh_instance(viewport, box, Vector3(0, 0, 6));
+
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	SUBCASE("Sources are grouped and hidden") {
+		CHECK(batch->get_source_instance_count() == 4);
+		CHECK(batch->get_batch_instance_count() == 3);
+
+		CHECK(first->is_batched());
+		CHECK(second->is_batched());
+		CHECK(other->is_batched());
+		CHECK(far->is_batched());
+		CHECK_FALSE(static_gi->is_batched());
+		CHECK_FALSE(shader_parameter->is_batched());
+		CHECK_FALSE(in_viewport->is_batched());
+
+		CHECK_FALSE(is_drawn(first));
+		CHECK_FALSE(is_drawn(far));
+		CHECK(is_drawn(static_gi));
+		CHECK(is_drawn(shader_parameter));
+	}
+
+	SUBCASE("Changing visibility doesn't show batched sources") {
+		first->hide();
+		first->show();
+		CHECK_FALSE(is_drawn(first));
+
+		batch->hide();
+		batch->show();
+		CHECK_FALSE(is_drawn(first));
+		CHECK_FALSE(is_drawn(second));
+	}
+
+	SUBCASE("Clearing restores the sources' visibility") {
+		second->hide();
+		batch->clear();
+
+		CHECK(batch->get_source_instance_count() == 0);
+		CHECK(batch->get_batch_instance_count() == 0);
+		CHECK_FALSE(first->is_batched());
+		CHECK(is_drawn(first));
+		CHECK_MESSAGE(!is_drawn(second), "Sources hidden while batched should stay hidden.");
+		CHECK(is_drawn(far));
+
+		batch->rebuild();
+		CHECK(batch->get_source_instance_count() == 3);
+		CHECK_FALSE(is_drawn(first));
+	}
+
+	SUBCASE("Leaving the tree restores the sources, entering it batches them again") {
+		SceneTree::get_singleton()->get_root()->remove_child(batch);
+		CHECK(batch->get_batch_instance_count() == 0);
+		CHECK_FALSE(first->is_batched());
+
+		SceneTree::get_singleton()->get_root()->add_child(batch);
+		CHECK(batch->get_batch_instance_count() == 3);
+		CHECK(first->is_batched());
+		CHECK_FALSE(is_drawn(first));
+	}
+
+	memdelete(batch);
+}
+
+} // namespace TestStaticBatch3D
+
+#endif // TEST_STATIC_BATCH_3D_H
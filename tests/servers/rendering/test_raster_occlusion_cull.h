@@ -0,0 +1,127 @@
+/**************************************************************************/
+/*  test_raster_occlusion_cull.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RASTER_OCCLUSION_CULL_H
+#define TEST_RASTER_OCCLUSION_CULL_H
+
+#include "servers/rendering/raster_occlusion_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRasterOcclusionCull {
+
+class OccluderQuadBuffer {
+	bool jitter_was_enabled = false;
+
+public:
+	RasterOcclusionCull::RasterHZBuffer buffer;
+	Transform3D cam_transform;
+	Projection cam_projection;
+
+	OccluderQuadBuffer(const Projection &p_projection, bool p_orthogonal) {
+		// Occlusion timers would delay the results otherwise.
+		jitter_was_enabled = RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled;
+		RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = false;
+
+		// A 10x10 quad 10 units in front of a camera looking down -Z.
+		LocalVector<Vector3> vertices;
+		vertices.push_back(Vector3(-5, -5, -10));
+		vertices.push_back(Vector3(5, -5, -10));
+		vertices.push_back(Vector3(5, 5, -10));
+		vertices.push_back(Vector3(-5, 5, -10));
+		LocalVector<uint32_t> indices;
+		indices.push_back(0);
+		indices.push_back(1);
+		indices.push_back(2);
+		indices.push_back(0);
+		indices.push_back(2);
+		indices.push_back(3);
+
+		cam_projection = p_projection;
+		buffer.resize(Size2i(64, 64));
+		buffer.begin(cam_transform, cam_projection, p_orthogonal);
+		buffer.add_occluder(vertices, indices);
+		buffer.rasterize();
+	}
+
+	~OccluderQuadBuffer() {
+		RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = jitter_was_enabled;
+	}
+
+	bool is_occluded(const AABB &p_box) {
+		const Vector3 end = p_box.get_end();
+		const real_t bounds[6] = { p_box.position.x, p_box.position.y, p_box.position.z, end.x, end.y, end.z };
+		uint64_t occlusion_timeout = 0;
+		return buffer.is_occluded(bounds, cam_transform.origin, cam_transform.affine_inverse(), cam_projection, cam_projection.get_z_near(), occlusion_timeout);
+	}
+};
+
+TEST_CASE("[RasterOcclusionCull] Boxes behind a rasterized occluder are culled") {
+	SUBCASE("Perspective camera") {
+		OccluderQuadBuffer quad(Projection::create_perspective(90, 1, 0.05, 100), false);
+
+		CHECK_MESSAGE(quad.is_occluded(AABB(Vector3(-0.5, -0.5, -20.5), Vector3(1, 1, 1))),
+				"A box centered behind the occluder should be culled.");
+		CHECK_MESSAGE(quad.is_occluded(AABB(Vector3(-8, -8, -40), Vector3(16, 16, 2))),
+				"A box hidden behind the occluder by perspective should be culled.");
+		CHECK_FALSE_MESSAGE(quad.is_occluded(AABB(Vector3(-0.5, -0.5, -5.5), Vector3(1, 1, 1))),
+				"A box in front of the occluder should be visible.");
+		CHECK_FALSE_MESSAGE(quad.is_occluded(AABB(Vector3(14.5, -0.5, -20.5), Vector3(1, 1, 1))),
+				"A box beside the occluder should be visible.");
+		CHECK_FALSE_MESSAGE(quad.is_occluded(AABB(Vector3(8, -0.5, -20.5), Vector3(4, 1, 1))),
+				"A box straddling the edge of the occluder should be visible.");
+		CHECK_FALSE_MESSAGE(quad.is_occluded(AABB(Vector3(-0.5, -0.5, -12), Vector3(1, 1, 4))),
+				"A box crossing the occluder should be visible.");
+	}
+
+	SUBCASE("Orthogonal camera") {
+		OccluderQuadBuffer quad(Projection::create_orthogonal(-20, 20, -20, 20, 0.05, 100), true);
+
+		CHECK_MESSAGE(quad.is_occluded(AABB(Vector3(-4, -4, -60), Vector3(8, 8, 1))),
+				"A box behind the occluder should be culled.");
+		CHECK_FALSE_MESSAGE(quad.is_occluded(AABB(Vector3(-0.5, -0.5, -5.5), Vector3(1, 1, 1))),
+				"A box in front of the occluder should be visible.");
+		CHECK_FALSE_MESSAGE(quad.is_occluded(AABB(Vector3(-8, -8, -60), Vector3(16, 16, 1))),
+				"A box larger than the occluder should be visible.");
+	}
+
+	SUBCASE("Empty buffer") {
+		OccluderQuadBuffer quad(Projection::create_perspective(90, 1, 0.05, 100), false);
+		quad.buffer.begin(quad.cam_transform, quad.cam_projection, false);
+		quad.buffer.rasterize();
+
+		CHECK_FALSE_MESSAGE(quad.is_occluded(AABB(Vector3(-0.5, -0.5, -20.5), Vector3(1, 1, 1))),
+				"Nothing should be culled once the occluders are gone.");
+	}
+}
+
+} // namespace TestRasterOcclusionCull
+
+#endif // TEST_RASTER_OCCLUSION_CULL_H
@@ -0,0 +1,332 @@
+/**************************************************************************/
+/*  test_renderer_canvas_cull.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_CANVAS_CULL_H
+#define TEST_RENDERER_CANVAS_CULL_H
+
+#include "core/os/os.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererCanvasCull {
+
+class CanvasTree {
+	struct ExpectedItem {
+		RID item;
+		int z = 0;
+	};
+
+	Vector<RID> items;
+	LocalVector<ExpectedItem> expected; // In tree order, before sorting by Z.
+
+	RID _create_item(RID p_parent, const Vector2 &p_position, int p_z, bool p_visible, int p_parent_z) {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		RID item = rs->canvas_item_create();
+		rs->canvas_item_set_parent(item, p_parent);
+		rs->canvas_item_set_transform(item, Transform2D(0, p_position));
+		rs->canvas_item_set_z_index(item, p_z);
+		rs->canvas_item_add_rect(item, Rect2(0, 0, 4, 4), Color(1, 1, 1));
+		items.push_back(item);
+		if (p_visible) {
+			expected.push_back({ item, p_parent_z + p_z });
+		}
+		return item;
+	}
+
+public:
+	RID canvas;
+	Vector<RID> roots;
+
+	// Enough subtrees to be culled on worker threads, some of them off screen or on another Z layer.
+	CanvasTree(int p_root_count, int p_child_count, int p_grandchild_count) {
+		canvas = RenderingServer::get_singleton()->canvas_create();
+		for (int i = 0; i < p_root_count; i++) {
+			RID root = _create_item(canvas, Vector2(i * 100, 0), 0, true, 0);
+			roots.push_back(root);
+			for (int j = 0; j < p_child_count; j++) {
+				const int child_z = j % 5 == 4 ? -1 : 0;
+				RID child = _create_item(root, Vector2(j * 5, 10), child_z, true, 0);
+				for (int k = 0; k < p_grandchild_count; k++) {
+					const bool off_screen = k % 4 == 3;
+					_create_item(child, off_screen ? Vector2(5000, 0) : Vector2(k, 1), k % 4 == 2 ? 1 : 0, !off_screen, child_z);
+				}
+			}
+		}
+	}
+
+	~CanvasTree() {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		for (int i = items.size() - 1; i >= 0; i--) {
+			rs->free(items[i]);
+		}
+		rs->free(canvas);
+	}
+
+	// Renders the canvas, and returns whether the draw list matches the items in tree order, stably sorted by Z.
+	bool check_draw_list() {
+		RendererCanvasCull *canvas_cull = RSG::canvas;
+		canvas_cull->render_canvas(RID(), canvas_cull->canvas_owner.get_or_null(canvas), Transform2D(), nullptr, nullptr, Rect2(0, 0, 1000, 1000), RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false, 0xFFFFFFFF);
+
+		LocalVector<ExpectedItem> sorted;
+		for (int z = RS::CANVAS_ITEM_Z_MIN; z <= RS::CANVAS_ITEM_Z_MAX; z++) {
+			for (const ExpectedItem &expected_item : expected) {
+				if (expected_item.z == z) {
+					sorted.push_back(expected_item);
+				}
+			}
+		}
+
+		// Items are chained through their next pointers, starting from the first one drawn.
+		const RendererCanvasRender::Item *drawn = canvas_cull->canvas_item_owner.get_or_null(sorted[0].item);
+		for (const ExpectedItem &expected_item : sorted) {
+			if (drawn != canvas_cull->canvas_item_owner.get_or_null(expected_item.item) || drawn->z_final != expected_item.z) {
+				return false;
+			}
+			drawn = drawn->next;
+		}
+		return drawn == nullptr;
+	}
+};
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Culling subtrees keeps the draw order") {
+	SUBCASE("Small tree") {
+		CanvasTree tree(2, 3, 4);
+		CHECK(tree.check_draw_list());
+	}
+
+	SUBCASE("Large tree") {
+		CanvasTree tree(8, 16, 8);
+		CHECK(tree.check_draw_list());
+		// Culling again must not chain items from the previous frame.
+		CHECK(tree.check_draw_list());
+	}
+
+	SUBCASE("Large tree with spatial indices") {
+		CanvasTree tree(8, 16, 8);
+		for (const RID &root : tree.roots) {
+			RenderingServer::get_singleton()->canvas_item_set_use_spatial_index(root, true);
+		}
+		CHECK(tree.check_draw_list());
+	}
+}
+
+TEST_CASE("[Stress][SceneTree][RendererCanvasCull] Culling 35000 canvas items") {
+	RendererCanvasCull *canvas_cull = RSG::canvas;
+	const uint32_t threaded_cull_minimum_jobs = canvas_cull->threaded_cull_minimum_jobs;
+
+	CanvasTree tree(32, 64, 16);
+	const int frame_count = 50;
+
+	uint64_t usec[2] = {};
+	for (int mode = 0; mode < 2; mode++) {
+		canvas_cull->threaded_cull_minimum_jobs = mode == 0 ? UINT32_MAX : threaded_cull_minimum_jobs;
+		CHECK(tree.check_draw_list());
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int frame = 0; frame < frame_count; frame++) {
+			canvas_cull->render_canvas(RID(), canvas_cull->canvas_owner.get_or_null(tree.canvas), Transform2D(), nullptr, nullptr, Rect2(0, 0, 1000, 1000), RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false, 0xFFFFFFFF);
+		}
+		usec[mode] = OS::get_singleton()->get_ticks_usec() - begin;
+	}
+	canvas_cull->threaded_cull_minimum_jobs = threaded_cull_minimum_jobs;
+
+	MESSAGE("Canvas culling over ", frame_count, " frames, single thread: ", usec[0], " usec, worker threads: ", usec[1], " usec.");
+}
+
+// The same items on two canvases, one of them with a spatial index on its root.
+class IndexedCanvasPair {
+	struct Canvas {
+		RID canvas;
+		RID root;
+		Vector<RID> children;
+		HashMap<const RendererCanvasRender::Item *, int> item_indices;
+	};
+
+	Canvas linear;
+	Canvas indexed;
+
+	void _create(Canvas &r_canvas, int p_child_count, bool p_spatial_index) {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		RendererCanvasCull *canvas_cull = RSG::canvas;
+		r_canvas.canvas = rs->canvas_create();
+		r_canvas.root = rs->canvas_item_create();
+		rs->canvas_item_set_parent(r_canvas.root, r_canvas.canvas);
+		rs->canvas_item_add_rect(r_canvas.root, Rect2(0, 0, 4, 4), Color(1, 1, 1));
+		rs->canvas_item_set_use_spatial_index(r_canvas.root, p_spatial_index);
+		r_canvas.item_indices.insert(canvas_cull->canvas_item_owner.get_or_null(r_canvas.root), -1);
+
+		for (int i = 0; i < p_child_count; i++) {
+			RID child = rs->canvas_item_create();
+			rs->canvas_item_set_parent(child, r_canvas.root);
+			rs->canvas_item_add_rect(child, Rect2(0, 0, 20, 10), Color(1, 1, 1));
+			rs->canvas_item_set_z_index(child, i % 6 == 5 ? 1 : 0);
+			r_canvas.children.push_back(child);
+			r_canvas.item_indices.insert(canvas_cull->canvas_item_owner.get_or_null(child), i);
+		}
+	}
+
+	void _free(Canvas &r_canvas) {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		for (const RID &child : r_canvas.children) {
+			rs->free(child);
+		}
+		rs->free(r_canvas.root);
+		rs->free(r_canvas.canvas);
+	}
+
+	Vector<int> _render(const Canvas &p_canvas) {
+		RendererCanvasCull *canvas_cull = RSG::canvas;
+		canvas_cull->render_canvas(RID(), canvas_cull->canvas_owner.get_or_null(p_canvas.canvas), Transform2D(), nullptr, nullptr, Rect2(0, 0, 1000, 1000), RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false, 0xFFFFFFFF);
+
+		// The root is always drawn first: it's in view, and on the lowest Z of the canvas.
+		Vector<int> drawn;
+		for (const RendererCanvasRender::Item *item = canvas_cull->canvas_item_owner.get_or_null(p_canvas.root); item; item = item->next) {
+			const int *index = p_canvas.item_indices.getptr(item);
+			drawn.push_back(index ? *index : -2);
+		}
+		return drawn;
+	}
+
+public:
+	int child_count = 0;
+
+	IndexedCanvasPair(int p_child_count) {
+		child_count = p_child_count;
+		_create(linear, p_child_count, false);
+		_create(indexed, p_child_count, true);
+	}
+
+	~IndexedCanvasPair() {
+		_free(indexed);
+		_free(linear);
+	}
+
+	void set_transform(int p_child, const Transform2D &p_transform) {
+		RenderingServer::get_singleton()->canvas_item_set_transform(linear.children[p_child], p_transform);
+		RenderingServer::get_singleton()->canvas_item_set_transform(indexed.children[p_child], p_transform);
+	}
+
+	void set_interpolated(int p_child, const Transform2D &p_prev, const Transform2D &p_curr) {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		for (const RID &child : { linear.children[p_child], indexed.children[p_child] }) {
+			rs->canvas_item_set_interpolated(child, true);
+			rs->canvas_item_set_transform(child, p_prev);
+			rs->canvas_item_reset_physics_interpolation(child);
+			rs->canvas_item_set_transform(child, p_curr);
+		}
+	}
+
+	// Renders both canvases, returns the drawn child indices of the linear one
+	// and whether the indexed one drew exactly the same items in the same order.
+	bool render_matches(Vector<int> &r_drawn) {
+		r_drawn = _render(linear);
+		return _render(indexed) == r_drawn;
+	}
+};
+
+// Spreads the children over a grid larger than the clip rect, around its edges, with some rotated or scaled.
+static inline Transform2D get_scattered_transform(int p_index) {
+	const Vector2 position(-200 + (p_index % 24) * 60, -200 + (p_index / 24) * 60);
+	switch (p_index % 4) {
+		case 1:
+			return Transform2D(Math_PI * 0.25 * (p_index % 8), position);
+		case 2:
+			return Transform2D(0.3, Size2(3, 0.5), 0, position);
+		default:
+			return Transform2D(0, position);
+	}
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Spatially indexed culling matches linear culling") {
+	const int child_count = 24 * 24;
+	IndexedCanvasPair pair(child_count);
+	for (int i = 0; i < child_count; i++) {
+		pair.set_transform(i, get_scattered_transform(i));
+	}
+
+	Vector<int> drawn;
+	REQUIRE(pair.render_matches(drawn));
+	// Make sure the clip rect actually culls part of the grid.
+	CHECK(drawn.size() > child_count / 4);
+	CHECK(drawn.size() < child_count);
+
+	SUBCASE("Rotated items sticking into the clip rect are drawn") {
+		// Rotated by half a turn, these extend back over the right and bottom edges.
+		pair.set_transform(0, Transform2D(Math_PI, Vector2(1015, 500)));
+		pair.set_transform(1, Transform2D(-Math_PI * 0.5, Vector2(500, 1015)));
+		CHECK(pair.render_matches(drawn));
+		CHECK(drawn.has(0));
+		CHECK(drawn.has(1));
+	}
+
+	SUBCASE("Items moved between frames are culled at their new position") {
+		for (int i = 0; i < child_count; i += 7) {
+			pair.set_transform(i, get_scattered_transform(child_count - 1 - i));
+		}
+		CHECK(pair.render_matches(drawn));
+
+		// Move them back, and out of view entirely.
+		for (int i = 0; i < child_count; i += 7) {
+			pair.set_transform(i, i % 2 ? get_scattered_transform(i) : Transform2D(0, Vector2(5000, 5000)));
+		}
+		CHECK(pair.render_matches(drawn));
+		CHECK_FALSE(drawn.has(0));
+	}
+
+	SUBCASE("Interpolated items are culled at their interpolated position") {
+		RSG::canvas->set_physics_interpolation_enabled(true);
+		// Drawn at their previous transform until the next tick, in view for even items.
+		for (int i = 0; i < 40; i++) {
+			const Transform2D inside(0.1 * i, Vector2(100 + i * 20, 500));
+			const Transform2D outside(Math_PI * 0.5 + 0.1 * i, Vector2(3000, -2000 + i * 100));
+			if (i % 2) {
+				pair.set_interpolated(i, outside, inside);
+			} else {
+				pair.set_interpolated(i, inside, outside);
+			}
+		}
+		CHECK(pair.render_matches(drawn));
+		CHECK(drawn.has(0));
+		CHECK_FALSE(drawn.has(1));
+
+		// Moving them again between frames must still match.
+		for (int i = 0; i < 40; i += 3) {
+			pair.set_interpolated(i, get_scattered_transform(i + 100), Transform2D(Math_PI * 0.75, Vector2(990, 990)));
+		}
+		CHECK(pair.render_matches(drawn));
+		RSG::canvas->set_physics_interpolation_enabled(false);
+	}
+}
+
+} // namespace TestRendererCanvasCull
+
+#endif // TEST_RENDERER_CANVAS_CULL_H
@@ -0,0 +1,235 @@
+/**************************************************************************/
+/*  test_renderer_scene_cull.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_CULL_H
+#define TEST_RENDERER_SCENE_CULL_H
+
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneCull {
+
+TEST_CASE("[SceneTree][RendererSceneCull] Block pre-culling matches the per-instance checks") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RendererSceneCull *scene_cull = static_cast<RendererSceneCull *>(RSG::scene);
+
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(4242);
+
+	// Two full blocks and a partial one.
+	const int instance_count = RendererSceneCull::CULL_BLOCK_SIZE * 2 + 22;
+
+	RID scenario = rs->scenario_create();
+	RID mesh = rs->mesh_create();
+	Vector<RID> instances;
+	for (int i = 0; i < instance_count; i++) {
+		RID instance = rs->instance_create2(mesh, scenario);
+		Vector3 position(rng->randf_range(-50, 50), rng->randf_range(-50, 50), rng->randf_range(-50, 50));
+		Vector3 size(rng->randf_range(0.1, 8), rng->randf_range(0.1, 8), rng->randf_range(0.1, 8));
+		// The dummy renderer reports empty mesh AABBs.
+		rs->instance_set_custom_aabb(instance, AABB(-size * 0.5, size));
+		rs->instance_set_transform(instance, Transform3D(Basis(), position));
+		rs->instance_set_layer_mask(instance, 1 << (i % 3));
+		if (i % 4 == 0) {
+			rs->instance_geometry_set_visibility_range(instance, 0, 30, 0, 0, RS::VISIBILITY_RANGE_FADE_DISABLED);
+		}
+		instances.push_back(instance);
+	}
+	scene_cull->update_dirty_instances();
+
+	RendererSceneCull::Scenario *scenario_data = scene_cull->scenario_owner.get_or_null(scenario);
+	REQUIRE(scenario_data != nullptr);
+	REQUIRE(scenario_data->instance_data.size() == uint64_t(instance_count));
+
+	Transform3D cam_transform;
+	cam_transform.origin = Vector3(5, 3, 40);
+	cam_transform = cam_transform.looking_at(Vector3(0, 0, 0));
+	Projection projection;
+	projection.set_perspective(75, 16.0 / 9.0, 0.05, 60);
+
+	RendererSceneCull::Cull cull;
+	cull.frustum = RendererSceneCull::Frustum(projection.get_projection_planes(cam_transform));
+
+	RendererSceneCull::CullData cull_data;
+	cull_data.cull = &cull;
+	cull_data.scenario = scenario_data;
+	cull_data.cam_transform = cam_transform;
+	cull_data.visible_layers = 1 | 2;
+	cull_data.occlusion_buffer = nullptr;
+	cull_data.camera_matrix = &projection;
+	cull_data.visibility_viewport_mask = 0;
+
+	uint8_t in_view[RendererSceneCull::CULL_BLOCK_SIZE];
+	float distance[RendererSceneCull::CULL_BLOCK_SIZE];
+	int visible_count = 0;
+	int culled_count = 0;
+	int ranged_count = 0;
+	bool matches = true;
+
+	for (uint64_t from = 0; from < uint64_t(instance_count); from += RendererSceneCull::CULL_BLOCK_SIZE) {
+		uint32_t count = MIN(uint64_t(RendererSceneCull::CULL_BLOCK_SIZE), instance_count - from);
+		scene_cull->_scene_cull_block(cull_data, from, count, in_view, distance);
+
+		for (uint32_t j = 0; j < count; j++) {
+			const RendererSceneCull::InstanceData &idata = scenario_data->instance_data[from + j];
+			bool expected_in_view = (cull_data.visible_layers & idata.layer_mask) && scenario_data->instance_aabbs[from + j].in_frustum(cull.frustum);
+			if (bool(in_view[j]) != expected_in_view) {
+				matches = false;
+			}
+			if (expected_in_view) {
+				visible_count++;
+			} else {
+				culled_count++;
+			}
+
+			if (idata.visibility_index != -1) {
+				ranged_count++;
+				float expected_distance = cam_transform.origin.distance_to(scenario_data->instance_visibility[idata.visibility_index].position);
+				if (!Math::is_equal_approx(distance[j], expected_distance)) {
+					matches = false;
+				}
+			}
+		}
+	}
+
+	CHECK_MESSAGE(matches, "The block pre-cull should agree with the layer mask, frustum and distance checks of each instance.");
+	// Make sure both branches were actually exercised.
+	CHECK(visible_count > 0);
+	CHECK(culled_count > 0);
+	CHECK(ranged_count > 0);
+
+	for (const RID &instance : instances) {
+		rs->free(instance);
+	}
+	rs->free(mesh);
+	rs->free(scenario);
+}
+
+TEST_CASE("[Stress][SceneTree][RendererSceneCull] Pre-culling 200000 foliage instances") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RendererSceneCull *scene_cull = static_cast<RendererSceneCull *>(RSG::scene);
+
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(2024);
+
+	// Small plants scattered over a 1000x1000 field. One in four has a visibility range, like grass fading out in the distance.
+	const int instance_count = 200000;
+	RID scenario = rs->scenario_create();
+	RID mesh = rs->mesh_create();
+	Vector<RID> instances;
+	for (int i = 0; i < instance_count; i++) {
+		RID instance = rs->instance_create2(mesh, scenario);
+		Vector3 position(rng->randf_range(-500, 500), 0, rng->randf_range(-500, 500));
+		rs->instance_set_custom_aabb(instance, AABB(Vector3(-0.5, 0, -0.5), Vector3(1, 1, 1)));
+		rs->instance_set_transform(instance, Transform3D(Basis(), position));
+		if (i % 4 == 0) {
+			rs->instance_geometry_set_visibility_range(instance, 0, 80, 0, 0, RS::VISIBILITY_RANGE_FADE_DISABLED);
+		}
+		instances.push_back(instance);
+	}
+	scene_cull->update_dirty_instances();
+
+	RendererSceneCull::Scenario *scenario_data = scene_cull->scenario_owner.get_or_null(scenario);
+	REQUIRE(scenario_data != nullptr);
+	REQUIRE(scenario_data->instance_data.size() == uint64_t(instance_count));
+
+	Transform3D cam_transform;
+	cam_transform.origin = Vector3(0, 2, 0);
+	cam_transform = cam_transform.looking_at(Vector3(0, 0, -50));
+	Projection projection;
+	projection.set_perspective(75, 16.0 / 9.0, 0.05, 500);
+
+	RendererSceneCull::Cull cull;
+	cull.frustum = RendererSceneCull::Frustum(projection.get_projection_planes(cam_transform));
+
+	RendererSceneCull::CullData cull_data;
+	cull_data.cull = &cull;
+	cull_data.scenario = scenario_data;
+	cull_data.cam_transform = cam_transform;
+	cull_data.visible_layers = 0xFFFFFFFF;
+	cull_data.occlusion_buffer = nullptr;
+	cull_data.camera_matrix = &projection;
+	cull_data.visibility_viewport_mask = 0;
+
+	const int pass_count = 10;
+
+	uint64_t block_visible = 0;
+	uint64_t block_begin = OS::get_singleton()->get_ticks_usec();
+	for (int pass = 0; pass < pass_count; pass++) {
+		uint8_t in_view[RendererSceneCull::CULL_BLOCK_SIZE];
+		float distance[RendererSceneCull::CULL_BLOCK_SIZE];
+		for (uint64_t from = 0; from < uint64_t(instance_count); from += RendererSceneCull::CULL_BLOCK_SIZE) {
+			uint32_t count = MIN(uint64_t(RendererSceneCull::CULL_BLOCK_SIZE), instance_count - from);
+			scene_cull->_scene_cull_block(cull_data, from, count, in_view, distance);
+			for (uint32_t j = 0; j < count; j++) {
+				block_visible += in_view[j];
+			}
+		}
+	}
+	uint64_t block_usec = OS::get_singleton()->get_ticks_usec() - block_begin;
+
+	// What each instance used to go through one by one.
+	uint64_t instance_visible = 0;
+	float distance_sum = 0;
+	uint64_t instance_begin = OS::get_singleton()->get_ticks_usec();
+	for (int pass = 0; pass < pass_count; pass++) {
+		for (uint64_t i = 0; i < uint64_t(instance_count); i++) {
+			const RendererSceneCull::InstanceData &idata = scenario_data->instance_data[i];
+			if ((cull_data.visible_layers & idata.layer_mask) && scenario_data->instance_aabbs[i].in_frustum(cull.frustum)) {
+				instance_visible++;
+				if (idata.visibility_index != -1) {
+					distance_sum += cam_transform.origin.distance_to(scenario_data->instance_visibility[idata.visibility_index].position);
+				}
+			}
+		}
+	}
+	uint64_t instance_usec = OS::get_singleton()->get_ticks_usec() - instance_begin;
+
+	CHECK(block_visible == instance_visible);
+	CHECK(distance_sum > 0);
+
+	MESSAGE("Pre-culling ", instance_count, " instances ", pass_count, " times, in blocks: ", block_usec, " usec, one by one: ", instance_usec, " usec.");
+
+	for (const RID &instance : instances) {
+		rs->free(instance);
+	}
+	rs->free(mesh);
+	rs->free(scenario);
+}
+
+} // namespace TestRendererSceneCull
+
+#endif // TEST_RENDERER_SCENE_CULL_H
@@ -0,0 +1,284 @@
+/**************************************************************************/
+/*  test_rendering_light_culler.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERING_LIGHT_CULLER_H
+#define TEST_RENDERING_LIGHT_CULLER_H
+
+#include "core/math/random_number_generator.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/rendering_light_culler.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingLightCuller {
+
+// Omni and spot lights scattered in and around the view of a fixed camera,
+// with a shared list of shadow casters to cull against each of them.
+class LightScene {
+	Vector<RID> light_rids;
+
+public:
+	Transform3D cam_transform;
+	Projection projection;
+	LocalVector<RendererSceneCull::Instance *> lights;
+	LocalVector<RendererSceneCull::Instance *> casters;
+
+	LightScene(int p_light_count, int p_caster_count, uint64_t p_seed) {
+		RenderingServer *rs = RenderingServer::get_singleton();
+
+		Ref<RandomNumberGenerator> rng;
+		rng.instantiate();
+		rng->set_seed(p_seed);
+
+		cam_transform.origin = Vector3(5, 3, 40);
+		cam_transform = cam_transform.looking_at(Vector3(0, 0, 0));
+		projection.set_perspective(75, 16.0 / 9.0, 0.05, 60);
+
+		for (int i = 0; i < p_light_count; i++) {
+			bool spot = i % 2 == 1;
+			RID light = spot ? rs->spot_light_create() : rs->omni_light_create();
+			rs->light_set_param(light, RS::LIGHT_PARAM_RANGE, rng->randf_range(2, 40));
+			if (spot) {
+				rs->light_set_param(light, RS::LIGHT_PARAM_SPOT_ANGLE, rng->randf_range(10, 80));
+			}
+			light_rids.push_back(light);
+
+			// Some lights are far enough away to be out of range of the view.
+			Vector3 position(rng->randf_range(-90, 90), rng->randf_range(-90, 90), rng->randf_range(-90, 90));
+			Vector3 target(rng->randf_range(-30, 30), rng->randf_range(-30, 30), rng->randf_range(-30, 30));
+
+			RendererSceneCull::Instance *instance = memnew(RendererSceneCull::Instance);
+			instance->base_type = RS::INSTANCE_LIGHT;
+			instance->base = light;
+			instance->transform.origin = position;
+			if (!position.is_equal_approx(target)) {
+				instance->transform = instance->transform.looking_at(target);
+			}
+			lights.push_back(instance);
+		}
+
+		for (int i = 0; i < p_caster_count; i++) {
+			Vector3 position(rng->randf_range(-80, 80), rng->randf_range(-80, 80), rng->randf_range(-80, 80));
+			Vector3 size(rng->randf_range(0.1, 6), rng->randf_range(0.1, 6), rng->randf_range(0.1, 6));
+
+			RendererSceneCull::Instance *instance = memnew(RendererSceneCull::Instance);
+			instance->base_type = RS::INSTANCE_MESH;
+			instance->transformed_aabb = AABB(position - size * 0.5, size);
+			casters.push_back(instance);
+		}
+	}
+
+	void fill(PagedArray<RendererSceneCull::Instance *> &r_array) const {
+		r_array.clear();
+		for (RendererSceneCull::Instance *caster : casters) {
+			r_array.push_back(caster);
+		}
+	}
+
+	~LightScene() {
+		for (RendererSceneCull::Instance *instance : lights) {
+			memdelete(instance);
+		}
+		for (RendererSceneCull::Instance *instance : casters) {
+			memdelete(instance);
+		}
+		for (const RID &light : light_rids) {
+			RenderingServer::get_singleton()->free(light);
+		}
+	}
+};
+
+static Vector<RendererSceneCull::Instance *> paged_array_to_vector(const PagedArray<RendererSceneCull::Instance *> &p_array) {
+	Vector<RendererSceneCull::Instance *> result;
+	for (uint64_t i = 0; i < p_array.size(); i++) {
+		result.push_back(p_array[i]);
+	}
+	return result;
+}
+
+TEST_CASE("[SceneTree][RenderingLightCuller] Stored regular lights cull the same casters as prepared ones") {
+	LightScene scene(32, 600, 1717);
+
+	PagedArrayPool<RendererSceneCull::Instance *> pool;
+	PagedArray<RendererSceneCull::Instance *> cull_result;
+	cull_result.set_page_pool(&pool);
+
+	RenderingLightCuller culler;
+	REQUIRE(culler.prepare_camera(scene.cam_transform, scene.projection));
+
+	// Cull each light straight after preparing it, then store its planes.
+	LocalVector<Vector<RendererSceneCull::Instance *>> expected;
+	LocalVector<int32_t> light_ids;
+	int partial_count = 0;
+	int empty_count = 0;
+	for (RendererSceneCull::Instance *light : scene.lights) {
+		culler.prepare_regular_light(*light);
+		scene.fill(cull_result);
+		culler.cull_regular_light(cull_result);
+		expected.push_back(paged_array_to_vector(cull_result));
+
+		if (cull_result.size() == 0) {
+			empty_count++;
+		} else if (cull_result.size() < scene.casters.size()) {
+			partial_count++;
+		}
+
+		int32_t light_id = culler.store_regular_light();
+		REQUIRE(light_id == int32_t(light_ids.size()));
+		light_ids.push_back(light_id);
+	}
+
+	// Make sure both the range check and the planes rejected something.
+	REQUIRE(partial_count > 0);
+	REQUIRE(empty_count > 0);
+
+	SUBCASE("Culling stored lights in reverse order") {
+		bool matches = true;
+		for (int i = int(light_ids.size()) - 1; i >= 0; i--) {
+			scene.fill(cull_result);
+			culler.cull_stored_regular_light(cull_result, light_ids[i]);
+			if (paged_array_to_vector(cull_result) != expected[i]) {
+				matches = false;
+			}
+		}
+		CHECK_MESSAGE(matches, "Stored lights should keep the planes and range of the light they were prepared from.");
+	}
+
+	SUBCASE("Culling stored lights from worker threads") {
+		struct CullJob {
+			const LightScene *scene = nullptr;
+			RenderingLightCuller *culler = nullptr;
+			PagedArrayPool<RendererSceneCull::Instance *> *pool = nullptr;
+			const LocalVector<int32_t> *light_ids = nullptr;
+			LocalVector<Vector<RendererSceneCull::Instance *>> results;
+
+			void cull(uint32_t p_index, void *p_userdata) {
+				PagedArray<RendererSceneCull::Instance *> array;
+				array.set_page_pool(pool);
+				scene->fill(array);
+				culler->cull_stored_regular_light(array, (*light_ids)[p_index]);
+				results[p_index] = paged_array_to_vector(array);
+			}
+		};
+
+		CullJob job;
+		job.scene = &scene;
+		job.culler = &culler;
+		job.pool = &pool;
+		job.light_ids = &light_ids;
+		job.results.resize(light_ids.size());
+
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&job, &CullJob::cull, (void *)nullptr, light_ids.size(), -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+		bool matches = true;
+		for (uint32_t i = 0; i < light_ids.size(); i++) {
+			if (job.results[i] != expected[i]) {
+				matches = false;
+			}
+		}
+		CHECK_MESSAGE(matches, "Culling stored lights concurrently should give the same casters as culling them one by one.");
+	}
+
+	SUBCASE("Preparing a new camera discards stored lights") {
+		REQUIRE(culler.prepare_camera(scene.cam_transform, scene.projection));
+		culler.prepare_regular_light(*scene.lights[0]);
+		CHECK(culler.store_regular_light() == 0);
+	}
+
+	cull_result.reset();
+}
+
+TEST_CASE("[Stress][SceneTree][RenderingLightCuller] Culling 20000 casters against 64 stored lights") {
+	LightScene scene(64, 20000, 99);
+
+	PagedArrayPool<RendererSceneCull::Instance *> pool;
+	PagedArray<RendererSceneCull::Instance *> cull_result;
+	cull_result.set_page_pool(&pool);
+
+	RenderingLightCuller culler;
+	REQUIRE(culler.prepare_camera(scene.cam_transform, scene.projection));
+
+	uint64_t serial_begin = OS::get_singleton()->get_ticks_usec();
+	uint64_t serial_casters = 0;
+	for (RendererSceneCull::Instance *light : scene.lights) {
+		culler.prepare_regular_light(*light);
+		scene.fill(cull_result);
+		culler.cull_regular_light(cull_result);
+		serial_casters += cull_result.size();
+	}
+	uint64_t serial_usec = OS::get_singleton()->get_ticks_usec() - serial_begin;
+	cull_result.reset();
+
+	struct CullJob {
+		const LightScene *scene = nullptr;
+		RenderingLightCuller *culler = nullptr;
+		PagedArrayPool<RendererSceneCull::Instance *> *pool = nullptr;
+		LocalVector<int32_t> light_ids;
+		LocalVector<uint64_t> caster_counts;
+
+		void cull(uint32_t p_index, void *p_userdata) {
+			PagedArray<RendererSceneCull::Instance *> array;
+			array.set_page_pool(pool);
+			scene->fill(array);
+			culler->cull_stored_regular_light(array, light_ids[p_index]);
+			caster_counts[p_index] = array.size();
+		}
+	};
+
+	CullJob job;
+	job.scene = &scene;
+	job.culler = &culler;
+	job.pool = &pool;
+
+	uint64_t stored_begin = OS::get_singleton()->get_ticks_usec();
+	for (RendererSceneCull::Instance *light : scene.lights) {
+		culler.prepare_regular_light(*light);
+		job.light_ids.push_back(culler.store_regular_light());
+	}
+	job.caster_counts.resize(job.light_ids.size());
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&job, &CullJob::cull, (void *)nullptr, job.light_ids.size(), -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	uint64_t stored_usec = OS::get_singleton()->get_ticks_usec() - stored_begin;
+
+	uint64_t stored_casters = 0;
+	for (uint64_t count : job.caster_counts) {
+		stored_casters += count;
+	}
+	CHECK(stored_casters == serial_casters);
+
+	MESSAGE("Light culling, prepared one by one: ", serial_usec, " usec, stored and culled in parallel: ", stored_usec, " usec (", serial_casters, " casters kept).");
+}
+
+} // namespace TestRenderingLightCuller
+
+#endif // TEST_RENDERING_LIGHT_CULLER_H
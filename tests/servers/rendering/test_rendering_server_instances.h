@@ -0,0 +1,167 @@
+/**************************************************************************/
+/*  test_rendering_server_instances.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERING_SERVER_INSTANCES_H
+#define TEST_RENDERING_SERVER_INSTANCES_H
+
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingServerInstances {
+
+struct InstanceGrid {
+	RID scenario;
+	RID mesh;
+	Vector<RID> instances;
+
+	InstanceGrid(int p_count) {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		scenario = rs->scenario_create();
+		mesh = rs->mesh_create();
+		for (int i = 0; i < p_count; i++) {
+			RID instance = rs->instance_create2(mesh, scenario);
+			// The dummy renderer reports empty mesh AABBs.
+			rs->instance_set_custom_aabb(instance, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+			rs->instance_attach_object_instance_id(instance, ObjectID(uint64_t(i + 1)));
+			instances.push_back(instance);
+		}
+	}
+
+	~InstanceGrid() {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		for (const RID &instance : instances) {
+			rs->free(instance);
+		}
+		rs->free(mesh);
+		rs->free(scenario);
+	}
+
+	Vector<ObjectID> cull_at(const Vector3 &p_position) const {
+		return RenderingServer::get_singleton()->instances_cull_aabb(AABB(p_position - Vector3(0.25, 0.25, 0.25), Vector3(0.5, 0.5, 0.5)), scenario);
+	}
+
+	bool is_at(int p_index, const Vector3 &p_position) const {
+		Vector<ObjectID> hits = cull_at(p_position);
+		return hits.size() == 1 && hits[0] == ObjectID(uint64_t(p_index + 1));
+	}
+};
+
+TEST_CASE("[SceneTree][RenderingServer] Bulk instance transforms") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+
+	SUBCASE("Every instance is moved") {
+		InstanceGrid grid(8);
+		Vector<Transform3D> transforms;
+		for (int i = 0; i < grid.instances.size(); i++) {
+			transforms.push_back(Transform3D(Basis(), Vector3(i * 10, 0, 0)));
+		}
+		rs->instances_set_transforms(grid.instances, transforms);
+
+		for (int i = 0; i < grid.instances.size(); i++) {
+			CHECK_MESSAGE(grid.is_at(i, Vector3(i * 10, 0, 0)), "Instance ", i, " should have been moved.");
+		}
+	}
+
+	SUBCASE("Large batches match individual calls") {
+		// Large enough to be split across worker threads.
+		InstanceGrid bulk(5000);
+		InstanceGrid single(5000);
+		Vector<Transform3D> transforms;
+		for (int i = 0; i < bulk.instances.size(); i++) {
+			transforms.push_back(Transform3D(Basis(Vector3(0, 1, 0), i * 0.01), Vector3(i % 100, 0, i / 100) * 2));
+			rs->instance_set_transform(single.instances[i], transforms[i]);
+		}
+		rs->instances_set_transforms(bulk.instances, transforms);
+
+		int mismatches = 0;
+		for (int i = 0; i < bulk.instances.size(); i++) {
+			if (!bulk.is_at(i, transforms[i].origin) || !single.is_at(i, transforms[i].origin)) {
+				mismatches++;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+
+	SUBCASE("The last transform wins for duplicates") {
+		InstanceGrid grid(1);
+		Vector<RID> instances;
+		instances.push_back(grid.instances[0]);
+		instances.push_back(grid.instances[0]);
+		Vector<Transform3D> transforms;
+		transforms.push_back(Transform3D(Basis(), Vector3(10, 0, 0)));
+		transforms.push_back(Transform3D(Basis(), Vector3(20, 0, 0)));
+		rs->instances_set_transforms(instances, transforms);
+
+		CHECK(grid.cull_at(Vector3(10, 0, 0)).is_empty());
+		CHECK(grid.is_at(0, Vector3(20, 0, 0)));
+
+		// Setting the current transform again followed by another one must still apply the last one.
+		transforms.write[0] = Transform3D(Basis(), Vector3(20, 0, 0));
+		transforms.write[1] = Transform3D(Basis(), Vector3(30, 0, 0));
+		rs->instances_set_transforms(instances, transforms);
+		CHECK(grid.is_at(0, Vector3(30, 0, 0)));
+	}
+
+	SUBCASE("Invalid entries are skipped") {
+		InstanceGrid grid(2);
+		Vector<RID> instances;
+		instances.push_back(grid.instances[0]);
+		instances.push_back(RID());
+		instances.push_back(grid.instances[1]);
+		Vector<Transform3D> transforms;
+		transforms.push_back(Transform3D(Basis(), Vector3(10, 0, 0)));
+		transforms.push_back(Transform3D(Basis(), Vector3(20, 0, 0)));
+		transforms.push_back(Transform3D(Basis(), Vector3(30, 0, 0)));
+
+		ERR_PRINT_OFF;
+		rs->instances_set_transforms(instances, transforms);
+		ERR_PRINT_ON;
+
+		CHECK(grid.is_at(0, Vector3(10, 0, 0)));
+		CHECK(grid.is_at(1, Vector3(30, 0, 0)));
+	}
+
+	SUBCASE("Mismatched array sizes are rejected") {
+		InstanceGrid grid(2);
+		Vector<Transform3D> transforms;
+		transforms.push_back(Transform3D(Basis(), Vector3(10, 0, 0)));
+
+		ERR_PRINT_OFF;
+		rs->instances_set_transforms(grid.instances, transforms);
+		ERR_PRINT_ON;
+
+		CHECK(grid.cull_at(Vector3(10, 0, 0)).is_empty());
+	}
+}
+
+} // namespace TestRenderingServerInstances
+
+#endif // TEST_RENDERING_SERVER_INSTANCES_H
@@ -0,0 +1,247 @@
+/**************************************************************************/
+/*  test_shader_compiler.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SHADER_COMPILER_H
+#define TEST_SHADER_COMPILER_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "servers/rendering/shader_compiler.h"
+
+#include "tests/test_macros.h"
+
+namespace TestShaderCompiler {
+
+static ShaderCompiler::DefaultIdentifierActions get_default_actions() {
+	ShaderCompiler::DefaultIdentifierActions actions;
+	actions.renames["COLOR"] = "color";
+	actions.renames["TIME"] = "global_time";
+	actions.render_mode_defines["unshaded"] = "#define MODE_UNSHADED\n";
+	actions.usage_defines["COLOR"] = "#define COLOR_USED\n";
+	actions.base_uniform_string = "material.";
+	return actions;
+}
+
+static String get_shader_code(int p_variant) {
+	return vformat("shader_type canvas_item;\nrender_mode unshaded;\nuniform vec4 tint : source_color;\nvoid fragment() {\n\tCOLOR = tint * sin(TIME * %d.0);\n}\n", p_variant);
+}
+
+// What a compilation reports back to the caller through its identifier actions.
+struct CompileResult {
+	Error error = FAILED;
+	String fragment_code;
+	Vector<String> defines;
+	bool unshaded = false;
+	bool uses_time = false;
+	bool writes_color = false;
+	HashMap<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+
+	void compile(ShaderCompiler &p_compiler, const String &p_code) {
+		ShaderCompiler::IdentifierActions actions;
+		actions.render_mode_flags["unshaded"] = &unshaded;
+		actions.usage_flag_pointers["TIME"] = &uses_time;
+		actions.write_flag_pointers["COLOR"] = &writes_color;
+		actions.uniforms = &uniforms;
+
+		ShaderCompiler::GeneratedCode gen_code;
+		error = p_compiler.compile(RS::SHADER_CANVAS_ITEM, p_code, &actions, "", gen_code);
+		if (gen_code.code.has("fragment")) {
+			fragment_code = gen_code.code["fragment"];
+		}
+		defines = gen_code.defines;
+	}
+
+	bool operator==(const CompileResult &p_other) const {
+		return error == p_other.error && fragment_code == p_other.fragment_code && defines == p_other.defines && unshaded == p_other.unshaded && uses_time == p_other.uses_time && writes_color == p_other.writes_color && uniforms.size() == p_other.uniforms.size();
+	}
+};
+
+TEST_CASE("[SceneTree][ShaderCompiler] Cached compilations report the same results") {
+	ShaderCompiler compiler;
+	compiler.initialize(get_default_actions());
+
+	CompileResult first;
+	first.compile(compiler, get_shader_code(1));
+	REQUIRE(first.error == OK);
+	CHECK_FALSE(first.fragment_code.is_empty());
+	CHECK(first.unshaded);
+	CHECK(first.uses_time);
+	CHECK(first.writes_color);
+	CHECK(first.uniforms.has("tint"));
+
+	// Served from the cache, the caller's flags and uniforms must still be set.
+	CompileResult second;
+	second.compile(compiler, get_shader_code(1));
+	CHECK(second == first);
+	CHECK(second.uniforms.has("tint"));
+
+	CompileResult other;
+	other.compile(compiler, get_shader_code(2));
+	REQUIRE(other.error == OK);
+	CHECK(other.fragment_code != first.fragment_code);
+
+	// Cached results are dropped, but compiling again must give the same code.
+	ShaderCompiler::global_shader_uniforms_changed();
+	CompileResult recompiled;
+	recompiled.compile(compiler, get_shader_code(1));
+	CHECK(recompiled == first);
+}
+
+TEST_CASE("[SceneTree][ShaderCompiler] Failed compilations aren't cached") {
+	ShaderCompiler compiler;
+	compiler.initialize(get_default_actions());
+	const String code = "shader_type canvas_item;\nvoid fragment() {\n\tCOLOR = undefined_variable;\n}\n";
+
+	ERR_PRINT_OFF;
+	CompileResult first;
+	first.compile(compiler, code);
+	CompileResult second;
+	second.compile(compiler, code);
+	ERR_PRINT_ON;
+
+	CHECK(first.error != OK);
+	CHECK(second.error != OK);
+	CHECK_FALSE(second.writes_color);
+}
+
+class ConcurrentCompiles {
+public:
+	static const int THREAD_COUNT = 4;
+	static const int SHADER_COUNT = 8;
+
+	ShaderCompiler compiler;
+	CompileResult results[THREAD_COUNT][SHADER_COUNT];
+
+	struct ThreadData {
+		ConcurrentCompiles *state = nullptr;
+		int index = 0;
+	} thread_data[THREAD_COUNT];
+
+	static void compile_all(void *p_userdata) {
+		ThreadData *data = static_cast<ThreadData *>(p_userdata);
+		for (int i = 0; i < SHADER_COUNT; i++) {
+			// Each thread starts from a different shader, so both cache misses and hits overlap.
+			const int variant = (i + data->index) % SHADER_COUNT;
+			data->state->results[data->index][variant].compile(data->state->compiler, get_shader_code(variant));
+		}
+	}
+
+	void run() {
+		compiler.initialize(get_default_actions());
+		Thread threads[THREAD_COUNT];
+		for (int i = 0; i < THREAD_COUNT; i++) {
+			thread_data[i].state = this;
+			thread_data[i].index = i;
+			threads[i].start(&ConcurrentCompiles::compile_all, &thread_data[i]);
+		}
+		for (int i = 0; i < THREAD_COUNT; i++) {
+			threads[i].wait_to_finish();
+		}
+	}
+};
+
+TEST_CASE("[SceneTree][ShaderCompiler] Concurrent compilations match serial ones") {
+	ConcurrentCompiles concurrent;
+	concurrent.run();
+
+	ShaderCompiler serial_compiler;
+	serial_compiler.initialize(get_default_actions());
+
+	int mismatches = 0;
+	for (int i = 0; i < ConcurrentCompiles::SHADER_COUNT; i++) {
+		CompileResult serial;
+		serial.compile(serial_compiler, get_shader_code(i));
+		REQUIRE(serial.error == OK);
+		for (int j = 0; j < ConcurrentCompiles::THREAD_COUNT; j++) {
+			if (!(concurrent.results[j][i] == serial)) {
+				mismatches++;
+			}
+		}
+	}
+	CHECK_MESSAGE(mismatches == 0, "Every thread should get the same results as a serial compilation.");
+}
+
+class CompileBenchmark {
+public:
+	static const int THREAD_COUNT = 4;
+	static const int SHADER_COUNT = 256;
+
+	ShaderCompiler compiler;
+
+	struct ThreadData {
+		CompileBenchmark *state = nullptr;
+		int from = 0;
+		int to = 0;
+	} thread_data[THREAD_COUNT];
+
+	static void compile_range(void *p_userdata) {
+		ThreadData *data = static_cast<ThreadData *>(p_userdata);
+		for (int i = data->from; i < data->to; i++) {
+			CompileResult result;
+			result.compile(data->state->compiler, get_shader_code(i));
+		}
+	}
+
+	uint64_t run(int p_thread_count) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		Thread threads[THREAD_COUNT];
+		for (int i = 0; i < p_thread_count; i++) {
+			thread_data[i].state = this;
+			thread_data[i].from = SHADER_COUNT * i / p_thread_count;
+			thread_data[i].to = SHADER_COUNT * (i + 1) / p_thread_count;
+			threads[i].start(&CompileBenchmark::compile_range, &thread_data[i]);
+		}
+		for (int i = 0; i < p_thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+		return OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	CompileBenchmark() {
+		compiler.initialize(get_default_actions());
+	}
+};
+
+TEST_CASE("[Stress][SceneTree][ShaderCompiler] Compiling 256 shaders") {
+	CompileBenchmark benchmark;
+
+	ShaderCompiler::global_shader_uniforms_changed();
+	const uint64_t serial_usec = benchmark.run(1);
+	const uint64_t cached_usec = benchmark.run(1);
+
+	ShaderCompiler::global_shader_uniforms_changed();
+	const uint64_t concurrent_usec = benchmark.run(CompileBenchmark::THREAD_COUNT);
+
+	MESSAGE("Shader front-end compiles of ", CompileBenchmark::SHADER_COUNT, " shaders, one thread: ", serial_usec, " usec, cached: ", cached_usec, " usec, ", CompileBenchmark::THREAD_COUNT, " threads: ", concurrent_usec, " usec.");
+}
+
+} // namespace TestShaderCompiler
+
+#endif // TEST_SHADER_COMPILER_H
@@ -31,6 +31,7 @@
 #ifndef TEST_NAVIGATION_SERVER_3D_H
 #define TEST_NAVIGATION_SERVER_3D_H
 
+#include "core/os/os.h"
 #include "modules/navigation/nav_utils.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
@@ -62,6 +63,57 @@ static inline Array build_array(Variant item, Targs... Fargs) {
 	return a;
 }
 
+// Builds a navigation mesh with a single square polygon.
+static inline Ref<NavigationMesh> build_square_navigation_mesh(const Vector3 &p_corner, real_t p_size) {
+	Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+	PackedVector3Array vertices;
+	vertices.push_back(p_corner);
+	vertices.push_back(p_corner + Vector3(p_size, 0, 0));
+	vertices.push_back(p_corner + Vector3(p_size, 0, p_size));
+	vertices.push_back(p_corner + Vector3(0, 0, p_size));
+	navigation_mesh->set_vertices(vertices);
+	PackedInt32Array polygon;
+	polygon.push_back(0);
+	polygon.push_back(1);
+	polygon.push_back(2);
+	polygon.push_back(3);
+	navigation_mesh->add_polygon(polygon);
+	return navigation_mesh;
+}
+
+// Sums the surface area of the navigation mesh polygons.
+static inline real_t get_navigation_mesh_area(const Ref<NavigationMesh> &p_navigation_mesh) {
+	const Vector<Vector3> vertices = p_navigation_mesh->get_vertices();
+	real_t area = 0.0;
+	for (int i = 0; i < p_navigation_mesh->get_polygon_count(); i++) {
+		const Vector<int> polygon = p_navigation_mesh->get_polygon(i);
+		for (int j = 2; j < polygon.size(); j++) {
+			area += Face3(vertices[polygon[0]], vertices[polygon[j - 1]], vertices[polygon[j]]).get_area();
+		}
+	}
+	return area;
+}
+
+static inline real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+// Synchronizes the server until the path query batch delivered its results, or gives up after a few seconds.
+static inline bool wait_for_path_query_batch(NavigationServer3D *p_navigation_server, uint32_t p_batch_id) {
+	for (int i = 0; i < 5000; i++) {
+		p_navigation_server->sync();
+		if (p_navigation_server->is_query_path_batch_completed(p_batch_id)) {
+			return true;
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+	return false;
+}
+
 struct GreaterThan {
 	bool operator()(int p_a, int p_b) const { return p_a > p_b; }
 };
@@ -795,6 +847,473 @@ TEST_SUITE("[Navigation]") {
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should bake tiled navigation meshes like monolithic ones") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(10.0, 0.001, 10.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+
+		Ref<NavigationMesh> monolithic_navigation_mesh = memnew(NavigationMesh);
+		navigation_server->bake_from_source_geometry_data(monolithic_navigation_mesh, source_geometry, Callable());
+		Ref<NavigationMesh> tiled_navigation_mesh = memnew(NavigationMesh);
+		tiled_navigation_mesh->set_tile_size(2.5);
+		navigation_server->bake_from_source_geometry_data(tiled_navigation_mesh, source_geometry, Callable());
+
+		REQUIRE_GT(monolithic_navigation_mesh->get_polygon_count(), 0);
+		REQUIRE_GT(tiled_navigation_mesh->get_polygon_count(), monolithic_navigation_mesh->get_polygon_count());
+		CHECK(Math::is_equal_approx(get_navigation_mesh_area(tiled_navigation_mesh), get_navigation_mesh_area(monolithic_navigation_mesh), real_t(1.0)));
+		for (const Vector3 &vertex : tiled_navigation_mesh->get_vertices()) {
+			CHECK_LE(Math::abs(vertex.x), 5.0);
+			CHECK_LE(Math::abs(vertex.z), 5.0);
+		}
+
+		SUBCASE("Tiles should be joined into one connected navigation mesh") {
+			RID map = navigation_server->map_create();
+			RID region = navigation_server->region_create();
+			navigation_server->map_set_active(map, true);
+			navigation_server->region_set_map(region, map);
+			navigation_server->region_set_navigation_mesh(region, tiled_navigation_mesh);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-4, 0, -4), Vector3(4, 0, 4), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK(Math::is_equal_approx(path[path.size() - 1].x, real_t(4.0), real_t(0.1)));
+			CHECK(Math::is_equal_approx(path[path.size() - 1].z, real_t(4.0), real_t(0.1)));
+
+			navigation_server->free(region);
+			navigation_server->free(map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+
+		SUBCASE("Baking again should only rebake the tiles whose source geometry changed") {
+			const Vector<Vector3> vertices = tiled_navigation_mesh->get_vertices();
+			const int polygon_count = tiled_navigation_mesh->get_polygon_count();
+			navigation_server->bake_from_source_geometry_data(tiled_navigation_mesh, source_geometry, Callable());
+			CHECK(tiled_navigation_mesh->get_vertices() == vertices);
+			CHECK_EQ(tiled_navigation_mesh->get_polygon_count(), polygon_count);
+
+			Ref<NavigationMeshSourceGeometryData3D> smaller_source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+			BoxMesh::create_mesh_array(arr, Vector3(6.0, 0.001, 6.0));
+			smaller_source_geometry->add_mesh_array(arr, Transform3D());
+			navigation_server->bake_from_source_geometry_data(monolithic_navigation_mesh, smaller_source_geometry, Callable());
+			navigation_server->bake_from_source_geometry_data(tiled_navigation_mesh, smaller_source_geometry, Callable());
+			CHECK(Math::is_equal_approx(get_navigation_mesh_area(tiled_navigation_mesh), get_navigation_mesh_area(monolithic_navigation_mesh), real_t(1.0)));
+			for (const Vector3 &vertex : tiled_navigation_mesh->get_vertices()) {
+				CHECK_LE(Math::abs(vertex.x), 3.0);
+				CHECK_LE(Math::abs(vertex.z), 3.0);
+			}
+		}
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should answer spatial queries across regions precisely") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		RID map = navigation_server->map_create();
+		RID region_a = navigation_server->region_create();
+		RID region_b = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region_a, map);
+		navigation_server->region_set_map(region_b, map);
+		navigation_server->region_set_navigation_mesh(region_a, build_square_navigation_mesh(Vector3(-10, 0, -5), 5.0));
+		navigation_server->region_set_navigation_mesh(region_b, build_square_navigation_mesh(Vector3(5, 2, -5), 5.0));
+		navigation_server->region_set_navigation_layers(region_b, 2);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		SUBCASE("Closest point queries should pick the nearest region") {
+			CHECK(navigation_server->map_get_closest_point(map, Vector3(-7, 1, 0)).is_equal_approx(Vector3(-7, 0, 0)));
+			CHECK_EQ(navigation_server->map_get_closest_point_owner(map, Vector3(-7, 1, 0)), region_a);
+			CHECK(navigation_server->map_get_closest_point(map, Vector3(7, 5, 1)).is_equal_approx(Vector3(7, 2, 1)));
+			CHECK_EQ(navigation_server->map_get_closest_point_owner(map, Vector3(7, 5, 1)), region_b);
+			// Between both regions, the edge of region A is closer.
+			CHECK(navigation_server->map_get_closest_point(map, Vector3(0, 0, 0)).is_equal_approx(Vector3(-5, 0, 0)));
+		}
+
+		SUBCASE("Segment queries should return the closest intersection or edge point") {
+			CHECK(navigation_server->map_get_closest_point_to_segment(map, Vector3(7, 10, 0), Vector3(7, -10, 0), true).is_equal_approx(Vector3(7, 2, 0)));
+			CHECK(navigation_server->map_get_closest_point_to_segment(map, Vector3(-8, 10, 1), Vector3(-8, -10, 1), true).is_equal_approx(Vector3(-8, 0, 1)));
+			CHECK(navigation_server->map_get_closest_point_to_segment(map, Vector3(0, 1, 0), Vector3(1, 1, 0), false).is_equal_approx(Vector3(5, 2, 0)));
+		}
+
+		SUBCASE("Random points should respect navigation layers") {
+			for (int i = 0; i < 20; i++) {
+				const Vector3 point = navigation_server->map_get_random_point(map, 2, true);
+				CHECK_GE(point.x, 5.0 - CMP_EPSILON);
+				CHECK_LE(point.x, 10.0 + CMP_EPSILON);
+				CHECK(Math::is_equal_approx(point.y, real_t(2.0)));
+			}
+			CHECK_EQ(navigation_server->map_get_random_point(map, 4, true), Vector3());
+		}
+
+		SUBCASE("Navigation layer changes should apply to random points") {
+			navigation_server->region_set_navigation_layers(region_b, 4);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->map_get_random_point(map, 2, false), Vector3());
+			CHECK_GE(navigation_server->map_get_random_point(map, 4, false).x, 5.0 - CMP_EPSILON);
+		}
+
+		navigation_server->free(region_b);
+		navigation_server->free(region_a);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should relink regions that change") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		RID map = navigation_server->map_create();
+		RID region_a = navigation_server->region_create();
+		RID region_b = navigation_server->region_create();
+		RID region_c = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_edge_connection_margin(map, 0.5);
+		navigation_server->region_set_map(region_a, map);
+		navigation_server->region_set_map(region_b, map);
+		navigation_server->region_set_map(region_c, map);
+		// Region A and B share an edge, region C is connected to B by the edge connection margin.
+		navigation_server->region_set_navigation_mesh(region_a, build_square_navigation_mesh(Vector3(0, 0, 0), 4.0));
+		navigation_server->region_set_navigation_mesh(region_b, build_square_navigation_mesh(Vector3(4, 0, 0), 4.0));
+		navigation_server->region_set_navigation_mesh(region_c, build_square_navigation_mesh(Vector3(8.3, 0, 0), 4.0));
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		CHECK_EQ(navigation_server->region_get_connections_count(region_b), 1);
+		CHECK_EQ(navigation_server->region_get_connections_count(region_c), 1);
+		Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(1, 0, 2), Vector3(11, 0, 2), true);
+		REQUIRE_FALSE(path.is_empty());
+		CHECK(path[path.size() - 1].is_equal_approx(Vector3(11, 0, 2)));
+
+		SUBCASE("Moving a region should drop and remake its connections") {
+			navigation_server->region_set_transform(region_c, Transform3D(Basis(), Vector3(10, 0, 0)));
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->region_get_connections_count(region_b), 0);
+			CHECK_EQ(navigation_server->region_get_connections_count(region_c), 0);
+			path = navigation_server->map_get_path(map, Vector3(1, 0, 2), Vector3(21, 0, 2), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK_LE(path[path.size() - 1].x, 8.0 + CMP_EPSILON);
+
+			navigation_server->region_set_transform(region_c, Transform3D());
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->region_get_connections_count(region_b), 1);
+			CHECK_EQ(navigation_server->region_get_connections_count(region_c), 1);
+			path = navigation_server->map_get_path(map, Vector3(1, 0, 2), Vector3(11, 0, 2), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(11, 0, 2)));
+		}
+
+		SUBCASE("Removing a region should disconnect its neighbors") {
+			navigation_server->region_set_map(region_b, RID());
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->region_get_connections_count(region_c), 0);
+			path = navigation_server->map_get_path(map, Vector3(1, 0, 2), Vector3(11, 0, 2), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK_LE(path[path.size() - 1].x, 4.0 + CMP_EPSILON);
+
+			navigation_server->region_set_map(region_b, map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->region_get_connections_count(region_c), 1);
+			path = navigation_server->map_get_path(map, Vector3(1, 0, 2), Vector3(11, 0, 2), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(11, 0, 2)));
+		}
+
+		SUBCASE("Disabling a region should disconnect its neighbors") {
+			navigation_server->region_set_enabled(region_b, false);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->region_get_connections_count(region_c), 0);
+			path = navigation_server->map_get_path(map, Vector3(1, 0, 2), Vector3(11, 0, 2), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK_LE(path[path.size() - 1].x, 4.0 + CMP_EPSILON);
+
+			navigation_server->region_set_enabled(region_b, true);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->region_get_connections_count(region_c), 1);
+			path = navigation_server->map_get_path(map, Vector3(1, 0, 2), Vector3(11, 0, 2), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(11, 0, 2)));
+		}
+
+		navigation_server->free(region_c);
+		navigation_server->free(region_b);
+		navigation_server->free(region_a);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should compute flow fields over valid map properly") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(10.0, 0.001, 10.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+		navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+		CHECK_NE(navigation_mesh->get_polygon_count(), 0);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		RID flow_field = navigation_server->flow_field_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->flow_field_set_map(flow_field, map);
+		Vector<Vector3> targets;
+		targets.push_back(Vector3(4, 0, 4));
+		navigation_server->flow_field_set_targets(flow_field, targets);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		SUBCASE("Setters/getters should work") {
+			CHECK_EQ(navigation_server->flow_field_get_map(flow_field), map);
+			CHECK_EQ(navigation_server->flow_field_get_targets(flow_field), targets);
+			CHECK_EQ(navigation_server->flow_field_get_navigation_layers(flow_field), 1);
+		}
+
+		SUBCASE("Samples should lead toward the target") {
+			const Vector3 direction = navigation_server->flow_field_get_direction(flow_field, Vector3(-4, 0, -4));
+			CHECK(direction.is_normalized());
+			CHECK_GT(direction.dot(Vector3(1, 0, 1).normalized()), 0.5);
+			const real_t distance = navigation_server->flow_field_get_distance(flow_field, Vector3(-4, 0, -4));
+			CHECK_GT(distance, 8.0);
+			CHECK_LT(distance, 20.0);
+
+			Vector<Vector3> positions;
+			positions.push_back(Vector3(-4, 0, -4));
+			positions.push_back(Vector3(4, 0, -4));
+			const Vector<Vector3> directions = navigation_server->flow_field_get_directions(flow_field, positions);
+			CHECK_EQ(directions.size(), 2);
+			CHECK(directions[0].is_equal_approx(direction));
+			CHECK_GT(directions[1].dot(Vector3(0, 0, 1)), 0.5);
+		}
+
+		SUBCASE("Region cost changes should update the field") {
+			const real_t distance = navigation_server->flow_field_get_distance(flow_field, Vector3(-4, 0, -4));
+			navigation_server->region_set_travel_cost(region, 2.0);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK(Math::is_equal_approx(navigation_server->flow_field_get_distance(flow_field, Vector3(-4, 0, -4)), distance * 2.0, real_t(0.01)));
+		}
+
+		SUBCASE("Non-matching navigation layers should yield no direction") {
+			navigation_server->flow_field_set_navigation_layers(flow_field, 2);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->flow_field_get_direction(flow_field, Vector3(-4, 0, -4)), Vector3());
+			CHECK_EQ(navigation_server->flow_field_get_distance(flow_field, Vector3(-4, 0, -4)), FLT_MAX);
+		}
+
+		navigation_server->free(flow_field);
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should answer path query batches like single path queries") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		RID map = navigation_server->map_create();
+		RID region_a = navigation_server->region_create();
+		RID region_b = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region_a, map);
+		navigation_server->region_set_map(region_b, map);
+		navigation_server->region_set_navigation_mesh(region_a, build_square_navigation_mesh(Vector3(-10, 0, -5), 10.0));
+		navigation_server->region_set_navigation_mesh(region_b, build_square_navigation_mesh(Vector3(0, 0, -5), 10.0));
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 starts[] = { Vector3(-9, 0, -4), Vector3(9, 0, 4), Vector3(-1, 0, 0), Vector3(-9, 0, 4) };
+		const Vector3 targets[] = { Vector3(9, 0, 4), Vector3(-9, 0, -4), Vector3(1, 0, 0), Vector3(-8, 0, 3) };
+		const int query_count = 4;
+
+		TypedArray<NavigationPathQueryParameters3D> parameters;
+		TypedArray<NavigationPathQueryResult3D> results;
+		Vector<Ref<NavigationPathQueryResult3D>> expected_results;
+		for (int i = 0; i < query_count; i++) {
+			Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+			query_parameters->set_map(map);
+			query_parameters->set_start_position(starts[i]);
+			query_parameters->set_target_position(targets[i]);
+			parameters.push_back(query_parameters);
+			results.push_back(Ref<NavigationPathQueryResult3D>(memnew(NavigationPathQueryResult3D)));
+
+			Ref<NavigationPathQueryResult3D> expected_result = memnew(NavigationPathQueryResult3D);
+			navigation_server->query_path(query_parameters, expected_result);
+			expected_results.push_back(expected_result);
+		}
+
+		CallableMock mock;
+
+		SUBCASE("Results should match single queries and the callback should be called once") {
+			const uint32_t batch_id = navigation_server->query_path_batch_async(parameters, results, callable_mp(&mock, &CallableMock::function1).bind(7));
+			REQUIRE_NE(batch_id, 0u);
+			REQUIRE(wait_for_path_query_batch(navigation_server, batch_id));
+			CHECK_EQ(mock.function1_calls, 1);
+			CHECK_EQ(mock.function1_latest_arg0, Variant(7));
+
+			for (int i = 0; i < query_count; i++) {
+				const Ref<NavigationPathQueryResult3D> result = results[i];
+				CHECK_NE(result->get_path().size(), 0);
+				CHECK_EQ(result->get_path(), expected_results[i]->get_path());
+				CHECK_EQ(result->get_path_types(), expected_results[i]->get_path_types());
+				CHECK_EQ(result->get_path_rids(), expected_results[i]->get_path_rids());
+				CHECK_EQ(result->get_path_owner_ids(), expected_results[i]->get_path_owner_ids());
+			}
+
+			// Delivered batches are not delivered again.
+			navigation_server->sync();
+			CHECK_EQ(mock.function1_calls, 1);
+		}
+
+		SUBCASE("Several batches in flight should each get their own results") {
+			TypedArray<NavigationPathQueryParameters3D> reversed_parameters;
+			TypedArray<NavigationPathQueryResult3D> reversed_results;
+			for (int i = query_count - 1; i >= 0; i--) {
+				reversed_parameters.push_back(parameters[i]);
+				reversed_results.push_back(Ref<NavigationPathQueryResult3D>(memnew(NavigationPathQueryResult3D)));
+			}
+
+			const uint32_t batch_a = navigation_server->query_path_batch_async(parameters, results);
+			const uint32_t batch_b = navigation_server->query_path_batch_async(reversed_parameters, reversed_results);
+			REQUIRE_NE(batch_a, 0u);
+			REQUIRE_NE(batch_b, 0u);
+			CHECK_NE(batch_a, batch_b);
+			REQUIRE(wait_for_path_query_batch(navigation_server, batch_a));
+			REQUIRE(wait_for_path_query_batch(navigation_server, batch_b));
+
+			for (int i = 0; i < query_count; i++) {
+				const Ref<NavigationPathQueryResult3D> result = results[i];
+				const Ref<NavigationPathQueryResult3D> reversed_result = reversed_results[query_count - 1 - i];
+				CHECK_EQ(result->get_path(), expected_results[i]->get_path());
+				CHECK_EQ(reversed_result->get_path(), expected_results[i]->get_path());
+			}
+		}
+
+		SUBCASE("Invalid batches should not start") {
+			TypedArray<NavigationPathQueryResult3D> too_few_results;
+			too_few_results.push_back(results[0]);
+			ERR_PRINT_OFF;
+			CHECK_EQ(navigation_server->query_path_batch_async(parameters, too_few_results), 0u);
+
+			Ref<NavigationPathQueryParameters3D> invalid_map_parameters = memnew(NavigationPathQueryParameters3D);
+			invalid_map_parameters->set_map(RID());
+			TypedArray<NavigationPathQueryParameters3D> invalid_parameters;
+			invalid_parameters.push_back(invalid_map_parameters);
+			CHECK_EQ(navigation_server->query_path_batch_async(invalid_parameters, too_few_results), 0u);
+			ERR_PRINT_ON;
+		}
+
+		SUBCASE("Freeing the region while a batch is pending should still deliver the results") {
+			const uint32_t batch_id = navigation_server->query_path_batch_async(parameters, results, callable_mp(&mock, &CallableMock::function1).bind(7));
+			REQUIRE_NE(batch_id, 0u);
+			navigation_server->free(region_b);
+			region_b = RID();
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			REQUIRE(wait_for_path_query_batch(navigation_server, batch_id));
+			CHECK_EQ(mock.function1_calls, 1);
+			for (int i = 0; i < query_count; i++) {
+				const Ref<NavigationPathQueryResult3D> result = results[i];
+				CHECK_NE(result->get_path().size(), 0);
+			}
+		}
+
+		SUBCASE("Freeing the map while a batch is pending should still deliver the results") {
+			const uint32_t batch_id = navigation_server->query_path_batch_async(parameters, results, callable_mp(&mock, &CallableMock::function1).bind(7));
+			REQUIRE_NE(batch_id, 0u);
+			navigation_server->free(region_b);
+			navigation_server->free(region_a);
+			navigation_server->free(map);
+			region_b = RID();
+			region_a = RID();
+			map = RID();
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			REQUIRE(wait_for_path_query_batch(navigation_server, batch_id));
+			CHECK_EQ(mock.function1_calls, 1);
+			for (int i = 0; i < query_count; i++) {
+				const Ref<NavigationPathQueryResult3D> result = results[i];
+				CHECK_NE(result->get_path().size(), 0);
+			}
+		}
+
+		if (region_b.is_valid()) {
+			navigation_server->free(region_b);
+		}
+		if (region_a.is_valid()) {
+			navigation_server->free(region_a);
+		}
+		if (map.is_valid()) {
+			navigation_server->free(map);
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should find the same goal with hierarchical and flat path queries") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+
+		// An 8x8 grid of regions with a wall in column 4 that only has a gap in the last row,
+		// so paths across the wall have to detour through several clusters.
+		const int grid_size = 8;
+		const real_t region_size = 5.0;
+		Vector<RID> regions;
+		for (int z = 0; z < grid_size; z++) {
+			for (int x = 0; x < grid_size; x++) {
+				if (x == 4 && z < grid_size - 1) {
+					continue;
+				}
+				RID region = navigation_server->region_create();
+				navigation_server->region_set_map(region, map);
+				navigation_server->region_set_navigation_mesh(region, build_square_navigation_mesh(Vector3(x * region_size, 0, z * region_size), region_size));
+				regions.push_back(region);
+			}
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 starts[] = { Vector3(1, 0, 1), Vector3(39, 0, 1), Vector3(2, 0, 38), Vector3(12, 0, 12) };
+		const Vector3 targets[] = { Vector3(39, 0, 1), Vector3(1, 0, 20), Vector3(38, 0, 38), Vector3(13, 0, 14) };
+
+		for (int i = 0; i < 4; i++) {
+			Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+			query_parameters->set_map(map);
+			query_parameters->set_start_position(starts[i]);
+			query_parameters->set_target_position(targets[i]);
+
+			Ref<NavigationPathQueryResult3D> flat_result = memnew(NavigationPathQueryResult3D);
+			navigation_server->query_path(query_parameters, flat_result);
+			const Vector<Vector3> flat_path = flat_result->get_path();
+			REQUIRE_FALSE(flat_path.is_empty());
+			CHECK(flat_path[flat_path.size() - 1].is_equal_approx(targets[i]));
+
+			query_parameters->set_use_hierarchical_pathfinding(true);
+			Ref<NavigationPathQueryResult3D> hierarchical_result = memnew(NavigationPathQueryResult3D);
+			navigation_server->query_path(query_parameters, hierarchical_result);
+			const Vector<Vector3> hierarchical_path = hierarchical_result->get_path();
+			REQUIRE_FALSE(hierarchical_path.is_empty());
+			CHECK(hierarchical_path[0].is_equal_approx(flat_path[0]));
+			CHECK(hierarchical_path[hierarchical_path.size() - 1].is_equal_approx(flat_path[flat_path.size() - 1]));
+			// Ties between corridors may be broken differently, but the route must not get noticeably longer.
+			CHECK_LE(get_path_length(hierarchical_path), get_path_length(flat_path) * 1.1);
+
+			// A weighted estimate may find a longer path, but never longer than the bound allows.
+			query_parameters->set_hierarchical_suboptimality_bound(2.0);
+			Ref<NavigationPathQueryResult3D> bounded_result = memnew(NavigationPathQueryResult3D);
+			navigation_server->query_path(query_parameters, bounded_result);
+			const Vector<Vector3> bounded_path = bounded_result->get_path();
+			REQUIRE_FALSE(bounded_path.is_empty());
+			CHECK(bounded_path[bounded_path.size() - 1].is_equal_approx(flat_path[flat_path.size() - 1]));
+			CHECK_LE(get_path_length(bounded_path), get_path_length(flat_path) * 2.0 + CMP_EPSILON);
+		}
+
+		// The path from the bottom left to the bottom right has to go around the wall.
+		const Vector<Vector3> detour = navigation_server->map_get_path(map, starts[0], targets[0], true);
+		REQUIRE_FALSE(detour.is_empty());
+		CHECK_GT(get_path_length(detour), 70.0);
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
 	// FIXME: The race condition mentioned below is actually a problem and fails on CI (GH-90613).
 	/*
 	TEST_CASE("[NavigationServer3D] Server should be able to bake asynchronously") {